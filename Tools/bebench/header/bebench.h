@@ -0,0 +1,37 @@
+#ifndef BEBENCH_HEADER
+#define BEBENCH_HEADER
+
+#include <cstddef>
+
+/// Benchmark interface.
+class Benchmark
+{
+public:
+	virtual ~Benchmark() { }
+
+	/// Prints what the benchmark measures & its arguments.
+	virtual void PrintHelp() const = 0;
+	/// Runs the benchmark.
+	virtual int Run(int argc, const char* argv[]) const = 0;
+};
+
+/// Registers the given benchmark.
+void RegisterBenchmark(const char *name, const Benchmark *pBenchmark);
+/// Unregisters the given benchmark.
+void UnregisterBenchmark(const char *name);
+
+/// Gets the value of the given integer argument (e.g. "/n:"), returns the given default value if missing.
+int GetIntArgument(int argc, const char* argv[], const char *name, int defaultValue);
+/// Checks if the given flag argument (e.g. "/ws") was passed.
+bool HasArgument(int argc, const char* argv[], const char *name);
+
+/// Gets the number of logical processors.
+size_t GetProcessorCount();
+
+/// Simulates the given amount of work.
+void SimulateWork(unsigned int iterations);
+
+/// Prints one line of results, the number of items processed in the given time & the resulting throughput.
+void PrintResult(const char *label, double seconds, double itemCount, const char *itemName);
+
+#endif
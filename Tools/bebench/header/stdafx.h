@@ -0,0 +1,20 @@
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently, but
+// are changed infrequently
+//
+
+#pragma once
+
+#include "targetver.h"
+
+#include <beCore/beCore.h>
+
+#include <cstdio>
+#include <tchar.h>
+#include <cstring>
+
+#include <iostream>
+
+using namespace lean::types;
+LEAN_REIMPORT_NUMERIC_TYPES;
+using namespace lean::strings::types;
\ No newline at end of file
@@ -0,0 +1,134 @@
+// bebench.cpp : Defines the entry point for the console application.
+//
+
+#include "stdafx.h"
+#include "bebench.h"
+#include <lean/logging/log.h>
+#include <lean/logging/log_stream.h>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <iomanip>
+#include <Windows.h>
+
+/// Registered benchmarks.
+typedef std::map<std::string, const Benchmark*> benchmark_map;
+
+namespace
+{
+
+/// Gets all registered benchmarks.
+benchmark_map& GetBenchmarks()
+{
+	// NOTE: Benchmarks register during static initialization of other translation units
+	static benchmark_map benchmarks;
+	return benchmarks;
+}
+
+/// Prints all registered benchmarks.
+void PrintHelp()
+{
+	std::cout << " Syntax: bebench <benchmark> [arguments]"  << std::endl << std::endl;
+
+	const benchmark_map &benchmarks = GetBenchmarks();
+
+	for (benchmark_map::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it)
+	{
+		std::cout << " " << it->first << std::endl;
+		it->second->PrintHelp();
+		std::cout << std::endl;
+	}
+}
+
+} // namespace
+
+// Runs a specified benchmark.
+int main(int argc, const char* argv[])
+{
+	lean::log_stream coutLogStream(&std::cout);
+	lean::error_log().add_target(&coutLogStream);
+	lean::info_log().add_target(&coutLogStream);
+
+	const benchmark_map &benchmarks = GetBenchmarks();
+	benchmark_map::const_iterator itBenchmark = (argc > 1) ? benchmarks.find(argv[1]) : benchmarks.end();
+
+	if (itBenchmark == benchmarks.end())
+	{
+		PrintHelp();
+		return (argc > 1) ? -1 : 0;
+	}
+
+	try
+	{
+		return itBenchmark->second->Run(argc - 2, &argv[2]);
+	}
+	catch (const std::runtime_error &error)
+	{
+		std::cout << "ERROR: An exception occurred: " << error.what() << std::endl;
+		return -1;
+	}
+}
+
+// Registers the given benchmark.
+void RegisterBenchmark(const char *name, const Benchmark *pBenchmark)
+{
+	LEAN_ASSERT(name);
+	LEAN_ASSERT(pBenchmark);
+
+	GetBenchmarks()[name] = pBenchmark;
+}
+
+// Unregisters the given benchmark.
+void UnregisterBenchmark(const char *name)
+{
+	GetBenchmarks().erase(name);
+}
+
+// Gets the value of the given integer argument.
+int GetIntArgument(int argc, const char* argv[], const char *name, int defaultValue)
+{
+	size_t nameLength = strlen(name);
+
+	for (int i = 0; i < argc; ++i)
+		if (_strnicmp(argv[i], name, nameLength) == 0)
+			return atoi(argv[i] + nameLength);
+
+	return defaultValue;
+}
+
+// Checks if the given flag argument was passed.
+bool HasArgument(int argc, const char* argv[], const char *name)
+{
+	for (int i = 0; i < argc; ++i)
+		if (_stricmp(argv[i], name) == 0)
+			return true;
+
+	return false;
+}
+
+// Gets the number of logical processors.
+size_t GetProcessorCount()
+{
+	SYSTEM_INFO sysInfo;
+	::GetSystemInfo(&sysInfo);
+	return sysInfo.dwNumberOfProcessors;
+}
+
+// Simulates the given amount of work.
+void SimulateWork(unsigned int iterations)
+{
+	volatile unsigned int sink = 0;
+
+	for (unsigned int i = 0; i < iterations; ++i)
+		sink += i;
+}
+
+// Prints one line of results.
+void PrintResult(const char *label, double seconds, double itemCount, const char *itemName)
+{
+	std::cout << "  " << std::left << std::setw(32) << label << std::right
+		<< std::fixed << std::setprecision(3) << std::setw(10) << seconds * 1000.0 << " ms"
+		<< std::setw(14) << std::setprecision(0) << itemCount << " " << itemName
+		<< std::setw(14) << std::setprecision(3) << ((seconds > 0.0) ? itemCount / seconds * 1.0e-6 : 0.0) << " M/s"
+		<< std::endl;
+}
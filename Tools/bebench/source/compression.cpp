@@ -0,0 +1,184 @@
+// compression.cpp : Compressed content load benchmarks.
+//
+// NOTE: "Cold" loads are the first load of a file in this process. The file was written just before unless passed
+// via /i:, in which case it is only uncached by the OS if it was not touched since the last reboot (or standby flush).
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beCore/beCompressedContent.h>
+#include <beCore/beThreadPool.h>
+
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include <lean/io/raw_file.h>
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Load timings.
+struct LoadTimes
+{
+	double coldSeconds;
+	double warmSeconds;
+	bool bValid;
+};
+
+/// Creates repetitive float data with a little noise, compressing roughly like vertex data.
+void CreateContent(std::vector<char> &data, size_t size)
+{
+	data.resize(size);
+	float *floats = reinterpret_cast<float*>(&data[0]);
+	const size_t floatCount = size / sizeof(float);
+
+	uint4 noise = 12345;
+
+	for (size_t i = 0; i < floatCount; ++i)
+	{
+		noise = noise * 1103515245 + 12345;
+		floats[i] = static_cast<float>(i % 4096) * 0.25f + static_cast<float>((noise >> 16) & 0x3) * 0.125f;
+	}
+}
+
+/// Reads the whole given file.
+void ReadFile(const utf8_string &file, std::vector<char> &data)
+{
+	lean::raw_file inFile(file, lean::file::read, lean::file::open, lean::file::sequential);
+	data.resize( static_cast<size_t>(inFile.size()) );
+
+	if (!data.empty())
+		inFile.read(&data[0], data.size());
+}
+
+/// Loads the given file as the engine does, decompressing on the given thread pool if compressed.
+bool LoadFile(const utf8_string &file, std::vector<char> &data, uint8 expectedSize, beCore::ThreadPool *pPool, bool bCompressed)
+{
+	ReadFile(file, data);
+
+	if (bCompressed)
+	{
+		lean::com_ptr<beCore::Content> pContent = beCore::DecompressContent(&data[0], data.size(), pPool);
+		return (pContent->Size() == expectedSize);
+	}
+	else
+		return (data.size() == expectedSize);
+}
+
+/// Loads the given file once cold & the given number of rounds warm.
+LoadTimes RunLoads(const utf8_string &file, uint8 expectedSize, beCore::ThreadPool *pPool, bool bCompressed, uint4 roundCount)
+{
+	LoadTimes times;
+	std::vector<char> data;
+
+	lean::highres_timer coldTimer;
+	times.bValid = LoadFile(file, data, expectedSize, pPool, bCompressed);
+	times.coldSeconds = coldTimer.seconds();
+
+	lean::highres_timer warmTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		times.bValid &= LoadFile(file, data, expectedSize, pPool, bCompressed);
+
+	times.warmSeconds = warmTimer.seconds() / roundCount;
+
+	return times;
+}
+
+/// Prints the given timings.
+void PrintLoadTimes(const char *label, const LoadTimes &times, double megabytes)
+{
+	std::cout << "  " << label << ":" << std::endl;
+	PrintResult("  cold", times.coldSeconds, megabytes, "MB");
+	PrintResult("  warm", times.warmSeconds, megabytes, "MB");
+}
+
+/// Compressed content load benchmark.
+const struct CompressionBenchmark : public Benchmark
+{
+	/// Constructor.
+	CompressionBenchmark() { RegisterBenchmark("compression", this); }
+	/// Destructor.
+	~CompressionBenchmark() { UnregisterBenchmark("compression"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Cold & warm load times of block-compressed content, decompressed serially & in"  << std::endl;
+		std::cout << "  parallel, vs. loading the same content uncompressed. Cold loads are the first load"  << std::endl;
+		std::cout << "  in this process, truly cold only for input files untouched since the last reboot."  << std::endl;
+		std::cout << "  /i:<file>      Uncompressed input file, replaces generated content."  << std::endl;
+		std::cout << "  /m:<MB>        Generated content size. Default: 64"  << std::endl;
+		std::cout << "  /b:<KB>        Block size. Default: 256"  << std::endl;
+		std::cout << "  /t:<threads>   Worker threads. Default: processors - 1"  << std::endl;
+		std::cout << "  /r:<rounds>    Warm rounds. Default: 10"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 threadCount = GetIntArgument(argc, argv, "/t:", static_cast<int>(max(GetProcessorCount(), (size_t) 2) - 1));
+		uint4 blockSize = max(GetIntArgument(argc, argv, "/b:", 256), 1) * 1024U;
+		uint4 roundCount = max(GetIntArgument(argc, argv, "/r:", 10), 1);
+
+		utf8_string rawFile = "bebench_compression.raw";
+		const utf8_string compressedFile = "bebench_compression.bez";
+		std::vector<char> data;
+
+		for (int i = 1; i < argc; ++i)
+			if (strncmp(argv[i], "/i:", 3) == 0)
+				rawFile = argv[i] + 3;
+
+		if (rawFile == "bebench_compression.raw")
+		{
+			CreateContent(data, static_cast<size_t>(max(GetIntArgument(argc, argv, "/m:", 64), 1)) << 20);
+			lean::raw_file(rawFile, lean::file::write, lean::file::overwrite, lean::file::sequential).write(&data[0], data.size());
+		}
+		else
+			ReadFile(rawFile, data);
+
+		if (data.empty())
+		{
+			std::cout << "ERROR: No content." << std::endl;
+			return -1;
+		}
+
+		beCore::ThreadPool pool(threadCount);
+		beCore::WriteCompressedContent(compressedFile, &data[0], data.size(), blockSize, &pool);
+
+		const uint8 size = data.size();
+		const double megabytes = static_cast<double>(size) / (1 << 20);
+
+		{
+			lean::raw_file compressed(compressedFile, lean::file::read);
+			std::cout << " " << megabytes << " MB compressed to " << static_cast<double>(compressed.size()) / (1 << 20)
+				<< " MB in " << blockSize / 1024 << " KB blocks, " << threadCount << " worker threads + main thread:" << std::endl;
+		}
+
+		// NOTE: First load of each file counted as cold, later variants re-reading a file only see OS-cached data
+		LoadTimes rawTimes = RunLoads(rawFile, size, nullptr, false, roundCount);
+		LoadTimes serialTimes = RunLoads(compressedFile, size, nullptr, true, roundCount);
+		LoadTimes parallelTimes = RunLoads(compressedFile, size, &pool, true, roundCount);
+
+		if (rawFile == "bebench_compression.raw")
+			remove(rawFile.c_str());
+		remove(compressedFile.c_str());
+
+		if (!rawTimes.bValid || !serialTimes.bValid || !parallelTimes.bValid)
+		{
+			std::cout << "ERROR: Loaded content size mismatch." << std::endl;
+			return -1;
+		}
+
+		PrintLoadTimes("uncompressed", rawTimes, megabytes);
+		PrintLoadTimes("compressed, serial", serialTimes, megabytes);
+		PrintLoadTimes("compressed, parallel", parallelTimes, megabytes);
+
+		return 0;
+	}
+
+} g_compressionBenchmark;
+
+} // namespace
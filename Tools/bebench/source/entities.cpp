@@ -0,0 +1,153 @@
+// entities.cpp : World loading benchmarks.
+//
+// NOTE: bebench links beEntitySystem only, generated entities carry entity properties but no controllers.
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beEntitySystem/beWorld.h>
+#include <beEntitySystem/beEntities.h>
+#include <beEntitySystem/beSerializationParameters.h>
+#include <beCore/beParameterSet.h>
+#include <beCore/beThreadPool.h>
+
+#include <cstdio>
+
+#include <lean/smart/scoped_ptr.h>
+#include <lean/xml/utility.h>
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Load timings.
+struct LoadTimes
+{
+	double seconds;
+	bool bValid;
+};
+
+/// Fills the given world with the given number of entities, positions, orientations & scaling varying.
+void CreateEntities(beEntitySystem::World &world, uint4 count)
+{
+	beEntitySystem::Entities &entities = *world.Entities();
+	entities.Reserve(count);
+
+	char name[64];
+
+	for (uint4 i = 0; i < count; ++i)
+	{
+		sprintf_s(name, "Entity%u", i);
+		beEntitySystem::Entity *pEntity = entities.AddEntity(name);
+
+		pEntity->SetPosition( beMath::vec(static_cast<float>(i % 1000), static_cast<float>(i / 1000), 0.5f * (i % 7)) );
+		pEntity->SetAngles( beMath::vec(0.0f, 0.001f * (i % 6283), 0.0f) );
+		pEntity->SetScaling( beMath::vec(1.0f, 1.0f + 0.01f * (i % 100), 1.0f) );
+		pEntity->SetVisible(i % 13 != 0);
+	}
+
+	entities.Commit();
+}
+
+/// Sums up entity positions to compare loaded worlds.
+double GetPositionChecksum(const beEntitySystem::World &world)
+{
+	beEntitySystem::Entities::ConstRange entities = world.Entities()->GetEntities();
+	double checksum = 0.0;
+
+	for (; entities.Begin < entities.End; ++entities.Begin)
+	{
+		const beMath::fvec3 &position = (*entities.Begin)->GetPosition();
+		checksum += position[0] + 2.0 * position[1] + 3.0 * position[2];
+	}
+
+	return checksum;
+}
+
+/// Loads the given world node the given number of times, parsing entities on the given thread pool if any.
+LoadTimes RunLoads(const rapidxml::xml_node<utf8_t> &worldNode, uint4 expectedCount, double expectedChecksum,
+	beCore::ThreadPool *pPool, uint4 roundCount)
+{
+	LoadTimes times = { 0.0, true };
+
+	for (uint4 round = 0; round < roundCount; ++round)
+	{
+		beCore::ParameterSet parameters(&beEntitySystem::GetSerializationParameters());
+
+		lean::highres_timer timer;
+		lean::scoped_ptr<beEntitySystem::World> pWorld(
+				new beEntitySystem::World("bebench", worldNode, parameters, nullptr, beEntitySystem::WorldDesc(10000, pPool))
+			);
+		pWorld->Entities()->Commit();
+		times.seconds += timer.seconds();
+
+		// NOTE: Destruction not timed
+		times.bValid &= (Size(pWorld->Entities()->GetEntities()) == expectedCount)
+			&& (GetPositionChecksum(*pWorld) == expectedChecksum);
+	}
+
+	times.seconds /= roundCount;
+	return times;
+}
+
+/// World loading benchmark.
+const struct EntityLoadBenchmark : public Benchmark
+{
+	/// Constructor.
+	EntityLoadBenchmark() { RegisterBenchmark("entities", this); }
+	/// Destructor.
+	~EntityLoadBenchmark() { UnregisterBenchmark("entities"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Time taken to construct a world from an in-memory XML document, parsing entity"  << std::endl;
+		std::cout << "  properties serially vs. on a thread pool, at 100k generated entities."  << std::endl;
+		std::cout << "  /n:<entities>  Entities. Default: 100000"  << std::endl;
+		std::cout << "  /t:<threads>   Worker threads. Default: processors - 1"  << std::endl;
+		std::cout << "  /r:<rounds>    Rounds. Default: 5"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 entityCount = max(GetIntArgument(argc, argv, "/n:", 100000), 1);
+		uint4 threadCount = GetIntArgument(argc, argv, "/t:", static_cast<int>(max(GetProcessorCount(), (size_t) 2) - 1));
+		uint4 roundCount = max(GetIntArgument(argc, argv, "/r:", 5), 1);
+
+		rapidxml::xml_document<utf8_t> document;
+		rapidxml::xml_node<utf8_t> &worldNode = *lean::allocate_node<utf8_t>(document, "world");
+		// ORDER: Append FIRST, otherwise parent document == nullptr
+		document.append_node(&worldNode);
+
+		double expectedChecksum;
+
+		{
+			beEntitySystem::World source("bebench");
+			CreateEntities(source, entityCount);
+			expectedChecksum = GetPositionChecksum(source);
+			source.Serialize(worldNode);
+		}
+
+		beCore::ThreadPool pool(threadCount);
+
+		std::cout << " " << entityCount << " entities, " << threadCount << " worker threads + main thread:" << std::endl;
+
+		LoadTimes serialTimes = RunLoads(worldNode, entityCount, expectedChecksum, nullptr, roundCount);
+		LoadTimes parallelTimes = RunLoads(worldNode, entityCount, expectedChecksum, &pool, roundCount);
+
+		if (!serialTimes.bValid || !parallelTimes.bValid)
+		{
+			std::cout << "ERROR: Loaded worlds differ from the saved world." << std::endl;
+			return -1;
+		}
+
+		PrintResult("serial", serialTimes.seconds, entityCount, "entities");
+		PrintResult("parallel", parallelTimes.seconds, entityCount, "entities");
+
+		return 0;
+	}
+
+} g_entityLoadBenchmark;
+
+} // namespace
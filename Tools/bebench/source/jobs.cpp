@@ -0,0 +1,150 @@
+// jobs.cpp : Job hierarchy benchmarks.
+//
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beCore/beThreadPool.h>
+#include <beCore/beJob.h>
+
+#include <vector>
+
+#include <lean/concurrent/atomic.h>
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Adds its children when run, counting all runs.
+class NestedJob : public beCore::Job
+{
+private:
+	std::vector<NestedJob*> m_children;
+	volatile int *m_pRunCount;
+	uint4 m_work;
+
+protected:
+	/// Adds all children.
+	void Run()
+	{
+		lean::atomic_increment(*m_pRunCount);
+		SimulateWork(m_work);
+
+		for (std::vector<NestedJob*>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+			AddJob(*it);
+	}
+
+public:
+	/// Constructor.
+	NestedJob(beCore::JobType::T type, volatile int *pRunCount, uint4 work)
+		: Job(type, "NestedJob"),
+		m_pRunCount(pRunCount),
+		m_work(work) { }
+
+	/// Adds a child to be added whenever this job is run.
+	void AddChild(NestedJob *pChild) { m_children.push_back(pChild); }
+};
+
+/// Creates a job tree of the given depth, alternating between parallel & sequential levels if requested.
+NestedJob* CreateJobTree(std::vector<NestedJob*> &jobs, uint4 depth, uint4 fanOut, bool bAlternate,
+	volatile int *pRunCount, uint4 work)
+{
+	beCore::JobType::T type = (bAlternate && depth % 2 == 0) ? beCore::JobType::Sequential : beCore::JobType::Parallel;
+
+	jobs.push_back( new NestedJob(type, pRunCount, work) );
+	NestedJob *pJob = jobs.back();
+
+	if (depth > 0)
+		for (uint4 i = 0; i < fanOut; ++i)
+			pJob->AddChild( CreateJobTree(jobs, depth - 1, fanOut, bAlternate, pRunCount, work) );
+
+	return pJob;
+}
+
+/// Runs the given job tree the given number of times, returns the time taken or a negative value if jobs were lost.
+double RunJobTree(uint4 threadCount, uint4 depth, uint4 fanOut, bool bAlternate, uint4 work, uint4 roundCount)
+{
+	beCore::ThreadPool pool(threadCount);
+
+	std::vector<NestedJob*> jobs;
+	volatile int runCount = 0;
+
+	// NOTE: Sequential top-level job waits for the whole tree, top-level parallel jobs return immediately
+	NestedJob root(beCore::JobType::Sequential, &runCount, 0);
+	root.AddChild( CreateJobTree(jobs, depth, fanOut, bAlternate, &runCount, work) );
+
+	bool bComplete = true;
+	lean::highres_timer timer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+	{
+		runCount = 0;
+		static_cast<beCore::Job&>(root).Run(&pool);
+
+		// Root counted in addition to the tree
+		bComplete &= (runCount == static_cast<int>(jobs.size() + 1));
+	}
+
+	double seconds = timer.seconds();
+
+	for (std::vector<NestedJob*>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+		delete *it;
+
+	return (bComplete) ? seconds : -1.0;
+}
+
+/// Nested job depth stress test.
+const struct NestedJobBenchmark : public Benchmark
+{
+	/// Constructor.
+	NestedJobBenchmark() { RegisterBenchmark("jobs", this); }
+	/// Destructor.
+	~NestedJobBenchmark() { UnregisterBenchmark("jobs"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Runs deeply nested job trees, checking every job ran once per round. Trees either"  << std::endl;
+		std::cout << "  are parallel on all levels or alternate between parallel & sequential levels, the"  << std::endl;
+		std::cout << "  latter waiting for children on every other level."  << std::endl;
+		std::cout << "  /t:<threads>   Worker threads. Default: processors - 1"  << std::endl;
+		std::cout << "  /d:<depth>     Tree depth. Default: 8"  << std::endl;
+		std::cout << "  /f:<fan-out>   Children per job. Default: 3"  << std::endl;
+		std::cout << "  /w:<work>      Work per job, in loop iterations. Default: 100"  << std::endl;
+		std::cout << "  /r:<rounds>    Rounds. Default: 10"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 threadCount = GetIntArgument(argc, argv, "/t:", static_cast<int>(max(GetProcessorCount(), (size_t) 2) - 1));
+		uint4 depth = GetIntArgument(argc, argv, "/d:", 8);
+		uint4 fanOut = max(GetIntArgument(argc, argv, "/f:", 3), 1);
+		uint4 work = GetIntArgument(argc, argv, "/w:", 100);
+		uint4 roundCount = GetIntArgument(argc, argv, "/r:", 10);
+
+		double jobCount = 0.0;
+		for (uint4 level = 0, levelCount = 1; level <= depth; ++level, levelCount *= fanOut)
+			jobCount += levelCount;
+		double totalJobCount = jobCount * roundCount;
+
+		std::cout << " Nested jobs on " << threadCount << " worker threads + main thread:" << std::endl;
+
+		double parallelSeconds = RunJobTree(threadCount, depth, fanOut, false, work, roundCount);
+		double alternatingSeconds = RunJobTree(threadCount, depth, fanOut, true, work, roundCount);
+
+		if (parallelSeconds < 0.0 || alternatingSeconds < 0.0)
+		{
+			std::cout << "ERROR: Jobs were lost or run more than once." << std::endl;
+			return -1;
+		}
+
+		PrintResult("parallel", parallelSeconds, totalJobCount, "jobs");
+		PrintResult("parallel/sequential", alternatingSeconds, totalJobCount, "jobs");
+
+		return 0;
+	}
+
+} g_nestedJobBenchmark;
+
+} // namespace
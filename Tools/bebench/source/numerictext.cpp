@@ -0,0 +1,187 @@
+// numerictext.cpp : Numeric text codec benchmarks.
+//
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beCore/beNumericText.h>
+#include <beCore/beGenericTextSerializer.h>
+#include <lean/properties/property_types.h>
+
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Text slot size per value.
+const size_t SlotSize = 64;
+
+/// Codec timings.
+struct CodecTimes
+{
+	double writeSeconds;
+	double readSeconds;
+	size_t mismatchCount;
+	bool bValid;
+};
+
+/// Writes & reads values using sprintf_s & strtod, printing enough digits to round-trip.
+template <class Value>
+struct CRuntimeSerialization
+{
+	static utf8_t* write(utf8_t *begin, const std::type_info&, const void *values, size_t)
+	{
+		const int digits = (sizeof(Value) == sizeof(float)) ? 9 : 17;
+		return begin + sprintf_s(begin, SlotSize, "%.*g", digits, static_cast<double>(*static_cast<const Value*>(values)));
+	}
+	static const utf8_t* read(const utf8_t *begin, const utf8_t*, const std::type_info&, void *values, size_t)
+	{
+		utf8_t *end;
+		*static_cast<Value*>(values) = static_cast<Value>( strtod(begin, &end) );
+		return (end != begin) ? end : nullptr;
+	}
+};
+
+/// Creates random finite values from random bit patterns, spanning the whole range of exponents.
+template <class Value, class Bits>
+void CreateValues(std::vector<Value> &values, size_t count)
+{
+	values.reserve(count);
+	uint8 state = 88172645463325252ULL;
+
+	while (values.size() < count)
+	{
+		// xorshift64
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		Bits bits = static_cast<Bits>(state);
+		Value value;
+		memcpy(&value, &bits, sizeof(value));
+
+		// NOTE: Skips inf & nan
+		if (value - value == 0)
+			values.push_back(value);
+	}
+}
+
+/// Writes all values to their text slots & reads them back the given number of times.
+template <class Serialization, class Value>
+CodecTimes RunCodec(const std::vector<Value> &values, uint4 roundCount)
+{
+	CodecTimes times;
+	const size_t count = values.size();
+
+	std::vector<utf8_t> text(count * SlotSize);
+	std::vector<const utf8_t*> ends(count);
+	std::vector<Value> readValues(count);
+
+	lean::highres_timer writeTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (size_t i = 0; i < count; ++i)
+		{
+			utf8_t *slot = &text[i * SlotSize];
+			utf8_t *end = Serialization::write(slot, typeid(Value), &values[i], 1);
+			// NOTE: Some readers require null termination
+			*end = 0;
+			ends[i] = end;
+		}
+
+	times.writeSeconds = writeTimer.seconds();
+
+	times.bValid = true;
+	lean::highres_timer readTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (size_t i = 0; i < count; ++i)
+			times.bValid &= (Serialization::read(&text[i * SlotSize], ends[i], typeid(Value), &readValues[i], 1) == ends[i]);
+
+	times.readSeconds = readTimer.seconds();
+
+	times.mismatchCount = 0;
+
+	for (size_t i = 0; i < count; ++i)
+		times.mismatchCount += (memcmp(&readValues[i], &values[i], sizeof(Value)) != 0);
+
+	return times;
+}
+
+/// Prints the given timings.
+void PrintCodecTimes(const char *label, const CodecTimes &times, double valueCount)
+{
+	std::cout << "  " << label << ":" << std::endl;
+	PrintResult("  write", times.writeSeconds, valueCount, "values");
+	PrintResult("  read", times.readSeconds, valueCount, "values");
+
+	if (times.mismatchCount != 0)
+		std::cout << "    " << times.mismatchCount << " values did not read back exactly" << std::endl;
+}
+
+/// Benchmarks all codecs for the given value type.
+template <class Value, class Bits>
+bool RunCodecs(const char *typeName, size_t count, uint4 roundCount)
+{
+	std::vector<Value> values;
+	CreateValues<Value, Bits>(values, count);
+
+	std::cout << " " << count << " random " << typeName << " values:" << std::endl;
+
+	CodecTimes codecTimes = RunCodec< beCore::NumericTextSerialization<Value> >(values, roundCount);
+	CodecTimes leanTimes = RunCodec< lean::io::float_serialization<Value> >(values, roundCount);
+	CodecTimes crtTimes = RunCodec< CRuntimeSerialization<Value> >(values, roundCount);
+
+	// NOTE: Only the numeric text codec guarantees exact round trips
+	if (!codecTimes.bValid || !leanTimes.bValid || !crtTimes.bValid || codecTimes.mismatchCount != 0)
+	{
+		std::cout << "ERROR: Values could not be read back." << std::endl;
+		return false;
+	}
+
+	const double valueCount = static_cast<double>(count) * roundCount;
+	PrintCodecTimes("numeric text codec", codecTimes, valueCount);
+	PrintCodecTimes("former lean::io serialization", leanTimes, valueCount);
+	PrintCodecTimes("sprintf_s & strtod", crtTimes, valueCount);
+
+	return true;
+}
+
+/// Numeric text codec throughput benchmark.
+const struct NumericTextBenchmark : public Benchmark
+{
+	/// Constructor.
+	NumericTextBenchmark() { RegisterBenchmark("numerictext", this); }
+	/// Destructor.
+	~NumericTextBenchmark() { UnregisterBenchmark("numerictext"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Write & read throughput of the numeric text codec used for float & double properties"  << std::endl;
+		std::cout << "  vs. the former lean::io serialization & sprintf_s/strtod, on random bit patterns."  << std::endl;
+		std::cout << "  Also checks that all values read back exactly."  << std::endl;
+		std::cout << "  /n:<values>    Values per type. Default: 1000000"  << std::endl;
+		std::cout << "  /r:<rounds>    Rounds. Default: 3"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		size_t count = max(GetIntArgument(argc, argv, "/n:", 1000000), 1);
+		uint4 roundCount = max(GetIntArgument(argc, argv, "/r:", 3), 1);
+
+		if (!RunCodecs<float, uint4>("float", count, roundCount)
+			|| !RunCodecs<double, uint8>("double", count, roundCount))
+			return -1;
+
+		return 0;
+	}
+
+} g_numericTextBenchmark;
+
+} // namespace
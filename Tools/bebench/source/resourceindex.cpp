@@ -0,0 +1,304 @@
+// resourceindex.cpp : Resource index benchmarks.
+//
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beCore/beResourceIndex.h>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdio>
+
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Stand-in resource.
+struct DummyResource
+{
+	uint4 id;
+};
+
+typedef beCore::ResourceIndex<DummyResource, uint4> resource_index;
+
+/// Map-based index layout as used by the resource caches before the flat index.
+struct MapIndex
+{
+	typedef std::map<const DummyResource*, uint4> resource_map;
+	typedef std::map<utf8_string, uint4> string_map;
+
+	resource_map byResource;
+	string_map byName;
+	string_map byFile;
+	std::vector<uint4> entries;
+};
+
+/// Test data.
+struct ResourceSet
+{
+	std::vector<DummyResource> resources;
+	std::vector<utf8_string> names;
+	std::vector<utf8_string> files;
+
+	/// Creates the given number of resources with names & files resembling those of typical assets.
+	ResourceSet(uint4 count)
+		: resources(count),
+		names(count),
+		files(count)
+	{
+		char buffer[256];
+
+		for (uint4 i = 0; i < count; ++i)
+		{
+			resources[i].id = i;
+
+			sprintf_s(buffer, "Textures/Set%u/Surface%u", i % 97, i);
+			names[i] = buffer;
+
+			sprintf_s(buffer, "C:/Projects/Game/Data/Textures/Set%u/Surface%u_diffuse.dds", i % 97, i);
+			files[i] = buffer;
+		}
+	}
+};
+
+/// Lookup timings.
+struct LookupTimes
+{
+	double insertSeconds;
+	double resourceSeconds;
+	double nameSeconds;
+	double fileSeconds;
+	double uniqueSeconds;
+	double orderedSeconds;
+	bool bValid;
+};
+
+/// Benchmarks the resource index.
+LookupTimes RunResourceIndex(const ResourceSet &set, uint4 roundCount)
+{
+	const uint4 count = static_cast<uint4>(set.resources.size());
+	LookupTimes times;
+	uint8 checksum = 0, expected = 0;
+
+	for (uint4 i = 0; i < count; ++i)
+		expected += i;
+
+	resource_index index;
+
+	lean::highres_timer insertTimer;
+
+	for (uint4 i = 0; i < count; ++i)
+	{
+		resource_index::iterator it = index.Insert(&set.resources[i], set.names[i], i);
+		index.SetFile(it, set.files[i]);
+	}
+
+	times.insertSeconds = insertTimer.seconds();
+
+	lean::highres_timer resourceTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += *index.Find(&set.resources[i]);
+
+	times.resourceSeconds = resourceTimer.seconds();
+
+	lean::highres_timer nameTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += *index.FindByName(set.names[i]);
+
+	times.nameSeconds = nameTimer.seconds();
+
+	lean::highres_timer fileTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += *index.FindByFile(set.files[i]);
+
+	times.fileSeconds = fileTimer.seconds();
+
+	lean::highres_timer uniqueTimer;
+
+	// NOTE: All names taken, each query probes at least twice
+	for (uint4 i = 0; i < count; ++i)
+		checksum += index.GetUniqueName(set.names[i]).size();
+
+	times.uniqueSeconds = uniqueTimer.seconds();
+
+	lean::highres_timer orderedTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (resource_index::name_iterator it = index.BeginByName(), itEnd = index.EndByName(); it != itEnd; ++it)
+			checksum += *it;
+
+	times.orderedSeconds = orderedTimer.seconds();
+
+	// Unique names append ".1"
+	uint8 uniqueLength = 0;
+	for (uint4 i = 0; i < count; ++i)
+		uniqueLength += set.names[i].size() + 2;
+
+	times.bValid = (checksum == 4 * roundCount * expected + uniqueLength);
+	return times;
+}
+
+/// Benchmarks the map-based index layout.
+LookupTimes RunMapIndex(const ResourceSet &set, uint4 roundCount)
+{
+	const uint4 count = static_cast<uint4>(set.resources.size());
+	LookupTimes times;
+	uint8 checksum = 0, expected = 0;
+
+	for (uint4 i = 0; i < count; ++i)
+		expected += i;
+
+	MapIndex index;
+
+	lean::highres_timer insertTimer;
+
+	for (uint4 i = 0; i < count; ++i)
+	{
+		index.entries.push_back(i);
+		index.byResource.insert( MapIndex::resource_map::value_type(&set.resources[i], i) );
+		index.byName.insert( MapIndex::string_map::value_type(set.names[i], i) );
+		index.byFile.insert( MapIndex::string_map::value_type(set.files[i], i) );
+	}
+
+	times.insertSeconds = insertTimer.seconds();
+
+	lean::highres_timer resourceTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += index.entries[index.byResource.find(&set.resources[i])->second];
+
+	times.resourceSeconds = resourceTimer.seconds();
+
+	lean::highres_timer nameTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += index.entries[index.byName.find(set.names[i])->second];
+
+	times.nameSeconds = nameTimer.seconds();
+
+	lean::highres_timer fileTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (uint4 i = 0; i < count; ++i)
+			checksum += index.entries[index.byFile.find(set.files[i])->second];
+
+	times.fileSeconds = fileTimer.seconds();
+
+	lean::highres_timer uniqueTimer;
+
+	for (uint4 i = 0; i < count; ++i)
+	{
+		utf8_string unique = set.names[i];
+		uint4 uniqueIdx = 1;
+		char suffix[16];
+
+		while (index.byName.find(unique) != index.byName.end())
+		{
+			sprintf_s(suffix, ".%u", uniqueIdx++);
+			unique = set.names[i] + suffix;
+		}
+
+		checksum += unique.size();
+	}
+
+	times.uniqueSeconds = uniqueTimer.seconds();
+
+	lean::highres_timer orderedTimer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+		for (MapIndex::string_map::const_iterator it = index.byName.begin(); it != index.byName.end(); ++it)
+			checksum += index.entries[it->second];
+
+	times.orderedSeconds = orderedTimer.seconds();
+
+	uint8 uniqueLength = 0;
+	for (uint4 i = 0; i < count; ++i)
+		uniqueLength += set.names[i].size() + 2;
+
+	times.bValid = (checksum == 4 * roundCount * expected + uniqueLength);
+	return times;
+}
+
+/// Prints the given timings.
+void PrintLookupTimes(const char *label, const LookupTimes &times, uint4 count, uint4 roundCount)
+{
+	const double lookupCount = static_cast<double>(count) * roundCount;
+
+	std::cout << "  " << label << ":" << std::endl;
+	PrintResult("  insert", times.insertSeconds, count, "resources");
+	PrintResult("  find by resource", times.resourceSeconds, lookupCount, "lookups");
+	PrintResult("  find by name", times.nameSeconds, lookupCount, "lookups");
+	PrintResult("  find by file", times.fileSeconds, lookupCount, "lookups");
+	PrintResult("  unique name", times.uniqueSeconds, count, "names");
+	PrintResult("  ordered by name", times.orderedSeconds, lookupCount, "resources");
+}
+
+/// Resource index lookup benchmark.
+const struct ResourceIndexBenchmark : public Benchmark
+{
+	/// Constructor.
+	ResourceIndexBenchmark() { RegisterBenchmark("resourceindex", this); }
+	/// Destructor.
+	~ResourceIndexBenchmark() { UnregisterBenchmark("resourceindex"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Insertion, lookup, unique naming & ordered iteration throughput of the flat resource"  << std::endl;
+		std::cout << "  index vs. the former map-based layout, at 10k & 100k resources."  << std::endl;
+		std::cout << "  /n:<resources> Resources, replaces the default sizes."  << std::endl;
+		std::cout << "  /r:<rounds>    Lookup rounds. Default: 10"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 roundCount = GetIntArgument(argc, argv, "/r:", 10);
+
+		std::vector<uint4> counts;
+		int customCount = GetIntArgument(argc, argv, "/n:", 0);
+
+		if (customCount > 0)
+			counts.push_back(customCount);
+		else
+		{
+			counts.push_back(10000);
+			counts.push_back(100000);
+		}
+
+		for (size_t i = 0; i < counts.size(); ++i)
+		{
+			ResourceSet set(counts[i]);
+
+			std::cout << " " << counts[i] << " resources:" << std::endl;
+
+			LookupTimes flatTimes = RunResourceIndex(set, roundCount);
+			LookupTimes mapTimes = RunMapIndex(set, roundCount);
+
+			if (!flatTimes.bValid || !mapTimes.bValid)
+			{
+				std::cout << "ERROR: Lookups returned wrong resources." << std::endl;
+				return -1;
+			}
+
+			PrintLookupTimes("flat index", flatTimes, counts[i], roundCount);
+			PrintLookupTimes("std::map", mapTimes, counts[i], roundCount);
+		}
+
+		return 0;
+	}
+
+} g_resourceIndexBenchmark;
+
+} // namespace
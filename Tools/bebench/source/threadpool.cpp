@@ -0,0 +1,319 @@
+// threadpool.cpp : Thread pool scheduling benchmarks.
+//
+
+#include "stdafx.h"
+#include "bebench.h"
+
+#include <beCore/beThreadPool.h>
+#include <beCore/beTask.h>
+
+#include <vector>
+#include <iomanip>
+#include <Windows.h>
+
+#include <lean/concurrent/atomic.h>
+#include <lean/time/highres_timer.h>
+
+namespace
+{
+
+/// Counts down once run, adding its children to the pool first.
+struct FanOutTask : public beCore::Task
+{
+	beCore::ThreadPool *pPool;
+	FanOutTask *children;
+	uint4 childCount;
+	uint4 work;
+	volatile int *pPending;
+
+	/// Runs the task.
+	void Run()
+	{
+		for (uint4 i = 0; i < childCount; ++i)
+			pPool->AddTask(&children[i]);
+
+		SimulateWork(work);
+
+		lean::atomic_decrement(*pPending);
+	}
+};
+
+/// Waits for all pending tasks, helping out with tasks of the given priority or higher.
+void WaitForTasks(beCore::ThreadPool &pool, volatile int &pending,
+	beCore::TaskPriority::T lowestPriority = beCore::TaskPriority::Normal)
+{
+	while (pending > 0)
+		if (!pool.RunPendingTask(lowestPriority))
+			::SwitchToThread();
+}
+
+/// Adds the given number of root tasks from the calling thread, each of which adds the given number of child tasks
+/// from whichever thread runs it. Returns the time taken to run all tasks the given number of times.
+double RunFanOut(beCore::ThreadPoolMode::T mode, uint4 threadCount, uint4 rootCount, uint4 childCount, uint4 work, uint4 roundCount)
+{
+	beCore::ThreadPool pool(threadCount, mode);
+
+	std::vector<FanOutTask> tasks(rootCount * (1 + childCount));
+	volatile int pending = 0;
+
+	for (uint4 rootIdx = 0; rootIdx < rootCount; ++rootIdx)
+	{
+		FanOutTask &root = tasks[rootIdx];
+		root.pPool = &pool;
+		root.children = (childCount) ? &tasks[rootCount + rootIdx * childCount] : nullptr;
+		root.childCount = childCount;
+		root.work = work;
+		root.pPending = &pending;
+
+		for (uint4 childIdx = 0; childIdx < childCount; ++childIdx)
+		{
+			FanOutTask &child = root.children[childIdx];
+			child.pPool = &pool;
+			child.children = nullptr;
+			child.childCount = 0;
+			child.work = work;
+			child.pPending = &pending;
+		}
+	}
+
+	lean::highres_timer timer;
+
+	for (uint4 round = 0; round < roundCount; ++round)
+	{
+		pending = static_cast<int>(tasks.size());
+
+		for (uint4 rootIdx = 0; rootIdx < rootCount; ++rootIdx)
+			pool.AddTask(&tasks[rootIdx]);
+
+		WaitForTasks(pool, pending);
+	}
+
+	return timer.seconds();
+}
+
+/// Fan-out benchmark.
+const struct FanOutBenchmark : public Benchmark
+{
+	/// Constructor.
+	FanOutBenchmark() { RegisterBenchmark("fanout", this); }
+	/// Destructor.
+	~FanOutBenchmark() { UnregisterBenchmark("fanout"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Task throughput of the shared queue vs. work-stealing scheduling modes. Tasks are"  << std::endl;
+		std::cout << "  either all added by the main thread (flat) or fanned out by the workers (nested)."  << std::endl;
+		std::cout << "  /t:<threads>   Worker threads. Default: processors - 1"  << std::endl;
+		std::cout << "  /n:<tasks>     Tasks per round. Default: 100000"  << std::endl;
+		std::cout << "  /w:<work>      Work per task, in loop iterations. Default: 100"  << std::endl;
+		std::cout << "  /r:<rounds>    Rounds. Default: 10"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 threadCount = GetIntArgument(argc, argv, "/t:", static_cast<int>(max(GetProcessorCount(), (size_t) 2) - 1));
+		uint4 taskCount = GetIntArgument(argc, argv, "/n:", 100000);
+		uint4 work = GetIntArgument(argc, argv, "/w:", 100);
+		uint4 roundCount = GetIntArgument(argc, argv, "/r:", 10);
+
+		// NOTE: Nested fan-out starts one root task per worker & main thread, roots add the remaining tasks
+		uint4 rootCount = threadCount + 1;
+		uint4 childCount = max(taskCount / rootCount, 1U) - 1;
+		double totalTaskCount = static_cast<double>(taskCount) * roundCount;
+		double totalNestedTaskCount = static_cast<double>(rootCount * (1 + childCount)) * roundCount;
+
+		std::cout << " Fan-out on " << threadCount << " worker threads + main thread:" << std::endl;
+
+		PrintResult("shared, flat", RunFanOut(beCore::ThreadPoolMode::Shared, threadCount, taskCount, 0, work, roundCount), totalTaskCount, "tasks");
+		PrintResult("work-stealing, flat", RunFanOut(beCore::ThreadPoolMode::WorkStealing, threadCount, taskCount, 0, work, roundCount), totalTaskCount, "tasks");
+		PrintResult("shared, nested", RunFanOut(beCore::ThreadPoolMode::Shared, threadCount, rootCount, childCount, work, roundCount), totalNestedTaskCount, "tasks");
+		PrintResult("work-stealing, nested", RunFanOut(beCore::ThreadPoolMode::WorkStealing, threadCount, rootCount, childCount, work, roundCount), totalNestedTaskCount, "tasks");
+
+		return 0;
+	}
+
+} g_fanOutBenchmark;
+
+/// Re-adds itself until stopped, flooding the pool.
+struct FloodTask : public beCore::Task
+{
+	beCore::ThreadPool *pPool;
+	beCore::TaskPriority::T priority;
+	uint4 work;
+	volatile int *pStop;
+	volatile int *pActive;
+
+	/// Runs the task.
+	void Run()
+	{
+		SimulateWork(work);
+
+		if (!*pStop)
+			pPool->AddTask(this, priority);
+		else
+			lean::atomic_decrement(*pActive);
+	}
+};
+
+/// Records the time from being added to being started.
+struct FrameTask : public beCore::Task
+{
+	lean::highres_timer *pTimer;
+	double addTime;
+	double latency;
+	uint4 work;
+	volatile int *pPending;
+
+	/// Runs the task.
+	void Run()
+	{
+		latency = pTimer->seconds() - addTime;
+		SimulateWork(work);
+		lean::atomic_decrement(*pPending);
+	}
+};
+
+/// Frame latency results.
+struct FrameLatency
+{
+	double avgStartSeconds;
+	double maxStartSeconds;
+	double avgFrameSeconds;
+	double maxFrameSeconds;
+};
+
+/// Runs the given number of frames of frame tasks at the given priority while the given number of flood tasks
+/// keep the pool busy at the given priority.
+FrameLatency RunFrames(uint4 threadCount, uint4 floodCount, beCore::TaskPriority::T floodPriority, uint4 floodWork,
+	uint4 frameTaskCount, beCore::TaskPriority::T framePriority, uint4 frameWork, uint4 frameCount)
+{
+	beCore::ThreadPool pool(threadCount);
+	lean::highres_timer timer;
+
+	volatile int stop = 0;
+	volatile int activeFloodTasks = static_cast<int>(floodCount);
+	std::vector<FloodTask> floodTasks(floodCount);
+
+	for (uint4 i = 0; i < floodCount; ++i)
+	{
+		FloodTask &task = floodTasks[i];
+		task.pPool = &pool;
+		task.priority = floodPriority;
+		task.work = floodWork;
+		task.pStop = &stop;
+		task.pActive = &activeFloodTasks;
+		pool.AddTask(&task, floodPriority);
+	}
+
+	std::vector<FrameTask> frameTasks(frameTaskCount);
+	volatile int pending = 0;
+
+	FrameLatency result = { 0.0, 0.0, 0.0, 0.0 };
+
+	for (uint4 frame = 0; frame < frameCount; ++frame)
+	{
+		pending = static_cast<int>(frameTaskCount);
+		double frameStart = timer.seconds();
+
+		for (uint4 i = 0; i < frameTaskCount; ++i)
+		{
+			FrameTask &task = frameTasks[i];
+			task.pTimer = &timer;
+			task.addTime = timer.seconds();
+			task.work = frameWork;
+			task.pPending = &pending;
+			pool.AddTask(&task, framePriority);
+		}
+
+		// Main thread helps out with frame work only
+		WaitForTasks(pool, pending, framePriority);
+
+		double frameSeconds = timer.seconds() - frameStart;
+		result.avgFrameSeconds += frameSeconds;
+		result.maxFrameSeconds = max(result.maxFrameSeconds, frameSeconds);
+
+		for (uint4 i = 0; i < frameTaskCount; ++i)
+		{
+			result.avgStartSeconds += frameTasks[i].latency;
+			result.maxStartSeconds = max(result.maxStartSeconds, frameTasks[i].latency);
+		}
+	}
+
+	stop = 1;
+
+	// NOTE: Flood tasks point to this stack frame
+	while (activeFloodTasks > 0)
+		::Sleep(1);
+
+	result.avgFrameSeconds /= max(frameCount, 1U);
+	result.avgStartSeconds /= max(frameCount * frameTaskCount, 1U);
+
+	return result;
+}
+
+/// Prints one line of frame latency results.
+void PrintLatency(const char *label, const FrameLatency &latency)
+{
+	std::cout << "  " << std::left << std::setw(32) << label << std::right << std::fixed << std::setprecision(3)
+		<< "  start avg " << std::setw(8) << latency.avgStartSeconds * 1000.0 << " ms"
+		<< ", max " << std::setw(8) << latency.maxStartSeconds * 1000.0 << " ms"
+		<< "  frame avg " << std::setw(8) << latency.avgFrameSeconds * 1000.0 << " ms"
+		<< ", max " << std::setw(8) << latency.maxFrameSeconds * 1000.0 << " ms"
+		<< std::endl;
+}
+
+/// Frame latency under background load benchmark.
+const struct LatencyBenchmark : public Benchmark
+{
+	/// Constructor.
+	LatencyBenchmark() { RegisterBenchmark("latency", this); }
+	/// Destructor.
+	~LatencyBenchmark() { UnregisterBenchmark("latency"); }
+
+	/// Prints what the benchmark measures & its arguments.
+	void PrintHelp() const
+	{
+		std::cout << "  Time frame tasks wait to be started & frames take to complete while the pool is flooded"  << std::endl;
+		std::cout << "  with long-running tasks, for floods in the frame's own lane (i.e. plain FIFO) vs. the"  << std::endl;
+		std::cout << "  background lane, and for frames scheduled at normal vs. critical priority."  << std::endl;
+		std::cout << "  /t:<threads>   Worker threads. Default: processors - 1"  << std::endl;
+		std::cout << "  /b:<tasks>     Flood tasks kept queued. Default: 4 per thread"  << std::endl;
+		std::cout << "  /bw:<work>     Work per flood task, in loop iterations. Default: 1000000"  << std::endl;
+		std::cout << "  /n:<tasks>     Tasks per frame. Default: 64"  << std::endl;
+		std::cout << "  /w:<work>      Work per frame task, in loop iterations. Default: 10000"  << std::endl;
+		std::cout << "  /f:<frames>    Frames. Default: 100"  << std::endl;
+	}
+
+	/// Runs the benchmark.
+	int Run(int argc, const char* argv[]) const
+	{
+		uint4 threadCount = GetIntArgument(argc, argv, "/t:", static_cast<int>(max(GetProcessorCount(), (size_t) 2) - 1));
+		uint4 floodCount = GetIntArgument(argc, argv, "/b:", static_cast<int>(4 * threadCount));
+		uint4 floodWork = GetIntArgument(argc, argv, "/bw:", 1000000);
+		uint4 frameTaskCount = GetIntArgument(argc, argv, "/n:", 64);
+		uint4 frameWork = GetIntArgument(argc, argv, "/w:", 10000);
+		uint4 frameCount = GetIntArgument(argc, argv, "/f:", 100);
+
+		std::cout << " Frame latency on " << threadCount << " worker threads + main thread:" << std::endl;
+
+		PrintLatency("idle pool",
+			RunFrames(threadCount, 0, beCore::TaskPriority::Background, floodWork,
+				frameTaskCount, beCore::TaskPriority::Normal, frameWork, frameCount) );
+		PrintLatency("normal flood, normal frames",
+			RunFrames(threadCount, floodCount, beCore::TaskPriority::Normal, floodWork,
+				frameTaskCount, beCore::TaskPriority::Normal, frameWork, frameCount) );
+		PrintLatency("background flood, normal frames",
+			RunFrames(threadCount, floodCount, beCore::TaskPriority::Background, floodWork,
+				frameTaskCount, beCore::TaskPriority::Normal, frameWork, frameCount) );
+		PrintLatency("background flood, critical frames",
+			RunFrames(threadCount, floodCount, beCore::TaskPriority::Background, floodWork,
+				frameTaskCount, beCore::TaskPriority::Critical, frameWork, frameCount) );
+
+		return 0;
+	}
+
+} g_latencyBenchmark;
+
+} // namespace
@@ -3,6 +3,11 @@
 
 #include <cstddef>
 
+namespace beCore
+{
+	class ArtifactStore;
+}
+
 /// Command line tool interface.
 class CommandLineTool
 {
@@ -21,4 +26,10 @@ void UnregisterTool(const char *name);
 /// Stores the current command for the given file.
 void StoreCommand(const char *tool, const char *file, const char *const *args, size_t argCount);
 
+/// Gets the artifact store shared by all tools, nullptr if disabled. Defaults to a per-user store, may be
+/// redirected to a store shared by multiple machines via the BERC_ARTIFACTS environment variable ("none" disables).
+beCore::ArtifactStore* GetArtifactStore();
+/// Computes the artifact key of the given tool run, i.e. of the given tool version, input file & options.
+beCore::uint8 GetArtifactKey(const char *tool, beCore::uint4 version, const char *inputFile, const char *const *args, size_t argCount);
+
 #endif
\ No newline at end of file
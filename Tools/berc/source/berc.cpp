@@ -7,6 +7,9 @@
 #include <lean/logging/log_stream.h>
 #include <fstream>
 #include <lean/io/file.h>
+#include <lean/io/filesystem.h>
+#include <lean/smart/scoped_ptr.h>
+#include <beCore/beArtifactStore.h>
 #include <map>
 #include <string>
 
@@ -112,6 +115,53 @@ void StoreCommand(const char *tool, const char *file, const char *const *args, s
 	}
 }
 
+// Gets the artifact store shared by all tools, nullptr if disabled.
+beCore::ArtifactStore* GetArtifactStore()
+{
+	static lean::scoped_ptr<beCore::ArtifactStore> pStore;
+	static bool bOpened = false;
+
+	if (!bOpened)
+	{
+		bOpened = true;
+
+		const wchar_t *sharedDirectory = _wgetenv(L"BERC_ARTIFACTS");
+		const wchar_t *userDirectory = _wgetenv(L"LOCALAPPDATA");
+		std::string directory;
+
+		if (sharedDirectory)
+			directory = lean::utf_to_utf8(sharedDirectory);
+		else if (userDirectory)
+			directory = lean::append_path<std::string>(lean::utf_to_utf8(userDirectory), "breeze\\berc\\artifacts");
+
+		if (!directory.empty() && _stricmp(directory.c_str(), "none") != 0)
+		{
+			try
+			{
+				pStore.reset( new beCore::ArtifactStore(directory) );
+			}
+			catch (const std::runtime_error &error)
+			{
+				std::cout << "WARNING: Artifact store unavailable, rebuilding everything: " << error.what() << std::endl;
+			}
+		}
+	}
+
+	return pStore.get();
+}
+
+// Computes the artifact key of the given tool run.
+beCore::uint8 GetArtifactKey(const char *tool, beCore::uint4 version, const char *inputFile, const char *const *args, size_t argCount)
+{
+	beCore::ArtifactKey key(tool, version);
+	key.AddFile(inputFile);
+
+	for (size_t i = 0; i < argCount; ++i)
+		key.AddString(args[i]);
+
+	return key.Get();
+}
+
 /// Help tool.
 const struct HelpTool : public CommandLineTool
 {
@@ -6,6 +6,7 @@
 #include <beResourceCompiler/beMeshImporter.h>
 #include <beResourceCompiler/beMesh.h>
 #include <beResourceCompiler/beMeshSerialization.h>
+#include <beCore/beCompressedContent.h>
 
 #include <vector>
 #include <string>
@@ -14,6 +15,10 @@
 #include <lean/io/filesystem.h>
 
 #include <lean/smart/resource_ptr.h>
+#include <beCore/beArtifactStore.h>
+
+/// Version of mesh artifacts, increment whenever the output changes.
+const beCore::uint4 MeshArtifactVersion = 1;
 
 /// Mesh tool help.
 const struct MeshToolHelp : public CommandLineTool
@@ -26,7 +31,7 @@ const struct MeshToolHelp : public CommandLineTool
 	/// Runs the command line tool.
 	int Run(int argc, const char* argv[]) const
 	{
-		std::cout << " Syntax: berc mesh [/VDn] [/Vc] [/VDt] [/Vtan] [/Vbtan] [/Vsn] [/Vsna] [/Von] [/Tsf] [/Iw] [/O] [/S]  [/Ms] <input> <output>"  << std::endl << std::endl;
+		std::cout << " Syntax: berc mesh [/VDn] [/Vc] [/VDt] [/Vtan] [/Vbtan] [/Vsn] [/Vsna] [/Von] [/Tsf] [/Iw] [/O] [/S]  [/Ms] [/Z] <input> <output>"  << std::endl << std::endl;
 
 		std::cout << " Arguments:"  << std::endl;
 		std::cout << "  /VDn           Don't include vertex normals"  << std::endl;
@@ -43,6 +48,7 @@ const struct MeshToolHelp : public CommandLineTool
 		std::cout << "  /O             Optimize mesh"  << std::endl;
 		std::cout << "  /S             Sort meshes"  << std::endl;
 		std::cout << "  /Ms            Single material"  << std::endl;
+		std::cout << "  /Z             Compress output"  << std::endl;
 		std::cout << "  <input>        Input mesh file path"  << std::endl;
 		std::cout << "  <output>       Output mesh file path"  << std::endl;
 
@@ -79,6 +85,7 @@ const struct MeshTool : public CommandLineTool
 			| beResourceCompiler::MeshWriteFlags::SubsetNames;
 		float smoothingAngle = 30.0f;
 		float scaleFactor = 1.0f;
+		bool bCompress = false;
 
 		for (int i = 0; i < argc - 2; ++i)
 		{
@@ -151,6 +158,10 @@ const struct MeshTool : public CommandLineTool
 			{
 				importerFlags |= beResourceCompiler::MeshLoadFlags::RemoveMaterials;
 			}
+			else if (_stricmp(arg, "/Z") == 0)
+			{
+				bCompress = true;
+			}
 			else
 				std::cout << "Unrecognized argument, consult meshhelp for help: " << arg << std::endl;
 
@@ -169,10 +180,35 @@ const struct MeshTool : public CommandLineTool
 			StoreCommand("mesh", inputFile, storedArgs.data(), storedArgs.size());
 		}
 
+		// Reuse output built from identical input before
+		beCore::ArtifactStore *pArtifacts = GetArtifactStore();
+		beCore::uint8 artifactKey = GetArtifactKey("mesh", MeshArtifactVersion, inputFile, argv, argc - 2);
+
+		if (pArtifacts && pArtifacts->Retrieve(artifactKey, outputFile))
+		{
+			std::cout << "Retrieved from artifact store: " << outputFile << std::endl;
+			return 0;
+		}
+
 		beResourceCompiler::MeshImporter importer;
 		lean::resource_ptr<beResourceCompiler::Mesh> pMesh = importer.LoadMesh(inputFile, importerFlags, smoothingAngle, scaleFactor);
 		beResourceCompiler::SaveMesh(outputFile, *pMesh, writeFlags);
 
+		if (bCompress)
+			beCore::CompressContentFile(outputFile, outputFile);
+
+		if (pArtifacts)
+		{
+			try
+			{
+				pArtifacts->StoreFile(artifactKey, outputFile);
+			}
+			catch (const std::runtime_error &error)
+			{
+				std::cout << "WARNING: Failed to store artifact: " << error.what() << std::endl;
+			}
+		}
+
 		return 0;
 	}
 
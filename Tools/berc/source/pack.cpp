@@ -0,0 +1,267 @@
+// pack.cpp : Builds content pack archives.
+//
+
+#include "stdafx.h"
+#include "berc.h"
+#include <beCore/beContentPack.h>
+
+#include <Windows.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <fstream>
+#include <unordered_set>
+
+#include <lean/io/numeric.h>
+#include <lean/io/filesystem.h>
+
+/// Pack tool help.
+const struct PackToolHelp : public CommandLineTool
+{
+	/// Constructor.
+	PackToolHelp() { RegisterTool("packhelp", this); }
+	/// Destructor.
+	~PackToolHelp() { UnregisterTool("packhelp"); }
+
+	/// Runs the command line tool.
+	int Run(int argc, const char* argv[]) const
+	{
+		std::cout << " Syntax: berc pack [/A] [/C] [/ext] [/M] <input> <output>"  << std::endl << std::endl;
+
+		std::cout << " Arguments:"  << std::endl;
+		std::cout << "  /A:<int>       Align file data to <int> bytes (default 16)"  << std::endl;
+		std::cout << "  /C             Compress files"  << std::endl;
+		std::cout << "  /ext:<mask>    Only pack files matching <mask> (default '*')"  << std::endl;
+		std::cout << "  /M:<file>      Pack files listed in manifest <file> first, in the listed order"  << std::endl;
+		std::cout << "                 (one path relative to <input> per line, '#' starts a comment)"  << std::endl;
+		std::cout << "  <input>        Input directory, packed recursively"  << std::endl;
+		std::cout << "  <output>       Output archive file path"  << std::endl;
+
+		return 0;
+	}
+
+} g_packToolHelp;
+
+namespace
+{
+
+/// Collects all files matching the given mask in the given directory and its subdirectories.
+void CollectFiles(std::vector<lean::utf8_string> &files, const lean::utf8_string &directory, const lean::utf8_string &relative,
+	const lean::utf8_string &mask)
+{
+	WIN32_FIND_DATAW findData;
+
+	// Files
+	HANDLE hFind = ::FindFirstFileW( lean::utf_to_utf16(directory + '\\' + mask).c_str(), &findData );
+
+	if (hFind != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if (~findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+				files.push_back(relative + lean::utf_to_utf8(findData.cFileName));
+		}
+		while (::FindNextFileW(hFind, &findData));
+
+		::FindClose(hFind);
+	}
+
+	// Subdirectories
+	hFind = ::FindFirstFileW( lean::utf_to_utf16(directory + "\\*").c_str(), &findData );
+
+	if (hFind != INVALID_HANDLE_VALUE)
+	{
+		std::vector<lean::utf8_string> subdirectories;
+
+		do
+		{
+			if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+				wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0)
+				subdirectories.push_back(lean::utf_to_utf8(findData.cFileName));
+		}
+		while (::FindNextFileW(hFind, &findData));
+
+		::FindClose(hFind);
+
+		for (std::vector<lean::utf8_string>::const_iterator it = subdirectories.begin(); it != subdirectories.end(); ++it)
+			CollectFiles(files, directory + '\\' + *it, relative + *it + '/', mask);
+	}
+}
+
+/// Reads the relative paths listed in the given manifest file, in order.
+bool ReadManifest(std::vector<lean::utf8_string> &files, const lean::utf8_string &manifestFile)
+{
+	std::ifstream manifest(lean::utf_to_utf16(manifestFile).c_str());
+
+	if (!manifest)
+		return false;
+
+	std::unordered_set<lean::utf8_string> listedFiles;
+	lean::utf8_string line;
+
+	while (std::getline(manifest, line))
+	{
+		// Trim whitespace
+		size_t begin = line.find_first_not_of(" \t\r");
+		size_t end = line.find_last_not_of(" \t\r");
+
+		// Skip empty lines & comments
+		if (begin == lean::utf8_string::npos || line[begin] == '#')
+			continue;
+
+		lean::utf8_string path = line.substr(begin, end + 1 - begin);
+		// NOTE: Pack paths always use forward slashes
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		// NOTE: Paths may only be added once
+		if (listedFiles.insert(path).second)
+			files.push_back(path);
+	}
+
+	return true;
+}
+
+} // namespace
+
+/// Pack tool.
+const struct PackTool : public CommandLineTool
+{
+	/// Constructor.
+	PackTool() { RegisterTool("pack", this); }
+	/// Destructor.
+	~PackTool() { UnregisterTool("pack"); }
+
+	/// Runs the command line tool.
+	int Run(int argc, const char* argv[]) const
+	{
+		if (argc < 2)
+		{
+			g_packToolHelp.Run(argc, argv);
+			return -1;
+		}
+
+		std::vector<const char*> storedArgs;
+		storedArgs.reserve(argc);
+
+		const char *inputDirectory = argv[argc - 2];
+		const char *outputFile = argv[argc - 1];
+		int alignment = 16;
+		bool bCompress = false;
+		lean::utf8_string mask("*");
+		const char *manifestFile = nullptr;
+
+		for (int i = 0; i < argc - 2; ++i)
+		{
+			const char *arg = argv[i];
+
+			if (_strnicmp(arg, "/A:", lean::ntarraylen("/A:")) == 0)
+			{
+				lean::string_to_int(
+					&arg[lean::ntarraylen("/A:")],
+					alignment);
+			}
+			else if (_stricmp(arg, "/C") == 0)
+				bCompress = true;
+			else if (_strnicmp(arg, "/ext:", lean::ntarraylen("/ext:")) == 0)
+				mask = &arg[lean::ntarraylen("/ext:")];
+			else if (_strnicmp(arg, "/M:", lean::ntarraylen("/M:")) == 0)
+			{
+				manifestFile = &arg[lean::ntarraylen("/M:")];
+				// NOTE: Stored relative to the stored command below
+				continue;
+			}
+			else
+				std::cout << "Unrecognized argument, consult packhelp for help: " << arg << std::endl;
+
+			storedArgs.push_back(arg);
+		}
+
+		if (alignment <= 0 || (alignment & (alignment - 1)) != 0)
+		{
+			std::cout << "Alignment must be a power of two: " << alignment << std::endl;
+			return -1;
+		}
+
+		lean::utf8_string directory = lean::absolute_path<lean::utf8_string>(inputDirectory);
+		lean::utf8_string archive = lean::absolute_path<lean::utf8_string>(outputFile);
+		lean::utf8_string manifest = (manifestFile) ? lean::absolute_path<lean::utf8_string>(manifestFile) : lean::utf8_string();
+
+		{
+			std::string manifestArg;
+			if (manifestFile)
+			{
+				manifestArg = "/M:" + lean::relative_path<std::string>(
+						manifest,
+						lean::get_directory<std::string>(directory)
+					);
+				storedArgs.push_back(manifestArg.c_str());
+			}
+
+			std::string inputDirectoryName = lean::get_filename(directory);
+			storedArgs.push_back(inputDirectoryName.c_str());
+			std::string relativeOutputFile = lean::relative_path<std::string>(
+					archive,
+					lean::get_directory<std::string>(directory)
+				);
+			storedArgs.push_back(relativeOutputFile.c_str());
+
+			// NOTE: Command stored next to the input directory
+			StoreCommand("pack", directory.c_str(), storedArgs.data(), storedArgs.size());
+		}
+
+		std::vector<lean::utf8_string> files;
+
+		// NOTE: Data stored in order of addition, manifest keeps files loaded together close
+		if (manifestFile)
+		{
+			if (!ReadManifest(files, manifest))
+			{
+				std::cout << "Failed to read manifest: " << manifestFile << std::endl;
+				return -1;
+			}
+
+			std::cout << "Read " << files.size() << " manifest entries from " << manifestFile << std::endl;
+		}
+
+		// Remaining files follow in directory order
+		{
+			std::vector<lean::utf8_string> collectedFiles;
+			CollectFiles(collectedFiles, directory, lean::utf8_string(), mask);
+
+			std::unordered_set<lean::utf8_string> listedFiles(files.begin(), files.end());
+
+			for (std::vector<lean::utf8_string>::const_iterator it = collectedFiles.begin(); it != collectedFiles.end(); ++it)
+				if (listedFiles.find(*it) == listedFiles.end())
+					files.push_back(*it);
+		}
+
+		beCore::ContentPackWriter writer(static_cast<uint4>(alignment));
+
+		for (std::vector<lean::utf8_string>::const_iterator it = files.begin(); it != files.end(); ++it)
+		{
+			lean::utf8_string file = lean::absolute_path<lean::utf8_string>(*it, directory);
+
+			// Never pack the archive itself, the manifest or generated batch files
+			if (file == archive || file == manifest || (it->size() >= lean::ntarraylen(".berc.bat")
+				&& _stricmp(it->c_str() + it->size() - lean::ntarraylen(".berc.bat"), ".berc.bat") == 0))
+				continue;
+
+			// NOTE: Manifests may list files that have since been removed
+			if (!lean::file_exists(file))
+			{
+				std::cout << "Listed file not found, skipped: " << *it << std::endl;
+				continue;
+			}
+
+			writer.Add(file, *it, bCompress);
+		}
+
+		writer.Write(archive);
+
+		std::cout << "Packed " << writer.GetFileCount() << " files into " << outputFile << std::endl;
+
+		return 0;
+	}
+
+} g_packTool;
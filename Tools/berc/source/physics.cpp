@@ -8,6 +8,7 @@
 #include <beResourceCompiler/beScene.h>
 #include <beResourceCompiler/beMeshSerialization.h>
 #include <lean/smart/resource_ptr.h>
+#include <beCore/beArtifactStore.h>
 
 #include <vector>
 #include <string>
@@ -15,6 +16,9 @@
 #include <lean/io/numeric.h>
 #include <lean/io/filesystem.h>
 
+/// Version of physics shape artifacts, increment whenever the output changes.
+const beCore::uint4 PhysicsArtifactVersion = 1;
+
 /// Physics tool help.
 const struct PhysicsToolHelp : public CommandLineTool
 {
@@ -90,12 +94,34 @@ const struct PhysicsTool : public CommandLineTool
 			StoreCommand("physics", inputFile, storedArgs.data(), storedArgs.size());
 		}
 
+		// Reuse output built from identical input before
+		beCore::ArtifactStore *pArtifacts = GetArtifactStore();
+		beCore::uint8 artifactKey = GetArtifactKey("physics", PhysicsArtifactVersion, inputFile, argv, argc - 2);
+
+		if (pArtifacts && pArtifacts->Retrieve(artifactKey, outputFile))
+		{
+			std::cout << "Retrieved from artifact store: " << outputFile << std::endl;
+			return 0;
+		}
+
 		beResourceCompiler::MeshImporter importer;
 		lean::resource_ptr<beResourceCompiler::Scene> pScene = importer.LoadScene(inputFile, 0, 30.0f, scaleFactor);
 
 		beResourceCompiler::PhysicsCooker cooker;
 		beResourceCompiler::SavePhysXShapes(outputFile, *pScene, cooker);
 
+		if (pArtifacts)
+		{
+			try
+			{
+				pArtifacts->StoreFile(artifactKey, outputFile);
+			}
+			catch (const std::runtime_error &error)
+			{
+				std::cout << "WARNING: Failed to store artifact: " << error.what() << std::endl;
+			}
+		}
+
 		return 0;
 	}
 
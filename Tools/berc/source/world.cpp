@@ -0,0 +1,95 @@
+// world.cpp : Converts worlds between the XML & binary formats.
+//
+
+#include "stdafx.h"
+#include "berc.h"
+#include <beCore/beBinaryDocument.h>
+#include <beCore/bePropertySerialization.h>
+
+#include <lean/xml/xml_file.h>
+#include <lean/io/filesystem.h>
+
+/// World tool help.
+const struct WorldToolHelp : public CommandLineTool
+{
+	/// Constructor.
+	WorldToolHelp() { RegisterTool("worldhelp", this); }
+	/// Destructor.
+	~WorldToolHelp() { UnregisterTool("worldhelp"); }
+
+	/// Runs the command line tool.
+	int Run(int argc, const char* argv[]) const
+	{
+		std::cout << " Syntax: berc world <input> <output>"  << std::endl << std::endl;
+
+		std::cout << " Arguments:"  << std::endl;
+		std::cout << "  <input>        Input world file, XML or binary"  << std::endl;
+		std::cout << "  <output>       Output world file, binary if input is XML, XML otherwise"  << std::endl;
+
+		return 0;
+	}
+
+} g_worldToolHelp;
+
+/// World tool.
+const struct WorldTool : public CommandLineTool
+{
+	/// Constructor.
+	WorldTool() { RegisterTool("world", this); }
+	/// Destructor.
+	~WorldTool() { UnregisterTool("world"); }
+
+	/// Runs the command line tool.
+	int Run(int argc, const char* argv[]) const
+	{
+		if (argc < 2)
+		{
+			g_worldToolHelp.Run(argc, argv);
+			return -1;
+		}
+
+		const char *inputFile = argv[argc - 2];
+		const char *outputFile = argv[argc - 1];
+
+		for (int i = 0; i < argc - 2; ++i)
+			std::cout << "Unrecognized argument, consult worldhelp for help: " << argv[i] << std::endl;
+
+		{
+			std::string inputFilename = lean::get_filename(inputFile);
+			std::string relativeOutputFile = lean::relative_path<std::string>(
+					lean::absolute_path(outputFile),
+					lean::get_directory<std::string>( lean::absolute_path(inputFile) )
+				);
+			const char *storedArgs[] = { inputFilename.c_str(), relativeOutputFile.c_str() };
+
+			StoreCommand("world", inputFile, storedArgs, lean::arraylen(storedArgs));
+		}
+
+		if (beCore::IsBinaryDocument(inputFile))
+		{
+			beCore::BinaryDocument binary(inputFile);
+			lean::xml_file<lean::utf8_t> xml;
+
+			// NOTE: Cloned nodes share the strings of the binary document, which outlives the XML file
+			for (const rapidxml::xml_node<lean::utf8_t> *node = binary.Document().first_node(); node; node = node->next_sibling())
+				xml.document().append_node( xml.document().clone_node(node) );
+
+			// NOTE: Typed binary property values cannot be printed
+			beCore::ConvertPropertyValuesToText(xml.document());
+
+			xml.save(outputFile);
+
+			std::cout << "Converted binary world " << inputFile << " to XML " << outputFile << std::endl;
+		}
+		else
+		{
+			lean::xml_file<lean::utf8_t> xml(inputFile);
+			beCore::SaveBinaryDocument(xml.document(), outputFile);
+
+			std::cout << "Converted XML world " << inputFile << " to binary " << outputFile << std::endl;
+		}
+
+		return 0;
+	}
+
+} g_worldTool;
@@ -23,8 +23,15 @@
 #include <QtCore/QVector>
 
 #include <beCore/beParameters.h>
+#include <beCore/beAsync.h>
+
+namespace beEntitySystem
+{
+	class WorldSnapshot;
+}
 
 class QUndoStack;
+class QTimer;
 class Interaction;
 class DropInteraction;
 class DeviceManager;
@@ -59,6 +66,23 @@ private:
 
 	EntityVector m_selection;
 
+	QTimer *m_pAutosaveTimer;
+	QTimer *m_pAutosavePollTimer;
+	lean::scoped_ptr<beEntitySystem::WorldSnapshot> m_pAutosaveSnapshot;
+	beCore::Async<double> m_autosave;
+	double m_autosaveSnapshotSeconds;
+
+	uint8 m_cacheEvictions;
+
+	/// Waits for any autosave still running in the background.
+	void waitForAutosave();
+	/// Logs resource cache statistics whenever resources have been evicted.
+	void logCacheEvictions();
+
+private Q_SLOTS:
+	/// Reports the results of the background autosave, once done.
+	void pollAutosave();
+
 public:
 	/// Code document type name.
 	static const char *const DocumentTypeName;
@@ -74,6 +98,9 @@ public:
 	/// Saves the document using the given filename.
 	virtual bool saveAs(const QString &file);
 
+	/// Gets the file the document is autosaved to, empty if the document has not been saved yet.
+	QString autosaveFile() const;
+
 	/// Adds the given interaction.
 	void pushInteraction(Interaction *pInteraction);
 	/// Removes the given interaction.
@@ -149,6 +176,9 @@ public Q_SLOTS:
 	/// Commits changes.
 	void commit();
 
+	/// Snapshots the world & writes the snapshot to the autosave file in the background, if changed.
+	void autosave();
+
 Q_SIGNALS:
 	/// Emitted whenever the selection has changed.
 	void selectionChanged(SceneDocument *pDocument);
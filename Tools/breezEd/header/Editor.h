@@ -10,10 +10,19 @@ class QSettings;
 class DocumentManager;
 class DeviceManager;
 
+namespace beCore
+{
+	class ThreadPool;
+	class ThreadPoolExecutor;
+}
+
 class Editor : public lean::noncopyable
 {
 private:
 	lean::scoped_ptr<QSettings> m_pSettings;
+	// ORDER: Outlive all documents, which may wait for background work on destruction
+	lean::scoped_ptr<beCore::ThreadPool> m_pThreadPool;
+	lean::scoped_ptr<beCore::ThreadPoolExecutor> m_pBackgroundExecutor;
 	lean::scoped_ptr<DocumentManager> m_pDocumentManager;
 	lean::scoped_ptr<MainWindow> m_pMainWindow;
 	lean::scoped_ptr<DeviceManager> m_pDeviceManager;
@@ -52,6 +61,12 @@ public:
 	LEAN_INLINE DeviceManager* deviceManager() { return m_pDeviceManager.get(); };
 	/// Gets the main window.
 	LEAN_INLINE const DeviceManager* deviceManager() const { return m_pDeviceManager.get(); };
+
+	/// Gets the thread pool running background work & asynchronous resource loads.
+	LEAN_INLINE beCore::ThreadPool* threadPool() { return m_pThreadPool.get(); };
+	/// Gets the executor running low-priority background work off the UI thread, e.g. autosaves. Leaves at least one
+	/// worker to normal-priority work, unless there is only one, see beCore::ThreadPool::SetBackgroundThreadLimit().
+	LEAN_INLINE beCore::ThreadPoolExecutor* backgroundExecutor() { return m_pBackgroundExecutor.get(); };
 };
 
 template <class Parameter>
@@ -15,6 +15,12 @@
 #include <beScene/beShaderDrivenPipeline.h>
 
 #include <beEntitySystem/beEntities.h>
+#include <beEntitySystem/beWorldSnapshot.h>
+#include <beEntitySystem/beWorldDelta.h>
+
+#include <beCore/bePropertySnapshot.h>
+#include <lean/time/highres_timer.h>
+#include <lean/logging/log.h>
 
 #include "Utility/Strings.h"
 #include "Utility/Checked.h"
@@ -22,16 +28,44 @@
 // Scene document type name.
 const char *const SceneDocument::DocumentTypeName = "Scene";
 
+namespace
+{
+
+/// Gets the file changes to the given world file are appended to between full saves.
+QString deltaFileOf(const QString &file)
+{
+	return file + ".delta";
+}
+
+} // namespace
+
 // Constructor.
 SceneDocument::SceneDocument(const QString &type, const QString &name, const QString &file, bool bLoadFromFile, Editor *pEditor, QObject *pParent)
 	: AbstractDocument(type, name, file, pEditor, pParent),
 	m_pUndoStack( new QUndoStack(this) ),
-	m_pGraphicsResources( beScene::CreateResourceManager(editor()->deviceManager()->graphicsDevice(), "EffectCache", "Effects", "Textures", "Materials", "Meshes") ),
+	m_pGraphicsResources( beScene::CreateResourceManager(editor()->deviceManager()->graphicsDevice(), "EffectCache", "Effects", "Textures", "Materials", "Meshes",
+		nullptr, editor()->threadPool()) ),
 	m_pPhysicsResources( bePhysics::CreateResourceManager(editor()->deviceManager()->physicsDevice(), "PhysicsMaterials", "PhysicsShapes", m_pGraphicsResources->Monitor()) ),
 	m_pRenderer( beScene::CreateEffectDrivenRenderer(editor()->deviceManager()->graphicsDevice(), m_pGraphicsResources->Monitor()) ),
 	m_pRenderContext( beScene::CreateRenderContext(*m_pRenderer->ImmediateContext()) ),
-	m_pPrimaryView()
+	m_pPrimaryView(),
+	m_pAutosaveTimer( new QTimer(this) ),
+	m_pAutosavePollTimer( new QTimer(this) ),
+	m_pAutosaveSnapshot( new beEntitySystem::WorldSnapshot() ),
+	m_autosaveSnapshotSeconds(0.0),
+	m_cacheEvictions(0)
 {
+	// Resource memory budgets in MB, 0 leaves resources resident until released
+	{
+		uint8 gpuBudget = editor()->settings()->value("sceneDocument/gpuMemoryBudget", 0).toULongLong();
+		uint8 cpuBudget = editor()->settings()->value("sceneDocument/cpuMemoryBudget", 0).toULongLong();
+
+		if (gpuBudget || cpuBudget)
+			m_pGraphicsResources->SetMemoryBudget( beCore::ResourceMemory(
+					(gpuBudget) ? gpuBudget << 20 : beCore::ResourceMemory::Unlimited,
+					(cpuBudget) ? cpuBudget << 20 : beCore::ResourceMemory::Unlimited
+				) );
+	}
 	
 	// TODO: read from somewhere
 	beScene::LoadRenderingPipeline(*m_pRenderer->Pipeline(),
@@ -48,7 +82,20 @@ SceneDocument::SceneDocument(const QString &type, const QString &name, const QSt
 		controllers->AddControllerKeep(m_pPhysics);
 
 		if (bLoadFromFile)
-			m_pWorld = new_resource bees::World( toUtf8Range(name), toUtf8Range(file), getSerializationParameters(), controllers.move_ptr() );
+		{
+			QString deltaFile = deltaFileOf(file);
+
+			// Merge changes appended since the last full save
+			if (QFileInfo(deltaFile).exists())
+			{
+				bees::CompactWorld( toUtf8Range(file), toUtf8Range(deltaFile), toUtf8Range(file) );
+				// NOTE: Compacted world stamped anew, deltas never applied twice even if removal fails
+				QFile::remove(deltaFile);
+			}
+
+			m_pWorld = new_resource bees::World( toUtf8Range(name), toUtf8Range(file), getSerializationParameters(), controllers.move_ptr(),
+				bees::WorldDesc(10000, editor()->threadPool()) );
+		}
 		else
 			m_pWorld = new_resource bees::World( toUtf8Range(name), controllers.move_ptr() );
 	}
@@ -60,11 +107,24 @@ SceneDocument::SceneDocument(const QString &type, const QString &name, const QSt
 	// Keep documents in sync
 	checkedConnect(m_pUndoStack, SIGNAL(cleanChanged(bool)), this, SLOT(setClean(bool)));
 	checkedConnect(this, SIGNAL(documentClean()), m_pUndoStack, SLOT(setClean()));
+
+	// Autosave in the background, 0 disables
+	int autosaveInterval = editor()->settings()->value("sceneDocument/autosaveInterval", 300).toInt();
+
+	if (autosaveInterval > 0)
+	{
+		checkedConnect(m_pAutosaveTimer, SIGNAL(timeout()), this, SLOT(autosave()));
+		m_pAutosaveTimer->start(autosaveInterval * 1000);
+	}
+
+	checkedConnect(m_pAutosavePollTimer, SIGNAL(timeout()), this, SLOT(pollAutosave()));
 }
 
 // Destructor.
 SceneDocument::~SceneDocument()
 {
+	// ORDER: Snapshot may not be destroyed while being written
+	waitForAutosave();
 	releaseReferences();
 }
 
@@ -109,6 +169,8 @@ void SceneDocument::commit()
 			m_pPhysicsResources->Commit();
 			m_pWorld->Commit();
 
+			logCacheEvictions();
+
 			Q_EMIT postCommit();
 			bRetry = m_pGraphicsResources->Monitor->ChangesPending();
 		}
@@ -118,6 +180,21 @@ void SceneDocument::commit()
 		}
 }
 
+// Logs resource cache statistics whenever resources have been evicted.
+void SceneDocument::logCacheEvictions()
+{
+	beCore::ResourceCacheStats stats = m_pGraphicsResources->GetCacheStats();
+
+	if (stats.Evictions != m_cacheEvictions)
+	{
+		LEAN_LOG(
+			"Evicted " << stats.Evictions - m_cacheEvictions << " resources from the caches of " << toUtf8(name()) << ", "
+			<< stats.ResidentCount << " resident: " << (stats.Resident.GPUBytes >> 20) << " MB GPU, " << (stats.Resident.CPUBytes >> 20) << " MB CPU; "
+			<< stats.Hits << " hits, " << stats.Misses << " misses" );
+		m_cacheEvictions = stats.Evictions;
+	}
+}
+
 // Clears the selection.
 void SceneDocument::clearSelection()
 {
@@ -187,7 +264,31 @@ bool SceneDocument::saveAs(const QString &file)
 		if (!directory.exists())
 			QFileInfo(directory.path()).dir().mkdir(directory.dirName());
 
-		m_pWorld->Serialize( toUtf8Range(file) );
+		QString deltaFile = deltaFileOf(file);
+		bool bDeltaSaved = false;
+
+		// Append changes to the file last saved in full, unless too many changes have piled up
+		if (file == this->file() && QFileInfo(file).exists()
+			&& QFileInfo(deltaFile).size() < editor()->settings()->value("sceneDocument/maxDeltaSize", 4 * 1024 * 1024).toLongLong())
+		{
+			bDeltaSaved = m_pWorld->SerializeDelta( toUtf8Range(deltaFile) );
+
+#ifdef _DEBUG
+			// Fall back to a full save if base & deltas do not reproduce the world
+			if (bDeltaSaved && !bees::WorldDeltasEquivalent(*m_pWorld, toUtf8Range(file), toUtf8Range(deltaFile)))
+			{
+				editor()->showMessage( AbstractDocument::tr("Incremental save of document '%1' does not match a full save.").arg(name()) );
+				bDeltaSaved = false;
+			}
+#endif
+		}
+
+		if (!bDeltaSaved)
+		{
+			m_pWorld->SerializeBase( toUtf8Range(file) );
+			// NOTE: Stamped with the previous save ID, never applied to the new file anyway
+			QFile::remove(deltaFile);
+		}
 	}
 	catch (...)
 	{
@@ -204,6 +305,101 @@ bool SceneDocument::saveAs(const QString &file)
 	return true;
 }
 
+// Gets the file the document is autosaved to.
+QString SceneDocument::autosaveFile() const
+{
+	return (!file().isEmpty()) ? file() + ".autosave" : QString();
+}
+
+namespace
+{
+
+/// Writes a world snapshot to file, returning the time taken.
+struct WriteWorldSnapshot
+{
+	typedef double result_type;
+
+	beEntitySystem::WorldSnapshot *pSnapshot;
+	lean::utf8_string file;
+
+	/// Constructor.
+	WriteWorldSnapshot(beEntitySystem::WorldSnapshot *pSnapshot, const lean::utf8_string &file)
+		: pSnapshot(pSnapshot),
+		file(file) { }
+
+	/// Writes the snapshot, returning the time taken in seconds.
+	double operator ()() const
+	{
+		lean::highres_timer timer;
+		pSnapshot->Serialize(file);
+		return timer.seconds();
+	}
+};
+
+} // namespace
+
+// Snapshots the world & writes the snapshot to the autosave file in the background.
+void SceneDocument::autosave()
+{
+	// Previous autosave still running
+	if (m_autosave.Valid() && !m_autosave.IsReady())
+		return;
+
+	QString file = autosaveFile();
+
+	if (!changed() || file.isEmpty())
+		return;
+
+	try
+	{
+		lean::highres_timer timer;
+		// NOTE: Only cost to the UI thread, builds structure nodes & copies raw property values, neither property nodes
+		// nor value text are created before the snapshot is written in the background
+		m_pWorld->Snapshot(*m_pAutosaveSnapshot);
+		m_autosaveSnapshotSeconds = timer.seconds();
+	}
+	catch (...)
+	{
+		editor()->showMessage( AbstractDocument::tr("Autosave of document '%1' failed.").arg(name()) );
+		return;
+	}
+
+	m_autosave = beCore::RunAsync( editor()->backgroundExecutor(), WriteWorldSnapshot(m_pAutosaveSnapshot.get(), toUtf8(file)) );
+	m_pAutosavePollTimer->start(100);
+}
+
+// Reports the results of the background autosave, once done.
+void SceneDocument::pollAutosave()
+{
+	if (!m_autosave.Valid() || !m_autosave.IsReady())
+		return;
+
+	m_pAutosavePollTimer->stop();
+
+	if (!m_autosave.IsFailed())
+		editor()->showMessage(
+				AbstractDocument::tr("Autosaved document '%1' to '%2' (snapshot: %3 ms, %4 values; serialize: %5 ms).")
+					.arg(name()).arg(autosaveFile())
+					.arg(m_autosaveSnapshotSeconds * 1000.0, 0, 'f', 1)
+					.arg(m_pAutosaveSnapshot->Properties().GetValueCount())
+					.arg(m_autosave.Get() * 1000.0, 0, 'f', 1),
+				10000
+			);
+	else
+		editor()->showMessage( AbstractDocument::tr("Autosave of document '%1' to '%2' failed.").arg(name()).arg(autosaveFile()) );
+
+	// Release snapshot memory until the next autosave
+	m_pAutosaveSnapshot->Clear();
+	m_autosave = beCore::Async<double>();
+}
+
+// Waits for any autosave still running in the background.
+void SceneDocument::waitForAutosave()
+{
+	if (m_autosave.Valid())
+		m_autosave.Wait();
+}
+
 // Sets the document name.
 void SceneDocument::setName(const QString &name)
 {
@@ -4,17 +4,65 @@
 #include "Windows/MainWindow.h"
 #include "Documents/DocumentManager.h"
 #include <QtCore/QSettings>
+#include <QtCore/QFileInfo>
+#include <QtCore/QThread>
 #include "Plugins/PluginManager.h"
 #include "Tiles/ConsoleWidget.h"
 #include "DeviceManager.h"
 
+#include <beCore/beThreadPool.h>
+#include <beCore/beAsync.h>
+#include <beCore/beContentPack.h>
+
+#include "Utility/Strings.h"
+
 #include <lean/logging/errors.h>
 
+namespace
+{
+
+/// Mounts all content packs listed in the given settings.
+void mountContentPacks(QSettings &settings)
+{
+	int packCount = settings.beginReadArray("contentPacks");
+
+	for (int i = 0; i < packCount; ++i)
+	{
+		settings.setArrayIndex(i);
+
+		QString archive = settings.value("archive").toString();
+		// NOTE: Packs are built from a directory (see berc pack), mount there by default
+		QString mountDirectory = settings.value("mountDirectory", QFileInfo(archive).absolutePath()).toString();
+
+		try
+		{
+			beCore::MountContentPack(
+					lean::bind_resource( new beCore::ContentPack(toUtf8Range(archive), toUtf8Range(mountDirectory)) ).get()
+				);
+		}
+		catch (const std::exception &error)
+		{
+			LEAN_LOG_ERROR_XCTX("Content pack could not be mounted.", error.what(), toUtf8(archive).c_str());
+		}
+	}
+
+	settings.endArray();
+}
+
+} // namespace
+
 // Constructor.
 Editor::Editor()
 	: m_pSettings( new QSettings("breeze", "breezEd") ),
+	// NOTE: World loading spreads over all workers, the calling (UI) thread joins in as the remaining core
+	m_pThreadPool( new beCore::ThreadPool( qMax(QThread::idealThreadCount() - 1, 1) ) ),
+	// NOTE: Background lane, autosaves never hold up world loading & other work waited for by the UI
+	m_pBackgroundExecutor( new beCore::ThreadPoolExecutor(m_pThreadPool.get(), beCore::TaskPriority::Background) ),
 	m_pDocumentManager( new DocumentManager() )
 {
+	// ORDER: Mount packs before any resources are loaded
+	mountContentPacks(*m_pSettings);
+
 	editorPlugins().initializePlugins(this);
 
 	// ORDER: Create window after plugins have been initialized
@@ -40,6 +88,8 @@ Editor::Editor()
 Editor::~Editor()
 {
 	editorPlugins().finalizePlugins(this);
+
+	beCore::UnmountContentPacks();
 }
 
 // Shows the given message for the given amount of time.
@@ -31,7 +31,8 @@ uint4 objectIDUnderCursor(beScene::Renderer &renderer, beScene::RenderingControl
 	rayPerspective.ViewProjMat = mul( rayPerspective.ViewMat, rayPerspective.ProjMat );
 	rayPerspective.OutputIndex = 0;
 
-	uint4 objectIDStage = renderer.Pipeline()->GetStageID("ObjectIDPipelineStage");
+	// NOTE: Literals hashed at compile time
+	uint4 objectIDStage = renderer.Pipeline()->GetStageID( beCore::FindAtom(beCore::HashLiteral("ObjectIDPipelineStage")) );
 
 	if (objectIDStage == beScene::InvalidPipelineStage)
 	{
@@ -49,7 +50,7 @@ uint4 objectIDUnderCursor(beScene::Renderer &renderer, beScene::RenderingControl
 		rayPerspective, pSelectionPipe, nullptr, 1U << objectIDStage);
 	scene.Render(*perspective, *scene.GetRenderContext());
 
-	const beGraphics::ColorTextureTarget *pObjectIDTarget = pSelectionPipe->GetColorTarget("ObjectIDTarget");
+	const beGraphics::ColorTextureTarget *pObjectIDTarget = pSelectionPipe->GetColorTarget( beCore::FindAtom(beCore::HashLiteral("ObjectIDTarget")) );
 
 	// Nothing rendered
 	if (!pObjectIDTarget)
@@ -50,6 +50,8 @@
 #include <lean/functional/algorithm.h>
 #include <lean/io/numeric.h>
 
+#include <algorithm>
+
 #include <beGraphics/DX/beError.h>
 
 namespace beAssets
@@ -285,13 +287,25 @@ void CommitExternalChanges(WaterControllers::M &m, beCore::ComponentMonitor &mon
 
 	M::Data &data = *m.data;
 
-	if (monitor.Replacement.HasChanged(besc::RenderableMaterial::GetComponentType()))
+	const beCore::ComponentMonitorChannel &replacement = monitor.Replacement;
+	const beCore::ComponentType *materialType = besc::RenderableMaterial::GetComponentType();
+
+	if (replacement.HasChanged(materialType))
 	{
+		// Only check materials replaced, if known
+		bool bAllTracked = replacement.AllChangesTracked(materialType);
+		beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(materialType);
+
 		uint4 controllerCount = (uint4) data.controllers.size();
 
 		for (uint4 internalIdx = 0; internalIdx < controllerCount; ++internalIdx)
 		{
 			M::Record &record = data.controllers[internalIdx];
+
+			// NOTE: Changed materials sorted by address
+			if (bAllTracked && !std::binary_search(changed.Begin, changed.End, static_cast<const void*>(record.Material.get())))
+				continue;
+
 			besc::RenderableMaterial *newMaterial = record.Material;
 			
 			while (besc::RenderableMaterial *successor = newMaterial->GetSuccessor())
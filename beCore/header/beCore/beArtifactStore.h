@@ -0,0 +1,119 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_ARTIFACT_STORE
+#define BE_CORE_ARTIFACT_STORE
+
+#include "beCore.h"
+#include "beContent.h"
+#include "beContentHash.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/smart/com_ptr.h>
+
+namespace beCore
+{
+
+class ThreadPool;
+
+/// Builds keys identifying build artifacts by everything that went into building them.
+class ArtifactKey
+{
+private:
+	ContentHasher m_hasher;
+
+public:
+	/// Constructor. Compilers pass their name & a version to be incremented whenever their output changes.
+	BE_CORE_API ArtifactKey(const utf8_ntri &compiler, uint4 version);
+
+	/// Adds the given data, e.g. build parameters.
+	BE_CORE_API ArtifactKey& Add(const void *data, size_t size);
+	/// Adds the given string. Strings are delimited, i.e. ("ab", "c") & ("a", "bc") yield different keys.
+	BE_CORE_API ArtifactKey& AddString(const utf8_ntri &string);
+	/// Adds the given content.
+	BE_CORE_API ArtifactKey& AddContent(const Content &content);
+	/// Adds the contents of the given file. Throws if the file cannot be read.
+	BE_CORE_API ArtifactKey& AddFile(const utf8_ntri &file);
+	/// Adds the given value.
+	template <class Value>
+	LEAN_INLINE ArtifactKey& AddValue(const Value &value) { return Add(&value, sizeof(value)); }
+
+	/// Gets the key.
+	LEAN_INLINE uint8 Get() const { return m_hasher.Finish(); }
+};
+
+/// Artifact file header, followed by the stored artifact data.
+struct ArtifactHeader
+{
+	static const uint4 MagicID = 0x52414542;	///< 'BEAR'
+	static const uint4 CurrentVersion = 1;		///< Current version.
+
+	/// Artifact flags.
+	enum Flags
+	{
+		Compressed = 1 << 0		///< Data is block-compressed.
+	};
+
+	uint4 Magic;		///< Magic ID.
+	uint4 Version;		///< Format version.
+	uint8 Key;			///< Artifact key.
+	uint8 Size;			///< Number of bytes stored.
+	uint8 Hash;			///< Content hash of the bytes stored.
+	uint4 Flags;		///< Artifact flags.
+	uint4 _Pad;
+};
+
+/// Content-addressed on-disk store of build artifacts. Artifacts are keyed by a hash of all inputs (see ArtifactKey),
+/// identical inputs are never rebuilt as long as their artifacts remain in the store. Stores may be shared by multiple
+/// processes & machines, artifacts are written atomically. Least recently used artifacts are evicted when the store
+/// exceeds its size budget. This class is thread-safe.
+class ArtifactStore : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Default size budget.
+	static const uint8 DefaultSizeBudget = 1ULL << 30;
+
+	/// Opens or creates the store in the given directory. Compressed artifacts are (de)compressed on the given pool, if any.
+	BE_CORE_API ArtifactStore(const utf8_ntri &directory, uint8 sizeBudget = DefaultSizeBudget, ThreadPool *pPool = nullptr);
+	/// Destructor.
+	BE_CORE_API ~ArtifactStore();
+
+	/// Gets the artifact stored under the given key, nullptr if none or corrupted. Marks the artifact as recently used.
+	BE_CORE_API lean::com_ptr<Content> Load(uint8 key);
+	/// Checks if an artifact is stored under the given key.
+	BE_CORE_API bool Contains(uint8 key) const;
+	/// Copies the artifact stored under the given key to the given file, returns false if none.
+	BE_CORE_API bool Retrieve(uint8 key, const utf8_ntri &file);
+
+	/// Stores the given data under the given key, optionally block-compressed. Concurrent readers either see
+	/// the previous or the new artifact. Evicts least recently used artifacts exceeding the size budget.
+	BE_CORE_API void Store(uint8 key, const void *data, uint8 size, bool bCompress = false);
+	/// Stores the contents of the given file under the given key, optionally block-compressed.
+	BE_CORE_API void StoreFile(uint8 key, const utf8_ntri &file, bool bCompress = false);
+
+	/// Evicts least recently used artifacts until the store no longer exceeds the given size budget.
+	BE_CORE_API void Trim(uint8 sizeBudget);
+	/// Sets the size budget, zero for unlimited.
+	BE_CORE_API void SetSizeBudget(uint8 sizeBudget);
+	/// Gets the size budget.
+	BE_CORE_API uint8 GetSizeBudget() const;
+	/// Gets the number of bytes currently stored.
+	BE_CORE_API uint8 GetSize() const;
+
+	/// Gets the store directory.
+	BE_CORE_API utf8_ntr GetDirectory() const;
+	/// Gets the thread pool used for (de)compression.
+	BE_CORE_API ThreadPool* GetThreadPool() const;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,447 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_ASYNC
+#define BE_CORE_ASYNC
+
+#include "beCore.h"
+#include "beShared.h"
+#include "beTask.h"
+#include "beThreadPool.h"
+#include "beContentProvider.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/smart/resource_ptr.h>
+#include <lean/smart/com_ptr.h>
+#include <lean/concurrent/spin_lock.h>
+#include <lean/concurrent/event.h>
+
+namespace beCore
+{
+
+/// Executor interface.
+class LEAN_INTERFACE Executor
+{
+	LEAN_INTERFACE_BEHAVIOR(Executor)
+
+public:
+	/// Schedules the given task for execution. This method is thread-safe.
+	virtual void Post(Task *pTask) = 0;
+};
+
+/// Executes tasks on a thread pool.
+class ThreadPoolExecutor : public Executor
+{
+private:
+	ThreadPool *m_pPool;
+	TaskPriority::T m_priority;
+
+public:
+	/// Constructs an executor scheduling tasks on the given thread pool with the given priority.
+	LEAN_INLINE ThreadPoolExecutor(ThreadPool *pPool, TaskPriority::T priority = TaskPriority::Normal)
+		: m_pPool(pPool),
+		m_priority(priority) { }
+
+	/// Schedules the given task for execution. This method is thread-safe.
+	BE_CORE_API void Post(Task *pTask);
+
+	/// Gets the thread pool.
+	LEAN_INLINE ThreadPool* GetThreadPool() const { return m_pPool; }
+	/// Gets the task priority.
+	LEAN_INLINE TaskPriority::T GetPriority() const { return m_priority; }
+};
+
+/// Executes tasks on the thread calling RunPending(), e.g. once per frame on the main thread.
+class SyncExecutor : public Executor, public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructor.
+	BE_CORE_API SyncExecutor();
+	/// Destructor. Runs all tasks still pending.
+	BE_CORE_API ~SyncExecutor();
+
+	/// Schedules the given task for execution. This method is thread-safe.
+	BE_CORE_API void Post(Task *pTask);
+	/// Runs all tasks posted so far on the calling thread, returning the number of tasks run.
+	/// Tasks posted while running are deferred to the next call.
+	BE_CORE_API uint4 RunPending();
+};
+
+/// Executes tasks one at a time in order of posting on a dedicated thread, e.g. for I/O.
+class ThreadExecutor : public Executor, public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructor. Launches the executor thread.
+	BE_CORE_API ThreadExecutor();
+	/// Destructor. Runs all tasks still pending, then terminates the executor thread.
+	BE_CORE_API ~ThreadExecutor();
+
+	/// Schedules the given task for execution. This method is thread-safe.
+	BE_CORE_API void Post(Task *pTask);
+};
+
+/// Continuation of an asynchronous operation, destroys itself after having been run.
+class AsyncContinuation : public Task, public Shared
+{
+	friend class AsyncStateBase;
+
+private:
+	Executor *m_pExecutor;
+	AsyncContinuation *m_pNext;
+
+protected:
+	/// Constructs a continuation to be run by the given executor, inline by the completing thread if nullptr.
+	LEAN_INLINE AsyncContinuation(Executor *pExecutor)
+		: m_pExecutor(pExecutor),
+		m_pNext(nullptr) { }
+	/// Destructor.
+	virtual ~AsyncContinuation() throw() { }
+
+	/// Continues the asynchronous operation.
+	virtual void Continue() = 0;
+	/// Called when Continue() has thrown an exception.
+	virtual void Abort() = 0;
+
+public:
+	/// Calls Continue(), calls Abort() on exceptions, destroys this continuation.
+	BE_CORE_API void Run();
+};
+
+/// Asynchronous operation state.
+class AsyncStateBase : public Resource, public lean::noncopyable
+{
+public:
+	/// Status enumeration.
+	enum Status
+	{
+		Pending,	///< Operation still running.
+		Done,		///< Operation completed.
+		Failed		///< Operation failed.
+	};
+
+private:
+	volatile int m_status;
+	AsyncContinuation *m_pContinuations;
+	lean::spin_lock<> m_continuationLock;
+	mutable lean::event m_done;
+
+	/// Runs or schedules the given continuation.
+	static void Dispatch(AsyncContinuation *pContinuation);
+	/// Marks the operation as completed or failed, runs or schedules all continuations.
+	void Finish(Status status);
+
+protected:
+	/// Constructor.
+	BE_CORE_API AsyncStateBase();
+	/// Destructor.
+	BE_CORE_API virtual ~AsyncStateBase() throw();
+
+	/// Marks the operation as completed, runs or schedules all continuations.
+	BE_CORE_API void Complete();
+
+public:
+	/// Marks the operation as failed, runs or schedules all continuations.
+	BE_CORE_API void Fail();
+	/// Runs or schedules the given continuation as soon as the operation has completed or failed. This method is thread-safe.
+	BE_CORE_API void Continue(AsyncContinuation *pContinuation);
+
+	/// Waits for the operation to complete or fail.
+	BE_CORE_API void Wait() const;
+	/// Waits for the operation to complete, throws if the operation failed.
+	BE_CORE_API void WaitForResult() const;
+
+	/// Checks if the operation has completed or failed.
+	LEAN_INLINE bool IsReady() const { return m_status != Pending; }
+	/// Checks if the operation has failed.
+	LEAN_INLINE bool IsFailed() const { return m_status == Failed; }
+};
+
+/// Asynchronous operation state holding a result value.
+template <class Value>
+class AsyncState : public AsyncStateBase
+{
+private:
+	Value m_value;
+
+public:
+	/// Stores the given result value & marks the operation as completed. Call once only.
+	LEAN_INLINE void SetValue(const Value &value)
+	{
+		m_value = value;
+		// ORDER: Complete AFTER the result value has been stored
+		Complete();
+	}
+	/// Gets the result value. Only valid after completion.
+	LEAN_INLINE const Value& GetValue() const { return m_value; }
+};
+
+/// Handle to the result of an asynchronous operation. Results are passed on by chaining continuations via Then(),
+/// each of which may run on a different executor, allowing streaming code to be written without ever blocking workers.
+/// Continuations are function objects exposing their result type as result_type, wrap lambdas in such objects.
+template <class Value>
+class Async
+{
+public:
+	/// State type.
+	typedef AsyncState<Value> state_type;
+	/// Value type.
+	typedef Value value_type;
+
+private:
+	lean::resource_ptr<state_type> m_state;
+
+public:
+	/// Constructs an invalid handle.
+	LEAN_INLINE Async() { }
+	/// Constructs a handle to the given state.
+	LEAN_INLINE explicit Async(state_type *pState)
+		: m_state(pState) { }
+
+	/// Runs function(const Value&) on the given executor as soon as this operation has completed, inline by the
+	/// completing thread if nullptr. Returns the result of the function, failures are passed on without calling it.
+	template <class Function>
+	Async<typename Function::result_type> Then(Executor *pExecutor, const Function &function) const;
+	/// Runs function(const Value&) returning another Async<> on the given executor as soon as this operation has
+	/// completed, inline by the completing thread if nullptr. Returns the result of the operation started by the function.
+	template <class Function>
+	typename Function::result_type ThenAsync(Executor *pExecutor, const Function &function) const;
+
+	/// Waits for the operation to complete or fail.
+	LEAN_INLINE void Wait() const { m_state->Wait(); }
+	/// Waits for the operation to complete & gets the result value. Throws if the operation failed.
+	/// Do not call on workers, chain continuations instead.
+	LEAN_INLINE const Value& Get() const
+	{
+		m_state->WaitForResult();
+		return m_state->GetValue();
+	}
+
+	/// Checks if this handle is valid.
+	LEAN_INLINE bool Valid() const { return (m_state != nullptr); }
+	/// Checks if the operation has completed or failed.
+	LEAN_INLINE bool IsReady() const { return m_state->IsReady(); }
+	/// Checks if the operation has failed.
+	LEAN_INLINE bool IsFailed() const { return m_state->IsFailed(); }
+
+	/// Gets the state.
+	LEAN_INLINE state_type* GetState() const { return m_state; }
+};
+
+/// Producer side of an asynchronous operation.
+template <class Value>
+class AsyncPromise
+{
+private:
+	lean::resource_ptr< AsyncState<Value> > m_state;
+
+public:
+	/// Constructs a new pending operation.
+	AsyncPromise()
+		: m_state( new_resource AsyncState<Value>() ) { }
+
+	/// Stores the given result value & marks the operation as completed. Call once only.
+	LEAN_INLINE void SetValue(const Value &value) { m_state->SetValue(value); }
+	/// Marks the operation as failed. Call once only.
+	LEAN_INLINE void Fail() { m_state->Fail(); }
+
+	/// Gets a handle to the operation result.
+	LEAN_INLINE Async<Value> GetAsync() const { return Async<Value>(m_state); }
+};
+
+namespace Impl
+{
+
+/// Runs a function on the result of an asynchronous operation.
+template <class Value, class Function>
+class AsyncThen : public AsyncContinuation
+{
+private:
+	typedef typename Function::result_type result_type;
+
+	lean::resource_ptr< AsyncState<Value> > m_source;
+	AsyncPromise<result_type> m_result;
+	Function m_function;
+
+protected:
+	void Continue()
+	{
+		if (m_source->IsFailed())
+			m_result.Fail();
+		else
+			m_result.SetValue( m_function(m_source->GetValue()) );
+	}
+	void Abort()
+	{
+		m_result.Fail();
+	}
+
+public:
+	AsyncThen(Executor *pExecutor, AsyncState<Value> *pSource, const AsyncPromise<result_type> &result, const Function &function)
+		: AsyncContinuation(pExecutor),
+		m_source(pSource),
+		m_result(result),
+		m_function(function) { }
+};
+
+/// Passes on the result of an asynchronous operation.
+template <class Value>
+class AsyncForward : public AsyncContinuation
+{
+private:
+	lean::resource_ptr< AsyncState<Value> > m_source;
+	AsyncPromise<Value> m_result;
+
+protected:
+	void Continue()
+	{
+		if (m_source->IsFailed())
+			m_result.Fail();
+		else
+			m_result.SetValue(m_source->GetValue());
+	}
+	void Abort()
+	{
+		m_result.Fail();
+	}
+
+public:
+	AsyncForward(AsyncState<Value> *pSource, const AsyncPromise<Value> &result)
+		: AsyncContinuation(nullptr),
+		m_source(pSource),
+		m_result(result) { }
+};
+
+/// Runs a function starting another asynchronous operation on the result of an asynchronous operation.
+template <class Value, class Function>
+class AsyncThenAsync : public AsyncContinuation
+{
+private:
+	typedef typename Function::result_type::value_type result_type;
+
+	lean::resource_ptr< AsyncState<Value> > m_source;
+	AsyncPromise<result_type> m_result;
+	Function m_function;
+
+protected:
+	void Continue()
+	{
+		if (m_source->IsFailed())
+			m_result.Fail();
+		else
+		{
+			Async<result_type> next = m_function(m_source->GetValue());
+
+			if (next.Valid())
+				next.GetState()->Continue( new AsyncForward<result_type>(next.GetState(), m_result) );
+			else
+				m_result.Fail();
+		}
+	}
+	void Abort()
+	{
+		m_result.Fail();
+	}
+
+public:
+	AsyncThenAsync(Executor *pExecutor, AsyncState<Value> *pSource, const AsyncPromise<result_type> &result, const Function &function)
+		: AsyncContinuation(pExecutor),
+		m_source(pSource),
+		m_result(result),
+		m_function(function) { }
+};
+
+/// Runs a function without arguments.
+template <class Function>
+class AsyncCall : public AsyncContinuation
+{
+private:
+	typedef typename Function::result_type result_type;
+
+	AsyncPromise<result_type> m_result;
+	Function m_function;
+
+protected:
+	void Continue()
+	{
+		m_result.SetValue( m_function() );
+	}
+	void Abort()
+	{
+		m_result.Fail();
+	}
+
+public:
+	AsyncCall(Executor *pExecutor, const AsyncPromise<result_type> &result, const Function &function)
+		: AsyncContinuation(pExecutor),
+		m_result(result),
+		m_function(function) { }
+};
+
+} // namespace
+
+// Runs function(const Value&) on the given executor as soon as this operation has completed.
+template <class Value>
+template <class Function>
+Async<typename Function::result_type> Async<Value>::Then(Executor *pExecutor, const Function &function) const
+{
+	AsyncPromise<typename Function::result_type> result;
+	m_state->Continue( new Impl::AsyncThen<Value, Function>(pExecutor, m_state, result, function) );
+	return result.GetAsync();
+}
+
+// Runs function(const Value&) returning another Async<> on the given executor as soon as this operation has completed.
+template <class Value>
+template <class Function>
+typename Function::result_type Async<Value>::ThenAsync(Executor *pExecutor, const Function &function) const
+{
+	AsyncPromise<typename Function::result_type::value_type> result;
+	m_state->Continue( new Impl::AsyncThenAsync<Value, Function>(pExecutor, m_state, result, function) );
+	return result.GetAsync();
+}
+
+/// Runs function() on the given executor, returning its result.
+template <class Function>
+Async<typename Function::result_type> RunAsync(Executor *pExecutor, const Function &function)
+{
+	AsyncPromise<typename Function::result_type> result;
+	Impl::AsyncCall<Function> *pCall = new Impl::AsyncCall<Function>(pExecutor, result, function);
+
+	if (pExecutor)
+		pExecutor->Post(pCall);
+	else
+		pCall->Run();
+
+	return result.GetAsync();
+}
+
+/// Makes an asynchronous operation that has already completed with the given value.
+template <class Value>
+LEAN_INLINE Async<Value> MakeAsync(const Value &value)
+{
+	AsyncPromise<Value> result;
+	result.SetValue(value);
+	return result.GetAsync();
+}
+
+/// Reads the content identified by the given path on the given executor, e.g. a ThreadExecutor dedicated to I/O.
+/// The content provider needs to be thread-safe & outlive the operation. Continue with Then() on a SyncExecutor to
+/// get back to the main thread.
+BE_CORE_API Async< lean::com_ptr<Content> > ReadContentAsync(ContentProvider *pProvider, const utf8_ntri &file, Executor *pExecutor);
+
+} // namespace
+
+#endif
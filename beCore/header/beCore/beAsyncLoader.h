@@ -0,0 +1,107 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_ASYNC_LOADER
+#define BE_CORE_ASYNC_LOADER
+
+#include "beCore.h"
+#include "beTask.h"
+#include "beThreadPool.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+
+namespace beCore
+{
+
+class AsyncLoader;
+
+/// Load request state enumeration.
+struct AsyncLoadState
+{
+	/// Load request state enumeration.
+	enum T
+	{
+		Queued,		///< Waiting for a worker.
+		Loading,	///< Being loaded by a worker.
+		Loaded,		///< Loaded, waiting to be published.
+		Failed,		///< Loading failed.
+		Cancelled	///< Dropped before having been published.
+	};
+	LEAN_MAKE_ENUM_STRUCT(AsyncLoadState)
+};
+
+/// Asynchronous load request. Resource caches hand out a placeholder resource right away and derive
+/// from this class to load the actual resource on a worker thread, publishing it when committed.
+class AsyncLoadRequest : public Task, public lean::noncopyable
+{
+	friend class AsyncLoader;
+
+private:
+	AsyncLoader *m_pLoader;
+	AsyncLoadState::T m_state;
+	bool m_bScheduled;
+
+protected:
+	/// Constructor.
+	LEAN_INLINE AsyncLoadRequest()
+		: m_pLoader(nullptr),
+		m_state(AsyncLoadState::Queued),
+		m_bScheduled(false) { }
+
+	/// Loads the requested resource. Called on a worker thread, may throw.
+	virtual void Load() = 0;
+	/// Checks if the requested resource is still referenced by anyone but the cache. Called on the committing thread.
+	virtual bool IsUsed() const = 0;
+	/// Publishes the loaded resource, e.g. by replacing the placeholder. Called on the committing thread.
+	virtual void Publish() = 0;
+	/// Called on the committing thread when loading has failed or the request has been cancelled.
+	virtual void Drop() { }
+
+public:
+	/// Destructor.
+	virtual ~AsyncLoadRequest() throw() { }
+
+	/// Loads the requested resource unless cancelled. Called by the thread pool.
+	BE_CORE_API void Run();
+
+	/// Gets the current state. Only reliable on the committing thread.
+	LEAN_INLINE AsyncLoadState::T GetState() const { return m_state; }
+};
+
+/// Schedules asynchronous load requests on a thread pool & publishes their results when committed.
+class AsyncLoader : public lean::noncopyable
+{
+	friend class AsyncLoadRequest;
+
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructor.
+	BE_CORE_API AsyncLoader(ThreadPool *pPool = nullptr);
+	/// Destructor. Cancels all pending requests & waits for those currently being loaded.
+	BE_CORE_API ~AsyncLoader();
+
+	/// Schedules the given request with the given priority, taking ownership. Loads synchronously if no thread pool set.
+	BE_CORE_API void Load(AsyncLoadRequest *pRequest, TaskPriority::T priority = TaskPriority::Background);
+	/// Publishes all loaded requests & cancels pending requests no longer in use. Call once per frame on
+	/// the thread owning the resource cache. Returns the number of resources published.
+	BE_CORE_API uint4 Commit();
+
+	/// Gets the number of requests not yet published or dropped.
+	BE_CORE_API uint4 GetPendingCount() const;
+
+	/// Sets the thread pool used for loading, nullptr to load synchronously. Applies to requests scheduled from now on.
+	BE_CORE_API void SetThreadPool(ThreadPool *pPool);
+	/// Gets the thread pool used for loading.
+	BE_CORE_API ThreadPool* GetThreadPool() const;
+};
+
+} // namespace
+
+#endif
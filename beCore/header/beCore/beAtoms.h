@@ -0,0 +1,99 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_ATOMS
+#define BE_CORE_ATOMS
+
+#include "beCore.h"
+
+namespace beCore
+{
+
+/// Handle of a globally interned string. Equal strings are always interned into equal atoms, atoms are never released.
+typedef uint4 Atom;
+
+/// Invalid atom.
+const Atom InvalidAtom = static_cast<Atom>(-1);
+
+/// Atom hash offset basis (32-bit FNV-1a).
+const uint4 AtomHashBasis = 2166136261U;
+/// Atom hash prime (32-bit FNV-1a).
+const uint4 AtomHashPrime = 16777619U;
+
+/// Computes the atom hash of the given string.
+LEAN_INLINE uint4 HashAtomString(const utf8_t *str, size_t length)
+{
+	uint4 hash = AtomHashBasis;
+
+	for (size_t i = 0; i < length; ++i)
+		hash = (hash ^ static_cast<unsigned char>(str[i])) * AtomHashPrime;
+
+	return hash;
+}
+
+/// String and its atom hash.
+struct HashedString
+{
+	const utf8_t *String;	///< String, not necessarily null-terminated.
+	size_t Length;			///< Number of characters.
+	uint4 Hash;				///< Atom hash.
+
+	/// Constructor. Hashes the given string.
+	HashedString(const utf8_ntri &str)
+		: String(str.c_str()),
+		Length(str.size()),
+		Hash(HashAtomString(str.c_str(), str.size())) { }
+	/// Constructor.
+	HashedString(const utf8_t *str, size_t length, uint4 hash)
+		: String(str),
+		Length(length),
+		Hash(hash) { }
+};
+
+namespace Impl
+{
+
+/// Hashes the given number of characters, fully unrolled.
+template <size_t Length>
+struct LiteralHash
+{
+	static LEAN_INLINE uint4 Hash(const utf8_t *str, uint4 hash)
+	{
+		return LiteralHash<Length - 1>::Hash( str + 1, (hash ^ static_cast<unsigned char>(*str)) * AtomHashPrime );
+	}
+};
+template <>
+struct LiteralHash<0>
+{
+	static LEAN_INLINE uint4 Hash(const utf8_t*, uint4 hash) { return hash; }
+};
+
+} // namespace
+
+/// Hashes the given string literal. The hash computation is fully unrolled and folded into a constant by the optimizer.
+template <size_t Size>
+LEAN_INLINE HashedString HashLiteral(const utf8_t (&str)[Size])
+{
+	return HashedString( str, Size - 1, Impl::LiteralHash<Size - 1>::Hash(str, AtomHashBasis) );
+}
+
+/// Gets the atom of the given string, interning the string if not interned yet. This function is thread-safe.
+BE_CORE_API Atom InternAtom(const HashedString &str);
+/// Gets the atom of the given string, InvalidAtom if the string has never been interned. This function is thread-safe.
+BE_CORE_API Atom FindAtom(const HashedString &str);
+
+/// Gets the atom of the given string, interning the string if not interned yet. This function is thread-safe.
+LEAN_INLINE Atom InternAtom(const utf8_ntri &str) { return InternAtom( HashedString(str) ); }
+/// Gets the atom of the given string, InvalidAtom if the string has never been interned. This function is thread-safe.
+LEAN_INLINE Atom FindAtom(const utf8_ntri &str) { return FindAtom( HashedString(str) ); }
+
+/// Gets the string of the given atom, empty if invalid. The string remains valid until shut-down. This function is lock-free.
+BE_CORE_API utf8_ntr GetAtomString(Atom atom);
+/// Gets the atom hash of the given atom's string. This function is lock-free.
+BE_CORE_API uint4 GetAtomHash(Atom atom);
+
+} // namespace
+
+#endif
@@ -0,0 +1,111 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_BINARY_DOCUMENT
+#define BE_CORE_BINARY_DOCUMENT
+
+#include "beCore.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/rapidxml/rapidxml.hpp>
+#include <vector>
+
+namespace beCore
+{
+
+/// Binary document header, followed by a sequence of chunks.
+struct BinaryDocumentHeader
+{
+	static const uint4 MagicID = 0x44584542;	///< 'BEXD'
+	static const uint4 CurrentVersion = 2;		///< Current version, 2 adds typed binary property values.
+	static const uint4 MinVersion = 1;			///< Oldest version still supported.
+
+	uint4 Magic;		///< Magic ID.
+	uint4 Version;		///< Format version.
+	uint4 ChunkCount;	///< Number of chunks.
+	uint4 _Pad;
+};
+
+/// Binary document chunk header, followed by the chunk data (padded to 4 bytes).
+struct BinaryDocumentChunk
+{
+	/// Chunk IDs.
+	enum ID
+	{
+		Strings = 0x53525453,	///< 'STRS': String count, string offsets, zero-terminated strings. Exactly one, always first.
+		Section = 0x54434553	///< 'SECT': Section header, nodes in pre-order, attributes.
+	};
+
+	uint4 ID;			///< Chunk ID.
+	uint4 Size;			///< Number of bytes of chunk data, excluding padding.
+};
+
+/// Binary document section header. Each top-level node is stored in a section of depth 0, children of top-level
+/// elements in sections of depth 1 following the section of their parent. Unknown sections may be skipped as a whole.
+struct BinaryDocumentSection
+{
+	uint4 Depth;			///< Depth of the section root node.
+	uint4 NodeCount;		///< Number of nodes.
+	uint4 AttributeCount;	///< Number of attributes.
+	uint4 _Pad;
+};
+
+/// Binary document node.
+struct BinaryDocumentNode
+{
+	/// Invalid string index, empty string.
+	static const uint4 NoString = static_cast<uint4>(-1);
+
+	uint4 Type;				///< Node type (rapidxml::node_type).
+	uint4 Name;				///< String index of the node name.
+	uint4 Value;			///< String index of the node value.
+	uint4 AttributeCount;	///< Number of attributes, consecutive in the section's attribute array.
+	uint4 ChildCount;		///< Number of direct children, following this node in pre-order.
+};
+
+/// Binary document attribute.
+struct BinaryDocumentAttribute
+{
+	uint4 Name;				///< String index of the attribute name.
+	uint4 Value;			///< String index of the attribute value.
+};
+
+/// Memory-mapped binary document. Node names & values point into the mapped file, no strings are copied or parsed.
+class BinaryDocument : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Maps & loads the given binary document file.
+	BE_CORE_API BinaryDocument(const utf8_ntri &file);
+	/// Destructor.
+	BE_CORE_API ~BinaryDocument();
+
+	/// Gets the document. Strings remain valid as long as this binary document exists.
+	BE_CORE_API rapidxml::xml_document<utf8_t>& Document();
+	/// Gets the document. Strings remain valid as long as this binary document exists.
+	BE_CORE_API const rapidxml::xml_document<utf8_t>& Document() const;
+};
+
+/// Checks if the given file is a binary document.
+BE_CORE_API bool IsBinaryDocument(const utf8_ntri &file);
+/// Checks if the given data is a binary document.
+BE_CORE_API bool IsBinaryDocument(const void *data, size_t size);
+
+/// Loads the given binary document data into the given document. Strings point into the given data, which is required
+/// to remain valid as long as the document is in use. Throws on corrupt data.
+BE_CORE_API void LoadBinaryDocument(const void *data, size_t size, rapidxml::xml_document<utf8_t> &document);
+/// Writes the given document into the given buffer in binary form.
+BE_CORE_API void WriteBinaryDocument(const rapidxml::xml_document<utf8_t> &document, std::vector<char> &data);
+/// Saves the given document to the given file in binary form, replacing the file only once complete.
+BE_CORE_API void SaveBinaryDocument(const rapidxml::xml_document<utf8_t> &document, const utf8_ntri &file);
+
+} // namespace
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "beCore.h"
 #include "beShared.h"
+#include "beMany.h"
 #include <lean/tags/noncopyable.h>
 #include <vector>
 #include <lean/pimpl/pimpl_ptr.h>
@@ -17,11 +18,15 @@ namespace beCore
 
 struct ComponentType;
 
-/// Tracks component changes by type.
+/// Tracks component changes by type, optionally by component.
 class ComponentMonitorChannel : public lean::noncopyable_chain<Shared>
 {
+public:
 	struct M;
 
+	/// Range of changed components.
+	typedef Range<const void *const *> Components;
+
 private:
 	typedef std::vector<const ComponentType*> types_t;
 	types_t m_changedTypes;
@@ -37,6 +42,9 @@ public:
 
 	/// Marks components of the given type as changed.
 	BE_CORE_API void AddChanged(const ComponentType *type);
+	/// Marks the given component of the given type as changed, allowing dependents to only process the given component.
+	/// Components are identified by their address as a pointer to the class of the given type, never dereferenced.
+	BE_CORE_API void AddChanged(const ComponentType *type, const void *component);
 	/// Processes the next batch of changes.
 	BE_CORE_API void Process();
 	/// Checks if there are more changes to process.
@@ -45,6 +53,12 @@ public:
 	BE_CORE_API bool HasChanges() const { return !m_processedTypes.empty(); }
 	/// Checks if components of the given type have been changed.
 	BE_CORE_API bool HasChanged(const ComponentType *type) const;
+	/// Checks if all changes to components of the given type have been recorded per component. If false, dependents
+	/// need to check all components of the given type.
+	BE_CORE_API bool AllChangesTracked(const ComponentType *type) const;
+	/// Gets the components of the given type that have been changed, sorted by address. Only complete if
+	/// AllChangesTracked() returns true, valid until the next batch of changes is processed.
+	BE_CORE_API Components GetChanged(const ComponentType *type) const;
 };
 
 /// Tracks component changes by type.
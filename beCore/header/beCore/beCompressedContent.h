@@ -0,0 +1,57 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_COMPRESSED_CONTENT
+#define BE_CORE_COMPRESSED_CONTENT
+
+#include "beCore.h"
+#include "beContent.h"
+#include <lean/smart/com_ptr.h>
+#include <lean/io/raw_file.h>
+
+namespace beCore
+{
+
+// Prototypes
+class ThreadPool;
+
+/// Block-compressed content header, followed by one block size per block & the compressed blocks.
+struct CompressedContentHeader
+{
+	static const uint4 MagicID = 0x5a424542;		///< 'BEBZ'
+	static const uint4 CurrentVersion = 1;			///< Current version.
+	static const uint4 DefaultBlockSize = 1U << 18;	///< Default number of content bytes per block.
+	static const uint4 RawBlockFlag = 1U << 31;		///< Set in block sizes of blocks stored uncompressed.
+
+	uint4 Magic;		///< Magic ID.
+	uint4 Version;		///< Format version.
+	uint4 BlockSize;	///< Number of content bytes per block, except for the last block.
+	uint4 BlockCount;	///< Number of blocks.
+	uint8 Size;			///< Number of content bytes.
+};
+
+/// Checks if the given data is block-compressed content.
+BE_CORE_API bool IsCompressedContent(const void *data, uint8 size);
+
+/// Decompresses the given block-compressed content into one contiguous buffer. Blocks are decompressed in parallel
+/// on the given thread pool, serially if nullptr. Throws on corrupt data.
+BE_CORE_API lean::com_ptr<Content, true> DecompressContent(const void *data, uint8 size, ThreadPool *pPool = nullptr);
+/// Decompresses the given content if block-compressed, returns the given content unchanged otherwise.
+BE_CORE_API lean::com_ptr<Content, true> DecompressContent(Content *pContent, ThreadPool *pPool = nullptr);
+
+/// Writes the given data to the given file as block-compressed content. Blocks are compressed in parallel
+/// on the given thread pool, serially if nullptr.
+BE_CORE_API void WriteCompressedContent(const utf8_ntri &file, const void *data, uint8 size,
+	uint4 blockSize = CompressedContentHeader::DefaultBlockSize, ThreadPool *pPool = nullptr);
+/// Writes the given data to the given file as block-compressed content, starting at the current file position.
+BE_CORE_API void WriteCompressedContent(lean::raw_file &file, const void *data, uint8 size,
+	uint4 blockSize = CompressedContentHeader::DefaultBlockSize, ThreadPool *pPool = nullptr);
+/// Compresses the given source file into the given destination file, which may be the same as the source file.
+BE_CORE_API void CompressContentFile(const utf8_ntri &source, const utf8_ntri &dest,
+	uint4 blockSize = CompressedContentHeader::DefaultBlockSize, ThreadPool *pPool = nullptr);
+
+} // namespace
+
+#endif
@@ -0,0 +1,49 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_COMPRESSED_CONTENT_PROVIDER
+#define BE_CORE_COMPRESSED_CONTENT_PROVIDER
+
+#include "beCore.h"
+#include "beContentProvider.h"
+#include <lean/smart/cloneable_obj.h>
+
+namespace beCore
+{
+
+// Prototypes
+class ThreadPool;
+
+/// Content provider transparently decompressing block-compressed content provided by another content provider.
+class CompressedContentProvider : public ContentProvider
+{
+private:
+	lean::cloneable_obj<ContentProvider> m_provider;
+	ThreadPool *m_pPool;
+
+public:
+	/// Constructor. Blocks are decompressed in parallel on the given thread pool, serially if nullptr.
+	BE_CORE_API CompressedContentProvider(const ContentProvider &provider, ThreadPool *pPool = nullptr);
+
+	/// Gets the content identified by the given path.
+	BE_CORE_API lean::com_ptr<Content, true> GetContent(const utf8_ntri &file);
+	
+	/// Gets a revision number for the content identified by the given path.
+	BE_CORE_API uint8 GetRevision(const utf8_ntri &file) const;
+
+	/// Gets the content provider wrapped.
+	LEAN_INLINE const ContentProvider& GetProvider() const { return *m_provider; }
+	/// Gets the thread pool used for decompression.
+	LEAN_INLINE ThreadPool* GetThreadPool() const { return m_pPool; }
+
+	/// Constructs and returns a clone of this path resolver.
+	BE_CORE_API CompressedContentProvider* clone() const;
+	/// Destroys an include manager.
+	BE_CORE_API void destroy() const;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,35 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_COMPRESSION
+#define BE_CORE_COMPRESSION
+
+#include "beCore.h"
+
+namespace beCore
+{
+
+/// Gets the maximum number of bytes the given number of bytes may take up when compressed.
+LEAN_INLINE size_t GetMaxCompressedSize(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+/// Gets the maximum number of bytes the given number of compressed bytes may expand to. Each LZ length continuation
+/// byte adds at most 255 bytes of output, bounding the ratio of any valid compressed data.
+LEAN_INLINE uint8 GetMaxDecompressedSize(uint8 compressedSize)
+{
+	return compressedSize * 255;
+}
+
+/// Compresses the given data using a fast LZ codec (LZ4 block format), returns the compressed size. The destination
+/// buffer needs to hold at least GetMaxCompressedSize(srcSize) bytes.
+BE_CORE_API size_t CompressLZ(const void *src, size_t srcSize, void *dest, size_t destCapacity);
+/// Decompresses the given LZ-compressed data into the given buffer of exactly the original size. Throws on corrupt data.
+BE_CORE_API void DecompressLZ(const void *src, size_t srcSize, void *dest, size_t destSize);
+
+} // namespace
+
+#endif
@@ -0,0 +1,43 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_CONTENT_HASH
+#define BE_CORE_CONTENT_HASH
+
+#include "beCore.h"
+
+namespace beCore
+{
+
+/// Computes fast non-cryptographic 64-bit hashes of content (xxHash64) incrementally.
+class ContentHasher
+{
+private:
+	uint8 m_seed;
+	uint8 m_acc[4];
+	unsigned char m_buffer[32];
+	uint4 m_bufferSize;
+	uint8 m_totalSize;
+
+public:
+	/// Constructor.
+	BE_CORE_API explicit ContentHasher(uint8 seed = 0);
+
+	/// Restarts hashing.
+	BE_CORE_API void Reset(uint8 seed = 0);
+	/// Appends the given data.
+	BE_CORE_API void Update(const void *data, size_t size);
+	/// Gets the hash of all data appended so far.
+	BE_CORE_API uint8 Finish() const;
+};
+
+/// Computes a fast non-cryptographic 64-bit hash of the given data.
+BE_CORE_API uint8 HashContent(const void *data, size_t size, uint8 seed = 0);
+/// Computes a fast non-cryptographic 64-bit hash of the given file's contents. Throws on failure.
+BE_CORE_API uint8 HashFileContent(const utf8_ntri &file, uint8 seed = 0);
+
+} // namespace
+
+#endif
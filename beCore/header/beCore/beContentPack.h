@@ -0,0 +1,133 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_CONTENT_PACK
+#define BE_CORE_CONTENT_PACK
+
+#include "beCore.h"
+#include "beShared.h"
+#include "beContent.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/smart/com_ptr.h>
+#include <lean/smart/resource_ptr.h>
+
+namespace beCore
+{
+
+/// Content pack archive header.
+struct ContentPackHeader
+{
+	static const uint4 MagicID = 0x4b504542;	///< 'BEPK'
+	static const uint4 CurrentVersion = 1;		///< Current version.
+
+	uint4 Magic;			///< Magic ID.
+	uint4 Version;			///< Format version.
+	uint4 EntryCount;		///< Number of directory entries.
+	uint4 Alignment;		///< Alignment of entry data.
+	uint8 DirectoryOffset;	///< Offset of the directory, an array of entries sorted by path hash.
+	uint8 PathOffset;		///< Offset of the path string block.
+	uint8 PathSize;			///< Size of the path string block, paths are zero-terminated.
+};
+
+/// Content pack entry flags.
+struct ContentPackEntryFlags
+{
+	/// Enumeration.
+	enum T
+	{
+		Compressed = 1 << 0		///< Data is LZ-compressed.
+	};
+	LEAN_MAKE_ENUM_STRUCT(ContentPackEntryFlags)
+};
+
+/// Content pack directory entry.
+struct ContentPackEntry
+{
+	uint8 PathHash;		///< Content hash of the normalized path (lower case, forward slashes).
+	uint8 Offset;		///< Offset of the (aligned) entry data.
+	uint8 StoredSize;	///< Number of bytes stored.
+	uint8 Size;			///< Number of bytes of content.
+	uint4 PathOffset;	///< Offset of the normalized path in the path string block.
+	uint4 PathLength;	///< Length of the normalized path.
+	uint4 Flags;		///< Entry flags (ContentPackEntryFlags).
+	uint4 _Pad;
+};
+
+/// Memory-mapped content pack archive. Packed files appear in the mount directory once mounted.
+class ContentPack : public lean::noncopyable, public Resource
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Maps the given archive, placing the files it contains in the given mount directory.
+	BE_CORE_API ContentPack(const utf8_ntri &archive, const utf8_ntri &mountDirectory);
+	/// Destructor.
+	BE_CORE_API ~ContentPack();
+
+	/// Finds the entry of the given absolute path, nullptr if not contained.
+	BE_CORE_API const ContentPackEntry* Find(const utf8_ntri &file) const;
+	/// Gets the content of the given entry. Uncompressed content is served from the archive mapping without copying.
+	BE_CORE_API lean::com_ptr<Content, true> GetContent(const ContentPackEntry &entry) const;
+
+	/// Gets the number of entries.
+	BE_CORE_API uint4 GetEntryCount() const;
+	/// Gets the given entry.
+	BE_CORE_API const ContentPackEntry& GetEntry(uint4 idx) const;
+	/// Gets the normalized path of the given entry.
+	BE_CORE_API utf8_ntr GetPath(const ContentPackEntry &entry) const;
+
+	/// Gets the archive path.
+	BE_CORE_API utf8_ntr GetArchive() const;
+	/// Gets the mount directory.
+	BE_CORE_API utf8_ntr GetMountDirectory() const;
+	/// Gets the revision of the archive at the time it was mapped.
+	BE_CORE_API uint8 GetRevision() const;
+};
+
+/// Mounts the given content pack. Packs mounted later take precedence over packs mounted earlier.
+BE_CORE_API void MountContentPack(ContentPack *pPack);
+/// Unmounts the given content pack.
+BE_CORE_API void UnmountContentPack(ContentPack *pPack);
+/// Unmounts all content packs.
+BE_CORE_API void UnmountContentPacks();
+
+/// Gets the mounted content pack containing the given absolute path, nullptr if none.
+BE_CORE_API lean::resource_ptr<ContentPack> FindContentPack(const utf8_ntri &file);
+/// Checks if any mounted content pack contains the given absolute path.
+BE_CORE_API bool IsPackedFile(const utf8_ntri &file);
+
+/// Builds content pack archives.
+class ContentPackWriter : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructor. Entry data is aligned to the given number of bytes.
+	BE_CORE_API ContentPackWriter(uint4 alignment = 16);
+	/// Destructor.
+	BE_CORE_API ~ContentPackWriter();
+
+	/// Adds the given file under the given path relative to the pack root. Compressed entries are
+	/// stored uncompressed if compression does not pay off. Throws if the path has been added before.
+	BE_CORE_API void Add(const utf8_ntri &file, const utf8_ntri &path, bool bCompress = false);
+	/// Writes all files added so far to the given archive.
+	BE_CORE_API void Write(const utf8_ntri &archive) const;
+
+	/// Gets the number of files added.
+	BE_CORE_API uint4 GetFileCount() const;
+};
+
+} // namespace
+
+#endif
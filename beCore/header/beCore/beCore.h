@@ -15,6 +15,9 @@
 	/// Define this when not compiling this library into a DLL.
 	#define BE_CORE_NO_EXPORT
 	#undef BE_CORE_NO_EXPORT
+	/// Define this to compile scheduler instrumentation into the thread pool & job system.
+	#define BE_CORE_SCHEDULER_TRACING
+	#undef BE_CORE_SCHEDULER_TRACING
 #endif
 
 /// @}
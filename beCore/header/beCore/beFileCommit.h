@@ -0,0 +1,29 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_FILE_COMMIT
+#define BE_CORE_FILE_COMMIT
+
+#include "beCore.h"
+#include "beExchangeContainers.h"
+
+namespace beCore
+{
+
+/// Gets a temporary file name next to the given file, unique per process & thread. Files are written to a temporary
+/// file first & committed once complete, readers never see partially written files.
+BE_CORE_API Exchange::utf8_string GetTempFile(const utf8_ntri &file);
+/// Replaces the given file by the given complete temporary file, optionally not returning before the file has been
+/// written to disk. Deletes the temporary file & throws on failure.
+BE_CORE_API void CommitFile(const utf8_ntri &tempFile, const utf8_ntri &file, bool bWriteThrough = true);
+/// Deletes the given temporary file, ignoring errors.
+BE_CORE_API void DiscardFile(const utf8_ntri &tempFile);
+
+/// Writes the given data to a temporary file & commits it to the given file once complete. Throws on failure.
+BE_CORE_API void CommitFile(const utf8_ntri &file, const void *data, uint8 size, bool bWriteThrough = true);
+
+} // namespace
+
+#endif
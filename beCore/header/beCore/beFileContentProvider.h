@@ -8,6 +8,7 @@
 
 #include "beCore.h"
 #include "beContentProvider.h"
+#include "beFileRevision.h"
 
 namespace beCore
 {
@@ -20,13 +21,22 @@ class DefaultContentProvider;
 template <>
 class DefaultContentProvider<FileContent> : public ContentProvider
 {
+private:
+	FileRevisionMode::T m_revisionMode;
+
 public:
+	/// Constructor. In content hash mode, revisions only change when the contents of a file change.
+	BE_CORE_API DefaultContentProvider(FileRevisionMode::T revisionMode = FileRevisionMode::Timestamp);
+
 	/// Gets the content identified by the given path.
 	BE_CORE_API lean::com_ptr<Content, true> GetContent(const utf8_ntri &file);
 	
 	/// Gets a revision number for the content identified by the given path.
 	BE_CORE_API uint8 GetRevision(const utf8_ntri &file) const;
 
+	/// Gets the revision mode.
+	LEAN_INLINE FileRevisionMode::T GetRevisionMode() const { return m_revisionMode; }
+
 	/// Constructs and returns a clone of this path resolver.
 	BE_CORE_API DefaultContentProvider* clone() const;
 	/// Destroys an include manager.
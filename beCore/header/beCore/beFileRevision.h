@@ -0,0 +1,33 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_FILE_REVISION
+#define BE_CORE_FILE_REVISION
+
+#include "beCore.h"
+
+namespace beCore
+{
+
+/// File revision mode enumeration.
+struct FileRevisionMode
+{
+	/// File revision mode enumeration.
+	enum T
+	{
+		Timestamp,		///< Revision changes whenever the file is written.
+		ContentHash		///< Revision changes only when the contents of the file change.
+	};
+	LEAN_MAKE_ENUM_STRUCT(FileRevisionMode)
+};
+
+/// Gets a revision number for the given file, 0 if the file does not exist. In content hash mode, the revision is the
+/// modification time of the last write that actually changed the file's contents. Hashes are cached per file, files
+/// are only re-hashed when their modification time changes. This function is thread-safe.
+BE_CORE_API uint8 GetFileRevision(const utf8_ntri &file, FileRevisionMode::T mode);
+
+} // namespace
+
+#endif
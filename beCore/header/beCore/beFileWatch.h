@@ -7,6 +7,7 @@
 #define BE_CORE_FILEWATCH
 
 #include "beCore.h"
+#include "beFileRevision.h"
 #include <lean/tags/noncopyable.h>
 #include <lean/pimpl/pimpl_ptr.h>
 #include <lean/strings/types.h>
@@ -34,7 +35,9 @@ public:
 	virtual void DirectoryChanged(const lean::utf8_ntri &directory) = 0;
 };
 
-/// File watch class that allows for the observation of file changes.
+/// File watch class that allows for the observation of file changes. All directories are watched by one thread.
+/// Windows-only: directories are watched via overlapped ReadDirectoryChangesW requests completing into one
+/// I/O completion port, there is no backend for other platforms (e.g. inotify) yet.
 class FileWatch : public lean::noncopyable
 {
 public:
@@ -44,8 +47,8 @@ private:
 	lean::pimpl_ptr<M> m;
 
 public:
-	/// Constructor.
-	BE_CORE_API FileWatch();
+	/// Constructor. In content hash mode, observers are only notified when the contents of observed files change.
+	BE_CORE_API FileWatch(FileRevisionMode::T revisionMode = FileRevisionMode::Timestamp);
 	/// Destructor.
 	BE_CORE_API ~FileWatch();
 
@@ -58,6 +61,18 @@ public:
 	BE_CORE_API bool AddObserver(const lean::utf8_ntri &directory, DirectoryObserver *pObserver);
 	/// Removes the given observer, no longer to be called when the given directory is modified.
 	BE_CORE_API void RemoveObserver(const lean::utf8_ntri &directory, DirectoryObserver *pObserver);
+
+	/// Sets the time in ms to wait for further changes before notifying observers. Bursts of changes within this
+	/// window result in one notification per file. Notifications are delayed by no more than a few windows.
+	BE_CORE_API void SetCoalescingWindow(uint4 milliseconds);
+	/// Gets the time in ms to wait for further changes before notifying observers.
+	BE_CORE_API uint4 GetCoalescingWindow() const;
+
+	/// Sets whether observers are notified whenever files are written (timestamp mode) or only when their contents
+	/// change (content hash mode). Applies to revisions compared from now on.
+	BE_CORE_API void SetRevisionMode(FileRevisionMode::T mode);
+	/// Gets whether observers are notified whenever files are written or only when their contents change.
+	BE_CORE_API FileRevisionMode::T GetRevisionMode() const;
 };
 
 /// Gets the file watch.
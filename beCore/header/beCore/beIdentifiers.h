@@ -7,8 +7,10 @@
 #define BE_CORE_IDENTIFIERS
 
 #include "beCore.h"
+#include "beAtoms.h"
 #include <lean/tags/noncopyable.h>
 #include <vector>
+#include <unordered_map>
 
 namespace beCore
 {
@@ -17,9 +19,12 @@ namespace beCore
 class Identifiers : public lean::noncopyable
 {
 private:
-	typedef std::vector<utf8_string> identifier_vector;
+	typedef std::vector<Atom> identifier_vector;
 	identifier_vector m_identifiers;
 
+	typedef std::unordered_map<Atom, uint4> id_map;
+	id_map m_ids;
+
 public:
 	/// Invalid ID.
 	static const uint4 InvalidID = static_cast<uint4>(-1);
@@ -35,9 +40,15 @@ public:
 	BE_CORE_API uint4 GetID(const utf8_ntri &name);
 	/// Adds the given identifier to this identifier manager.
 	BE_CORE_API uint4 GetID(const utf8_ntri &name) const;
+	/// Adds the given identifier to this identifier manager.
+	BE_CORE_API uint4 GetID(Atom name);
+	/// Gets the ID of the given identifier, InvalidID if unknown.
+	BE_CORE_API uint4 GetID(Atom name) const;
 
 	/// Adds the given identifier to this identifier manager.
-	LEAN_INLINE utf8_string GetName(uint4 id) const { return (id < m_identifiers.size()) ? m_identifiers[id] : ""; }
+	LEAN_INLINE utf8_string GetName(uint4 id) const { return (id < m_identifiers.size()) ? GetAtomString(m_identifiers[id]).to<utf8_string>() : ""; }
+	/// Gets the atom of the given identifier.
+	LEAN_INLINE Atom GetAtom(uint4 id) const { return (id < m_identifiers.size()) ? m_identifiers[id] : InvalidAtom; }
 };
 
 }
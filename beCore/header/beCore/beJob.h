@@ -7,16 +7,13 @@
 #define BE_CORE_JOB
 
 #include "beCore.h"
+#include "beThreadPool.h"
 #include <lean/tags/noncopyable.h>
 #include <lean/pimpl/pimpl_ptr.h>
 
 namespace beCore
 {
 
-// Prototypes
-class Task;
-class ThreadPool;
-
 /// Job type enumeration.
 struct JobType
 {
@@ -41,8 +38,8 @@ protected:
 	virtual void Run() { }
 
 public:
-	/// Constructs an empty job.
-	BE_CORE_API Job(JobType::T type);
+	/// Constructs an empty job. The given name is used for scheduler tracing & needs to outlive any traces (e.g. a string literal).
+	BE_CORE_API Job(JobType::T type, const char *name = nullptr);
 	/// Destructor.
 	BE_CORE_API ~Job();
 	
@@ -52,8 +49,17 @@ public:
 	/// Adds a child job. This method is thread-safe.
 	BE_CORE_API bool AddJob(Job *pJob);
 
+	/// Sets the priority of this job's tasks. Jobs inherit their parent's priority unless assigned a priority of their own,
+	/// top-level jobs default to normal priority. Threads waiting for the job only help out with tasks of the job's
+	/// priority or higher. Do not change while running.
+	BE_CORE_API void SetPriority(TaskPriority::T priority);
+	/// Gets the priority of this job's tasks.
+	BE_CORE_API TaskPriority::T GetPriority() const;
+
 	/// Gets the job type.
 	BE_CORE_API JobType::T GetType() const;
+	/// Gets the job name, nullptr if unnamed.
+	BE_CORE_API const char* GetName() const;
 };
 
 } // namespace
@@ -0,0 +1,218 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_NUMERIC_TEXT
+#define BE_CORE_NUMERIC_TEXT
+
+#include "beCore.h"
+#include <limits>
+#include <iosfwd>
+#include <typeinfo>
+
+namespace beCore
+{
+
+/// Maximum number of characters written by WriteFloat().
+const size_t MaxFloatTextLength = 16;
+/// Maximum number of characters written by WriteDouble().
+const size_t MaxDoubleTextLength = 24;
+
+/// Writes a short decimal representation of the given value that reads back to the exact same value. Shortest
+/// in all but rare cases (Grisu2), locale-independent, returns the first character not written to.
+BE_CORE_API utf8_t* WriteFloat(utf8_t *begin, float value);
+/// Writes a short decimal representation of the given value that reads back to the exact same value. Shortest
+/// in all but rare cases (Grisu2), locale-independent, returns the first character not written to.
+BE_CORE_API utf8_t* WriteDouble(utf8_t *begin, double value);
+/// Writes the given value in decimal form, returning the first character not written to.
+BE_CORE_API utf8_t* WriteInteger(utf8_t *begin, long long value);
+/// Writes the given value in decimal form, returning the first character not written to.
+BE_CORE_API utf8_t* WriteUnsigned(utf8_t *begin, unsigned long long value);
+
+/// Reads a value from the given range of characters, returning the first character not read, nullptr on failure.
+/// Locale-independent, correctly rounded. Values beyond the range of float fail (nullptr) instead of reading as
+/// +-inf, unlike strtod(); only "inf" & "infinity" read as infinite values.
+BE_CORE_API const utf8_t* ReadFloat(const utf8_t *begin, const utf8_t *end, float &value);
+/// Reads a value from the given range of characters, returning the first character not read, nullptr on failure.
+/// Locale-independent, correctly rounded. Values beyond the range of double fail (nullptr) instead of reading as
+/// +-inf, unlike strtod(); only "inf" & "infinity" read as infinite values.
+BE_CORE_API const utf8_t* ReadDouble(const utf8_t *begin, const utf8_t *end, double &value);
+/// Reads a value from the given range of characters, returning the first character not read, nullptr on failure.
+BE_CORE_API const utf8_t* ReadInteger(const utf8_t *begin, const utf8_t *end, long long &value);
+/// Reads a value from the given range of characters, returning the first character not read, nullptr on failure.
+BE_CORE_API const utf8_t* ReadUnsigned(const utf8_t *begin, const utf8_t *end, unsigned long long &value);
+
+namespace Impl
+{
+
+/// Numeric text codec.
+template <class Value, bool Integer = std::numeric_limits<Value>::is_integer, bool Signed = std::numeric_limits<Value>::is_signed>
+struct NumericTextCodec;
+
+template <class Value>
+struct NumericTextCodec<Value, true, true>
+{
+	static const size_t MaxLength = std::numeric_limits<Value>::digits10 + 2;
+
+	static LEAN_INLINE utf8_t* Write(utf8_t *begin, Value value) { return WriteInteger(begin, value); }
+	static LEAN_INLINE const utf8_t* Read(const utf8_t *begin, const utf8_t *end, Value &value)
+	{
+		long long wide;
+		begin = ReadInteger(begin, end, wide);
+
+		if (!begin || wide < (std::numeric_limits<Value>::min)() || wide > (std::numeric_limits<Value>::max)())
+			return nullptr;
+
+		value = static_cast<Value>(wide);
+		return begin;
+	}
+};
+
+template <class Value>
+struct NumericTextCodec<Value, true, false>
+{
+	static const size_t MaxLength = std::numeric_limits<Value>::digits10 + 1;
+
+	static LEAN_INLINE utf8_t* Write(utf8_t *begin, Value value) { return WriteUnsigned(begin, value); }
+	static LEAN_INLINE const utf8_t* Read(const utf8_t *begin, const utf8_t *end, Value &value)
+	{
+		unsigned long long wide;
+		begin = ReadUnsigned(begin, end, wide);
+
+		if (!begin || wide > (std::numeric_limits<Value>::max)())
+			return nullptr;
+
+		value = static_cast<Value>(wide);
+		return begin;
+	}
+};
+
+template <>
+struct NumericTextCodec<float, false, true>
+{
+	static const size_t MaxLength = MaxFloatTextLength;
+
+	static LEAN_INLINE utf8_t* Write(utf8_t *begin, float value) { return WriteFloat(begin, value); }
+	static LEAN_INLINE const utf8_t* Read(const utf8_t *begin, const utf8_t *end, float &value) { return ReadFloat(begin, end, value); }
+};
+
+template <>
+struct NumericTextCodec<double, false, true>
+{
+	static const size_t MaxLength = MaxDoubleTextLength;
+
+	static LEAN_INLINE utf8_t* Write(utf8_t *begin, double value) { return WriteDouble(begin, value); }
+	static LEAN_INLINE const utf8_t* Read(const utf8_t *begin, const utf8_t *end, double &value) { return ReadDouble(begin, end, value); }
+};
+
+/// Skips whitespace.
+LEAN_INLINE const utf8_t* SkipNumericSpace(const utf8_t *begin, const utf8_t *end)
+{
+	while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r'))
+		++begin;
+	return begin;
+}
+
+/// Writes the given range of characters to the given stream.
+BE_CORE_API bool WriteNumericText(std::basic_ostream<utf8_t> &stream, const utf8_t *begin, const utf8_t *end);
+/// Extracts the next whitespace-separated token from the given stream, fails if it does not fit into the given buffer.
+BE_CORE_API bool ReadNumericToken(std::basic_istream<utf8_t> &stream, utf8_t *buffer, size_t bufferSize, const utf8_t *&tokenEnd);
+
+} // namespace
+
+/// Locale-independent numeric text serialization, compatible with GenericTextSerializer. Values are separated by spaces.
+template <class Value>
+struct NumericTextSerialization
+{
+	/// Value type.
+	typedef Value value_type;
+	/// Codec.
+	typedef Impl::NumericTextCodec<Value> codec_type;
+
+	/// Gets the maximum length of the given number of values when serialized, including one separator per value.
+	static size_t max_length(size_t count) { return count * (codec_type::MaxLength + 1); }
+
+	/// Writes the given number of values to the given character buffer, returning the first character not written to.
+	static utf8_t* write(utf8_t *begin, const std::type_info &type, const void *values, size_t count)
+	{
+		if (type != typeid(value_type))
+			return begin;
+
+		const value_type *typedValues = static_cast<const value_type*>(values);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (i != 0)
+				*begin++ = ' ';
+
+			begin = codec_type::Write(begin, typedValues[i]);
+		}
+
+		return begin;
+	}
+
+	/// Writes the given number of values to the given stream.
+	static bool write(std::basic_ostream<utf8_t> &stream, const std::type_info &type, const void *values, size_t count)
+	{
+		if (type != typeid(value_type))
+			return false;
+
+		const value_type *typedValues = static_cast<const value_type*>(values);
+		utf8_t buffer[codec_type::MaxLength + 1];
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			utf8_t *begin = buffer;
+
+			if (i != 0)
+				*begin++ = ' ';
+
+			if (!Impl::WriteNumericText(stream, buffer, codec_type::Write(begin, typedValues[i])))
+				return false;
+		}
+
+		return true;
+	}
+
+	/// Reads the given number of values from the given range of characters, returning the first character not read.
+	static const utf8_t* read(const utf8_t *begin, const utf8_t *end, const std::type_info &type, void *values, size_t count)
+	{
+		if (type != typeid(value_type))
+			return nullptr;
+
+		value_type *typedValues = static_cast<value_type*>(values);
+
+		for (size_t i = 0; i < count && begin; ++i)
+			begin = codec_type::Read(Impl::SkipNumericSpace(begin, end), end, typedValues[i]);
+
+		return begin;
+	}
+
+	/// Reads the given number of values from the given stream.
+	static bool read(std::basic_istream<utf8_t> &stream, const std::type_info &type, void *values, size_t count)
+	{
+		if (type != typeid(value_type))
+			return false;
+
+		value_type *typedValues = static_cast<value_type*>(values);
+		// NOTE: Leave room for overlong tokens of leading zeroes & digits beyond precision
+		static const size_t TokenBufferSize = 256;
+		utf8_t buffer[TokenBufferSize];
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const utf8_t *tokenEnd;
+
+			if (!Impl::ReadNumericToken(stream, buffer, TokenBufferSize, tokenEnd)
+				|| codec_type::Read(buffer, tokenEnd, typedValues[i]) != tokenEnd)
+				return false;
+		}
+
+		return true;
+	}
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,48 @@
+/******************************************************/
+/* breeze Engine Core Module     (c) Tobias Zirr 2011 */
+/******************************************************/
+
+#pragma once
+#ifndef BE_CORE_PACK_CONTENT_PROVIDER
+#define BE_CORE_PACK_CONTENT_PROVIDER
+
+#include "beCore.h"
+#include "beContentProvider.h"
+#include "beFileRevision.h"
+
+namespace beCore
+{
+
+/// Content provider serving files from mounted content packs & loose files.
+class PackContentProvider : public ContentProvider
+{
+private:
+	bool m_bLooseOverrides;
+	FileRevisionMode::T m_revisionMode;
+
+public:
+	/// Constructor. If loose files override packed files, requests for packed files check for a loose file first,
+	/// which allows for packed content to be edited during development. Loose overrides are only available
+	/// in builds defining BE_CORE_LOOSE_CONTENT_OVERRIDES, otherwise the flag is ignored.
+	BE_CORE_API PackContentProvider(bool bLooseOverrides = false, FileRevisionMode::T revisionMode = FileRevisionMode::Timestamp);
+
+	/// Gets the content identified by the given path.
+	BE_CORE_API lean::com_ptr<Content, true> GetContent(const utf8_ntri &file);
+	
+	/// Gets a revision number for the content identified by the given path.
+	BE_CORE_API uint8 GetRevision(const utf8_ntri &file) const;
+
+	/// Checks if loose files override packed files.
+	LEAN_INLINE bool LooseOverrides() const { return m_bLooseOverrides; }
+	/// Gets the revision mode for loose files.
+	LEAN_INLINE FileRevisionMode::T GetRevisionMode() const { return m_revisionMode; }
+
+	/// Constructs and returns a clone of this path resolver.
+	BE_CORE_API PackContentProvider* clone() const;
+	/// Destroys an include manager.
+	BE_CORE_API void destroy() const;
+};
+
+} // namespace
+
+#endif
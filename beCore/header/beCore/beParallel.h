@@ -0,0 +1,220 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_PARALLEL
+#define BE_CORE_PARALLEL
+
+#include "beCore.h"
+#include "beMany.h"
+#include "beThreadPool.h"
+#include <vector>
+
+namespace beCore
+{
+
+/// Chunked parallel loop body interface.
+class LEAN_INTERFACE ParallelBody
+{
+	LEAN_INTERFACE_BEHAVIOR(ParallelBody)
+
+public:
+	/// Processes the given chunk of the loop range.
+	virtual void Run(uint4 chunkIdx, Range<uint4> chunk) = 0;
+};
+
+/// Gets the number of chunks the given range will be split into for the given thread pool.
+BE_CORE_API uint4 GetParallelChunkCount(const ThreadPool *pPool, Range<uint4> range, uint4 grainSize);
+/// Gets the given chunk of the given range split into the given number of chunks.
+LEAN_INLINE Range<uint4> GetParallelChunk(Range<uint4> range, uint4 chunkCount, uint4 chunkIdx)
+{
+	const uint8 count = range.End - range.Begin;
+	return Range<uint4>(
+			range.Begin + static_cast<uint4>(count * chunkIdx / chunkCount),
+			range.Begin + static_cast<uint4>(count * (chunkIdx + 1) / chunkCount)
+		);
+}
+
+/// Runs the given body on all chunks of the given range, in parallel on the given thread pool. Splits the range
+/// adaptively, runs the body inline if the range does not exceed the given grain size or no pool is given.
+/// The calling thread helps out until all chunks have been processed. Chunk indices are stable for any given
+/// pool & range, allowing for per-chunk result buffers (see GetParallelChunkCount()). If the body throws, chunks
+/// not yet started are skipped & the first exception is rethrown by the calling thread once all chunks have finished.
+/// Chunks are scheduled at the given priority, the calling thread only helps out with tasks of this priority or higher
+/// & blocks once none are left.
+BE_CORE_API void ParallelForChunks(ThreadPool *pPool, Range<uint4> range, uint4 grainSize, ParallelBody &body,
+	TaskPriority::T priority = TaskPriority::Normal);
+
+namespace Impl
+{
+
+/// Wraps a loop functor taking index ranges.
+template <class Body>
+class ParallelForBody : public ParallelBody
+{
+private:
+	const Body &m_body;
+
+public:
+	ParallelForBody(const Body &body)
+		: m_body(body) { }
+
+	void Run(uint4 chunkIdx, Range<uint4> chunk)
+	{
+		m_body(chunk);
+	}
+};
+
+/// Wraps a reduction functor taking index ranges & partial results.
+template <class Value, class Body>
+class ParallelReduceBody : public ParallelBody
+{
+private:
+	const Body &m_body;
+	Value *m_partials;
+
+public:
+	ParallelReduceBody(const Body &body, Value *partials)
+		: m_body(body),
+		m_partials(partials) { }
+
+	void Run(uint4 chunkIdx, Range<uint4> chunk)
+	{
+		m_body(chunk, m_partials[chunkIdx]);
+	}
+};
+
+/// Scans chunks of an array, optionally offset by the sums of all preceding chunks.
+template <class Value, class Combine>
+class ParallelScanBody : public ParallelBody
+{
+private:
+	const Value *m_in;
+	Value *m_out;
+	Value *m_partials;
+	const Value &m_identity;
+	const Combine &m_combine;
+	bool m_bWrite;
+
+public:
+	ParallelScanBody(const Value *in, Value *out, Value *partials, const Value &identity, const Combine &combine)
+		: m_in(in),
+		m_out(out),
+		m_partials(partials),
+		m_identity(identity),
+		m_combine(combine),
+		m_bWrite(false) { }
+
+	void Run(uint4 chunkIdx, Range<uint4> chunk)
+	{
+		Value running = (m_bWrite) ? m_partials[chunkIdx] : m_identity;
+
+		if (m_bWrite)
+			for (uint4 i = chunk.Begin; i < chunk.End; ++i)
+			{
+				// NOTE: In & out may alias
+				Value next = m_combine(running, m_in[i]);
+				m_out[i] = running;
+				running = next;
+			}
+		else
+		{
+			for (uint4 i = chunk.Begin; i < chunk.End; ++i)
+				running = m_combine(running, m_in[i]);
+
+			m_partials[chunkIdx] = running;
+		}
+	}
+
+	/// Switches from summation to output.
+	void BeginWrite() { m_bWrite = true; }
+};
+
+} // namespace
+
+/// Calls body(Range<uint4>) for disjoint sub-ranges covering the given range, in parallel on the given thread pool.
+/// Runs the body inline if the range does not exceed the given grain size or no pool is given.
+template <class Body>
+LEAN_INLINE void ParallelFor(ThreadPool *pPool, Range<uint4> range, uint4 grainSize, const Body &body,
+	TaskPriority::T priority = TaskPriority::Normal)
+{
+	Impl::ParallelForBody<Body> forBody(body);
+	ParallelForChunks(pPool, range, grainSize, forBody, priority);
+}
+
+/// Calls body(Range<uint4>, Value&) for disjoint sub-ranges covering the given range, in parallel on the given thread
+/// pool, accumulating into per-chunk partial results initialized to the given identity value. Returns the partial
+/// results combined in range order via combine(const Value&, const Value&), i.e. results are deterministic.
+template <class Value, class Body, class Combine>
+Value ParallelReduce(ThreadPool *pPool, Range<uint4> range, uint4 grainSize,
+	const Value &identity, const Body &body, const Combine &combine, TaskPriority::T priority = TaskPriority::Normal)
+{
+	const uint4 chunkCount = GetParallelChunkCount(pPool, range, grainSize);
+
+	if (chunkCount <= 1)
+	{
+		Value result(identity);
+		body(range, result);
+		return result;
+	}
+
+	std::vector<Value> partials(chunkCount, identity);
+	Impl::ParallelReduceBody<Value, Body> reduceBody(body, &partials[0]);
+	ParallelForChunks(pPool, range, grainSize, reduceBody, priority);
+
+	Value result(partials[0]);
+
+	for (uint4 i = 1; i < chunkCount; ++i)
+		result = combine(result, partials[i]);
+
+	return result;
+}
+
+/// Computes the exclusive prefix scan of the given values via combine(const Value&, const Value&), in parallel on
+/// the given thread pool. Input & output may alias. Returns the combination of all values.
+template <class Value, class Combine>
+Value ParallelScan(ThreadPool *pPool, const Value *in, Value *out, uint4 count, uint4 grainSize,
+	const Value &identity, const Combine &combine, TaskPriority::T priority = TaskPriority::Normal)
+{
+	const Range<uint4> range(0, count);
+	const uint4 chunkCount = GetParallelChunkCount(pPool, range, grainSize);
+
+	if (chunkCount <= 1)
+	{
+		Value running(identity);
+
+		for (uint4 i = 0; i < count; ++i)
+		{
+			// NOTE: In & out may alias
+			Value next = combine(running, in[i]);
+			out[i] = running;
+			running = next;
+		}
+
+		return running;
+	}
+
+	// Sum chunks, scan chunk sums, offset & scan chunks
+	std::vector<Value> partials(chunkCount, identity);
+	Impl::ParallelScanBody<Value, Combine> scanBody(in, out, &partials[0], identity, combine);
+	ParallelForChunks(pPool, range, grainSize, scanBody, priority);
+
+	Value total(identity);
+
+	for (uint4 i = 0; i < chunkCount; ++i)
+	{
+		Value next = combine(total, partials[i]);
+		partials[i] = total;
+		total = next;
+	}
+
+	scanBody.BeginWrite();
+	ParallelForChunks(pPool, range, grainSize, scanBody, priority);
+
+	return total;
+}
+
+} // namespace
+
+#endif
\ No newline at end of file
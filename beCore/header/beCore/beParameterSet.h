@@ -7,10 +7,14 @@
 #define BE_CORE_PARAMETER_SET
 
 #include "beCore.h"
+#include "beAtoms.h"
 #include <lean/containers/any.h>
 #include <lean/smart/cloneable_obj.h>
 #include <lean/meta/strip.h>
 #include <vector>
+#include <typeinfo>
+#include <type_traits>
+#include <cstring>
 #include <lean/tags/noncopyable.h>
 
 namespace beCore
@@ -20,9 +24,23 @@ namespace beCore
 class ParameterLayout : public lean::nonassignable
 {
 private:
-	typedef std::vector<utf8_string> parameter_vector;
+	typedef std::vector<Atom> parameter_vector;
 	parameter_vector m_parameters;
 
+	/// Hash table slot, empty if parameter ID invalid.
+	struct Slot
+	{
+		uint4 hash;
+		uint4 parameterID;
+	};
+	typedef std::vector<Slot> slot_vector;
+	slot_vector m_slots;
+
+	/// Gets the slot of the given name, first empty slot in its probe sequence if not found.
+	uint4 Probe(const HashedString &name) const;
+	/// Gets the slot of the given atom, first empty slot in its probe sequence if not found.
+	uint4 Probe(Atom name, uint4 hash) const;
+
 public:
 	/// Invalid parameter ID.
 	static const uint4 InvalidID = static_cast<uint4>(-1);
@@ -36,24 +54,66 @@ public:
 
 	/// Adds a parameter of the given name, returning its parameter ID.
 	BE_CORE_API uint4 Add(const utf8_ntri &name);
+	/// Adds a parameter of the given name, returning its parameter ID.
+	BE_CORE_API uint4 Add(Atom name);
 	/// Gets the name of the parameter identified by the given ID.
 	BE_CORE_API utf8_ntr GetName(uint4 parameterID) const;
+	/// Gets the name of the parameter identified by the given ID.
+	LEAN_INLINE Atom GetAtom(uint4 parameterID) const { return (parameterID < m_parameters.size()) ? m_parameters[parameterID] : InvalidAtom; }
 	/// Gets the current number of parameters.
 	BE_CORE_API uint4 GetCount() const;
 	/// Gets the parameter identified by the given name.
 	BE_CORE_API uint4 GetID(const utf8_ntri &name) const;
+	/// Gets the parameter identified by the given name.
+	BE_CORE_API uint4 GetID(const HashedString &name) const;
+	/// Gets the parameter identified by the given name.
+	BE_CORE_API uint4 GetID(Atom name) const;
 };
 
-/// Parameter set.
+/// Checks if parameter values of the given type are stored in place.
+template <class Value>
+struct IsInlineParameter
+{
+	/// Maximum size of values stored in place.
+	static const size_t MaxSize = 16;
+	/// True, if values of the given type are stored in place.
+	static const bool value = sizeof(Value) <= MaxSize && __alignof(Value) <= sizeof(uint8)
+		&& std::has_trivial_copy<Value>::value && std::has_trivial_destructor<Value>::value;
+};
+
+/// Parameter set. Trivially copyable values are stored in place, in an inline arena sized from the parameter layout.
+/// Other values are cloned into individually allocated any objects.
 class ParameterSet : public lean::nonassignable
 {
+public:
+	/// Value stored in place.
+	struct InlineValue
+	{
+		const std::type_info *type;		///< Type of the value, nullptr if none stored in place.
+		union
+		{
+			uint8 alignment;
+			char bytes[IsInlineParameter<char>::MaxSize];
+		} data;							///< Value bytes.
+	};
+
+	/// Number of values stored in place without allocating.
+	static const uint4 InlineArenaSize = 16;
+
 private:
 	const ParameterLayout *m_pLayout;
 
+	uint4 m_inlineCapacity;
+	InlineValue *m_inlineValues;
+	InlineValue m_inlineArena[InlineArenaSize];
+
 	typedef lean::cloneable_obj<lean::any, true> parameter_value;
 	typedef std::vector<parameter_value> parameter_vector;
 	parameter_vector m_parameters;
 
+	/// Makes room for the given number of values stored in place.
+	void ReserveInline(uint4 count);
+
 public:
 	/// Constructor.
 	BE_CORE_API ParameterSet(const ParameterLayout *pLayout);
@@ -64,26 +124,58 @@ public:
 	
 	/// Assigns the given value to the parameter identified by the given ID.
 	BE_CORE_API void SetAnyValue(uint4 parameterID, const lean::any *pValue);
-	/// Gets the value of the parameter identified by the given ID.
+	/// Gets the value of the parameter identified by the given ID. Values stored in place are not visible to this method.
 	BE_CORE_API const lean::any* GetAnyValue(uint4 parameterID) const;
 
+	/// Prepares storing a value of the given type in place, returning a pointer to its storage or nullptr if ID invalid.
+	BE_CORE_API void* SetInlineValue(uint4 parameterID, const std::type_info &type);
+	/// Gets the value of the parameter identified by the given ID, nullptr if no value of the given type stored in place.
+	LEAN_INLINE const void* GetInlineValue(uint4 parameterID, const std::type_info &type) const
+	{
+		if (parameterID < m_inlineCapacity)
+		{
+			const InlineValue &inlineValue = m_inlineValues[parameterID];
+
+			if (inlineValue.type && (inlineValue.type == &type || *inlineValue.type == type))
+				return inlineValue.data.bytes;
+		}
+
+		return nullptr;
+	}
+
 	/// Assigns the given value to the parameter identified by the given ID.
 	template <class Value>
 	LEAN_INLINE void SetValue(uint4 parameterID, const Value &value)
 	{
-		lean::any_value<Value> anyValue(value);
-		SetAnyValue(parameterID, &anyValue);
+		if (IsInlineParameter<Value>::value)
+		{
+			if (void *pStorage = SetInlineValue(parameterID, typeid(Value)))
+				memcpy(pStorage, &value, sizeof(Value));
+		}
+		else
+		{
+			lean::any_value<Value> anyValue(value);
+			SetAnyValue(parameterID, &anyValue);
+		}
 	}
 	/// Gets the value of the parameter identified by the given ID.
 	template <class Value>
 	LEAN_INLINE const Value* GetValue(uint4 parameterID) const
 	{
+		if (IsInlineParameter<Value>::value)
+			if (const void *pValue = GetInlineValue(parameterID, typeid(Value)))
+				return static_cast<const Value*>(pValue);
+
 		return lean::any_cast<Value>( GetAnyValue(parameterID) );
 	}
 	/// Gets the value of the parameter identified by the given ID.
 	template <class Value>
 	LEAN_INLINE const Value& GetValueChecked(uint4 parameterID) const
 	{
+		if (IsInlineParameter<Value>::value)
+			if (const void *pValue = GetInlineValue(parameterID, typeid(Value)))
+				return *static_cast<const Value*>(pValue);
+
 		return lean::any_cast_checked<const Value&>( GetAnyValue(parameterID) );
 	}
 	/// Gets the value of the parameter identified by the given ID.
@@ -8,33 +8,22 @@
 
 #include "beCore.h"
 #include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
 #include <typeinfo>
 #include <vector>
 
 namespace beCore
 {
 
-/// Persistent ID manager.
+/// Persistent ID manager. References are stored in pages that are directly indexed by ID, IDs beyond the
+/// directly indexed range (e.g. sparse imported IDs) are kept in a hash index.
 class PersistentIDs : public lean::noncopyable
 {
 public:
-	/// Reference.
-	struct Reference
-	{
-		uint8 id;
-		void *pointer;
-		const std::type_info *type;
-
-		/// Constructor.
-		Reference(uint8 id, void *pointer, const std::type_info &type)
-			: id(id),
-			pointer(pointer),
-			type(&type) { }
-	};
+	struct M;
 
 private:
-	typedef std::vector<Reference> ref_vector;
-	ref_vector m_references;
+	lean::pimpl_ptr<M> m;
 
 	uint8 m_nextID;
 
@@ -54,12 +43,24 @@ public:
 	/// Skips all IDs up to the given the next ID.
 	BE_CORE_API void SkipIDs(uint8 nextID);
 
+	/// Reserves the given number of consecutive IDs, returning the first one. Storage for the new IDs is allocated at once.
+	/// Count must not be 0.
+	BE_CORE_API uint8 ReserveIDs(uint8 count);
+	/// Allocates storage for references to all IDs in the given range up front, e.g. before loading many references.
+	/// Never pass ranges read from untrusted input unchecked, storage is allocated for every ID in the range.
+	BE_CORE_API void ReserveStorage(uint8 beginID, uint8 endID);
+	/// Unsets all references in the given range & returns the IDs for re-use by ReserveID() & ReserveIDs().
+	/// Only ever release IDs that have never been saved, e.g. the unused remainder of a bulk reservation.
+	BE_CORE_API void ReleaseIDs(uint8 beginID, uint8 endID);
+
 	/// Adds a new reference.
 	BE_CORE_API uint8 AddReference(void *ptr, const std::type_info &type);
 	/// Updates a reference.
 	BE_CORE_API bool SetReference(uint8 id, void *ptr, const std::type_info &type, bool bNoOverwrite = false);
 	/// Gets a reference.
 	BE_CORE_API void* GetReference(uint8 id, const std::type_info &type) const;
+	/// Checks if the given ID is referenced, regardless of type.
+	BE_CORE_API bool IsReferenced(uint8 id) const;
 	/// Unsets a reference.
 	BE_CORE_API void UnsetReference(uint8 id, const void *compare = nullptr, bool bErase = true);
 
@@ -53,6 +53,20 @@ struct PropertyDeserializer : public PropertyVisitor
 	BE_CORE_API bool Visit(const PropertyProvider &provider, uint4 propertyID, const PropertyDesc &desc, void *values) LEAN_OVERRIDE;
 };
 
+/// Stores property values appended to the given document as typed binary values instead of text from now on, where possible.
+/// Such documents can only be saved in binary form (see beBinaryDocument.h), convert to text using ConvertPropertyValuesToText().
+BE_CORE_API void SetBinaryPropertyValues(rapidxml::xml_document<lean::utf8_t> &document);
+/// Checks if property values appended to the given document are stored as typed binary values.
+BE_CORE_API bool HasBinaryPropertyValues(const rapidxml::xml_document<lean::utf8_t> &document);
+/// Converts all typed binary property values stored in the given XML node & its children to text.
+BE_CORE_API void ConvertPropertyValuesToText(rapidxml::xml_node<lean::utf8_t> &node);
+
+/// Reads the given number of values of the given type from the given property node, stored either as text or as typed binary values.
+BE_CORE_API bool ReadPropertyValues(const rapidxml::xml_node<lean::utf8_t> &node, const ValueTypeDesc &typeDesc, void *values, uint4 count);
+
+/// Appends a property node of the given name & values to the given XML node.
+BE_CORE_API void AppendProperty(rapidxml::xml_node<lean::utf8_t> &parent, const utf8_ntri &name, const PropertyDesc &desc, const void *values, bool bWithType = false);
+
 /// Saves the given property provider to the given XML node.
 BE_CORE_API void SaveProperties(const PropertyProvider &properties, rapidxml::xml_node<lean::utf8_t> &node, bool bPersistentOnly = true, bool bWithType = false);
 /// Saves the given property provider to the given XML node.
@@ -0,0 +1,51 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_PROPERTY_SNAPSHOT
+#define BE_CORE_PROPERTY_SNAPSHOT
+
+#include "beCore.h"
+#include "bePropertyProvider.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/rapidxml/rapidxml.hpp>
+
+namespace beCore
+{
+
+/// Captures persistent property values to be written to XML later, e.g. on a different thread. Capturing only
+/// copies raw values, no XML nodes are created & text formatting is deferred until WriteProperties() is called.
+class PropertySnapshot : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructor.
+	BE_CORE_API PropertySnapshot();
+	/// Destructor.
+	BE_CORE_API ~PropertySnapshot();
+
+	/// Captures all persistent properties of the given provider. WriteProperties() later inserts a properties node into
+	/// the given XML node where SaveProperties() would have appended it, nodes may only be appended in the meantime.
+	BE_CORE_API void CaptureProperties(const PropertyProvider &properties, rapidxml::xml_node<utf8_t> &node);
+	/// Writes all values captured since the last call to the XML nodes they were captured for. Only touches the documents
+	/// of the nodes passed to CaptureProperties(), may be called on any thread once capturing is done.
+	BE_CORE_API void WriteProperties();
+	/// Releases all captured values.
+	BE_CORE_API void Clear();
+
+	/// Gets the number of values captured.
+	BE_CORE_API uint4 GetValueCount() const;
+	/// Gets the number of bytes of value data captured.
+	BE_CORE_API size_t GetDataSize() const;
+};
+
+} // namespace
+
+#endif
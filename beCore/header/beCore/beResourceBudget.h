@@ -0,0 +1,78 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_RESOURCE_BUDGET
+#define BE_CORE_RESOURCE_BUDGET
+
+#include "beCore.h"
+#include "beResourceManager.h"
+
+namespace beCore
+{
+
+/// Keeps track of the memory held by the resources of a resource cache & of cache usage.
+class ResourceBudget
+{
+private:
+	ResourceCacheStats m_stats;
+	uint8 m_clock;
+
+public:
+	/// Constructor. Unlimited budget.
+	LEAN_INLINE ResourceBudget()
+		: m_clock(0) { }
+
+	/// Records a request served from the cache. Returns a new use time stamp.
+	LEAN_INLINE uint8 Hit() { ++m_stats.Hits; return ++m_clock; }
+	/// Records a request that required loading. Returns a new use time stamp.
+	LEAN_INLINE uint8 Miss() { ++m_stats.Misses; return ++m_clock; }
+	/// Returns a new use time stamp.
+	LEAN_INLINE uint8 Tick() { return ++m_clock; }
+
+	/// Accounts for the given resource having been added.
+	LEAN_INLINE void Add(const ResourceMemory &memory)
+	{
+		m_stats.Resident += memory;
+		++m_stats.ResidentCount;
+	}
+	/// Accounts for a resource having been replaced.
+	LEAN_INLINE void Replace(const ResourceMemory &oldMemory, const ResourceMemory &newMemory)
+	{
+		m_stats.Resident -= oldMemory;
+		m_stats.Resident += newMemory;
+	}
+	/// Accounts for the given resource having been evicted.
+	LEAN_INLINE void Evict(const ResourceMemory &memory)
+	{
+		m_stats.Resident -= memory;
+		--m_stats.ResidentCount;
+		++m_stats.Evictions;
+	}
+
+	/// Checks if a budget has been set.
+	LEAN_INLINE bool IsLimited() const
+	{
+		return m_stats.Budget.GPUBytes != ResourceMemory::Unlimited
+			|| m_stats.Budget.CPUBytes != ResourceMemory::Unlimited;
+	}
+	/// Checks if the resident memory exceeds the budget.
+	LEAN_INLINE bool IsExceeded() const
+	{
+		return m_stats.Resident.GPUBytes > m_stats.Budget.GPUBytes
+			|| m_stats.Resident.CPUBytes > m_stats.Budget.CPUBytes;
+	}
+
+	/// Sets the budget.
+	LEAN_INLINE void SetBudget(const ResourceMemory &budget) { m_stats.Budget = budget; }
+	/// Gets the budget.
+	LEAN_INLINE const ResourceMemory& GetBudget() const { return m_stats.Budget; }
+
+	/// Gets the statistics.
+	LEAN_INLINE const ResourceCacheStats& GetStats() const { return m_stats; }
+};
+
+} // namespace
+
+#endif
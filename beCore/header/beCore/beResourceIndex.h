@@ -7,9 +7,9 @@
 #define BE_CORE_RESOURCE_INDEX
 
 #include "beCore.h"
-#include <map>
-#include <list>
-#include <lean/tags/transitive_ptr.h>
+#include "beResourceIndexTables.h"
+#include <deque>
+#include <vector>
 #include <lean/logging/errors.h>
 
 #include <lean/io/numeric.h>
@@ -28,178 +28,248 @@ public:
 	typedef Info Info;
 
 private:
+	/// Invalid entry or string record.
+	static const uint4 InvalidIndex = ResourceStringTable::InvalidIndex;
+
 	/// Resource entry.
 	struct Entry
 	{
-		const utf8_string *name;
-		const utf8_string *file;
+		uint4 name;
+		uint4 file;
+		uint4 aliases;	///< First additional name record, linked via m_nextAlias.
 
 		Info info;
 
 		/// Constructor.
 		template <class InfoFW>
-		Entry(const utf8_string *name, const utf8_string *file, InfoFW LEAN_FW_REF info)
+		Entry(uint4 name, uint4 file, InfoFW LEAN_FW_REF info)
 			: name( name ),
 			file( file ),
+			aliases( InvalidIndex ),
 			info( LEAN_FORWARD(InfoFW, info) ) { }
 #ifdef LEAN0X_NEED_EXPLICIT_MOVE
 		/// Constructor.
 		Entry(Entry &&right)
 			: name( right.name ),
 			file( right.file ),
+			aliases( right.aliases ),
 			info( std::move(right.info) ) { }
 #endif
 	};
 
-	typedef std::list<Entry> info_t;
-	info_t m_info;
+	// NOTE: Entries are never erased, indices serve as stable handles. Removed entries lose their name.
+	// Deque keeps entries in contiguous blocks without relocating them on insertion.
+	typedef std::deque<Entry> entries_t;
+	entries_t m_entries;
+	uint4 m_removedCount;
+
+	ResourcePointerTable m_byResource;
+	ResourceStringTable m_byName;
+	ResourceStringTable m_byFile;
 
-	typedef std::map<Resource*, typename info_t::iterator> resource_map;
-	resource_map m_byResource;
+	// Additional names of each entry, singly linked by name record
+	typedef std::vector<uint4> alias_links_t;
+	alias_links_t m_nextAlias;
 
-	typedef std::map<utf8_string, typename info_t::iterator> string_map;
-	string_map m_byName;
-	string_map m_byFile;
+	enum iterator_tag { name_tag, file_tag };
 
-	template <class Iterator, class Derived>
-	class basic_iterator
+	/// Gets the next entry not removed, InvalidIndex if none.
+	template <class Entries>
+	static uint4 NextEntry(const Entries &entries, uint4 idx)
 	{
-		friend class ResourceIndex;
+		const uint4 count = static_cast<uint4>(entries.size());
+		
+		// NOTE: InvalidIndex + 1 wraps to the first entry
+		do { ++idx; } while (idx < count && entries[idx].name == InvalidIndex);
+		
+		return (idx < count) ? idx : InvalidIndex;
+	}
+	/// Adds the given name record to the additional names of the given entry.
+	void LinkAlias(Entry &entry, uint4 nameRecord)
+	{
+		if (nameRecord >= m_nextAlias.size())
+			m_nextAlias.resize(nameRecord + 1, InvalidIndex);
 
-	protected:
-		Iterator it;
+		m_nextAlias[nameRecord] = entry.aliases;
+		entry.aliases = nameRecord;
+	}
+	/// Removes the given name record from the additional names of the given entry, if linked.
+	void UnlinkAlias(Entry &entry, uint4 nameRecord)
+	{
+		// NOTE: Resources rarely have more than a few names
+		for (uint4 *pLink = &entry.aliases; *pLink != InvalidIndex; pLink = &m_nextAlias[*pLink])
+			if (*pLink == nameRecord)
+			{
+				*pLink = m_nextAlias[nameRecord];
+				break;
+			}
+	}
 
-		LEAN_INLINE basic_iterator() { }
-		LEAN_INLINE basic_iterator(Iterator it)
-			: it(it) { }
+	/// Gets the previous entry not removed, last entry if InvalidIndex, InvalidIndex if none.
+	template <class Entries>
+	static uint4 PrevEntry(const Entries &entries, uint4 idx)
+	{
+		if (idx == InvalidIndex)
+			idx = static_cast<uint4>(entries.size());
 
-	public:
-		LEAN_INLINE Derived& operator ++() { ++it; return static_cast<Derived&>(*this); }
-		LEAN_INLINE Derived& operator --() { --it; return static_cast<Derived&>(*this); }
-		LEAN_INLINE Derived operator ++(int) { Derived prev(it); ++(*this); return prev; }
-		LEAN_INLINE Derived operator --(int) { Derived prev(it); --(*this); return prev; }
+		while (idx-- > 0)
+			if (entries[idx].name != InvalidIndex)
+				return idx;
 
-		template <class It>
-		LEAN_INLINE bool operator ==(const It &right) const { return (it == right.it); }
-		template <class It>
-		LEAN_INLINE bool operator !=(const It &right) const { return (it != right.it); }
-	};
+		return InvalidIndex;
+	}
 
-	enum iterator_tag { name_tag, file_tag };
+	template <class Entries, class Value>
+	class resource_iterator;
+	template <class Entries, class Value, iterator_tag Tag>
+	class string_iterator;
 
-	template <class Iterator, class Info>
-	class resource_iterator : public basic_iterator< Iterator, resource_iterator<Iterator, Info> >
+	template <class Entries, class Value>
+	class resource_iterator
 	{
 		friend class ResourceIndex;
+		template <class OtherEntries, class OtherValue>
+		friend class resource_iterator;
+		template <class OtherEntries, class OtherValue, iterator_tag Tag>
+		friend class string_iterator;
 
 	private:
-		typedef typename resource_iterator::basic_iterator base_type;
-		
-		LEAN_INLINE resource_iterator(Iterator it)
-			: base_type(it) { }
+		Entries *entries;
+		uint4 idx;
+
+		LEAN_INLINE resource_iterator(Entries *entries, uint4 idx)
+			: entries(entries),
+			idx(idx) { }
 
 	public:
-		LEAN_INLINE resource_iterator() { }
-		template <class OtherIterator, class OtherInfo>
-		LEAN_INLINE resource_iterator(const resource_iterator<OtherIterator, OtherInfo> &right)
-			: base_type(right.it) { }
+		LEAN_INLINE resource_iterator()
+			: entries(),
+			idx(InvalidIndex) { }
+		template <class OtherEntries, class OtherValue>
+		LEAN_INLINE resource_iterator(const resource_iterator<OtherEntries, OtherValue> &right)
+			: entries(right.entries),
+			idx(right.idx) { }
+
+		LEAN_INLINE resource_iterator& operator ++() { idx = NextEntry(*entries, idx); return *this; }
+		LEAN_INLINE resource_iterator& operator --() { idx = PrevEntry(*entries, idx); return *this; }
+		LEAN_INLINE resource_iterator operator ++(int) { resource_iterator prev(*this); ++(*this); return prev; }
+		LEAN_INLINE resource_iterator operator --(int) { resource_iterator prev(*this); --(*this); return prev; }
+
+		template <class It>
+		LEAN_INLINE bool operator ==(const It &right) const { return (idx == right.idx); }
+		template <class It>
+		LEAN_INLINE bool operator !=(const It &right) const { return (idx != right.idx); }
 
-		LEAN_INLINE Info& operator *() const { return this->it->info; }
-		LEAN_INLINE Info* operator ->() const { return &this->it->info; }
+		LEAN_INLINE Value& operator *() const { return (*entries)[idx].info; }
+		LEAN_INLINE Value* operator ->() const { return &(*entries)[idx].info; }
 
-//		LEAN_INLINE Resource* resource() const { return *this->it->resource; }
-//		LEAN_INLINE Resource* key() const { return *this->it->resource; }
-		LEAN_INLINE Info& value() const { return this->it->info; }
+		LEAN_INLINE Value& value() const { return (*entries)[idx].info; }
 	};
 
-	template <class Iterator, class Info, iterator_tag Tag>
-	class string_iterator : public basic_iterator< Iterator, string_iterator<Iterator, Info, Tag> >
+	template <class Entries, class Value, iterator_tag Tag>
+	class string_iterator
 	{
 		friend class ResourceIndex;
+		template <class OtherEntries, class OtherValue, iterator_tag OtherTag>
+		friend class string_iterator;
 
 	private:
-		typedef typename string_iterator::basic_iterator  base_type;
-		
-		LEAN_INLINE string_iterator(Iterator it)
-			: base_type(it) { }
+		Entries *entries;
+		const ResourceStringTable *table;
+		uint4 record;
+
+		LEAN_INLINE string_iterator(Entries *entries, const ResourceStringTable *table, uint4 record)
+			: entries(entries),
+			table(table),
+			record(record) { }
 
 	public:
-		LEAN_INLINE string_iterator() { }
-		template <class OtherIterator, class OtherInfo>
-		LEAN_INLINE string_iterator(const string_iterator<OtherIterator, OtherInfo, Tag> &right)
-			: base_type(right.it) { }
+		LEAN_INLINE string_iterator()
+			: entries(),
+			table(),
+			record(InvalidIndex) { }
+		template <class OtherEntries, class OtherValue>
+		LEAN_INLINE string_iterator(const string_iterator<OtherEntries, OtherValue, Tag> &right)
+			: entries(right.entries),
+			table(right.table),
+			record(right.record) { }
+
+		// NOTE: Ordered traversal builds the sorted view on demand
+		LEAN_INLINE string_iterator& operator ++() { record = table->Next(record); return *this; }
+		LEAN_INLINE string_iterator& operator --() { record = table->Prev(record); return *this; }
+		LEAN_INLINE string_iterator operator ++(int) { string_iterator prev(*this); ++(*this); return prev; }
+		LEAN_INLINE string_iterator operator --(int) { string_iterator prev(*this); --(*this); return prev; }
+
+		template <class It>
+		LEAN_INLINE bool operator ==(const It &right) const { return (record == right.record); }
+		template <class It>
+		LEAN_INLINE bool operator !=(const It &right) const { return (record != right.record); }
 
-		LEAN_INLINE Info& operator *() const { return this->it->second->info; }
-		LEAN_INLINE Info* operator ->() const { return &this->it->second->info; }
+		LEAN_INLINE Value& operator *() const { return (*entries)[table->GetValue(record)].info; }
+		LEAN_INLINE Value* operator ->() const { return &(*entries)[table->GetValue(record)].info; }
 		
-		template <class OtherIterator>
-		LEAN_INLINE operator resource_iterator<OtherIterator, Info>() const { return this->it->second; } 
+		template <class OtherEntries>
+		LEAN_INLINE operator resource_iterator<OtherEntries, Value>() const
+		{
+			return resource_iterator<OtherEntries, Value>( entries, (record != InvalidIndex) ? table->GetValue(record) : InvalidIndex );
+		}
 
-//		LEAN_INLINE Resource* resource() const { return *this->it->second->resource; }
-		LEAN_INLINE utf8_ntr key() const { return utf8_ntr(this->it->first); }
-		LEAN_INLINE Info& value() const { return this->it->second->info; }
+		LEAN_INLINE utf8_ntr key() const { return utf8_ntr(table->GetString(record)); }
+		LEAN_INLINE Value& value() const { return (*entries)[table->GetValue(record)].info; }
 	};
 
 public:
 	/// Unordered resource iterator type.
-	typedef resource_iterator<typename info_t::iterator, Info> iterator;
+	typedef resource_iterator<entries_t, Info> iterator;
 	/// Unordered constant resource iterator type.
-	typedef resource_iterator<typename info_t::const_iterator, const Info> const_iterator;
+	typedef resource_iterator<const entries_t, const Info> const_iterator;
 	/// Ordered resource iterator type.
-	typedef string_iterator<typename string_map::iterator, Info, name_tag> name_iterator;
+	typedef string_iterator<entries_t, Info, name_tag> name_iterator;
 	/// Ordered resource iterator type.
-	typedef string_iterator<typename string_map::const_iterator, const Info, name_tag> const_name_iterator;
+	typedef string_iterator<const entries_t, const Info, name_tag> const_name_iterator;
 	/// Ordered resource iterator type.
-	typedef string_iterator<typename string_map::iterator, Info, file_tag> file_iterator;
+	typedef string_iterator<entries_t, Info, file_tag> file_iterator;
 	/// Ordered resource iterator type.
-	typedef string_iterator<typename string_map::const_iterator, const Info, file_tag> const_file_iterator;
+	typedef string_iterator<const entries_t, const Info, file_tag> const_file_iterator;
+
+	/// Constructor.
+	ResourceIndex()
+		: m_removedCount(0) { }
 
 	/// Adds the given resource.
 	template <class InfoFW>
 	iterator Insert(Resource *resource, const utf8_ntri &name, InfoFW LEAN_FW_REF info)
 	{
-		typename info_t::iterator it;
+		const uint4 entryIdx = static_cast<uint4>(m_entries.size());
 
 		// Name must be valid
 		if (name.empty())
 			LEAN_THROW_ERROR_MSG("Empty string is not a valid resource name");
 
 		// Try to insert NEW name link
-		typename string_map::iterator itByName = m_byName.insert(
-				typename string_map::value_type(name.to<utf8_string>(), m_info.end())
-			).first;
+		uint4 nameRecord = m_byName.Insert(name, entryIdx);
 
 		// Names must be unique
-		if (itByName->second != m_info.end())
+		if (m_byName.GetValue(nameRecord) != entryIdx)
 			LEAN_THROW_ERROR_CTX("Resource name already taken by another resource", name.c_str());
 
 		try
 		{
-			/// Try to insert NEW resource link
-			typename resource_map::iterator itByResource = m_byResource.insert(
-					typename resource_map::value_type(resource, m_info.end())
-				).first;
-
-			// Do not re-insert resources
-			if (itByResource->second != m_info.end())
+			// Try to insert NEW resource link, do not re-insert resources
+			if (m_byResource.Insert(resource, entryIdx) != entryIdx)
 				// TODO: Actually a programming error? Assert instead of throwing?
 				LEAN_THROW_ERROR_CTX("Resource has been inserted before", name.c_str());
 
 			try
 			{
 				// Try to insert NEW resource info block
-				// ORDER: Map insertions revertible more easily?
-				it = m_info.insert( m_info.end(), Entry(&itByName->first, nullptr, LEAN_FORWARD(InfoFW, info)) );
-
-				// ORDER: Establish mapping after successful insertion
-				itByName->second = it;
-				itByResource->second = it;
+				// ORDER: Table insertions revertible more easily
+				m_entries.push_back( Entry(nameRecord, InvalidIndex, LEAN_FORWARD(InfoFW, info)) );
 			}
 			catch (...)
 			{
 				// NOTE: Never forget to release resource on failure
-				if (itByResource->second != m_info.end())
-					m_byResource.erase(itByResource);
+				m_byResource.Erase(resource);
 
 				throw;
 			}
@@ -207,106 +277,125 @@ public:
 		catch (...)
 		{
 			// NOTE: Never forget to release name on failure
-			if (itByName->second != m_info.end())
-				m_byName.erase(itByName);
+			m_byName.Erase(nameRecord);
 
 			throw;
 		}
 
-		return it;
+		return iterator(&m_entries, entryIdx);
 	}
 
 	/// Adds the given name to the given resource.
 	name_iterator AddName(iterator where, const utf8_ntri &name)
 	{
+		const uint4 prevNameCount = m_byName.Count();
+
 		// Establish one-way mapping
-		typename string_map::iterator itByName = m_byName.insert(
-				typename string_map::value_type(name.to<utf8_string>(), where.it)
-			).first;
+		uint4 nameRecord = m_byName.Insert(name, where.idx);
 
 		// Names must be unique
-		if (itByName->second != where.it)
+		if (m_byName.GetValue(nameRecord) != where.idx)
 			LEAN_THROW_ERROR_CTX("Resource name already taken by another resource", name.c_str());
 
-		return itByName;
+		// Keep track of new names, released on removal
+		if (m_byName.Count() != prevNameCount)
+		{
+			try
+			{
+				LinkAlias(m_entries[where.idx], nameRecord);
+			}
+			catch (...)
+			{
+				m_byName.Erase(nameRecord);
+				throw;
+			}
+		}
+
+		return name_iterator(&m_entries, &m_byName, nameRecord);
 	}
 	
 	/// Changes the name of the given resource.
 	name_iterator SetName(iterator where, const utf8_ntri &name, bool bKeepOldName = false, bool *pNameChanged = nullptr)
 	{
-		const utf8_string *oldName = where.it->name;
-		typename string_map::iterator itByNewName = AddName(where, name).it;
+		Entry &entry = m_entries[where.idx];
+		const uint4 oldName = entry.name;
+		const uint4 newName = AddName(where, name).record;
 
-		bool bNameChange = (&itByNewName->first != oldName);
+		bool bNameChange = (newName != oldName);
 
 		// Ignore redundant calls
 		if (bNameChange)
 		{
 			// Establish two-way mapping
-			where.it->name = &itByNewName->first;
+			UnlinkAlias(entry, newName);
+			entry.name = newName;
 
 			// Release old name
 			if (!bKeepOldName)
-				m_byName.erase(*oldName);
+				m_byName.Erase(oldName);
+			else
+				LinkAlias(entry, oldName);
 		}
 
 		if (pNameChanged)
 			*pNameChanged = bNameChange;
 
-		return itByNewName;
+		return name_iterator(&m_entries, &m_byName, newName);
 	}
 
 	/// Changes the file of the given resource.
 	file_iterator SetFile(iterator where, const utf8_ntri &file, bool *pFileChanged = nullptr, iterator *pUnfiled = nullptr)
 	{
-		const utf8_string *pOldFile = where.it->file;
+		Entry &entry = m_entries[where.idx];
+		const uint4 oldFile = entry.file;
 
 		// Try to insert NEW file link
-		typename string_map::iterator itByFile = m_byFile.insert(
-				typename string_map::value_type(file.to<utf8_string>(), m_info.end())
-			).first;
+		const uint4 fileRecord = m_byFile.Insert(file, InvalidIndex);
 
-		bool bFileChange = (&itByFile->first != pOldFile);
+		bool bFileChange = (fileRecord != oldFile);
 
 		if (pUnfiled)
-			*pUnfiled = m_info.end();
+			*pUnfiled = End();
 
 		// Ignore redundant calls
 		if (bFileChange)
 		{
+			const uint4 prevEntryIdx = m_byFile.GetValue(fileRecord);
+
 			// Unlink previous resource, if necessary
-			if (itByFile->second != m_info.end())
+			if (prevEntryIdx != InvalidIndex)
 			{
-				itByFile->second->file = nullptr;
+				m_entries[prevEntryIdx].file = InvalidIndex;
 
 				if (pUnfiled)
-					*pUnfiled = itByFile->second;
+					*pUnfiled = iterator(&m_entries, prevEntryIdx);
 			}
 
 			// Establish two-way mapping
-			itByFile->second = where.it;
-			where.it->file = &itByFile->first;
+			m_byFile.SetValue(fileRecord, where.idx);
+			entry.file = fileRecord;
 
 			// Release old file
-			if (pOldFile)
-				m_byFile.erase(*pOldFile);
+			if (oldFile != InvalidIndex)
+				m_byFile.Erase(oldFile);
 		}
 
 		if (pFileChanged)
 			*pFileChanged = bFileChange;
 
-		return itByFile;
+		return file_iterator(&m_entries, &m_byFile, fileRecord);
 	}
 
 	/// Unsets the file of the given resource.
 	bool Unfile(iterator where)
 	{
-		const utf8_string *pOldFile = where.it->file;
+		Entry &entry = m_entries[where.idx];
+		const uint4 oldFile = entry.file;
 
-		if (pOldFile)
+		if (oldFile != InvalidIndex)
 		{
-			where.it->file = nullptr;
-			m_byFile.erase(*pOldFile);
+			entry.file = InvalidIndex;
+			m_byFile.Erase(oldFile);
 			return true;
 		}
 		else
@@ -316,13 +405,8 @@ public:
 	/// Links the given new resource to the given iterator.
 	iterator Link(iterator where, Resource *resource)
 	{
-		// Establish one-way mapping
-		typename resource_map::iterator itByResource = m_byResource.insert(
-				typename resource_map::value_type(resource, where.it)
-			).first;
-
-		// Do not re-insert resources
-		if (itByResource->second != where.it)
+		// Establish one-way mapping, do not re-insert resources
+		if (m_byResource.Insert(resource, where.idx) != where.idx)
 			// TODO: Actually a programming error? Assert instead of throwing?
 			LEAN_THROW_ERROR_MSG("Resource has been inserted before");
 
@@ -332,23 +416,41 @@ public:
 	iterator Unlink(iterator where, Resource *resource)
 	{
 		// Remove one-way mapping
-		typename resource_map::iterator itByResource = m_byResource.find(resource);
-
-		if (itByResource != m_byResource.end() && itByResource->second == where.it)
-			m_byResource.erase(itByResource);
+		if (m_byResource.Find(resource) == where.idx)
+			m_byResource.Erase(resource);
 
 		return where;
 	}
 
+	/// Removes the given resource, releasing its name(s) and file. Iterators skip removed resources,
+	/// the index of a removed resource is never reused. Release any resources held by its info block separately.
+	void Remove(iterator where, Resource *resource)
+	{
+		Entry &entry = m_entries[where.idx];
+
+		Unlink(where, resource);
+		Unfile(where);
+
+		m_byName.Erase(entry.name);
+		entry.name = InvalidIndex;
+		++m_removedCount;
+
+		// Release names added or kept on renaming, if any
+		for (uint4 nameRecord = entry.aliases; nameRecord != InvalidIndex; nameRecord = m_nextAlias[nameRecord])
+			m_byName.Erase(nameRecord);
+		entry.aliases = InvalidIndex;
+	}
+
 	/// Gets the name of the resource pointed to by the given iterator.
 	utf8_ntr GetName(const_iterator where) const
 	{
-		return utf8_ntr(*where.it->name);
+		return utf8_ntr( m_byName.GetString(m_entries[where.idx].name) );
 	}
 	/// Gets the file of the resource pointed to by the given iterator.
 	utf8_ntr GetFile(const_iterator where) const
 	{
-		return (where.it->file) ? utf8_ntr(*where.it->file) : utf8_ntr("");
+		const uint4 fileRecord = m_entries[where.idx].file;
+		return (fileRecord != InvalidIndex) ? utf8_ntr(m_byFile.GetString(fileRecord)) : utf8_ntr("");
 	}
 
 	/// Gets a unique name.
@@ -365,7 +467,7 @@ public:
 		uint4 uniqueIdx = 1;
 
 		// Increment index unto name unique
-		while (m_byName.find(unique) != m_byName.end())
+		while (m_byName.Find(unique) != InvalidIndex)
 		{
 			unique.resize(maxLength);
 			
@@ -383,65 +485,65 @@ public:
 	}
 
 	/// Gets an iterator to the given resource, if existent.
-	iterator Find(const Resource *resource) { typename resource_map::iterator it = m_byResource.find(const_cast<Resource*>(resource)); return (it != m_byResource.end()) ? it->second : m_info.end(); }
+	iterator Find(const Resource *resource) { return iterator(&m_entries, m_byResource.Find(resource)); }
 	/// Gets an iterator to the given resource, if existent.
-	const_iterator Find(const Resource *resource) const { typename resource_map::const_iterator it = m_byResource.find(const_cast<Resource*>(resource)); return (it != m_byResource.end()) ? it->second : m_info.end(); }
+	const_iterator Find(const Resource *resource) const { return const_iterator(&m_entries, m_byResource.Find(resource)); }
 	/// Gets an iterator to the given resource, if existent.
-	name_iterator FindByName(const utf8_string &name) { return m_byName.find(name); }
+	name_iterator FindByName(const utf8_ntri &name) { return name_iterator(&m_entries, &m_byName, m_byName.Find(name)); }
 	/// Gets an iterator to the given resource, if existent.
-	const_name_iterator FindByName(const utf8_string &name) const { return m_byName.find(name); }
+	const_name_iterator FindByName(const utf8_ntri &name) const { return const_name_iterator(&m_entries, &m_byName, m_byName.Find(name)); }
 	/// Gets an iterator to the given resource, if existent.
-	file_iterator FindByFile(const utf8_string &file) { return m_byFile.find(file); }
+	file_iterator FindByFile(const utf8_ntri &file) { return file_iterator(&m_entries, &m_byFile, m_byFile.Find(file)); }
 	/// Gets an iterator to the given resource, if existent.
-	const_file_iterator FindByFile(const utf8_string &file) const { return m_byFile.find(file); }
+	const_file_iterator FindByFile(const utf8_ntri &file) const { return const_file_iterator(&m_entries, &m_byFile, m_byFile.Find(file)); }
 
 	/// Gets an iterator to the lower name bound.
-	name_iterator LowerBoundByName(const utf8_string &name) { return m_byName.lower_bound(name); }
+	name_iterator LowerBoundByName(const utf8_ntri &name) { return name_iterator(&m_entries, &m_byName, m_byName.LowerBound(name)); }
 	/// Gets an iterator to the lower name bound.
-	const_name_iterator LowerBoundByName(const utf8_string &name) const { return m_byName.lower_bound(name); }
+	const_name_iterator LowerBoundByName(const utf8_ntri &name) const { return const_name_iterator(&m_entries, &m_byName, m_byName.LowerBound(name)); }
 	/// Gets an iterator to the upper name bound.
-	name_iterator UpperBoundByName(const utf8_string &name) { return m_byName.upper_bound(name); }
+	name_iterator UpperBoundByName(const utf8_ntri &name) { return name_iterator(&m_entries, &m_byName, m_byName.UpperBound(name)); }
 	/// Gets an iterator to the upper name bound.
-	const_name_iterator UpperBoundByName(const utf8_string &name) const { return m_byName.upper_bound(name); }
+	const_name_iterator UpperBoundByName(const utf8_ntri &name) const { return const_name_iterator(&m_entries, &m_byName, m_byName.UpperBound(name)); }
 
 	/// Gets an iterator to the lower file bound.
-	file_iterator LowerBoundByFile(const utf8_string &file) { return m_byFile.lower_bound(file); }
+	file_iterator LowerBoundByFile(const utf8_ntri &file) { return file_iterator(&m_entries, &m_byFile, m_byFile.LowerBound(file)); }
 	/// Gets an iterator to the lower file bound.
-	const_file_iterator LowerBoundByFile(const utf8_string &file) const { return m_byFile.lower_bound(file); }
+	const_file_iterator LowerBoundByFile(const utf8_ntri &file) const { return const_file_iterator(&m_entries, &m_byFile, m_byFile.LowerBound(file)); }
 	/// Gets an iterator to the upper file bound.
-	file_iterator UpperBoundByFile(const utf8_string &file) { return m_byFile.upper_bound(file); }
+	file_iterator UpperBoundByFile(const utf8_ntri &file) { return file_iterator(&m_entries, &m_byFile, m_byFile.UpperBound(file)); }
 	/// Gets an iterator to the upper file bound.
-	const_file_iterator UpperBoundByFile(const utf8_string &file) const { return m_byFile.upper_bound(file); }
+	const_file_iterator UpperBoundByFile(const utf8_ntri &file) const { return const_file_iterator(&m_entries, &m_byFile, m_byFile.UpperBound(file)); }
 
 	/// Gets an iterator to the first resource.
-	LEAN_INLINE iterator Begin() { return m_info.begin(); }
+	LEAN_INLINE iterator Begin() { return iterator(&m_entries, NextEntry(m_entries, InvalidIndex)); }
 	/// Gets an iterator to the first resource.
-	LEAN_INLINE const_iterator Begin() const { return m_info.begin(); }
+	LEAN_INLINE const_iterator Begin() const { return const_iterator(&m_entries, NextEntry(m_entries, InvalidIndex)); }
 	/// Gets an iterator one past the last resource.
-	LEAN_INLINE iterator End() { return m_info.end(); }
+	LEAN_INLINE iterator End() { return iterator(&m_entries, InvalidIndex); }
 	/// Gets an iterator one past the last resource.
-	LEAN_INLINE const_iterator End() const { return m_info.end(); }
+	LEAN_INLINE const_iterator End() const { return const_iterator(&m_entries, InvalidIndex); }
 
-	/// Gets an iterator to the first resource by name.
-	LEAN_INLINE name_iterator BeginByName() { return m_byName.begin(); }
-	/// Gets an iterator to the first resource by name.
-	LEAN_INLINE const_name_iterator BeginByName() const { return m_byName.begin(); }
+	/// Gets an iterator to the first resource by name. Sorts names on demand.
+	LEAN_INLINE name_iterator BeginByName() { return name_iterator(&m_entries, &m_byName, m_byName.First()); }
+	/// Gets an iterator to the first resource by name. Sorts names on demand.
+	LEAN_INLINE const_name_iterator BeginByName() const { return const_name_iterator(&m_entries, &m_byName, m_byName.First()); }
 	/// Gets an iterator one past the last resource by name.
-	LEAN_INLINE name_iterator EndByName() { return m_byName.end(); }
+	LEAN_INLINE name_iterator EndByName() { return name_iterator(&m_entries, &m_byName, InvalidIndex); }
 	/// Gets an iterator one past the last resource by name.
-	LEAN_INLINE const_name_iterator EndByName() const { return m_byName.end(); }
+	LEAN_INLINE const_name_iterator EndByName() const { return const_name_iterator(&m_entries, &m_byName, InvalidIndex); }
 
-	/// Gets an iterator to the first resource by file.
-	LEAN_INLINE file_iterator BeginByFile() { return m_byFile.begin(); }
-	/// Gets an iterator to the first resource by file.
-	LEAN_INLINE const_file_iterator BeginByFile() const { return m_byFile.begin(); }
+	/// Gets an iterator to the first resource by file. Sorts files on demand.
+	LEAN_INLINE file_iterator BeginByFile() { return file_iterator(&m_entries, &m_byFile, m_byFile.First()); }
+	/// Gets an iterator to the first resource by file. Sorts files on demand.
+	LEAN_INLINE const_file_iterator BeginByFile() const { return const_file_iterator(&m_entries, &m_byFile, m_byFile.First()); }
 	/// Gets an iterator one past the last resource by file.
-	LEAN_INLINE file_iterator EndByFile() { return m_byFile.end(); }
+	LEAN_INLINE file_iterator EndByFile() { return file_iterator(&m_entries, &m_byFile, InvalidIndex); }
 	/// Gets an iterator one past the last resource by file.
-	LEAN_INLINE const_file_iterator EndByFile() const { return m_byFile.end(); }
+	LEAN_INLINE const_file_iterator EndByFile() const { return const_file_iterator(&m_entries, &m_byFile, InvalidIndex); }
 
 	/// Gets the number of resources.
-	LEAN_INLINE uint4 Count() const { return static_cast<uint4>(m_byName.size()); }
+	LEAN_INLINE uint4 Count() const { return m_byName.Count(); }
 };
 
 } // namespace
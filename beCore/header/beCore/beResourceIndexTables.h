@@ -0,0 +1,146 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_RESOURCE_INDEX_TABLES
+#define BE_CORE_RESOURCE_INDEX_TABLES
+
+#include "beCore.h"
+#include <vector>
+#include <lean/tags/noncopyable.h>
+#include <lean/concurrent/critical_section.h>
+
+namespace beCore
+{
+
+/// Open-addressing hash table mapping pointers to indices.
+class ResourcePointerTable
+{
+public:
+	/// Invalid index.
+	static const uint4 InvalidIndex = static_cast<uint4>(-1);
+
+private:
+	/// Hash table slot, empty if key is nullptr.
+	struct Slot
+	{
+		const void *key;
+		uint4 value;
+	};
+	typedef std::vector<Slot> slot_vector;
+	slot_vector m_slots;
+	uint4 m_count;
+
+	// nullptr marks empty slots, stored separately
+	uint4 m_nullValue;
+
+	/// Gets the slot of the given key, first empty slot in its probe sequence if not found.
+	uint4 Probe(const void *key) const;
+	/// Grows the hash table to the given capacity.
+	void Rehash(uint4 capacity);
+
+public:
+	/// Constructor.
+	BE_CORE_API ResourcePointerTable();
+	/// Destructor.
+	BE_CORE_API ~ResourcePointerTable();
+
+	/// Gets the index mapped to the given pointer, InvalidIndex if none.
+	BE_CORE_API uint4 Find(const void *key) const;
+	/// Maps the given pointer to the given index, if not mapped yet. Returns the index the pointer is now mapped to.
+	BE_CORE_API uint4 Insert(const void *key, uint4 value);
+	/// Removes the given pointer.
+	BE_CORE_API void Erase(const void *key);
+
+	/// Gets the number of pointers.
+	LEAN_INLINE uint4 Count() const { return m_count + (m_nullValue != InvalidIndex); }
+};
+
+/// Table of unique strings, each mapped to an index. Strings are interned into records that are looked up by
+/// pre-computed hashes in an open-addressing hash table. Records may be iterated in order via a sorted view that
+/// is rebuilt on demand. Concurrent const access is thread-safe, the sorted view is rebuilt under lock.
+class ResourceStringTable : public lean::noncopyable
+{
+public:
+	/// Invalid index.
+	static const uint4 InvalidIndex = static_cast<uint4>(-1);
+
+private:
+	/// Interned string.
+	struct Record
+	{
+		utf8_string string;
+		uint8 hash;
+		uint4 value;
+		mutable uint4 sortedPos;
+		bool bUsed;
+	};
+	typedef std::vector<Record> record_vector;
+	record_vector m_records;
+
+	typedef std::vector<uint4> index_vector;
+	index_vector m_freeRecords;
+
+	/// Hash table slot, empty if record invalid.
+	struct Slot
+	{
+		uint4 hash;
+		uint4 record;
+	};
+	typedef std::vector<Slot> slot_vector;
+	slot_vector m_slots;
+	uint4 m_count;
+
+	// Sorted view, rebuilt on demand
+	mutable index_vector m_sorted;
+	mutable volatile bool m_bSorted;
+	mutable lean::critical_section m_sortLock;
+
+	/// Gets the slot of the given string, first empty slot in its probe sequence if not found.
+	uint4 Probe(const utf8_ntri &string, uint8 hash) const;
+	/// Grows the hash table to the given capacity.
+	void Rehash(uint4 capacity);
+	/// Rebuilds the sorted view, if out of date.
+	void Sort() const;
+
+public:
+	/// Constructor.
+	BE_CORE_API ResourceStringTable();
+	/// Destructor.
+	BE_CORE_API ~ResourceStringTable();
+
+	/// Gets the record of the given string, InvalidIndex if none.
+	BE_CORE_API uint4 Find(const utf8_ntri &string) const;
+	/// Adds the given string mapped to the given index, if not present yet. Returns the record of the given string.
+	BE_CORE_API uint4 Insert(const utf8_ntri &string, uint4 value);
+	/// Removes the given record.
+	BE_CORE_API void Erase(uint4 record);
+
+	/// Gets the string of the given record.
+	LEAN_INLINE const utf8_string& GetString(uint4 record) const { return m_records[record].string; }
+	/// Gets the index the given record is mapped to.
+	LEAN_INLINE uint4 GetValue(uint4 record) const { return m_records[record].value; }
+	/// Sets the index the given record is mapped to.
+	LEAN_INLINE void SetValue(uint4 record, uint4 value) { m_records[record].value = value; }
+
+	/// Gets the first record in order, InvalidIndex if none.
+	BE_CORE_API uint4 First() const;
+	/// Gets the last record in order, InvalidIndex if none.
+	BE_CORE_API uint4 Last() const;
+	/// Gets the next record in order, InvalidIndex if none.
+	BE_CORE_API uint4 Next(uint4 record) const;
+	/// Gets the previous record in order, last record if InvalidIndex.
+	BE_CORE_API uint4 Prev(uint4 record) const;
+	/// Gets the first record not ordered before the given string, InvalidIndex if none.
+	BE_CORE_API uint4 LowerBound(const utf8_ntri &string) const;
+	/// Gets the first record ordered after the given string, InvalidIndex if none.
+	BE_CORE_API uint4 UpperBound(const utf8_ntri &string) const;
+
+	/// Gets the number of strings.
+	LEAN_INLINE uint4 Count() const { return m_count; }
+};
+
+} // namespace
+
+#endif
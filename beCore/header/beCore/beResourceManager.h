@@ -28,6 +28,54 @@ public:
 		Resource(resource) { }
 };
 
+/// Memory held by resources.
+struct ResourceMemory
+{
+	static const uint8 Unlimited = static_cast<uint8>(-1);	///< No budget.
+
+	uint8 GPUBytes;		///< Bytes of GPU memory.
+	uint8 CPUBytes;		///< Bytes of CPU memory.
+
+	/// Constructor.
+	LEAN_INLINE explicit ResourceMemory(uint8 gpuBytes = 0, uint8 cpuBytes = 0)
+		: GPUBytes(gpuBytes),
+		CPUBytes(cpuBytes) { }
+
+	/// Adds the given memory.
+	LEAN_INLINE ResourceMemory& operator +=(const ResourceMemory &right)
+	{
+		GPUBytes += right.GPUBytes;
+		CPUBytes += right.CPUBytes;
+		return *this;
+	}
+	/// Subtracts the given memory.
+	LEAN_INLINE ResourceMemory& operator -=(const ResourceMemory &right)
+	{
+		GPUBytes -= right.GPUBytes;
+		CPUBytes -= right.CPUBytes;
+		return *this;
+	}
+};
+
+/// Resource cache statistics.
+struct ResourceCacheStats
+{
+	ResourceMemory Resident;	///< Memory held by resident resources.
+	ResourceMemory Budget;		///< Memory budget, resources no longer in use are evicted beyond.
+	uint4 ResidentCount;		///< Number of resident resources.
+	uint8 Hits;					///< Number of requests served from the cache.
+	uint8 Misses;				///< Number of requests that required loading.
+	uint8 Evictions;			///< Number of resources evicted.
+
+	/// Constructor.
+	LEAN_INLINE ResourceCacheStats()
+		: Budget(ResourceMemory::Unlimited, ResourceMemory::Unlimited),
+		ResidentCount(0),
+		Hits(0),
+		Misses(0),
+		Evictions(0) { }
+};
+
 /// Resource manager interface for named resources.
 template <class ResourceT>
 class LEAN_INTERFACE ResourceManager : public beCore::Resource
@@ -58,6 +106,12 @@ public:
 
 	/// Commits changes / reacts to changes.
 	virtual void Commit() { }
+
+	/// Sets the memory budget. Resources no longer in use are evicted in least-recently-used order on commit
+	/// while the memory held by resident resources exceeds the budget. Ignored by managers that cannot evict.
+	virtual void SetMemoryBudget(const ResourceMemory &budget) { }
+	/// Gets memory & usage statistics.
+	virtual ResourceCacheStats GetCacheStats() const { return ResourceCacheStats(); }
 };
 
 /// Resource manager interface for named and filed resources.
@@ -9,6 +9,8 @@
 #include "beCore.h"
 #include "beResourceManagerImpl.h"
 #include <lean/pimpl/pimpl_ptr.h>
+#include <vector>
+#include <algorithm>
 
 #include <lean/logging/errors.h>
 
@@ -77,17 +79,18 @@ namespace
 template <class Monitor, class Resource>
 LEAN_INLINE void MonitorAddChanged(Monitor &monitor, const Resource *resource)
 {
-	monitor.AddChanged(Resource::GetComponentType());
+	monitor.AddChanged(Resource::GetComponentType(), resource);
 }
 
 } // namespace
 
-/// Default resource change monitoring implementation. Replace using ADL.
-template <class M, class Iterator>
-LEAN_INLINE void ResourceChanged(M &m, Iterator it)
+/// Default resource change monitoring implementation, reports the replaced resource dependents still hold.
+/// Replace using ADL.
+template <class M, class Iterator, class Resource>
+LEAN_INLINE void ResourceChanged(M &m, Iterator it, const Resource *oldResource)
 {
 	if (m.pComponentMonitor)
-		MonitorAddChanged(m.pComponentMonitor->Replacement, GetResource(m ,it));
+		MonitorAddChanged(m.pComponentMonitor->Replacement, oldResource);
 }
 
 /// Default resource management change monitoring implementation. Replace using ADL.
@@ -100,6 +103,83 @@ LEAN_INLINE void ResourceManagementChanged(M &m, Iterator it)
 
 // NOTE: Also implement ResourceFileChanged(M&, resources_t::iterator) using ADL
 
+/// Default resource insertion handling, replace using ADL.
+template <class M, class Iterator>
+LEAN_INLINE void ResourceInserted(M&, Iterator it)
+{
+}
+
+/// Default resource usage check, replace using ADL. Resources in use are never evicted.
+template <class M, class Iterator>
+LEAN_INLINE bool IsResourceUsed(const M&, Iterator it)
+{
+	return true;
+}
+
+/// Default resource eviction, replace using ADL. Releases everything held by the resource info.
+template <class M, class Iterator>
+LEAN_INLINE void ResourceEvicted(M&, Iterator it)
+{
+	it->resource = nullptr;
+}
+
+namespace detail
+{
+
+/// Orders resources by last use.
+template <class Iterator>
+LEAN_INLINE bool ResourceUsedBefore(const Iterator &left, const Iterator &right)
+{
+	return left->lastUse < right->lastUse;
+}
+
+} // namespace
+
+/// Updates the use time stamps of all resources in use & evicts resources no longer in use in least-recently-used
+/// order while the memory held by the given cache exceeds its budget. Requires m.budget (ResourceBudget),
+/// Info::memory (ResourceMemory) and Info::lastUse (uint8). Returns the number of resources evicted.
+template <class M>
+uint4 EvictResources(M &m)
+{
+	typedef typename M::resources_t::iterator iterator;
+
+	// Nothing to evict without budget
+	if (!m.budget.IsLimited())
+		return 0;
+
+	const uint8 now = m.budget.Tick();
+	const bool bExceeded = m.budget.IsExceeded();
+
+	std::vector<iterator> unused;
+
+	for (iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
+		if (IsResourceUsed(m, it))
+			it->lastUse = now;
+		else if (bExceeded)
+			unused.push_back(it);
+
+	std::sort(unused.begin(), unused.end(), &detail::ResourceUsedBefore<iterator>);
+
+	uint4 evictedCount = 0;
+
+	for (typename std::vector<iterator>::const_iterator it = unused.begin(), itEnd = unused.end();
+		it != itEnd && m.budget.IsExceeded(); ++it)
+	{
+		iterator victim = *it;
+		typename M::resources_t::Resource *key = GetResourceKey(m, GetResource(m, victim));
+
+		ResourceManagementChanged(m, victim);
+		// NOTE: Key only compared, resource may already have been released
+		ResourceEvicted(m, victim);
+		m.budget.Evict(victim->memory);
+		m.resourceIndex.Remove(victim, key);
+
+		++evictedCount;
+	}
+
+	return evictedCount;
+}
+
 /// Default notes, replace using ADL.
 template <class M, class Iterator>
 LEAN_INLINE Exchange::utf8_string GetResourceNotes(const M&, Iterator it)
@@ -157,6 +237,7 @@ void ResourceManagerImpl<R, D, B>::SetName(Resource *resource, const utf8_ntri &
 		try
 		{
 			it = m.resourceIndex.Insert( GetResourceKey(m, resource), name, MakeResourceInfo(m, resource, static_cast<Derived*>(this)) );
+			ResourceInserted(m, it);
 		}
 		catch (const std::runtime_error &e)
 		{
@@ -224,7 +305,7 @@ void ResourceManagerImpl<R, D, B>::Replace(Resource *oldResource, Resource *newR
 		m.resourceIndex.Unlink(it, GetResourceKey(m, oldResource));
 		SetResourceSuccessor(m, oldResource, newResource);
 
-		ResourceChanged(m, it);
+		ResourceChanged(m, it, oldResource);
 	}
 	else
 		LEAN_THROW_ERROR_MSG("Resource to be replaced unknown to the resource manager");
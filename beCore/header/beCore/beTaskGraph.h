@@ -0,0 +1,59 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_TASK_GRAPH
+#define BE_CORE_TASK_GRAPH
+
+#include "beCore.h"
+#include "beThreadPool.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+
+namespace beCore
+{
+
+/// Task graph class that allows for the distribution of tasks with arbitrary (acyclic) dependencies on multiple cores.
+/// Once built, a task graph may be run any number of times without being rebuilt or reallocating memory.
+class TaskGraph : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Invalid node ID.
+	static const uint4 InvalidID = static_cast<uint4>(-1);
+
+	/// Constructs an empty task graph.
+	BE_CORE_API TaskGraph();
+	/// Destructor. Waits for the graph to finish running.
+	BE_CORE_API ~TaskGraph();
+
+	/// Adds the given task, returning its node ID. The task is NOT owned by this graph.
+	BE_CORE_API uint4 AddTask(Task *pTask);
+	/// Makes the given successor node wait for the given predecessor node to finish.
+	BE_CORE_API bool AddDependency(uint4 predecessorID, uint4 successorID);
+
+	/// Runs all tasks on the given thread pool with the given priority, returning when all tasks have finished.
+	BE_CORE_API void Run(ThreadPool *pPool, TaskPriority::T priority = TaskPriority::Normal);
+	/// Starts running all tasks on the given thread pool with the given priority, returning immediately.
+	BE_CORE_API bool Start(ThreadPool *pPool, TaskPriority::T priority = TaskPriority::Normal);
+	/// Waits for all tasks started to finish.
+	BE_CORE_API void Wait();
+	/// Checks if all tasks started have finished.
+	BE_CORE_API bool IsDone() const;
+
+	/// Removes all tasks & dependencies.
+	BE_CORE_API void Clear();
+
+	/// Gets the number of tasks.
+	BE_CORE_API uint4 GetTaskCount() const;
+};
+
+} // namespace
+
+#endif
\ No newline at end of file
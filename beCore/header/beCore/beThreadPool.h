@@ -10,10 +10,62 @@
 #include "beTask.h"
 #include <lean/tags/noncopyable.h>
 #include <lean/pimpl/pimpl_ptr.h>
+#include <iosfwd>
 
 namespace beCore
 {
 
+/// Thread pool scheduling mode enumeration.
+struct ThreadPoolMode
+{
+	/// Thread pool scheduling mode enumeration.
+	enum T
+	{
+		Shared,			///< All tasks are kept in one shared FIFO queue.
+		WorkStealing	///< Workers keep local task deques, idle workers steal from busy ones.
+	};
+	LEAN_MAKE_ENUM_STRUCT(ThreadPoolMode)
+};
+
+/// Task priority enumeration.
+struct TaskPriority
+{
+	/// Task priority enumeration.
+	enum T
+	{
+		Critical,	///< Frame-critical tasks, always dequeued first.
+		Normal,		///< Regular tasks.
+		Background,	///< Background tasks, only run by a limited number of workers at a time.
+
+		Count
+	};
+	LEAN_MAKE_ENUM_STRUCT(TaskPriority)
+};
+
+/// Thread pool statistics.
+struct ThreadPoolStats
+{
+	uint8 TaskCount;		///< Number of tasks run.
+	uint8 StealCount;		///< Number of tasks stolen from other workers.
+	uint8 ParkCount;		///< Number of times idle workers were parked.
+	double RunSeconds;		///< Time spent running tasks.
+	double IdleSeconds;		///< Time spent parked.
+	double WaitSeconds;		///< Time spent waiting for child jobs, excluding tasks run while waiting.
+	uint4 QueueDepth;		///< Current number of tasks in the shared queues.
+	uint4 MaxQueueDepth;	///< Maximum number of tasks in the shared queues.
+
+	/// Constructor.
+	ThreadPoolStats()
+		: TaskCount(0),
+		StealCount(0),
+		ParkCount(0),
+		RunSeconds(0.0),
+		IdleSeconds(0.0),
+		WaitSeconds(0.0),
+		QueueDepth(0),
+		MaxQueueDepth(0) { }
+};
+
 /// Thread pool class that allows for the distribution of separate tasks on multiple cores.
 class ThreadPool : public lean::noncopyable
 {
@@ -23,12 +75,39 @@ private:
 	
 public:
 	/// Constructs a thread pool maintaining the given number of threads.
-	BE_CORE_API ThreadPool(size_t threadCount);
+	BE_CORE_API ThreadPool(size_t threadCount, ThreadPoolMode::T mode = ThreadPoolMode::Shared);
 	/// Destructor.
 	BE_CORE_API ~ThreadPool();
 	
 	/// Adds the given task to be executed when a thread becomes available. This method is thread-safe.
-	BE_CORE_API void AddTask(Task *pTask);
+	BE_CORE_API void AddTask(Task *pTask, TaskPriority::T priority = TaskPriority::Normal);
+	/// Runs one pending task of the given or higher priority on the calling thread, returns false if no task was pending.
+	/// Allows threads waiting for other tasks to help out instead of blocking. Background tasks are not run unless
+	/// explicitly requested, they are not subject to throttling then. This method is thread-safe.
+	BE_CORE_API bool RunPendingTask(TaskPriority::T lowestPriority = TaskPriority::Normal);
+
+	/// Sets the maximum number of worker threads running background tasks at the same time, defaults to all threads but one.
+	/// A limit of zero holds back all background tasks until explicitly run via RunPendingTask(). This method is thread-safe.
+	BE_CORE_API void SetBackgroundThreadLimit(size_t threadCount);
+	/// Gets the maximum number of worker threads running background tasks at the same time.
+	BE_CORE_API size_t GetBackgroundThreadLimit() const;
+
+	/// Gets the scheduling mode.
+	BE_CORE_API ThreadPoolMode::T GetMode() const;
+	/// Gets the number of worker threads.
+	BE_CORE_API size_t GetThreadCount() const;
+
+	/// Enables or disables recording of scheduler events & statistics on worker threads.
+	/// Returns false if scheduler tracing has not been compiled in (see BE_CORE_SCHEDULER_TRACING).
+	BE_CORE_API bool EnableTracing(bool bEnable);
+	/// Gets the statistics of all worker threads.
+	BE_CORE_API ThreadPoolStats GetStats() const;
+	/// Gets the statistics of the given worker thread.
+	BE_CORE_API ThreadPoolStats GetWorkerStats(size_t workerIdx) const;
+	/// Clears all statistics & recorded events.
+	BE_CORE_API void ResetTrace();
+	/// Writes the most recently recorded events in Chrome trace event JSON format (chrome://tracing).
+	BE_CORE_API void WriteChromeTrace(std::basic_ostream<utf8_t> &stream) const;
 };
 
 } // namespace
@@ -20,13 +20,15 @@ struct ValueTypeDesc
 	const lean::property_type_info Info;	///< Type info.
 	const utf8_ntr Name;					///< Type name.
 	const TextSerializer *Text;				///< Type reflector.
+	const bool Plain;						///< Values may be copied bytewise.
 
 	/// Initializing constructor.
 	explicit ValueTypeDesc(const lean::property_type_info &info,
-			const TextSerializer *pText = nullptr)
+			const TextSerializer *pText = nullptr, bool bPlain = false)
 		: Info( info ),
 		Name( info.type.name() ),
-		Text( pText ) { }
+		Text( pText ),
+		Plain( bPlain ) { }
 };
 
 class ValueTypes;
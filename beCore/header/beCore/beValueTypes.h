@@ -29,8 +29,8 @@ public:
 	/// Destructor.
 	BE_CORE_API ~ValueTypes();
 
-	/// Adds the given value type, returning a unique address for this type.
-	BE_CORE_API const ValueTypeDesc& AddType(const lean::property_type_info &info);
+	/// Adds the given value type, returning a unique address for this type. Plain values may be copied bytewise.
+	BE_CORE_API const ValueTypeDesc& AddType(const lean::property_type_info &info, bool bPlain = false);
 	/// Removes the given value type.
 	BE_CORE_API void RemoveType(const lean::property_type_info &info);
 
@@ -0,0 +1,63 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_XML_STREAM_WRITER
+#define BE_CORE_XML_STREAM_WRITER
+
+#include "beCore.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/rapidxml/rapidxml.hpp>
+
+namespace beCore
+{
+
+/// Writes XML elements straight to a buffered file, producing the same text as the rapidxml DOM printer.
+/// Only the elements currently open and the nodes in the scratch document are held in memory. Elements
+/// opened by BeginElement() may only receive element children, all of which are written on separate lines.
+/// Output goes to a temporary file that only replaces the target file once committed, see Commit().
+class XMLStreamWriter : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Default output buffer size.
+	static const size_t DefaultBufferSize = 64 * 1024;
+
+	/// Opens a temporary file next to the given file for writing, using the given rapidxml print flags.
+	BE_CORE_API XMLStreamWriter(const utf8_ntri &file, int printFlags = 0, size_t bufferSize = DefaultBufferSize);
+	/// Discards all output not committed, leaving the given file untouched.
+	BE_CORE_API ~XMLStreamWriter();
+
+	/// Begins an element of the given node's name & attributes. Children of the given node are NOT written.
+	BE_CORE_API void BeginElement(const rapidxml::xml_node<utf8_t> &node);
+	/// Ends the innermost element begun.
+	BE_CORE_API void EndElement();
+
+	/// Writes the given node including all of its children.
+	BE_CORE_API void WriteNode(const rapidxml::xml_node<utf8_t> &node);
+	/// Writes all children of the given node.
+	BE_CORE_API void WriteChildren(const rapidxml::xml_node<utf8_t> &node);
+
+	/// Gets a scratch document that nodes may be built in before they are written.
+	BE_CORE_API rapidxml::xml_document<utf8_t>& Scratch();
+	/// Frees all nodes & strings allocated from the scratch document.
+	BE_CORE_API void ClearScratch();
+
+	/// Writes all buffered output to the temporary file.
+	BE_CORE_API void Flush();
+	/// Writes all buffered output & replaces the given file by the complete output. No output may follow.
+	BE_CORE_API void Commit();
+	/// Gets the number of bytes written so far, including buffered output.
+	BE_CORE_API uint8 GetSize() const;
+};
+
+} // namespace
+
+#endif
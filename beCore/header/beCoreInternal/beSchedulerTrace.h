@@ -0,0 +1,270 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#pragma once
+#ifndef BE_CORE_SCHEDULER_TRACE
+#define BE_CORE_SCHEDULER_TRACE
+
+#include "beCore/beCore.h"
+
+/// @addtogroup GlobalMacros
+/// @{
+
+#ifdef BE_CORE_SCHEDULER_TRACING
+	/// Compiles the given statement only when scheduler tracing is enabled.
+	#define BE_SCHEDULER_TRACE(statement) statement
+#else
+	/// Compiles the given statement only when scheduler tracing is enabled.
+	#define BE_SCHEDULER_TRACE(statement)
+#endif
+
+/// @}
+
+#ifdef BE_CORE_SCHEDULER_TRACING
+
+#include "beCore/beThreadPool.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/smart/scoped_ptr.h>
+#include <iosfwd>
+
+namespace beCore
+{
+
+/// Scheduler counter enumeration.
+struct SchedulerCounter
+{
+	/// Scheduler counter enumeration.
+	enum T
+	{
+		Tasks,		///< Tasks run.
+		Steals,		///< Tasks stolen.
+		Parks,		///< Times parked.
+		RunTicks,	///< Ticks spent running tasks.
+		IdleTicks,	///< Ticks spent parked.
+		WaitTicks,	///< Ticks spent waiting for child jobs, excluding tasks run while waiting.
+
+		Count,
+		None = Count	///< No counter.
+	};
+	LEAN_MAKE_ENUM_STRUCT(SchedulerCounter)
+};
+
+class SchedulerTrace;
+
+/// Records scheduler events of one thread into a ring buffer.
+class SchedulerThreadTrace : public lean::noncopyable
+{
+public:
+	/// Recorded event.
+	struct Event
+	{
+		const char *name;
+		uint8 begin;
+		uint8 end;
+	};
+
+	/// Number of most recent events kept.
+	static const uint4 Capacity = 8192;
+
+private:
+	const SchedulerTrace *m_pTrace;
+	lean::scoped_ptr<Event[]> m_events;
+	volatile uint4 m_eventCount;
+	volatile uint8 m_counters[SchedulerCounter::Count];
+	uint8 m_taskTicks;
+
+public:
+	/// Constructor.
+	SchedulerThreadTrace();
+
+	/// Attaches this thread trace to the given pool trace.
+	void Attach(const SchedulerTrace *pTrace) { m_pTrace = pTrace; }
+	/// Checks if recording is enabled.
+	LEAN_INLINE bool IsEnabled() const;
+
+	/// Records the given event. Owner thread only.
+	LEAN_INLINE void Record(const char *name, uint8 begin, uint8 end)
+	{
+		Event &event = m_events[m_eventCount % Capacity];
+		event.name = name;
+		event.begin = begin;
+		event.end = end;
+		// ORDER: Publish AFTER event has been written
+		m_eventCount = m_eventCount + 1;
+	}
+	/// Adds the given value to the given counter. Owner thread only.
+	LEAN_INLINE void Count(SchedulerCounter::T counter, uint8 value = 1)
+	{
+		m_counters[counter] = m_counters[counter] + value;
+	}
+
+	/// Adds the given number of ticks spent running a task. Owner thread only.
+	LEAN_INLINE void AddTaskTicks(uint8 ticks) { m_taskTicks += ticks; }
+	/// Replaces the number of ticks spent running tasks since the innermost wait began, returning the previous one.
+	/// Owner thread only.
+	LEAN_INLINE uint8 ExchangeTaskTicks(uint8 ticks)
+	{
+		uint8 prevTicks = m_taskTicks;
+		m_taskTicks = ticks;
+		return prevTicks;
+	}
+
+	/// Gets the given counter.
+	LEAN_INLINE uint8 GetCounter(SchedulerCounter::T counter) const { return m_counters[counter]; }
+	/// Gets the number of events recorded (including those already overwritten).
+	LEAN_INLINE uint4 GetEventCount() const { return m_eventCount; }
+	/// Gets the given event.
+	LEAN_INLINE const Event& GetEvent(uint4 eventIdx) const { return m_events[eventIdx % Capacity]; }
+
+	/// Clears all events & counters.
+	void Reset();
+};
+
+/// Scheduler trace of one thread pool, one thread trace per worker thread.
+class SchedulerTrace : public lean::noncopyable
+{
+private:
+	size_t m_threadCount;
+	lean::scoped_ptr<SchedulerThreadTrace[]> m_threads;
+	volatile bool m_bEnabled;
+	uint8 m_baseTicks;
+	volatile uint4 m_maxQueueDepth;
+
+public:
+	/// Constructor.
+	SchedulerTrace(size_t threadCount);
+	/// Destructor.
+	~SchedulerTrace();
+
+	/// Enables or disables recording.
+	void Enable(bool bEnable) { m_bEnabled = bEnable; }
+	/// Checks if recording is enabled.
+	LEAN_INLINE bool IsEnabled() const { return m_bEnabled; }
+
+	/// Gets the trace of the given worker thread.
+	LEAN_INLINE SchedulerThreadTrace& GetThread(size_t workerIdx) { return m_threads[workerIdx]; }
+	/// Updates the maximum queue depth. Call while holding the queue lock.
+	LEAN_INLINE void QueueDepthChanged(uint4 queueDepth)
+	{
+		if (m_bEnabled && queueDepth > m_maxQueueDepth)
+			m_maxQueueDepth = queueDepth;
+	}
+
+	/// Gets the statistics of the given worker thread, all threads if invalid.
+	ThreadPoolStats GetStats(size_t workerIdx) const;
+	/// Clears all events & statistics.
+	void Reset();
+	/// Writes all recorded events in Chrome trace event JSON format.
+	void WriteChromeTrace(std::basic_ostream<utf8_t> &stream) const;
+};
+
+// Checks if recording is enabled.
+LEAN_INLINE bool SchedulerThreadTrace::IsEnabled() const
+{
+	return m_pTrace && m_pTrace->IsEnabled();
+}
+
+/// Gets the current high-resolution tick count.
+uint8 GetSchedulerTicks();
+/// Converts the given number of ticks into seconds.
+double SchedulerTicksToSeconds(uint8 ticks);
+
+/// Gets the scheduler trace of the current thread, nullptr if none.
+SchedulerThreadTrace* GetCurrentSchedulerTrace();
+/// Sets the scheduler trace of the current thread.
+void SetCurrentSchedulerTrace(SchedulerThreadTrace *pTrace);
+
+/// Records the duration of the enclosing scope, if the current thread is being traced.
+class SchedulerTraceScope : public lean::noncopyable
+{
+private:
+	SchedulerThreadTrace *m_pTrace;
+	const char *m_name;
+	SchedulerCounter::T m_counter;
+	uint8 m_begin;
+
+public:
+	/// Starts timing. Records an event if name is not nullptr, adds elapsed ticks to the given counter unless None.
+	LEAN_INLINE SchedulerTraceScope(const char *name, SchedulerCounter::T ticksCounter)
+		: m_pTrace( GetCurrentSchedulerTrace() ),
+		m_name(name),
+		m_counter(ticksCounter)
+	{
+		if (m_pTrace && m_pTrace->IsEnabled())
+			m_begin = GetSchedulerTicks();
+		else
+			m_pTrace = nullptr;
+	}
+	/// Stops timing.
+	LEAN_INLINE ~SchedulerTraceScope()
+	{
+		if (m_pTrace)
+		{
+			uint8 end = GetSchedulerTicks();
+
+			if (m_counter != SchedulerCounter::None)
+				m_pTrace->Count(m_counter, end - m_begin);
+
+			// Tasks run by waiting threads are excluded from the wait time
+			if (m_counter == SchedulerCounter::RunTicks)
+				m_pTrace->AddTaskTicks(end - m_begin);
+
+			if (m_name)
+				m_pTrace->Record(m_name, m_begin, end);
+		}
+	}
+};
+
+/// Records the duration of the enclosing wait, if the current thread is being traced. Time spent running tasks
+/// while waiting is already counted as run time, it is excluded from the wait time.
+class SchedulerWaitScope : public lean::noncopyable
+{
+private:
+	SchedulerThreadTrace *m_pTrace;
+	uint8 m_begin;
+	uint8 m_outerTaskTicks;
+
+public:
+	/// Starts timing.
+	LEAN_INLINE SchedulerWaitScope()
+		: m_pTrace( GetCurrentSchedulerTrace() )
+	{
+		if (m_pTrace && m_pTrace->IsEnabled())
+		{
+			m_begin = GetSchedulerTicks();
+			m_outerTaskTicks = m_pTrace->ExchangeTaskTicks(0);
+		}
+		else
+			m_pTrace = nullptr;
+	}
+	/// Stops timing.
+	LEAN_INLINE ~SchedulerWaitScope()
+	{
+		if (m_pTrace)
+		{
+			uint8 end = GetSchedulerTicks();
+			uint8 waitTicks = end - m_begin;
+			// NOTE: Tasks run by this wait are part of the enclosing task, restore outer wait's ticks
+			uint8 taskTicks = m_pTrace->ExchangeTaskTicks(m_outerTaskTicks);
+
+			m_pTrace->Count(SchedulerCounter::WaitTicks, (taskTicks < waitTicks) ? waitTicks - taskTicks : 0);
+			m_pTrace->Record("Wait", m_begin, end);
+		}
+	}
+};
+
+/// Counts the given scheduler event, if the current thread is being traced.
+LEAN_INLINE void CountSchedulerEvent(SchedulerCounter::T counter)
+{
+	SchedulerThreadTrace *pTrace = GetCurrentSchedulerTrace();
+
+	if (pTrace && pTrace->IsEnabled())
+		pTrace->Count(counter);
+}
+
+} // namespace
+
+#endif
+
+#endif
\ No newline at end of file
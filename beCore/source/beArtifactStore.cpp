@@ -0,0 +1,530 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beArtifactStore.h"
+#include "beCore/beCompressedContent.h"
+#include "beCore/beFileCommit.h"
+
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#include <lean/io/raw_file.h>
+#include <lean/io/mapped_file.h>
+#include <lean/io/filesystem.h>
+#include <lean/concurrent/critical_section.h>
+
+#include <lean/logging/errors.h>
+#include <lean/logging/log.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Artifact file extension.
+const wchar_t ArtifactExtension[] = L".art";
+/// Minimum number of 100ns ticks between two updates of an artifact's file time, avoids redundant writes.
+const uint8 TouchInterval = 10ULL * 60 * 10000000;
+/// Minimum age of abandoned temporary files to be cleaned up, in 100ns ticks.
+const uint8 TempFileTimeout = 60ULL * 60 * 10000000;
+
+/// Converts the given file time into 100ns ticks.
+LEAN_INLINE uint8 ToTicks(const FILETIME &time)
+{
+	return static_cast<uint8>(time.dwHighDateTime) << 32 | time.dwLowDateTime;
+}
+
+/// Converts the given 100ns ticks into a file time.
+LEAN_INLINE FILETIME ToFileTime(uint8 ticks)
+{
+	FILETIME time;
+	time.dwLowDateTime = static_cast<DWORD>(ticks);
+	time.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+	return time;
+}
+
+/// Gets the current time in 100ns ticks.
+LEAN_INLINE uint8 GetCurrentTicks()
+{
+	FILETIME time;
+	::GetSystemTimeAsFileTime(&time);
+	return ToTicks(time);
+}
+
+/// Gets the name of the given artifact's file.
+utf8_string GetArtifactName(uint8 key)
+{
+	char name[32];
+	sprintf_s(name, "%016llx.art", static_cast<unsigned long long>(key));
+	return name;
+}
+
+/// Parses the key of the given artifact file name, returns false if no artifact file.
+bool ParseArtifactName(const wchar_t *name, uint8 &key)
+{
+	key = 0;
+
+	for (int i = 0; i < 16; ++i, ++name)
+	{
+		int digit;
+
+		if (*name >= L'0' && *name <= L'9')
+			digit = *name - L'0';
+		else if (*name >= L'a' && *name <= L'f')
+			digit = *name - L'a' + 10;
+		else
+			return false;
+
+		key = key << 4 | digit;
+	}
+
+	return (wcscmp(name, ArtifactExtension) == 0);
+}
+
+/// Creates the given directory & all of its parent directories.
+void CreateDirectories(const utf8_string &directory)
+{
+	std::wstring path = lean::utf_to_utf16(directory);
+
+	for (size_t pos = path.find_first_of(L"\\/", 3); ; pos = path.find_first_of(L"\\/", pos + 1))
+	{
+		::CreateDirectoryW(path.substr(0, pos).c_str(), nullptr);
+
+		if (pos == std::wstring::npos)
+			break;
+	}
+}
+
+/// Artifact mapped into memory.
+class MappedArtifact : public Content
+{
+private:
+	lean::rmapped_file m_file;
+
+public:
+	/// Constructor.
+	MappedArtifact(const utf8_ntri &file)
+		: m_file(file)
+	{
+		m_memory = m_file.data();
+		m_size = m_file.size();
+	}
+
+	/// Skips the artifact header.
+	void SkipHeader()
+	{
+		m_memory = reinterpret_cast<const char*>(m_memory) + sizeof(ArtifactHeader);
+		m_size -= sizeof(ArtifactHeader);
+	}
+};
+
+} // namespace
+
+// Constructor.
+ArtifactKey::ArtifactKey(const utf8_ntri &compiler, uint4 version)
+{
+	AddString(compiler);
+	AddValue(version);
+}
+
+// Adds the given data, e.g. build parameters.
+ArtifactKey& ArtifactKey::Add(const void *data, size_t size)
+{
+	m_hasher.Update(data, size);
+	return *this;
+}
+
+// Adds the given string.
+ArtifactKey& ArtifactKey::AddString(const utf8_ntri &string)
+{
+	uint8 length = string.size();
+	m_hasher.Update(&length, sizeof(length));
+	m_hasher.Update(string.c_str(), string.size());
+	return *this;
+}
+
+// Adds the given content.
+ArtifactKey& ArtifactKey::AddContent(const Content &content)
+{
+	// NOTE: Hash of the content keeps key computation incremental for large content
+	return AddValue( HashContent(content.Data(), static_cast<size_t>(content.Size())) );
+}
+
+// Adds the contents of the given file.
+ArtifactKey& ArtifactKey::AddFile(const utf8_ntri &file)
+{
+	return AddValue( HashFileContent(file) );
+}
+
+/// Implementation of the artifact store class internals.
+struct ArtifactStore::M
+{
+	utf8_string directory;
+	uint8 sizeBudget;
+	ThreadPool *pPool;
+
+	/// Artifact bookkeeping.
+	struct Entry
+	{
+		uint8 size;		///< Size of the artifact file.
+		uint8 lastUse;	///< Time of last use in 100ns ticks.
+
+		Entry(uint8 size = 0, uint8 lastUse = 0)
+			: size(size),
+			lastUse(lastUse) { }
+	};
+	typedef std::unordered_map<uint8, Entry> entry_map;
+	entry_map entries;
+	uint8 size;
+
+	mutable lean::critical_section lock;
+
+	/// Constructor.
+	M(const utf8_ntri &directory, uint8 sizeBudget, ThreadPool *pPool)
+		: directory( lean::absolute_path<utf8_string>(directory) ),
+		sizeBudget(sizeBudget),
+		pPool(pPool),
+		size(0) { }
+
+	/// Gets the file of the given artifact.
+	utf8_string GetFile(uint8 key) const
+	{
+		return lean::append_path<utf8_string>(directory, GetArtifactName(key));
+	}
+
+	/// Updates bookkeeping for the given artifact.
+	void Update(uint8 key, uint8 fileSize, uint8 lastUse)
+	{
+		Entry &entry = entries[key];
+		size = size - entry.size + fileSize;
+		entry.size = fileSize;
+		entry.lastUse = lastUse;
+	}
+
+	/// Removes the given artifact from bookkeeping.
+	void Forget(uint8 key)
+	{
+		entry_map::iterator it = entries.find(key);
+
+		if (it != entries.end())
+		{
+			size -= it->second.size;
+			entries.erase(it);
+		}
+	}
+};
+
+namespace
+{
+
+/// Collects all artifacts in the store directory, cleans up files abandoned by crashed writers.
+void ScanArtifacts(ArtifactStore::M &m)
+{
+	const uint8 now = GetCurrentTicks();
+
+	WIN32_FIND_DATAW findData;
+	HANDLE hFind = ::FindFirstFileW( lean::utf_to_utf16(lean::append_path<utf8_string>(m.directory, "*")).c_str(), &findData );
+
+	if (hFind == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			continue;
+
+		uint8 key;
+		const uint8 fileSize = static_cast<uint8>(findData.nFileSizeHigh) << 32 | findData.nFileSizeLow;
+		const uint8 fileTime = ToTicks(findData.ftLastWriteTime);
+
+		if (ParseArtifactName(findData.cFileName, key))
+			m.Update(key, fileSize, fileTime);
+		else if (wcsstr(findData.cFileName, L".tmp") && now - fileTime > TempFileTimeout)
+			::DeleteFileW( lean::utf_to_utf16(lean::append_path<utf8_string>(m.directory, lean::utf_to_utf8(findData.cFileName))).c_str() );
+	}
+	while (::FindNextFileW(hFind, &findData));
+
+	::FindClose(hFind);
+}
+
+/// Marks the given artifact as recently used.
+void TouchArtifact(ArtifactStore::M &m, uint8 key, const utf8_string &file, uint8 fileSize)
+{
+	const uint8 now = GetCurrentTicks();
+	bool bTouchFile;
+
+	{
+		lean::scoped_cs_lock lock(m.lock);
+
+		ArtifactStore::M::entry_map::const_iterator it = m.entries.find(key);
+		// NOTE: Artifact may have been stored by another process
+		bTouchFile = (it == m.entries.end() || now - it->second.lastUse > TouchInterval);
+		m.Update(key, fileSize, now);
+	}
+
+	// Keep usage visible to other processes & future sessions
+	if (bTouchFile)
+	{
+		HANDLE hFile = ::CreateFileW(lean::utf_to_utf16(file).c_str(), FILE_WRITE_ATTRIBUTES,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 0, nullptr);
+
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			FILETIME time = ToFileTime(now);
+			::SetFileTime(hFile, nullptr, nullptr, &time);
+			::CloseHandle(hFile);
+		}
+	}
+}
+
+} // namespace
+
+// Opens or creates the store in the given directory.
+ArtifactStore::ArtifactStore(const utf8_ntri &directory, uint8 sizeBudget, ThreadPool *pPool)
+	: m( new M(directory, sizeBudget, pPool) )
+{
+	CreateDirectories(m->directory);
+	ScanArtifacts(*m);
+}
+
+// Destructor.
+ArtifactStore::~ArtifactStore()
+{
+}
+
+// Gets the artifact stored under the given key, nullptr if none or corrupted.
+lean::com_ptr<Content> ArtifactStore::Load(uint8 key)
+{
+	LEAN_PIMPL();
+
+	utf8_string file = m.GetFile(key);
+
+	if (!lean::file_exists(file))
+	{
+		lean::scoped_cs_lock lock(m.lock);
+		m.Forget(key);
+		return nullptr;
+	}
+
+	lean::com_ptr<Content> pContent;
+	uint8 fileSize;
+
+	try
+	{
+		lean::com_ptr<MappedArtifact> pArtifact = lean::bind_com( new MappedArtifact(file) );
+		fileSize = pArtifact->Size();
+
+		bool bValid = false;
+
+		if (fileSize >= sizeof(ArtifactHeader))
+		{
+			const ArtifactHeader &header = *reinterpret_cast<const ArtifactHeader*>(pArtifact->Data());
+
+			if (header.Magic == ArtifactHeader::MagicID && header.Version == ArtifactHeader::CurrentVersion &&
+				header.Key == key && header.Size == fileSize - sizeof(ArtifactHeader))
+			{
+				pArtifact->SkipHeader();
+
+				if (header.Flags & ArtifactHeader::Compressed)
+					pContent = DecompressContent(pArtifact->Data(), pArtifact->Size(), m.pPool);
+				else
+					pContent = pArtifact;
+
+				// NOTE: Stores may be shared, never trust artifacts written by others
+				bValid = (HashContent(pContent->Data(), static_cast<size_t>(pContent->Size())) == header.Hash);
+			}
+		}
+
+		if (!bValid)
+			LEAN_THROW_ERROR_CTX("Artifact corrupted", file.c_str());
+	}
+	catch (...)
+	{
+		LEAN_LOG_ERROR_CTX("Discarding invalid artifact", file.c_str());
+
+		// NOTE: Mapping released, fails if still mapped by someone else
+		pContent = nullptr;
+		::DeleteFileW(lean::utf_to_utf16(file).c_str());
+
+		lean::scoped_cs_lock lock(m.lock);
+		m.Forget(key);
+		return nullptr;
+	}
+
+	TouchArtifact(m, key, file, fileSize);
+
+	return pContent;
+}
+
+// Checks if an artifact is stored under the given key.
+bool ArtifactStore::Contains(uint8 key) const
+{
+	return lean::file_exists(m->GetFile(key));
+}
+
+// Copies the artifact stored under the given key to the given file, returns false if none.
+bool ArtifactStore::Retrieve(uint8 key, const utf8_ntri &file)
+{
+	lean::com_ptr<Content> pContent = Load(key);
+
+	if (!pContent)
+		return false;
+
+	lean::raw_file outFile(file, lean::file::write, lean::file::overwrite, lean::file::sequential);
+	outFile.write(pContent->Bytes(), static_cast<size_t>(pContent->Size()));
+
+	return true;
+}
+
+// Stores the given data under the given key, optionally block-compressed.
+void ArtifactStore::Store(uint8 key, const void *data, uint8 size, bool bCompress)
+{
+	LEAN_PIMPL();
+
+	utf8_string file = m.GetFile(key);
+
+	// NOTE: Unique per writer, renamed to the artifact file when complete
+	Exchange::utf8_string tempFile = GetTempFile(file);
+
+	uint8 fileSize;
+
+	try
+	{
+		lean::raw_file outFile(tempFile, lean::file::write, lean::file::overwrite, lean::file::sequential);
+
+		ArtifactHeader header;
+		memset(&header, 0, sizeof(header));
+		header.Magic = ArtifactHeader::MagicID;
+		header.Version = ArtifactHeader::CurrentVersion;
+		header.Key = key;
+		header.Hash = HashContent(data, static_cast<size_t>(size));
+		header.Flags = (bCompress) ? ArtifactHeader::Compressed : 0;
+
+		outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		if (bCompress)
+			WriteCompressedContent(outFile, data, size, CompressedContentHeader::DefaultBlockSize, m.pPool);
+		else
+			outFile.write(static_cast<const char*>(data), static_cast<size_t>(size));
+
+		// Complete header
+		fileSize = outFile.pos();
+		header.Size = fileSize - sizeof(header);
+		outFile.pos(0);
+		outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+	catch (...)
+	{
+		DiscardFile(tempFile);
+		throw;
+	}
+
+	try
+	{
+		// NOTE: Artifacts may be lost on power failure, never wait for the disk
+		CommitFile(tempFile, file, false);
+	}
+	catch (...)
+	{
+		// NOTE: Existing artifact may be mapped by readers, same key implies same content
+		if (!lean::file_exists(file))
+			throw;
+
+		return;
+	}
+
+	uint8 sizeBudget;
+	uint8 totalSize;
+
+	{
+		lean::scoped_cs_lock lock(m.lock);
+		m.Update(key, fileSize, GetCurrentTicks());
+		sizeBudget = m.sizeBudget;
+		totalSize = m.size;
+	}
+
+	// NOTE: Trim with some slack to avoid trimming on every store
+	if (sizeBudget && totalSize > sizeBudget)
+		Trim(sizeBudget - sizeBudget / 8);
+}
+
+// Stores the contents of the given file under the given key, optionally block-compressed.
+void ArtifactStore::StoreFile(uint8 key, const utf8_ntri &file, bool bCompress)
+{
+	lean::rmapped_file mappedFile(file);
+	Store(key, mappedFile.data(), mappedFile.size(), bCompress);
+}
+
+// Evicts least recently used artifacts until the store no longer exceeds the given size budget.
+void ArtifactStore::Trim(uint8 sizeBudget)
+{
+	LEAN_PIMPL();
+
+	typedef std::vector< std::pair<uint8, uint8> > use_vector;
+	use_vector uses;
+
+	lean::scoped_cs_lock lock(m.lock);
+
+	if (m.size <= sizeBudget)
+		return;
+
+	uses.reserve(m.entries.size());
+
+	for (M::entry_map::const_iterator it = m.entries.begin(); it != m.entries.end(); ++it)
+		uses.push_back( std::make_pair(it->second.lastUse, it->first) );
+
+	// Least recently used first
+	std::sort(uses.begin(), uses.end());
+
+	for (use_vector::const_iterator it = uses.begin(); it != uses.end() && m.size > sizeBudget; ++it)
+	{
+		// NOTE: Artifacts currently mapped cannot be deleted, kept
+		if (::DeleteFileW(lean::utf_to_utf16(m.GetFile(it->second)).c_str()) || ::GetLastError() == ERROR_FILE_NOT_FOUND)
+			m.Forget(it->second);
+	}
+}
+
+// Sets the size budget, zero for unlimited.
+void ArtifactStore::SetSizeBudget(uint8 sizeBudget)
+{
+	{
+		lean::scoped_cs_lock lock(m->lock);
+		m->sizeBudget = sizeBudget;
+	}
+
+	if (sizeBudget)
+		Trim(sizeBudget);
+}
+
+// Gets the size budget.
+uint8 ArtifactStore::GetSizeBudget() const
+{
+	lean::scoped_cs_lock lock(m->lock);
+	return m->sizeBudget;
+}
+
+// Gets the number of bytes currently stored.
+uint8 ArtifactStore::GetSize() const
+{
+	lean::scoped_cs_lock lock(m->lock);
+	return m->size;
+}
+
+// Gets the store directory.
+utf8_ntr ArtifactStore::GetDirectory() const
+{
+	return utf8_ntr(m->directory);
+}
+
+// Gets the thread pool used for (de)compression.
+ThreadPool* ArtifactStore::GetThreadPool() const
+{
+	return m->pPool;
+}
+
+} // namespace
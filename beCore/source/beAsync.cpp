@@ -0,0 +1,362 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beAsync.h"
+
+#include <lean/concurrent/thread.h>
+#include <lean/concurrent/critical_section.h>
+#include <lean/concurrent/semaphore.h>
+#include <lean/functional/callable.h>
+
+#include <deque>
+#include <vector>
+
+#include <lean/logging/errors.h>
+#include <lean/logging/log.h>
+
+namespace beCore
+{
+
+// Schedules the given task for execution. This method is thread-safe.
+void ThreadPoolExecutor::Post(Task *pTask)
+{
+	m_pPool->AddTask(pTask, m_priority);
+}
+
+/// Implementation of the synchronous executor class internals.
+struct SyncExecutor::M
+{
+	typedef std::vector<Task*> task_vector;
+	task_vector tasks;
+	task_vector running;
+
+	lean::critical_section tasksLock;
+};
+
+// Constructor.
+SyncExecutor::SyncExecutor()
+	: m(new M())
+{
+}
+
+// Destructor. Runs all tasks still pending.
+SyncExecutor::~SyncExecutor()
+{
+	// Continuations destroy themselves only when run
+	while (RunPending() > 0);
+}
+
+// Schedules the given task for execution. This method is thread-safe.
+void SyncExecutor::Post(Task *pTask)
+{
+	if (!pTask)
+	{
+		LEAN_LOG_ERROR("nullptr task passed.");
+		return;
+	}
+
+	// Tasks accessed concurrently
+	lean::scoped_cs_lock lock(m->tasksLock);
+	m->tasks.push_back(pTask);
+}
+
+// Runs all tasks posted so far on the calling thread, returning the number of tasks run.
+uint4 SyncExecutor::RunPending()
+{
+	{
+		// Tasks accessed concurrently
+		lean::scoped_cs_lock lock(m->tasksLock);
+
+		// NOTE: Swapping keeps both buffers allocated, no allocations in steady state
+		m->running.swap(m->tasks);
+	}
+
+	const uint4 taskCount = static_cast<uint4>(m->running.size());
+
+	for (M::task_vector::iterator itTask = m->running.begin(); itTask != m->running.end(); ++itTask)
+		(*itTask)->Run();
+
+	m->running.clear();
+
+	return taskCount;
+}
+
+/// Implementation of the thread executor class internals.
+struct ThreadExecutor::M
+{
+	std::deque<Task*> tasks;
+	lean::critical_section tasksLock;
+	lean::semaphore tasksAvailable;
+
+	volatile bool bShuttingDown;
+
+	lean::thread thread;
+
+	/// Constructor.
+	M();
+
+	/// Runs tasks until shut down.
+	void Run();
+};
+
+// Constructor.
+LEAN_INLINE ThreadExecutor::M::M()
+	: tasksAvailable(0),
+	bShuttingDown(false),
+	thread( lean::make_callable(this, &M::Run) )
+{
+}
+
+// Runs tasks until shut down.
+void ThreadExecutor::M::Run()
+{
+	while (true)
+	{
+		// One signal per task, plus one on shut-down
+		tasksAvailable.lock();
+
+		Task *pTask = nullptr;
+
+		{
+			// Tasks accessed concurrently
+			lean::scoped_cs_lock lock(tasksLock);
+
+			if (!tasks.empty())
+			{
+				pTask = tasks.front();
+				tasks.pop_front();
+			}
+		}
+
+		if (!pTask)
+		{
+			if (bShuttingDown)
+				break;
+			else
+				continue;
+		}
+
+		try
+		{
+			pTask->Run();
+		}
+		catch (const std::exception &exc)
+		{
+			LEAN_LOG_ERROR_CTX(exc.what(), "Executor thread");
+		}
+		catch (...)
+		{
+			LEAN_LOG_ERROR_MSG("Unhandled exception in executor thread.");
+		}
+	}
+}
+
+// Constructor. Launches the executor thread.
+ThreadExecutor::ThreadExecutor()
+	: m(new M())
+{
+}
+
+// Destructor. Runs all tasks still pending, then terminates the executor thread.
+ThreadExecutor::~ThreadExecutor()
+{
+	// ORDER: Signal AFTER shut-down flag has been set
+	m->bShuttingDown = true;
+	m->tasksAvailable.unlock();
+
+	// Wait for executor thread to run all pending tasks & exit gracefully
+	m->thread.join();
+}
+
+// Schedules the given task for execution. This method is thread-safe.
+void ThreadExecutor::Post(Task *pTask)
+{
+	if (!pTask)
+	{
+		LEAN_LOG_ERROR("nullptr task passed.");
+		return;
+	}
+
+	{
+		// Tasks accessed concurrently
+		lean::scoped_cs_lock lock(m->tasksLock);
+		m->tasks.push_back(pTask);
+	}
+
+	m->tasksAvailable.unlock();
+}
+
+// Calls Continue(), calls Abort() on exceptions, destroys this continuation.
+void AsyncContinuation::Run()
+{
+	try
+	{
+		Continue();
+	}
+	catch (const std::exception &exc)
+	{
+		LEAN_LOG_ERROR_CTX(exc.what(), "Asynchronous operation");
+		Abort();
+	}
+	catch (...)
+	{
+		LEAN_LOG_ERROR_MSG("Unhandled exception in asynchronous operation.");
+		Abort();
+	}
+
+	delete this;
+}
+
+// Constructor.
+AsyncStateBase::AsyncStateBase()
+	: m_status(Pending),
+	m_pContinuations(nullptr),
+	m_done(false)
+{
+}
+
+// Destructor.
+AsyncStateBase::~AsyncStateBase() throw()
+{
+	// ASSERT: Continuations hold references to their operation, none left when destroyed
+	LEAN_ASSERT(!m_pContinuations);
+}
+
+// Runs or schedules the given continuation.
+void AsyncStateBase::Dispatch(AsyncContinuation *pContinuation)
+{
+	if (pContinuation->m_pExecutor)
+		pContinuation->m_pExecutor->Post(pContinuation);
+	else
+		pContinuation->Run();
+}
+
+// Marks the operation as completed or failed, runs or schedules all continuations.
+void AsyncStateBase::Finish(Status status)
+{
+	AsyncContinuation *pContinuations;
+
+	{
+		// Continuations accessed concurrently
+		lean::scoped_sl_lock lock(m_continuationLock);
+
+		if (m_status != Pending)
+		{
+			LEAN_LOG_ERROR_MSG("Asynchronous operation cannot be completed twice.");
+			return;
+		}
+
+		m_status = status;
+		pContinuations = m_pContinuations;
+		m_pContinuations = nullptr;
+	}
+
+	m_done.set();
+
+	// Continuations were prepended, restore order of registration
+	AsyncContinuation *pOrdered = nullptr;
+
+	while (pContinuations)
+	{
+		AsyncContinuation *pNext = pContinuations->m_pNext;
+		pContinuations->m_pNext = pOrdered;
+		pOrdered = pContinuations;
+		pContinuations = pNext;
+	}
+
+	while (pOrdered)
+	{
+		// WARNING: Continuation may be destroyed as soon as dispatched
+		AsyncContinuation *pNext = pOrdered->m_pNext;
+		Dispatch(pOrdered);
+		pOrdered = pNext;
+	}
+}
+
+// Marks the operation as completed, runs or schedules all continuations.
+void AsyncStateBase::Complete()
+{
+	Finish(Done);
+}
+
+// Marks the operation as failed, runs or schedules all continuations.
+void AsyncStateBase::Fail()
+{
+	Finish(Failed);
+}
+
+// Runs or schedules the given continuation as soon as the operation has completed or failed. This method is thread-safe.
+void AsyncStateBase::Continue(AsyncContinuation *pContinuation)
+{
+	if (!pContinuation)
+	{
+		LEAN_LOG_ERROR("nullptr continuation passed.");
+		return;
+	}
+
+	{
+		// Continuations accessed concurrently
+		lean::scoped_sl_lock lock(m_continuationLock);
+
+		if (m_status == Pending)
+		{
+			pContinuation->m_pNext = m_pContinuations;
+			m_pContinuations = pContinuation;
+			return;
+		}
+	}
+
+	// Already done, continue right away
+	Dispatch(pContinuation);
+}
+
+// Waits for the operation to complete or fail.
+void AsyncStateBase::Wait() const
+{
+	if (m_status == Pending)
+		m_done.wait();
+}
+
+// Waits for the operation to complete, throws if the operation failed.
+void AsyncStateBase::WaitForResult() const
+{
+	Wait();
+
+	if (m_status == Failed)
+		LEAN_THROW_ERROR_MSG("Asynchronous operation failed");
+}
+
+namespace
+{
+
+/// Reads content from a content provider.
+struct ContentReader
+{
+	typedef lean::com_ptr<Content> result_type;
+
+	ContentProvider *pProvider;
+	utf8_string file;
+
+	ContentReader(ContentProvider *pProvider, const utf8_ntri &file)
+		: pProvider(pProvider),
+		file(file.to<utf8_string>()) { }
+
+	result_type operator ()() const
+	{
+		return pProvider->GetContent(file);
+	}
+};
+
+} // namespace
+
+// Reads the content identified by the given path on the given executor.
+Async< lean::com_ptr<Content> > ReadContentAsync(ContentProvider *pProvider, const utf8_ntri &file, Executor *pExecutor)
+{
+	LEAN_ASSERT(pProvider);
+
+	return RunAsync( pExecutor, ContentReader(pProvider, file) );
+}
+
+} // namespace
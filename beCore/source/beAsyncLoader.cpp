@@ -0,0 +1,272 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beAsyncLoader.h"
+
+#include <lean/concurrent/critical_section.h>
+#include <lean/concurrent/event.h>
+
+#include <vector>
+
+#include <lean/logging/errors.h>
+#include <lean/logging/log.h>
+
+namespace beCore
+{
+
+/// Implementation of the asynchronous loader class internals.
+struct AsyncLoader::M
+{
+	ThreadPool *volatile pPool;
+
+	typedef std::vector<AsyncLoadRequest*> request_vector;
+	request_vector requests;
+	request_vector cancelled;
+	request_vector finished;
+	mutable lean::critical_section requestLock;
+
+	volatile uint4 scheduledCount;
+	lean::event idle;
+
+	/// Constructor.
+	M(ThreadPool *pPool)
+		: pPool(pPool),
+		scheduledCount(0),
+		idle(true) { }
+};
+
+namespace
+{
+
+/// Checks if the given request is still waiting for or being loaded.
+LEAN_INLINE bool IsPending(const AsyncLoadRequest *pRequest)
+{
+	return pRequest->GetState() == AsyncLoadState::Queued || pRequest->GetState() == AsyncLoadState::Loading;
+}
+
+} // namespace
+
+// Loads the requested resource unless cancelled. Called by the thread pool.
+void AsyncLoadRequest::Run()
+{
+	AsyncLoader::M &m = *m_pLoader->m;
+	bool bLoad;
+
+	{
+		// States accessed concurrently
+		lean::scoped_cs_lock lock(m.requestLock);
+
+		bLoad = (m_state == AsyncLoadState::Queued);
+
+		if (bLoad)
+			m_state = AsyncLoadState::Loading;
+	}
+
+	AsyncLoadState::T result = AsyncLoadState::Cancelled;
+
+	if (bLoad)
+	{
+		try
+		{
+			Load();
+			result = AsyncLoadState::Loaded;
+		}
+		catch (const std::exception &exc)
+		{
+			LEAN_LOG_ERROR_CTX(exc.what(), "Asynchronous load");
+			result = AsyncLoadState::Failed;
+		}
+		catch (...)
+		{
+			LEAN_LOG_ERROR_MSG("Unhandled exception in asynchronous load.");
+			result = AsyncLoadState::Failed;
+		}
+	}
+
+	{
+		// States accessed concurrently
+		lean::scoped_cs_lock lock(m.requestLock);
+
+		// NOTE: Requests cancelled while loading stay cancelled
+		if (m_state == AsyncLoadState::Loading)
+			m_state = result;
+
+		if (m_bScheduled)
+		{
+			m_bScheduled = false;
+
+			if (--m.scheduledCount == 0)
+				m.idle.set();
+		}
+
+		// WARNING: Request may be destroyed as soon as lock has been released
+	}
+}
+
+// Constructor.
+AsyncLoader::AsyncLoader(ThreadPool *pPool)
+	: m( new M(pPool) )
+{
+}
+
+// Destructor. Cancels all pending requests & waits for those currently being loaded.
+AsyncLoader::~AsyncLoader()
+{
+	{
+		// States accessed concurrently
+		lean::scoped_cs_lock lock(m->requestLock);
+
+		for (M::request_vector::iterator it = m->requests.begin(); it != m->requests.end(); ++it)
+			if (IsPending(*it))
+				(*it)->m_state = AsyncLoadState::Cancelled;
+	}
+
+	// NOTE: Background tasks might be held back, help out instead of waiting forever
+	while (m->scheduledCount > 0)
+		if (!m->pPool || !m->pPool->RunPendingTask(TaskPriority::Background))
+			m->idle.wait();
+
+	{
+		// ORDER: Wait for the last worker to release the lock
+		lean::scoped_cs_lock lock(m->requestLock);
+	}
+
+	for (M::request_vector::iterator it = m->requests.begin(); it != m->requests.end(); ++it)
+		delete *it;
+}
+
+// Schedules the given request with the given priority, taking ownership. Loads synchronously if no thread pool set.
+void AsyncLoader::Load(AsyncLoadRequest *pRequest, TaskPriority::T priority)
+{
+	if (!pRequest)
+	{
+		LEAN_LOG_ERROR("nullptr request passed.");
+		return;
+	}
+
+	pRequest->m_pLoader = this;
+	ThreadPool *pPool = m->pPool;
+
+	{
+		// Requests accessed concurrently
+		lean::scoped_cs_lock lock(m->requestLock);
+
+		try
+		{
+			m->requests.push_back(pRequest);
+		}
+		catch (...)
+		{
+			delete pRequest;
+			throw;
+		}
+
+		if (pPool)
+		{
+			pRequest->m_bScheduled = true;
+
+			if (m->scheduledCount++ == 0)
+				m->idle.reset();
+		}
+	}
+
+	if (pPool)
+		pPool->AddTask(pRequest, priority);
+	else
+		pRequest->Run();
+}
+
+// Publishes all loaded requests & cancels pending requests no longer in use.
+uint4 AsyncLoader::Commit()
+{
+	LEAN_PIMPL();
+
+	{
+		// States accessed concurrently
+		lean::scoped_cs_lock lock(m.requestLock);
+
+		M::request_vector::iterator itKept = m.requests.begin();
+
+		for (M::request_vector::iterator it = m.requests.begin(); it != m.requests.end(); ++it)
+		{
+			AsyncLoadRequest *pRequest = *it;
+
+			// Drop requests nobody is waiting for anymore
+			if (IsPending(pRequest) && !pRequest->IsUsed())
+			{
+				pRequest->m_state = AsyncLoadState::Cancelled;
+				m.cancelled.push_back(pRequest);
+			}
+
+			// NOTE: Scheduled requests are still referenced by the thread pool
+			if (!IsPending(pRequest) && !pRequest->m_bScheduled)
+				m.finished.push_back(pRequest);
+			else
+				*itKept++ = pRequest;
+		}
+
+		m.requests.erase(itKept, m.requests.end());
+	}
+
+	// ORDER: Drop cancelled requests BEFORE finished requests are destroyed
+	for (M::request_vector::iterator it = m.cancelled.begin(); it != m.cancelled.end(); ++it)
+		(*it)->Drop();
+
+	m.cancelled.clear();
+
+	uint4 publishedCount = 0;
+
+	for (M::request_vector::iterator it = m.finished.begin(); it != m.finished.end(); ++it)
+	{
+		AsyncLoadRequest *pRequest = *it;
+
+		try
+		{
+			if (pRequest->m_state == AsyncLoadState::Loaded)
+			{
+				pRequest->Publish();
+				++publishedCount;
+			}
+			else if (pRequest->m_state == AsyncLoadState::Failed)
+				pRequest->Drop();
+		}
+		catch (const std::exception &exc)
+		{
+			LEAN_LOG_ERROR_CTX(exc.what(), "Publishing asynchronously loaded resource");
+		}
+		catch (...)
+		{
+			LEAN_LOG_ERROR_MSG("Unhandled exception while publishing asynchronously loaded resource.");
+		}
+
+		delete pRequest;
+	}
+
+	m.finished.clear();
+
+	return publishedCount;
+}
+
+// Gets the number of requests not yet published or dropped.
+uint4 AsyncLoader::GetPendingCount() const
+{
+	// Requests accessed concurrently
+	lean::scoped_cs_lock lock(m->requestLock);
+	return static_cast<uint4>(m->requests.size());
+}
+
+// Sets the thread pool used for loading.
+void AsyncLoader::SetThreadPool(ThreadPool *pPool)
+{
+	m->pPool = pPool;
+}
+
+// Gets the thread pool used for loading.
+ThreadPool* AsyncLoader::GetThreadPool() const
+{
+	return m->pPool;
+}
+
+} // namespace
@@ -0,0 +1,193 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beAtoms.h"
+
+#include <vector>
+#include <cstring>
+
+#include <lean/concurrent/shareable_spin_lock.h>
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Number of atoms per chunk.
+const uint4 AtomChunkSize = 1024;
+/// Maximum number of chunks.
+const uint4 MaxAtomChunks = 4096;
+
+/// Minimum number of hash table slots.
+const uint4 MinAtomTableCapacity = 256;
+
+/// Interned string.
+struct AtomRecord
+{
+	utf8_string string;
+	uint4 hash;
+};
+
+/// Hash table slot, empty if atom invalid.
+struct AtomSlot
+{
+	uint4 hash;
+	Atom atom;
+};
+
+/// Global atom table.
+struct AtomTable
+{
+	// NOTE: Records are stored in chunks that never move, strings & hashes may be read without locking
+	AtomRecord *chunks[MaxAtomChunks];
+	volatile uint4 count;
+
+	typedef std::vector<AtomSlot> slot_vector;
+	slot_vector slots;
+
+	lean::shareable_spin_lock<> lock;
+
+	/// Constructor.
+	AtomTable()
+		: count(0)
+	{
+		memset(chunks, 0, sizeof(chunks));
+	}
+	/// Destructor.
+	~AtomTable()
+	{
+		for (uint4 i = 0; i < MaxAtomChunks; ++i)
+			delete[] chunks[i];
+	}
+
+	/// Gets the record of the given atom.
+	LEAN_INLINE AtomRecord& GetRecord(Atom atom) const
+	{
+		return chunks[atom / AtomChunkSize][atom % AtomChunkSize];
+	}
+
+	/// Gets the slot of the given string, first empty slot in its probe sequence if not found.
+	uint4 Probe(const HashedString &str) const
+	{
+		const uint4 mask = static_cast<uint4>(slots.size()) - 1;
+		uint4 slotIdx = str.Hash & mask;
+
+		for (; slots[slotIdx].atom != InvalidAtom; slotIdx = (slotIdx + 1) & mask)
+		{
+			const AtomSlot &slot = slots[slotIdx];
+
+			// NOTE: Compare hashes first, strings only touched on likely match
+			if (slot.hash == str.Hash)
+			{
+				const utf8_string &string = GetRecord(slot.atom).string;
+
+				if (string.size() == str.Length && memcmp(string.c_str(), str.String, str.Length) == 0)
+					break;
+			}
+		}
+
+		return slotIdx;
+	}
+
+	/// Grows the hash table to the given capacity.
+	void Rehash(uint4 capacity)
+	{
+		const uint4 mask = capacity - 1;
+
+		AtomSlot emptySlot = { 0, InvalidAtom };
+		slot_vector newSlots(capacity, emptySlot);
+
+		for (slot_vector::const_iterator it = slots.begin(); it != slots.end(); ++it)
+			if (it->atom != InvalidAtom)
+			{
+				uint4 slotIdx = it->hash & mask;
+
+				while (newSlots[slotIdx].atom != InvalidAtom)
+					slotIdx = (slotIdx + 1) & mask;
+
+				newSlots[slotIdx] = *it;
+			}
+
+		newSlots.swap(slots);
+	}
+};
+
+AtomTable g_atoms;
+
+} // namespace
+
+// Gets the atom of the given string, InvalidAtom if the string has never been interned.
+Atom FindAtom(const HashedString &str)
+{
+	// Lookups run concurrently
+	lean::scoped_ssl_lock_shared lock(g_atoms.lock);
+
+	return (!g_atoms.slots.empty())
+		? g_atoms.slots[g_atoms.Probe(str)].atom
+		: InvalidAtom;
+}
+
+// Gets the atom of the given string, interning the string if not interned yet.
+Atom InternAtom(const HashedString &str)
+{
+	Atom atom = FindAtom(str);
+
+	if (atom != InvalidAtom)
+		return atom;
+
+	// Insertions exclusive
+	lean::scoped_ssl_lock lock(g_atoms.lock);
+
+	// NOTE: Keep load factor below 1/2, probe sequences stay short
+	if (2 * (g_atoms.count + 1) > g_atoms.slots.size())
+		g_atoms.Rehash( max(static_cast<uint4>(2 * g_atoms.slots.size()), MinAtomTableCapacity) );
+
+	// NOTE: String might have been interned in the meantime
+	AtomSlot &slot = g_atoms.slots[g_atoms.Probe(str)];
+
+	if (slot.atom != InvalidAtom)
+		return slot.atom;
+
+	atom = g_atoms.count;
+	const uint4 chunkIdx = atom / AtomChunkSize;
+
+	if (chunkIdx >= MaxAtomChunks)
+		LEAN_THROW_ERROR_MSG("Atom table exhausted");
+
+	if (!g_atoms.chunks[chunkIdx])
+		g_atoms.chunks[chunkIdx] = new AtomRecord[AtomChunkSize];
+
+	AtomRecord &record = g_atoms.GetRecord(atom);
+	record.string.assign(str.String, str.Length);
+	record.hash = str.Hash;
+
+	slot.hash = str.Hash;
+	slot.atom = atom;
+
+	// ORDER: Publish AFTER record has been written
+	g_atoms.count = atom + 1;
+
+	return atom;
+}
+
+// Gets the string of the given atom, empty if invalid.
+utf8_ntr GetAtomString(Atom atom)
+{
+	return (atom < g_atoms.count)
+		? utf8_ntr(g_atoms.GetRecord(atom).string)
+		: utf8_ntr("");
+}
+
+// Gets the atom hash of the given atom's string.
+uint4 GetAtomHash(Atom atom)
+{
+	return (atom < g_atoms.count)
+		? g_atoms.GetRecord(atom).hash
+		: HashAtomString("", 0);
+}
+
+} // namespace
@@ -0,0 +1,477 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beBinaryDocument.h"
+#include "beCore/beFileCommit.h"
+
+#include <unordered_map>
+#include <algorithm>
+
+#include <lean/io/mapped_file.h>
+#include <lean/io/raw_file.h>
+
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Pads the given size to 4 bytes.
+LEAN_INLINE size_t PadChunkSize(size_t size)
+{
+	return (size + 3) & ~static_cast<size_t>(3);
+}
+
+/// Appends the given values to the given buffer.
+template <class Value>
+LEAN_INLINE void Append(std::vector<char> &data, const Value *values, size_t count)
+{
+	const char *bytes = reinterpret_cast<const char*>(values);
+	data.insert(data.end(), bytes, bytes + sizeof(Value) * count);
+}
+
+/// Collects strings, storing each distinct string once.
+struct StringTableWriter
+{
+	typedef std::unordered_map<utf8_string, uint4> index_map;
+	index_map indices;
+
+	std::vector<uint4> offsets;
+	std::vector<char> data;
+
+	/// Adds the given string, returning its index.
+	uint4 Add(const utf8_t *str, size_t length)
+	{
+		if (length == 0)
+			return BinaryDocumentNode::NoString;
+
+		std::pair<index_map::iterator, bool> it = indices.insert(
+				index_map::value_type( utf8_string(str, length), static_cast<uint4>(offsets.size()) )
+			);
+
+		if (it.second)
+		{
+			// NOTE: Strings stored consecutively, lengths implied by offsets
+			offsets.push_back( static_cast<uint4>(data.size()) );
+			data.insert(data.end(), str, str + length);
+			data.push_back(0);
+		}
+
+		return it.first->second;
+	}
+};
+
+/// Collects the nodes & attributes of one section.
+struct SectionWriter
+{
+	std::vector<BinaryDocumentNode> nodes;
+	std::vector<BinaryDocumentAttribute> attributes;
+
+	/// Adds the given node & its attributes, including all of its children if requested.
+	void Add(const rapidxml::xml_node<utf8_t> &node, StringTableWriter &strings, bool bChildren)
+	{
+		const size_t nodeIdx = nodes.size();
+
+		BinaryDocumentNode nodeRecord;
+		nodeRecord.Type = node.type();
+		nodeRecord.Name = strings.Add(node.name(), node.name_size());
+		nodeRecord.Value = strings.Add(node.value(), node.value_size());
+		nodeRecord.AttributeCount = 0;
+		nodeRecord.ChildCount = 0;
+
+		for (const rapidxml::xml_attribute<utf8_t> *attribute = node.first_attribute();
+			attribute; attribute = attribute->next_attribute())
+		{
+			BinaryDocumentAttribute attributeRecord;
+			attributeRecord.Name = strings.Add(attribute->name(), attribute->name_size());
+			attributeRecord.Value = strings.Add(attribute->value(), attribute->value_size());
+			attributes.push_back(attributeRecord);
+
+			++nodeRecord.AttributeCount;
+		}
+
+		nodes.push_back(nodeRecord);
+
+		if (bChildren)
+			for (const rapidxml::xml_node<utf8_t> *child = node.first_node(); child; child = child->next_sibling())
+			{
+				Add(*child, strings, true);
+				// NOTE: Node vector may have been reallocated
+				++nodes[nodeIdx].ChildCount;
+			}
+	}
+
+	/// Appends the section to the given buffer.
+	void Write(std::vector<char> &data, uint4 depth) const
+	{
+		BinaryDocumentSection section;
+		section.Depth = depth;
+		section.NodeCount = static_cast<uint4>(nodes.size());
+		section.AttributeCount = static_cast<uint4>(attributes.size());
+		section._Pad = 0;
+
+		Append(data, &section, 1);
+		if (!nodes.empty())
+			Append(data, &nodes[0], nodes.size());
+		if (!attributes.empty())
+			Append(data, &attributes[0], attributes.size());
+	}
+};
+
+/// Appends the given chunk to the given buffer.
+void AppendChunk(std::vector<char> &data, uint4 id, const std::vector<char> &chunkData)
+{
+	BinaryDocumentChunk chunk;
+	chunk.ID = id;
+	chunk.Size = static_cast<uint4>(chunkData.size());
+
+	Append(data, &chunk, 1);
+	if (!chunkData.empty())
+		Append(data, &chunkData[0], chunkData.size());
+	data.resize(data.size() + PadChunkSize(chunkData.size()) - chunkData.size(), 0);
+}
+
+/// Mapped string table.
+struct StringTable
+{
+	const uint4 *offsets;
+	uint4 count;
+	const utf8_t *data;
+	uint4 size;
+
+	/// Constructor.
+	StringTable()
+		: offsets(), count(), data(), size() { }
+
+	/// Gets the given string.
+	LEAN_INLINE const utf8_t* Get(uint4 idx, size_t &length, const utf8_t *context) const
+	{
+		if (idx == BinaryDocumentNode::NoString)
+		{
+			length = 0;
+			return nullptr;
+		}
+		else if (idx >= count)
+			LEAN_THROW_ERROR_CTX("Binary document string index out of bounds", context);
+
+		// NOTE: Strings stored consecutively, validated on load
+		const uint4 end = (idx + 1 < count) ? offsets[idx + 1] : size;
+		length = end - offsets[idx] - 1;
+		return data + offsets[idx];
+	}
+};
+
+/// Loads the given string table chunk.
+void LoadStrings(StringTable &strings, const char *data, size_t size, const utf8_t *context)
+{
+	if (size < sizeof(uint4))
+		LEAN_THROW_ERROR_CTX("Binary document string table truncated", context);
+
+	strings.count = *reinterpret_cast<const uint4*>(data);
+
+	if (strings.count > (size - sizeof(uint4)) / sizeof(uint4))
+		LEAN_THROW_ERROR_CTX("Binary document string table truncated", context);
+
+	strings.offsets = reinterpret_cast<const uint4*>(data + sizeof(uint4));
+	strings.data = data + sizeof(uint4) * (1 + strings.count);
+	strings.size = static_cast<uint4>( size - sizeof(uint4) * (1 + strings.count) );
+
+	// NOTE: Validate once, string accesses trusted from now on
+	if (strings.count > 0 && (strings.size == 0 || strings.data[strings.size - 1] != 0 || strings.offsets[0] != 0))
+		LEAN_THROW_ERROR_CTX("Binary document string table corrupted", context);
+
+	for (uint4 i = 1; i < strings.count; ++i)
+		if (strings.offsets[i] <= strings.offsets[i - 1] || strings.offsets[i] >= strings.size
+			|| strings.data[strings.offsets[i] - 1] != 0)
+			LEAN_THROW_ERROR_CTX("Binary document string table corrupted", context);
+}
+
+/// Parent node awaiting children.
+struct PendingParent
+{
+	rapidxml::xml_node<utf8_t> *node;
+	uint4 remaining;
+
+	/// Constructor.
+	PendingParent(rapidxml::xml_node<utf8_t> *node, uint4 remaining)
+		: node(node), remaining(remaining) { }
+};
+
+/// Loads the given section chunk, returning its root node.
+rapidxml::xml_node<utf8_t>* LoadSection(rapidxml::xml_document<utf8_t> &document, const BinaryDocumentSection &section,
+	const char *data, size_t size, const StringTable &strings, const utf8_t *context)
+{
+	if (section.NodeCount == 0 ||
+		(size - sizeof(BinaryDocumentSection)) / sizeof(BinaryDocumentNode) < section.NodeCount ||
+		(size - sizeof(BinaryDocumentSection) - sizeof(BinaryDocumentNode) * section.NodeCount) / sizeof(BinaryDocumentAttribute) < section.AttributeCount)
+		LEAN_THROW_ERROR_CTX("Binary document section truncated", context);
+
+	const BinaryDocumentNode *nodes = reinterpret_cast<const BinaryDocumentNode*>(data + sizeof(BinaryDocumentSection));
+	const BinaryDocumentAttribute *attributes = reinterpret_cast<const BinaryDocumentAttribute*>(nodes + section.NodeCount);
+	uint4 nextAttributeIdx = 0;
+
+	rapidxml::xml_node<utf8_t> *root = nullptr;
+	std::vector<PendingParent> parents;
+
+	for (uint4 i = 0; i < section.NodeCount; ++i)
+	{
+		const BinaryDocumentNode &nodeRecord = nodes[i];
+
+		if (nodeRecord.Type > rapidxml::node_pi || nodeRecord.Type == rapidxml::node_document)
+			LEAN_THROW_ERROR_CTX("Binary document node type invalid", context);
+		if (root && parents.empty())
+			LEAN_THROW_ERROR_CTX("Binary document section has multiple roots", context);
+		if (nodeRecord.AttributeCount > section.AttributeCount - nextAttributeIdx)
+			LEAN_THROW_ERROR_CTX("Binary document attributes out of bounds", context);
+
+		rapidxml::xml_node<utf8_t> *node = document.allocate_node( static_cast<rapidxml::node_type>(nodeRecord.Type) );
+		size_t length;
+
+		// NOTE: Strings point into the given data, nothing copied
+		if (const utf8_t *name = strings.Get(nodeRecord.Name, length, context))
+			node->name(name, length);
+		if (const utf8_t *value = strings.Get(nodeRecord.Value, length, context))
+			node->value(value, length);
+
+		for (uint4 j = 0; j < nodeRecord.AttributeCount; ++j)
+		{
+			const BinaryDocumentAttribute &attributeRecord = attributes[nextAttributeIdx++];
+			rapidxml::xml_attribute<utf8_t> *attribute = document.allocate_attribute();
+
+			if (const utf8_t *name = strings.Get(attributeRecord.Name, length, context))
+				attribute->name(name, length);
+			if (const utf8_t *value = strings.Get(attributeRecord.Value, length, context))
+				attribute->value(value, length);
+
+			node->append_attribute(attribute);
+		}
+
+		if (parents.empty())
+			root = node;
+		else
+		{
+			PendingParent &parent = parents.back();
+			parent.node->append_node(node);
+
+			if (--parent.remaining == 0)
+				parents.pop_back();
+		}
+
+		if (nodeRecord.ChildCount > 0)
+			parents.push_back( PendingParent(node, nodeRecord.ChildCount) );
+	}
+
+	if (!parents.empty())
+		LEAN_THROW_ERROR_CTX("Binary document section truncated", context);
+
+	return root;
+}
+
+/// Loads the given binary document data into the given document.
+void LoadDocument(const void *data, size_t size, rapidxml::xml_document<utf8_t> &document, const utf8_t *context)
+{
+	const char *bytes = static_cast<const char*>(data);
+
+	if (!IsBinaryDocument(data, size))
+		LEAN_THROW_ERROR_CTX("Not a binary document", context);
+
+	const BinaryDocumentHeader &header = *reinterpret_cast<const BinaryDocumentHeader*>(bytes);
+
+	if (header.Version < BinaryDocumentHeader::MinVersion || header.Version > BinaryDocumentHeader::CurrentVersion)
+		LEAN_THROW_ERROR_CTX("Binary document version unsupported", context);
+
+	StringTable strings;
+	rapidxml::xml_node<utf8_t> *topLevelNode = nullptr;
+
+	size_t pos = sizeof(BinaryDocumentHeader);
+
+	for (uint4 i = 0; i < header.ChunkCount; ++i)
+	{
+		if (size - pos < sizeof(BinaryDocumentChunk))
+			LEAN_THROW_ERROR_CTX("Binary document truncated", context);
+
+		const BinaryDocumentChunk &chunk = *reinterpret_cast<const BinaryDocumentChunk*>(bytes + pos);
+		pos += sizeof(BinaryDocumentChunk);
+
+		if (chunk.Size > size - pos)
+			LEAN_THROW_ERROR_CTX("Binary document chunk truncated", context);
+
+		const char *chunkData = bytes + pos;
+
+		switch (chunk.ID)
+		{
+		case BinaryDocumentChunk::Strings:
+			LoadStrings(strings, chunkData, chunk.Size, context);
+			break;
+
+		case BinaryDocumentChunk::Section:
+			{
+				if (chunk.Size < sizeof(BinaryDocumentSection))
+					LEAN_THROW_ERROR_CTX("Binary document section truncated", context);
+
+				const BinaryDocumentSection &section = *reinterpret_cast<const BinaryDocumentSection*>(chunkData);
+				rapidxml::xml_node<utf8_t> *sectionRoot = LoadSection(document, section, chunkData, chunk.Size, strings, context);
+
+				if (section.Depth == 0)
+				{
+					document.append_node(sectionRoot);
+					topLevelNode = sectionRoot;
+				}
+				else if (section.Depth == 1 && topLevelNode)
+					topLevelNode->append_node(sectionRoot);
+				else
+					LEAN_THROW_ERROR_CTX("Binary document section out of place", context);
+			}
+			break;
+
+		// NOTE: Unknown chunks skipped for forward compatibility
+		}
+
+		pos += std::min(PadChunkSize(chunk.Size), size - pos);
+	}
+}
+
+} // namespace
+
+/// Binary document internals.
+struct BinaryDocument::M
+{
+	lean::rmapped_file file;
+	rapidxml::xml_document<utf8_t> document;
+
+	/// Constructor.
+	M(const utf8_ntri &file)
+		: file(file) { }
+};
+
+// Maps & loads the given binary document file.
+BinaryDocument::BinaryDocument(const utf8_ntri &file)
+	: m( new M(file) )
+{
+	LoadDocument(m->file.data(), static_cast<size_t>(m->file.size()), m->document, file.c_str());
+}
+
+// Destructor.
+BinaryDocument::~BinaryDocument()
+{
+}
+
+// Gets the document.
+rapidxml::xml_document<utf8_t>& BinaryDocument::Document()
+{
+	return m->document;
+}
+
+// Gets the document.
+const rapidxml::xml_document<utf8_t>& BinaryDocument::Document() const
+{
+	return m->document;
+}
+
+// Checks if the given file is a binary document.
+bool IsBinaryDocument(const utf8_ntri &file)
+{
+	BinaryDocumentHeader header;
+
+	try
+	{
+		lean::raw_file rawFile(file, lean::file::read);
+
+		if (rawFile.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header))
+			return false;
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	return IsBinaryDocument(&header, sizeof(header));
+}
+
+// Checks if the given data is a binary document.
+bool IsBinaryDocument(const void *data, size_t size)
+{
+	return size >= sizeof(BinaryDocumentHeader)
+		&& static_cast<const BinaryDocumentHeader*>(data)->Magic == BinaryDocumentHeader::MagicID;
+}
+
+// Loads the given binary document data into the given document.
+void LoadBinaryDocument(const void *data, size_t size, rapidxml::xml_document<utf8_t> &document)
+{
+	LoadDocument(data, size, document, "LoadBinaryDocument()");
+}
+
+// Writes the given document into the given buffer in binary form.
+void WriteBinaryDocument(const rapidxml::xml_document<utf8_t> &document, std::vector<char> &data)
+{
+	StringTableWriter strings;
+	std::vector<char> sections;
+	uint4 sectionCount = 0;
+
+	// NOTE: One section per top-level node and per child of top-level elements
+	for (const rapidxml::xml_node<utf8_t> *topLevelNode = document.first_node();
+		topLevelNode; topLevelNode = topLevelNode->next_sibling())
+	{
+		const bool bSplit = (topLevelNode->type() == rapidxml::node_element);
+
+		SectionWriter section;
+		section.Add(*topLevelNode, strings, !bSplit);
+
+		std::vector<char> sectionData;
+		section.Write(sectionData, 0);
+		AppendChunk(sections, BinaryDocumentChunk::Section, sectionData);
+		++sectionCount;
+
+		if (bSplit)
+			for (const rapidxml::xml_node<utf8_t> *node = topLevelNode->first_node(); node; node = node->next_sibling())
+			{
+				SectionWriter childSection;
+				childSection.Add(*node, strings, true);
+
+				sectionData.clear();
+				childSection.Write(sectionData, 1);
+				AppendChunk(sections, BinaryDocumentChunk::Section, sectionData);
+				++sectionCount;
+			}
+	}
+
+	std::vector<char> stringData;
+	{
+		uint4 stringCount = static_cast<uint4>(strings.offsets.size());
+		Append(stringData, &stringCount, 1);
+		if (!strings.offsets.empty())
+			Append(stringData, &strings.offsets[0], strings.offsets.size());
+		if (!strings.data.empty())
+			Append(stringData, &strings.data[0], strings.data.size());
+	}
+
+	BinaryDocumentHeader header;
+	header.Magic = BinaryDocumentHeader::MagicID;
+	header.Version = BinaryDocumentHeader::CurrentVersion;
+	header.ChunkCount = 1 + sectionCount;
+	header._Pad = 0;
+
+	data.clear();
+	data.reserve(sizeof(header) + sizeof(BinaryDocumentChunk) + PadChunkSize(stringData.size()) + sections.size());
+
+	Append(data, &header, 1);
+	// ORDER: Strings required by all sections
+	AppendChunk(data, BinaryDocumentChunk::Strings, stringData);
+	data.insert(data.end(), sections.begin(), sections.end());
+}
+
+// Saves the given document to the given file in binary form.
+void SaveBinaryDocument(const rapidxml::xml_document<utf8_t> &document, const utf8_ntri &file)
+{
+	std::vector<char> data;
+	WriteBinaryDocument(document, data);
+
+	// NOTE: Never leave a partially written document behind
+	CommitFile(file, &data[0], data.size());
+}
+
+} // namespace
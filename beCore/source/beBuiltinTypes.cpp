@@ -8,6 +8,7 @@
 
 #include <lean/properties/property_types.h>
 #include "beCore/beGenericTextSerializer.h"
+#include "beCore/beNumericText.h"
 
 namespace beCore
 {
@@ -19,7 +20,8 @@ template <class Type, class TextSerializerType>
 const ValueTypeDesc& RegisterBuiltinType(ValueTypes &valueTypes)
 {
 	static const GenericTextSerializer<TextSerializerType> textSerializer;
-	const ValueTypeDesc &desc = valueTypes.AddType( lean::get_property_type_info<Type>() );
+	// NOTE: Builtin types are plain values
+	const ValueTypeDesc &desc = valueTypes.AddType( lean::get_property_type_info<Type>(), true );
 	valueTypes.SetSerializer(&textSerializer);
 	return desc;
 }
@@ -33,13 +35,14 @@ const ValueTypeDesc& RegisterBoolType(ValueTypes &valueTypes)
 template <class Type>
 const ValueTypeDesc& RegisterIntType(ValueTypes &valueTypes)
 {
-	return RegisterBuiltinType< Type, lean::io::int_serialization<Type> >(valueTypes);
+	return RegisterBuiltinType< Type, NumericTextSerialization<Type> >(valueTypes);
 }
 
 template <class Type>
 const ValueTypeDesc& RegisterFloatType(ValueTypes &valueTypes)
 {
-	return RegisterBuiltinType< Type, lean::io::float_serialization<Type> >(valueTypes);
+	// NOTE: Shortest round-trip output, locale-independent
+	return RegisterBuiltinType< Type, NumericTextSerialization<Type> >(valueTypes);
 }
 
 } // namespace
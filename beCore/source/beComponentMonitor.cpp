@@ -5,15 +5,65 @@
 #include "beCoreInternal/stdafx.h"
 #include "beCore/beComponentMonitor.h"
 #include <string>
+#include <algorithm>
 #include <lean/functional/algorithm.h>
 #include <lean/concurrent/critical_section.h>
 
 namespace beCore
 {
 
+namespace
+{
+
+typedef std::vector<const void*> components_t;
+
+/// Changes to components of one type.
+struct TypeChanges
+{
+	const ComponentType *Type;
+	bool Untracked;				///< Some changes not recorded per component.
+	components_t Components;	///< Changed components.
+
+	/// Constructor.
+	TypeChanges(const ComponentType *type)
+		: Type(type),
+		Untracked(false) { }
+};
+
+typedef std::vector<TypeChanges> type_changes_t;
+
+/// Orders by type.
+struct TypeChangesByType
+{
+	LEAN_INLINE bool operator ()(const TypeChanges &left, const ComponentType *right) const { return left.Type < right; }
+};
+
+/// Gets the changes to components of the given type, inserting them if missing.
+TypeChanges& GetTypeChanges(type_changes_t &changes, const ComponentType *type)
+{
+	type_changes_t::iterator it = std::lower_bound(changes.begin(), changes.end(), type, TypeChangesByType());
+
+	if (it == changes.end() || it->Type != type)
+		it = changes.insert(it, TypeChanges(type));
+
+	return *it;
+}
+
+/// Gets the changes to components of the given type, nullptr if none.
+const TypeChanges* FindTypeChanges(const type_changes_t &changes, const ComponentType *type)
+{
+	type_changes_t::const_iterator it = std::lower_bound(changes.begin(), changes.end(), type, TypeChangesByType());
+	return (it != changes.end() && it->Type == type) ? &*it : nullptr;
+}
+
+} // namespace
+
 struct ComponentMonitorChannel::M
 {
 	lean::critical_section cs;
+
+	type_changes_t changedComponents;
+	type_changes_t processedComponents;
 };
 
 // Constructor.
@@ -33,6 +83,17 @@ void ComponentMonitorChannel::AddChanged(const ComponentType *type)
 	lean::scoped_cs_lock lock(m->cs);
 
 	lean::push_sorted_unique(m_changedTypes, type);
+	GetTypeChanges(m->changedComponents, type).Untracked = true;
+}
+
+// Marks the given component of the given type as changed.
+void ComponentMonitorChannel::AddChanged(const ComponentType *type, const void *component)
+{
+	lean::scoped_cs_lock lock(m->cs);
+
+	lean::push_sorted_unique(m_changedTypes, type);
+	// NOTE: Duplicates removed on processing, keep appending cheap
+	GetTypeChanges(m->changedComponents, type).Components.push_back(component);
 }
 
 // Processes the next batch of changes.
@@ -42,6 +103,16 @@ void ComponentMonitorChannel::Process()
 
 	m_processedTypes.clear();
 	swap(m_processedTypes, m_changedTypes);
+
+	m->processedComponents.clear();
+	swap(m->processedComponents, m->changedComponents);
+
+	for (type_changes_t::iterator it = m->processedComponents.begin(); it != m->processedComponents.end(); ++it)
+	{
+		components_t &components = it->Components;
+		std::sort(components.begin(), components.end());
+		components.erase(std::unique(components.begin(), components.end()), components.end());
+	}
 }
 
 // Checks if there are more changes to process.
@@ -56,4 +127,23 @@ bool ComponentMonitorChannel::HasChanged(const ComponentType *type) const
 	return lean::find_sorted(m_processedTypes.begin(), m_processedTypes.end(), type) != m_processedTypes.end();
 }
 
+// Checks if all changes to components of the given type have been recorded per component.
+bool ComponentMonitorChannel::AllChangesTracked(const ComponentType *type) const
+{
+	const TypeChanges *changes = FindTypeChanges(m->processedComponents, type);
+	// NOTE: No changes at all are trivially tracked
+	return !changes || !changes->Untracked;
+}
+
+// Gets the components of the given type that have been changed.
+ComponentMonitorChannel::Components ComponentMonitorChannel::GetChanged(const ComponentType *type) const
+{
+	const TypeChanges *changes = FindTypeChanges(m->processedComponents, type);
+
+	if (changes && !changes->Components.empty())
+		return Components(&changes->Components[0], &changes->Components[0] + changes->Components.size());
+	else
+		return Components();
+}
+
 } // namespace
@@ -0,0 +1,308 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beCompressedContent.h"
+#include "beCore/beCompression.h"
+#include "beCore/beParallel.h"
+
+
+#include <vector>
+#include <cstring>
+
+#include <lean/io/raw_file.h>
+#include <lean/smart/scoped_ptr.h>
+
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Content decompressed into one contiguous buffer.
+class DecompressedContent : public Content
+{
+private:
+	lean::scoped_ptr<char[]> m_buffer;
+
+public:
+	/// Constructor.
+	DecompressedContent(uint8 size)
+		: m_buffer( new char[static_cast<size_t>(size)] )
+	{
+		m_memory = m_buffer.get();
+		m_size = size;
+	}
+
+	/// Gets the buffer.
+	char* GetBuffer() { return m_buffer.get(); }
+};
+
+/// Number of blocks compressed ahead per worker, bounds compression scratch memory.
+const uint4 ScratchBlocksPerWorker = 2;
+
+/// Gets the number of content bytes in the given block.
+LEAN_INLINE uint4 GetBlockContentSize(uint8 size, uint4 blockSize, uint4 blockIdx)
+{
+	return static_cast<uint4>( min<uint8>(blockSize, size - static_cast<uint8>(blockSize) * blockIdx) );
+}
+
+/// Decompresses ranges of blocks.
+struct BlockDecompressor
+{
+	const char *blocks;
+	const uint4 *blockSizes;
+	const uint8 *blockOffsets;
+	char *dest;
+	uint8 size;
+	uint4 blockSize;
+	volatile long *pFailed;
+
+	/// Decompresses the given range of blocks.
+	void operator ()(Range<uint4> range) const
+	{
+		for (uint4 i = range.Begin; i < range.End; ++i)
+		{
+			const char *src = blocks + static_cast<size_t>(blockOffsets[i]);
+			char *blockDest = dest + static_cast<size_t>(blockSize) * i;
+			const uint4 storedSize = blockSizes[i] & ~CompressedContentHeader::RawBlockFlag;
+			const uint4 contentSize = GetBlockContentSize(size, blockSize, i);
+
+			try
+			{
+				// NOTE: Block sizes validated before allocation
+				if (blockSizes[i] & CompressedContentHeader::RawBlockFlag)
+					memcpy(blockDest, src, storedSize);
+				else
+					DecompressLZ(src, storedSize, blockDest, contentSize);
+			}
+			catch (...)
+			{
+				// NOTE: Exceptions must not escape worker threads, re-thrown by the calling thread
+				*pFailed = 1;
+			}
+		}
+	}
+};
+
+/// Compresses ranges of blocks.
+struct BlockCompressor
+{
+	const char *src;
+	uint8 size;
+	uint4 blockSize;
+	char *scratch;
+	size_t scratchStride;
+	uint4 firstBlock;
+	uint4 *blockSizes;
+
+	/// Compresses the given range of blocks.
+	void operator ()(Range<uint4> range) const
+	{
+		for (uint4 i = range.Begin; i < range.End; ++i)
+		{
+			const uint4 contentSize = GetBlockContentSize(size, blockSize, i);
+			size_t compressedSize = CompressLZ(src + static_cast<size_t>(blockSize) * i, contentSize,
+				scratch + scratchStride * (i - firstBlock), scratchStride);
+
+			// Store incompressible blocks as they are
+			blockSizes[i] = (compressedSize < contentSize)
+				? static_cast<uint4>(compressedSize)
+				: contentSize | CompressedContentHeader::RawBlockFlag;
+		}
+	}
+};
+
+} // namespace
+
+// Checks if the given data is block-compressed content.
+bool IsCompressedContent(const void *data, uint8 size)
+{
+	if (size < sizeof(CompressedContentHeader))
+		return false;
+
+	uint4 magic;
+	memcpy(&magic, data, sizeof(magic));
+	return (magic == CompressedContentHeader::MagicID);
+}
+
+// Decompresses the given block-compressed content into one contiguous buffer.
+lean::com_ptr<Content, true> DecompressContent(const void *data, uint8 size, ThreadPool *pPool)
+{
+	if (!IsCompressedContent(data, size))
+		LEAN_THROW_ERROR_MSG("Not block-compressed content");
+
+	CompressedContentHeader header;
+	memcpy(&header, data, sizeof(header));
+
+	if (header.Version != CompressedContentHeader::CurrentVersion)
+		LEAN_THROW_ERROR_MSG("Compressed content version unsupported");
+	// NOTE: Compare in blocks, content sizes near the range limit must not wrap around
+	if ((header.BlockSize == 0 || header.BlockSize & CompressedContentHeader::RawBlockFlag) ||
+		header.BlockCount != header.Size / header.BlockSize + (header.Size % header.BlockSize != 0) ||
+		header.Size > static_cast<size_t>(-1))
+		LEAN_THROW_ERROR_MSG("Compressed content header corrupted");
+
+	const char *bytes = static_cast<const char*>(data);
+	const uint8 tableSize = static_cast<uint8>(header.BlockCount) * sizeof(uint4);
+
+	if (tableSize > size - sizeof(header))
+		LEAN_THROW_ERROR_MSG("Compressed content block table truncated");
+
+	const uint4 *blockSizes = reinterpret_cast<const uint4*>(bytes + sizeof(header));
+	const char *blocks = bytes + sizeof(header) + static_cast<size_t>(tableSize);
+	const uint8 blocksSize = size - sizeof(header) - tableSize;
+
+	// Block offsets & sizes, validated before allocating anything the size of the content
+	std::vector<uint8> blockOffsets(header.BlockCount);
+	uint8 blockOffset = 0;
+
+	for (uint4 i = 0; i < header.BlockCount; ++i)
+	{
+		const uint4 storedSize = blockSizes[i] & ~CompressedContentHeader::RawBlockFlag;
+		const uint4 contentSize = GetBlockContentSize(header.Size, header.BlockSize, i);
+
+		if ((blockSizes[i] & CompressedContentHeader::RawBlockFlag)
+				? storedSize != contentSize
+				: storedSize == 0 || contentSize > GetMaxDecompressedSize(storedSize))
+			LEAN_THROW_ERROR_MSG("Compressed content block sizes inconsistent");
+
+		blockOffsets[i] = blockOffset;
+		blockOffset += storedSize;
+
+		if (blockOffset > blocksSize)
+			LEAN_THROW_ERROR_MSG("Compressed content blocks truncated");
+	}
+
+	// Each block checked above, total re-checked against the stored bytes actually present
+	if (header.Size > GetMaxDecompressedSize(blockOffset) || header.Size > static_cast<uint8>(header.BlockCount) * header.BlockSize)
+		LEAN_THROW_ERROR_MSG("Compressed content size inconsistent");
+
+	lean::com_ptr<DecompressedContent> pContent = lean::bind_com( new DecompressedContent(header.Size) );
+	volatile long failed = 0;
+
+	if (header.BlockCount > 0)
+	{
+		BlockDecompressor decompressor;
+		decompressor.blocks = blocks;
+		decompressor.blockSizes = blockSizes;
+		decompressor.blockOffsets = &blockOffsets[0];
+		decompressor.dest = pContent->GetBuffer();
+		decompressor.size = header.Size;
+		decompressor.blockSize = header.BlockSize;
+		decompressor.pFailed = &failed;
+
+		// NOTE: One block per chunk, blocks are large enough to amortize scheduling
+		ParallelFor(pPool, Range<uint4>(0, header.BlockCount), 1, decompressor);
+	}
+
+	if (failed)
+		LEAN_THROW_ERROR_MSG("Compressed content blocks corrupted");
+
+	return pContent.transfer();
+}
+
+// Decompresses the given content if block-compressed, returns the given content unchanged otherwise.
+lean::com_ptr<Content, true> DecompressContent(Content *pContent, ThreadPool *pPool)
+{
+	LEAN_THROW_NULL(pContent);
+
+	if (IsCompressedContent(pContent->Data(), pContent->Size()))
+		return DecompressContent(pContent->Data(), pContent->Size(), pPool);
+	else
+		return lean::com_ptr<Content>(pContent).transfer();
+}
+
+// Writes the given data to the given file as block-compressed content.
+void WriteCompressedContent(const utf8_ntri &file, const void *data, uint8 size, uint4 blockSize, ThreadPool *pPool)
+{
+	lean::raw_file outFile(file, lean::file::write, lean::file::overwrite, lean::file::sequential);
+	WriteCompressedContent(outFile, data, size, blockSize, pPool);
+}
+
+// Writes the given data to the given file as block-compressed content, starting at the current file position.
+void WriteCompressedContent(lean::raw_file &outFile, const void *data, uint8 size, uint4 blockSize, ThreadPool *pPool)
+{
+	if (blockSize == 0 || blockSize & CompressedContentHeader::RawBlockFlag)
+		LEAN_THROW_ERROR_MSG("Invalid compressed content block size");
+
+	CompressedContentHeader header;
+	header.Magic = CompressedContentHeader::MagicID;
+	header.Version = CompressedContentHeader::CurrentVersion;
+	header.BlockSize = blockSize;
+	header.BlockCount = static_cast<uint4>( (size + blockSize - 1) / blockSize );
+	header.Size = size;
+
+	const char *src = static_cast<const char*>(data);
+	const size_t scratchStride = GetMaxCompressedSize(blockSize);
+
+	std::vector<uint4> blockSizes(header.BlockCount);
+
+	outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	if (header.BlockCount > 0)
+	{
+		// NOTE: Table written once all blocks are known, reserved up front
+		const uint8 tablePos = outFile.pos();
+		outFile.write(reinterpret_cast<const char*>(&blockSizes[0]), sizeof(uint4) * blockSizes.size());
+
+		// Compress in batches of a few blocks per worker, scratch memory independent of content size
+		const uint4 batchSize = static_cast<uint4>( min<uint8>(
+				(pPool) ? (pPool->GetThreadCount() + 1) * ScratchBlocksPerWorker : 1,
+				header.BlockCount
+			) );
+		std::vector<char> scratch(scratchStride * batchSize);
+
+		BlockCompressor compressor;
+		compressor.src = src;
+		compressor.size = size;
+		compressor.blockSize = blockSize;
+		compressor.scratch = &scratch[0];
+		compressor.scratchStride = scratchStride;
+		compressor.blockSizes = &blockSizes[0];
+
+		for (uint4 batchBegin = 0; batchBegin < header.BlockCount; batchBegin += batchSize)
+		{
+			const uint4 batchEnd = min(batchBegin + batchSize, header.BlockCount);
+
+			compressor.firstBlock = batchBegin;
+			ParallelFor(pPool, Range<uint4>(batchBegin, batchEnd), 1, compressor);
+
+			for (uint4 i = batchBegin; i < batchEnd; ++i)
+				if (blockSizes[i] & CompressedContentHeader::RawBlockFlag)
+					outFile.write(src + static_cast<size_t>(blockSize) * i, blockSizes[i] & ~CompressedContentHeader::RawBlockFlag);
+				else
+					outFile.write(&scratch[scratchStride * (i - batchBegin)], blockSizes[i]);
+		}
+
+		const uint8 endPos = outFile.pos();
+		outFile.pos(tablePos);
+		outFile.write(reinterpret_cast<const char*>(&blockSizes[0]), sizeof(uint4) * blockSizes.size());
+		outFile.pos(endPos);
+	}
+}
+
+// Compresses the given source file into the given destination file.
+void CompressContentFile(const utf8_ntri &source, const utf8_ntri &dest, uint4 blockSize, ThreadPool *pPool)
+{
+	std::vector<char> data;
+
+	// NOTE: Read all data first, source & destination may be the same
+	{
+		lean::raw_file sourceFile(source, lean::file::read);
+		data.resize( static_cast<size_t>(sourceFile.size()) );
+
+		if (!data.empty() && sourceFile.read(&data[0], data.size()) != data.size())
+			LEAN_THROW_ERROR_CTX("Failed to read file to be compressed", source.c_str());
+	}
+
+	if (IsCompressedContent(!data.empty() ? &data[0] : nullptr, data.size()))
+		LEAN_THROW_ERROR_CTX("File already compressed", source.c_str());
+
+	WriteCompressedContent(dest, !data.empty() ? &data[0] : nullptr, data.size(), blockSize, pPool);
+}
+
+} // namespace
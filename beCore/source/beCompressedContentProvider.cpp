@@ -0,0 +1,43 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beCompressedContentProvider.h"
+#include "beCore/beCompressedContent.h"
+
+namespace beCore
+{
+
+// Constructor.
+CompressedContentProvider::CompressedContentProvider(const ContentProvider &provider, ThreadPool *pPool)
+	: m_provider(provider),
+	m_pPool(pPool)
+{
+}
+
+// Gets the content identified by the given path.
+lean::com_ptr<Content, true> CompressedContentProvider::GetContent(const utf8_ntri &file)
+{
+	lean::com_ptr<Content> pContent = m_provider->GetContent(file);
+	return DecompressContent(pContent, m_pPool);
+}
+
+// Gets a revision number for the content identified by the given path.
+uint8 CompressedContentProvider::GetRevision(const utf8_ntri &file) const
+{
+	return m_provider->GetRevision(file);
+}
+
+// Constructs and returns a clone of this path resolver.
+CompressedContentProvider* CompressedContentProvider::clone() const
+{
+	return new CompressedContentProvider(*this);
+}
+// Destroys an include manager.
+void CompressedContentProvider::destroy() const
+{
+	delete this;
+}
+
+} // namespace
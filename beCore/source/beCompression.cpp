@@ -0,0 +1,248 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beCompression.h"
+
+#include <cstring>
+
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+const size_t MinMatch = 4;
+/// Number of trailing bytes always stored as literals.
+const size_t LastLiterals = 5;
+/// Minimum distance of the last match start to the end of the input.
+const size_t MatchFindLimit = 12;
+const size_t MaxOffset = 0xffff;
+
+const uint4 HashBits = 12;
+const size_t HashSize = 1U << HashBits;
+
+/// Reads four unaligned bytes.
+LEAN_INLINE uint4 Read4(const unsigned char *p)
+{
+	uint4 value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+/// Hashes the given four bytes.
+LEAN_INLINE uint4 HashSequence(uint4 sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HashBits);
+}
+
+/// Writes the given length in LZ4 continuation bytes.
+LEAN_INLINE unsigned char* WriteLength(unsigned char *op, size_t length)
+{
+	for (; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = static_cast<unsigned char>(length);
+	return op;
+}
+
+/// Reads the given length in LZ4 continuation bytes.
+LEAN_INLINE size_t ReadLength(const unsigned char *&ip, const unsigned char *iend, size_t length)
+{
+	unsigned char next;
+
+	do
+	{
+		if (ip >= iend)
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: length truncated");
+
+		next = *ip++;
+		length += next;
+	}
+	while (next == 255);
+
+	return length;
+}
+
+/// Writes a sequence of literals followed by a match of the given length, if any.
+LEAN_INLINE unsigned char* WriteSequence(unsigned char *op, const unsigned char *literals, size_t literalLength,
+	size_t offset, size_t matchLength)
+{
+	unsigned char *token = op++;
+
+	if (literalLength >= 15)
+	{
+		*token = 15 << 4;
+		op = WriteLength(op, literalLength - 15);
+	}
+	else
+		*token = static_cast<unsigned char>(literalLength << 4);
+
+	memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	if (matchLength)
+	{
+		*op++ = static_cast<unsigned char>(offset);
+		*op++ = static_cast<unsigned char>(offset >> 8);
+
+		size_t extraLength = matchLength - MinMatch;
+
+		if (extraLength >= 15)
+		{
+			*token |= 15;
+			op = WriteLength(op, extraLength - 15);
+		}
+		else
+			*token |= static_cast<unsigned char>(extraLength);
+	}
+
+	return op;
+}
+
+} // namespace
+
+// Compresses the given data using a fast LZ codec (LZ4 block format), returns the compressed size.
+size_t CompressLZ(const void *src, size_t srcSize, void *dest, size_t destCapacity)
+{
+	if (destCapacity < GetMaxCompressedSize(srcSize))
+		LEAN_THROW_ERROR_MSG("Compression buffer too small");
+
+	const unsigned char *const ibegin = static_cast<const unsigned char*>(src);
+	const unsigned char *const iend = ibegin + srcSize;
+	unsigned char *const obegin = static_cast<unsigned char*>(dest);
+	unsigned char *op = obegin;
+
+	const unsigned char *anchor = ibegin;
+
+	if (srcSize > MatchFindLimit)
+	{
+		const unsigned char *const matchLimit = iend - LastLiterals;
+		const unsigned char *const findLimit = iend - MatchFindLimit;
+
+		// NOTE: Positions relative to input begin, all zero initially (tolerated, matches are verified)
+		uint4 table[HashSize];
+		memset(table, 0, sizeof(table));
+
+		const unsigned char *ip = ibegin + 1;
+		uint4 missCount = 0;
+
+		while (ip <= findLimit)
+		{
+			uint4 sequence = Read4(ip);
+			uint4 &entry = table[HashSequence(sequence)];
+			const unsigned char *ref = ibegin + entry;
+			entry = static_cast<uint4>(ip - ibegin);
+
+			if (ref >= ip || static_cast<size_t>(ip - ref) > MaxOffset || Read4(ref) != sequence)
+			{
+				// Skip faster through incompressible data
+				ip += 1 + (missCount++ >> 6);
+				continue;
+			}
+
+			missCount = 0;
+
+			// Extend match backwards
+			while (ip > anchor && ref > ibegin && ip[-1] == ref[-1])
+			{
+				--ip;
+				--ref;
+			}
+
+			// Extend match forwards
+			size_t matchLength = MinMatch;
+
+			while (ip + matchLength < matchLimit && ip[matchLength] == ref[matchLength])
+				++matchLength;
+
+			op = WriteSequence(op, anchor, ip - anchor, ip - ref, matchLength);
+
+			ip += matchLength;
+			anchor = ip;
+
+			// Keep recent positions in the table
+			if (ip - 2 > ibegin && ip - 2 <= findLimit)
+				table[HashSequence(Read4(ip - 2))] = static_cast<uint4>(ip - 2 - ibegin);
+		}
+	}
+
+	// Last literals
+	op = WriteSequence(op, anchor, iend - anchor, 0, 0);
+
+	return op - obegin;
+}
+
+// Decompresses the given LZ-compressed data into the given buffer of exactly the original size. Throws on corrupt data.
+void DecompressLZ(const void *src, size_t srcSize, void *dest, size_t destSize)
+{
+	const unsigned char *ip = static_cast<const unsigned char*>(src);
+	const unsigned char *const iend = ip + srcSize;
+	unsigned char *const obegin = static_cast<unsigned char*>(dest);
+	unsigned char *op = obegin;
+	unsigned char *const oend = obegin + destSize;
+
+	while (true)
+	{
+		if (ip >= iend)
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: sequence truncated");
+
+		const unsigned token = *ip++;
+
+		// Literals
+		size_t literalLength = token >> 4;
+
+		if (literalLength == 15)
+			literalLength = ReadLength(ip, iend, literalLength);
+
+		if (literalLength > static_cast<size_t>(iend - ip) || literalLength > static_cast<size_t>(oend - op))
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: literals out of bounds");
+
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// Last sequence consists of literals only
+		if (ip == iend)
+			break;
+
+		// Match
+		if (iend - ip < 2)
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: offset truncated");
+
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > static_cast<size_t>(op - obegin))
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: offset out of bounds");
+
+		size_t matchLength = token & 15;
+
+		if (matchLength == 15)
+			matchLength = ReadLength(ip, iend, matchLength);
+
+		matchLength += MinMatch;
+
+		if (matchLength > static_cast<size_t>(oend - op))
+			LEAN_THROW_ERROR_MSG("Corrupt compressed data: match out of bounds");
+
+		const unsigned char *ref = op - offset;
+
+		if (offset >= matchLength)
+		{
+			memcpy(op, ref, matchLength);
+			op += matchLength;
+		}
+		else
+			// NOTE: Overlapping matches repeat the last offset bytes
+			for (unsigned char *matchEnd = op + matchLength; op < matchEnd; )
+				*op++ = *ref++;
+	}
+
+	if (op != oend)
+		LEAN_THROW_ERROR_MSG("Corrupt compressed data: size mismatch");
+}
+
+} // namespace
@@ -0,0 +1,206 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beContentHash.h"
+
+#include <lean/io/mapped_file.h>
+#include <cstring>
+
+namespace beCore
+{
+
+namespace
+{
+
+const uint8 Prime1 = 0x9E3779B185EBCA87ULL;
+const uint8 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint8 Prime3 = 0x165667B19E3779F9ULL;
+const uint8 Prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint8 Prime5 = 0x27D4EB2F165667C5ULL;
+
+/// Number of bytes passed to the hasher at a time.
+const size_t FileHashWindow = 1 << 20;
+
+LEAN_INLINE uint8 RotateLeft(uint8 value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+LEAN_INLINE uint8 Read8(const unsigned char *data)
+{
+	uint8 value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+LEAN_INLINE uint4 Read4(const unsigned char *data)
+{
+	uint4 value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+LEAN_INLINE uint8 Round(uint8 acc, uint8 input)
+{
+	acc += input * Prime2;
+	acc = RotateLeft(acc, 31);
+	return acc * Prime1;
+}
+
+LEAN_INLINE uint8 MergeRound(uint8 acc, uint8 value)
+{
+	acc ^= Round(0, value);
+	return acc * Prime1 + Prime4;
+}
+
+/// Consumes all complete 32 byte stripes, returns the number of bytes consumed.
+LEAN_INLINE size_t ConsumeStripes(uint8 (&acc)[4], const unsigned char *data, size_t size)
+{
+	const unsigned char *const begin = data;
+	const unsigned char *const end = data + (size & ~static_cast<size_t>(31));
+
+	for (; data < end; data += 32)
+	{
+		acc[0] = Round(acc[0], Read8(data));
+		acc[1] = Round(acc[1], Read8(data + 8));
+		acc[2] = Round(acc[2], Read8(data + 16));
+		acc[3] = Round(acc[3], Read8(data + 24));
+	}
+
+	return data - begin;
+}
+
+} // namespace
+
+// Constructor.
+ContentHasher::ContentHasher(uint8 seed)
+{
+	Reset(seed);
+}
+
+// Restarts hashing.
+void ContentHasher::Reset(uint8 seed)
+{
+	m_seed = seed;
+	m_acc[0] = seed + Prime1 + Prime2;
+	m_acc[1] = seed + Prime2;
+	m_acc[2] = seed;
+	m_acc[3] = seed - Prime1;
+	m_bufferSize = 0;
+	m_totalSize = 0;
+}
+
+// Appends the given data.
+void ContentHasher::Update(const void *data, size_t size)
+{
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+	m_totalSize += size;
+
+	// Complete buffered stripe first
+	if (m_bufferSize)
+	{
+		size_t fill = min(size, sizeof(m_buffer) - m_bufferSize);
+		memcpy(m_buffer + m_bufferSize, bytes, fill);
+		m_bufferSize += static_cast<uint4>(fill);
+		bytes += fill;
+		size -= fill;
+
+		if (m_bufferSize < sizeof(m_buffer))
+			return;
+
+		ConsumeStripes(m_acc, m_buffer, sizeof(m_buffer));
+		m_bufferSize = 0;
+	}
+
+	size_t consumed = ConsumeStripes(m_acc, bytes, size);
+	bytes += consumed;
+	size -= consumed;
+
+	// Buffer remainder until next update
+	memcpy(m_buffer, bytes, size);
+	m_bufferSize = static_cast<uint4>(size);
+}
+
+// Gets the hash of all data appended so far.
+uint8 ContentHasher::Finish() const
+{
+	uint8 hash;
+
+	if (m_totalSize >= sizeof(m_buffer))
+	{
+		hash = RotateLeft(m_acc[0], 1) + RotateLeft(m_acc[1], 7) + RotateLeft(m_acc[2], 12) + RotateLeft(m_acc[3], 18);
+		hash = MergeRound(hash, m_acc[0]);
+		hash = MergeRound(hash, m_acc[1]);
+		hash = MergeRound(hash, m_acc[2]);
+		hash = MergeRound(hash, m_acc[3]);
+	}
+	else
+		hash = m_seed + Prime5;
+
+	hash += m_totalSize;
+
+	const unsigned char *tail = m_buffer;
+	const unsigned char *const tailEnd = m_buffer + m_bufferSize;
+
+	for (; tail + 8 <= tailEnd; tail += 8)
+	{
+		hash ^= Round(0, Read8(tail));
+		hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+	}
+
+	if (tail + 4 <= tailEnd)
+	{
+		hash ^= static_cast<uint8>(Read4(tail)) * Prime1;
+		hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+		tail += 4;
+	}
+
+	for (; tail < tailEnd; ++tail)
+	{
+		hash ^= static_cast<uint8>(*tail) * Prime5;
+		hash = RotateLeft(hash, 11) * Prime1;
+	}
+
+	// Avalanche
+	hash ^= hash >> 33;
+	hash *= Prime2;
+	hash ^= hash >> 29;
+	hash *= Prime3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+// Computes a fast non-cryptographic 64-bit hash of the given data.
+uint8 HashContent(const void *data, size_t size, uint8 seed)
+{
+	ContentHasher hasher(seed);
+	hasher.Update(data, size);
+	return hasher.Finish();
+}
+
+// Computes a fast non-cryptographic 64-bit hash of the given file's contents. Throws on failure.
+uint8 HashFileContent(const utf8_ntri &file, uint8 seed)
+{
+	lean::rmapped_file mappedFile(file);
+
+	const unsigned char *data = reinterpret_cast<const unsigned char*>(mappedFile.data());
+	size_t size = static_cast<size_t>(mappedFile.size());
+
+	ContentHasher hasher(seed);
+
+	// Hash incrementally, one window of the mapping at a time
+	while (size > 0)
+	{
+		size_t window = min(size, FileHashWindow);
+		hasher.Update(data, window);
+		data += window;
+		size -= window;
+	}
+
+	return hasher.Finish();
+}
+
+} // namespace
@@ -0,0 +1,501 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beContentPack.h"
+#include "beCore/beContentHash.h"
+#include "beCore/beCompression.h"
+
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+
+#include <lean/io/mapped_file.h>
+#include <lean/io/raw_file.h>
+#include <lean/io/filesystem.h>
+#include <lean/smart/scoped_ptr.h>
+#include <lean/concurrent/shareable_spin_lock.h>
+
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Content served straight from a mapped content pack.
+class PackedContent : public Content
+{
+private:
+	lean::resource_ptr<ContentPack> m_pack;
+
+public:
+	/// Constructor. Keeps the given pack mapped.
+	PackedContent(ContentPack *pack, const void *memory, uint8 size)
+		: m_pack(pack)
+	{
+		m_memory = memory;
+		m_size = size;
+	}
+};
+
+/// Content decompressed from a content pack.
+class UnpackedContent : public Content
+{
+private:
+	lean::scoped_ptr<char[]> m_buffer;
+
+public:
+	/// Constructor.
+	UnpackedContent(const void *compressed, uint8 compressedSize, uint8 size)
+		: m_buffer( new char[static_cast<size_t>(size)] )
+	{
+		DecompressLZ(compressed, static_cast<size_t>(compressedSize), m_buffer.get(), static_cast<size_t>(size));
+
+		m_memory = m_buffer.get();
+		m_size = size;
+	}
+};
+
+/// Orders entries by path hash.
+struct EntryHashOrder
+{
+	LEAN_INLINE bool operator ()(const ContentPackEntry &left, uint8 right) const { return left.PathHash < right; }
+	LEAN_INLINE bool operator ()(uint8 left, const ContentPackEntry &right) const { return left < right.PathHash; }
+	LEAN_INLINE bool operator ()(const ContentPackEntry &left, const ContentPackEntry &right) const { return left.PathHash < right.PathHash; }
+};
+
+/// Checks if the given range lies within the given size.
+LEAN_INLINE bool InBounds(uint8 offset, uint8 size, uint8 totalSize)
+{
+	return offset <= totalSize && size <= totalSize - offset;
+}
+
+/// Normalizes the given path relative to the pack root, i.e. converts it to lower case & forward slashes.
+utf8_string NormalizePackPath(const utf8_ntri &path)
+{
+	utf8_string result(path.begin(), path.end());
+
+	for (utf8_string::iterator it = result.begin(); it != result.end(); ++it)
+		if (*it == '\\')
+			*it = '/';
+		// NOTE: Windows file systems are case-insensitive, ignore case of ASCII characters only
+		else if (*it >= 'A' && *it <= 'Z')
+			*it += 'a' - 'A';
+
+	return result;
+}
+
+/// Computes the hash of the given normalized path.
+uint8 HashPackPath(const utf8_ntri &normalizedPath)
+{
+	return HashContent(normalizedPath.c_str(), normalizedPath.size());
+}
+
+typedef std::vector< lean::resource_ptr<ContentPack> > pack_vector;
+
+/// Mounted content packs.
+struct MountedPacks
+{
+	pack_vector packs;
+	lean::shareable_spin_lock<> lock;
+};
+
+MountedPacks g_mountedPacks;
+
+} // namespace
+
+/// Implementation of the content pack class internals.
+struct ContentPack::M
+{
+	utf8_string archive;
+	utf8_string mountDirectory;
+
+	lean::rmapped_file file;
+	uint8 revision;
+
+	const ContentPackEntry *entries;
+	uint4 entryCount;
+	const char *paths;
+
+	/// Constructor.
+	M(const utf8_ntri &archive, const utf8_ntri &mountDirectory)
+		: archive( lean::absolute_path<utf8_string>(archive) ),
+		mountDirectory( NormalizePackPath(lean::absolute_path<utf8_string>(mountDirectory)) ),
+		file(archive),
+		revision( lean::file_revision(archive) ),
+		entries(),
+		entryCount(),
+		paths()
+	{
+		if (!this->mountDirectory.empty() && *this->mountDirectory.rbegin() != '/')
+			this->mountDirectory.push_back('/');
+	}
+};
+
+// Maps the given archive, placing the files it contains in the given mount directory.
+ContentPack::ContentPack(const utf8_ntri &archive, const utf8_ntri &mountDirectory)
+	: m( new M(archive, mountDirectory) )
+{
+	const char *data = reinterpret_cast<const char*>(m->file.data());
+	const uint8 size = m->file.size();
+
+	if (size < sizeof(ContentPackHeader))
+		LEAN_THROW_ERROR_CTX("Content pack truncated", archive.c_str());
+
+	const ContentPackHeader &header = *reinterpret_cast<const ContentPackHeader*>(data);
+
+	if (header.Magic != ContentPackHeader::MagicID)
+		LEAN_THROW_ERROR_CTX("Not a content pack", archive.c_str());
+	if (header.Version != ContentPackHeader::CurrentVersion)
+		LEAN_THROW_ERROR_CTX("Content pack version unsupported", archive.c_str());
+
+	if (!InBounds(header.DirectoryOffset, static_cast<uint8>(header.EntryCount) * sizeof(ContentPackEntry), size) ||
+		!InBounds(header.PathOffset, header.PathSize, size))
+		LEAN_THROW_ERROR_CTX("Content pack directory corrupted", archive.c_str());
+
+	m->entries = reinterpret_cast<const ContentPackEntry*>(data + header.DirectoryOffset);
+	m->entryCount = header.EntryCount;
+	m->paths = data + header.PathOffset;
+
+	// NOTE: Validate once, entries trusted from now on
+	for (uint4 i = 0; i < m->entryCount; ++i)
+	{
+		const ContentPackEntry &entry = m->entries[i];
+
+		if (!InBounds(entry.PathOffset, static_cast<uint8>(entry.PathLength) + 1, header.PathSize) ||
+			m->paths[entry.PathOffset + entry.PathLength] != 0 ||
+			!InBounds(entry.Offset, entry.StoredSize, size) ||
+			(!(entry.Flags & ContentPackEntryFlags::Compressed) && entry.StoredSize != entry.Size) ||
+			(i > 0 && entry.PathHash < m->entries[i - 1].PathHash))
+			LEAN_THROW_ERROR_CTX("Content pack entry corrupted", archive.c_str());
+	}
+}
+
+// Destructor.
+ContentPack::~ContentPack()
+{
+}
+
+// Finds the entry of the given absolute path, nullptr if not contained.
+const ContentPackEntry* ContentPack::Find(const utf8_ntri &file) const
+{
+	LEAN_PIMPL_CONST();
+
+	utf8_string path = NormalizePackPath(file);
+
+	// Only files inside the mount directory contained
+	if (path.size() <= m.mountDirectory.size() || path.compare(0, m.mountDirectory.size(), m.mountDirectory) != 0)
+		return nullptr;
+
+	const char *relativePath = path.c_str() + m.mountDirectory.size();
+	const size_t relativeLength = path.size() - m.mountDirectory.size();
+
+	const ContentPackEntry *entriesEnd = m.entries + m.entryCount;
+	const ContentPackEntry *it = std::lower_bound(m.entries, entriesEnd,
+		HashContent(relativePath, relativeLength), EntryHashOrder());
+
+	// NOTE: Resolve hash collisions by comparing paths
+	for (const uint8 hash = (it != entriesEnd) ? it->PathHash : 0; it != entriesEnd && it->PathHash == hash; ++it)
+		if (it->PathLength == relativeLength && memcmp(m.paths + it->PathOffset, relativePath, relativeLength) == 0)
+			return it;
+
+	return nullptr;
+}
+
+// Gets the content of the given entry.
+lean::com_ptr<Content, true> ContentPack::GetContent(const ContentPackEntry &entry) const
+{
+	const char *data = reinterpret_cast<const char*>(m->file.data()) + entry.Offset;
+
+	if (entry.Flags & ContentPackEntryFlags::Compressed)
+		return lean::bind_com( new UnpackedContent(data, entry.StoredSize, entry.Size) );
+	else
+		return lean::bind_com( new PackedContent(const_cast<ContentPack*>(this), data, entry.Size) );
+}
+
+// Gets the number of entries.
+uint4 ContentPack::GetEntryCount() const
+{
+	return m->entryCount;
+}
+
+// Gets the given entry.
+const ContentPackEntry& ContentPack::GetEntry(uint4 idx) const
+{
+	LEAN_ASSERT(idx < m->entryCount);
+	return m->entries[idx];
+}
+
+// Gets the normalized path of the given entry.
+utf8_ntr ContentPack::GetPath(const ContentPackEntry &entry) const
+{
+	return utf8_ntr(m->paths + entry.PathOffset, m->paths + entry.PathOffset + entry.PathLength);
+}
+
+// Gets the archive path.
+utf8_ntr ContentPack::GetArchive() const
+{
+	return utf8_ntr(m->archive);
+}
+
+// Gets the mount directory.
+utf8_ntr ContentPack::GetMountDirectory() const
+{
+	return utf8_ntr(m->mountDirectory);
+}
+
+// Gets the revision of the archive at the time it was mapped.
+uint8 ContentPack::GetRevision() const
+{
+	return m->revision;
+}
+
+// Mounts the given content pack.
+void MountContentPack(ContentPack *pPack)
+{
+	LEAN_THROW_NULL(pPack);
+
+	lean::scoped_ssl_lock lock(g_mountedPacks.lock);
+
+	if (std::find(g_mountedPacks.packs.begin(), g_mountedPacks.packs.end(), pPack) == g_mountedPacks.packs.end())
+		g_mountedPacks.packs.push_back(pPack);
+}
+
+// Unmounts the given content pack.
+void UnmountContentPack(ContentPack *pPack)
+{
+	lean::scoped_ssl_lock lock(g_mountedPacks.lock);
+
+	pack_vector::iterator it = std::find(g_mountedPacks.packs.begin(), g_mountedPacks.packs.end(), pPack);
+
+	if (it != g_mountedPacks.packs.end())
+		g_mountedPacks.packs.erase(it);
+}
+
+// Unmounts all content packs.
+void UnmountContentPacks()
+{
+	pack_vector packs;
+
+	{
+		lean::scoped_ssl_lock lock(g_mountedPacks.lock);
+		packs.swap(g_mountedPacks.packs);
+	}
+
+	// NOTE: Packs released outside the lock
+}
+
+// Gets the mounted content pack containing the given absolute path, nullptr if none.
+lean::resource_ptr<ContentPack> FindContentPack(const utf8_ntri &file)
+{
+	lean::scoped_ssl_lock_shared lock(g_mountedPacks.lock);
+
+	// NOTE: Packs mounted later take precedence
+	for (pack_vector::const_reverse_iterator it = g_mountedPacks.packs.rbegin(); it != g_mountedPacks.packs.rend(); ++it)
+		if ((*it)->Find(file))
+			return *it;
+
+	return nullptr;
+}
+
+// Checks if any mounted content pack contains the given absolute path.
+bool IsPackedFile(const utf8_ntri &file)
+{
+	return (FindContentPack(file) != nullptr);
+}
+
+/// Implementation of the content pack writer class internals.
+struct ContentPackWriter::M
+{
+	/// Source file.
+	struct Source
+	{
+		utf8_string file;
+		utf8_string path;
+		bool bCompress;
+
+		/// Constructor.
+		Source(const utf8_ntri &file, const utf8_string &path, bool bCompress)
+			: file(file.to<utf8_string>()),
+			path(path),
+			bCompress(bCompress) { }
+	};
+	typedef std::vector<Source> source_vector;
+	source_vector sources;
+
+	typedef std::unordered_set<utf8_string> path_set;
+	path_set paths;
+
+	uint4 alignment;
+
+	/// Constructor.
+	M(uint4 alignment)
+		: alignment( max(alignment, 1U) ) { }
+};
+
+namespace
+{
+
+/// Pads the given file up to the next multiple of the given alignment.
+void PadFile(lean::raw_file &file, uint8 &pos, uint4 alignment)
+{
+	static const char zeroes[256] = { 0 };
+
+	for (uint8 padding = (alignment - pos % alignment) % alignment; padding > 0; )
+	{
+		size_t chunk = static_cast<size_t>( min<uint8>(padding, sizeof(zeroes)) );
+		file.write(zeroes, chunk);
+		padding -= chunk;
+		pos += chunk;
+	}
+}
+
+/// Orders entries by path hash, then by path.
+struct EntryOrder
+{
+	const std::string *paths;
+
+	EntryOrder(const std::string &paths)
+		: paths(&paths) { }
+
+	LEAN_INLINE bool operator ()(const ContentPackEntry &left, const ContentPackEntry &right) const
+	{
+		if (left.PathHash != right.PathHash)
+			return left.PathHash < right.PathHash;
+		else
+			return paths->compare(left.PathOffset, left.PathLength, *paths, right.PathOffset, right.PathLength) < 0;
+	}
+};
+
+} // namespace
+
+// Constructor.
+ContentPackWriter::ContentPackWriter(uint4 alignment)
+	: m( new M(alignment) )
+{
+}
+
+// Destructor.
+ContentPackWriter::~ContentPackWriter()
+{
+}
+
+// Adds the given file under the given path relative to the pack root.
+void ContentPackWriter::Add(const utf8_ntri &file, const utf8_ntri &path, bool bCompress)
+{
+	utf8_string normalizedPath = NormalizePackPath(path);
+
+	// Strip leading separators, paths are relative to the pack root
+	normalizedPath.erase(0, normalizedPath.find_first_not_of('/'));
+
+	if (normalizedPath.empty())
+		LEAN_THROW_ERROR_CTX("Invalid content pack path", path.c_str());
+	if (!m->paths.insert(normalizedPath).second)
+		LEAN_THROW_ERROR_CTX("Path added to content pack twice", path.c_str());
+
+	m->sources.push_back( M::Source(file, normalizedPath, bCompress) );
+}
+
+// Writes all files added so far to the given archive.
+void ContentPackWriter::Write(const utf8_ntri &archive) const
+{
+	LEAN_PIMPL_CONST();
+
+	lean::raw_file file(archive, lean::file::write, lean::file::overwrite, lean::file::sequential);
+
+	// NOTE: Header completed when all offsets known
+	ContentPackHeader header;
+	memset(&header, 0, sizeof(header));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	uint8 pos = sizeof(header);
+
+	std::vector<ContentPackEntry> entries;
+	entries.reserve(m.sources.size());
+	std::string paths;
+
+	std::vector<char> data, compressed;
+
+	// NOTE: Data stored in order of addition, allows for manifests to keep related files close
+	for (M::source_vector::const_iterator it = m.sources.begin(); it != m.sources.end(); ++it)
+	{
+		{
+			lean::raw_file sourceFile(it->file, lean::file::read);
+			data.resize( static_cast<size_t>(sourceFile.size()) );
+
+			if (!data.empty() && sourceFile.read(&data[0], data.size()) != data.size())
+				LEAN_THROW_ERROR_CTX("Failed to read file to be packed", it->file.c_str());
+		}
+
+		ContentPackEntry entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.PathHash = HashPackPath(it->path);
+		entry.PathOffset = static_cast<uint4>(paths.size());
+		entry.PathLength = static_cast<uint4>(it->path.size());
+		entry.Size = data.size();
+
+		PadFile(file, pos, m.alignment);
+		entry.Offset = pos;
+
+		const char *storedData = (!data.empty()) ? &data[0] : nullptr;
+		size_t storedSize = data.size();
+
+		if (it->bCompress && !data.empty())
+		{
+			compressed.resize( GetMaxCompressedSize(data.size()) );
+			size_t compressedSize = CompressLZ(&data[0], data.size(), &compressed[0], compressed.size());
+
+			// NOTE: Keep poorly compressible data uncompressed, served without copying
+			if (compressedSize < data.size() - data.size() / 8)
+			{
+				storedData = &compressed[0];
+				storedSize = compressedSize;
+				entry.Flags |= ContentPackEntryFlags::Compressed;
+			}
+		}
+
+		if (storedSize)
+			file.write(storedData, storedSize);
+		pos += storedSize;
+		entry.StoredSize = storedSize;
+
+		entries.push_back(entry);
+		// NOTE: Zero-terminated, allows for paths to be used in place
+		paths.append(it->path);
+		paths.push_back(0);
+	}
+
+	std::sort(entries.begin(), entries.end(), EntryOrder(paths));
+
+	// Directory
+	PadFile(file, pos, 8);
+	header.DirectoryOffset = pos;
+	header.EntryCount = static_cast<uint4>(entries.size());
+
+	if (!entries.empty())
+		file.write(reinterpret_cast<const char*>(&entries[0]), sizeof(ContentPackEntry) * entries.size());
+	pos += sizeof(ContentPackEntry) * entries.size();
+
+	// Paths
+	header.PathOffset = pos;
+	header.PathSize = paths.size();
+	file.write(paths.data(), paths.size());
+
+	// Header
+	header.Magic = ContentPackHeader::MagicID;
+	header.Version = ContentPackHeader::CurrentVersion;
+	header.Alignment = m.alignment;
+
+	file.pos(0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+// Gets the number of files added.
+uint4 ContentPackWriter::GetFileCount() const
+{
+	return static_cast<uint4>(m->sources.size());
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beFileCommit.h"
+
+#include <cstdio>
+
+#include <lean/io/raw_file.h>
+#include <lean/io/filesystem.h>
+
+#include <lean/logging/errors.h>
+#include <lean/logging/win_errors.h>
+
+namespace beCore
+{
+
+// Gets a temporary file name next to the given file, unique per process & thread.
+Exchange::utf8_string GetTempFile(const utf8_ntri &file)
+{
+	char tempSuffix[48];
+	sprintf_s(tempSuffix, ".%x.%x.tmp", ::GetCurrentProcessId(), ::GetCurrentThreadId());
+	return file.to<Exchange::utf8_string>() + tempSuffix;
+}
+
+// Replaces the given file by the given complete temporary file.
+void CommitFile(const utf8_ntri &tempFile, const utf8_ntri &file, bool bWriteThrough)
+{
+	if (!::MoveFileExW(lean::utf_to_utf16(tempFile).c_str(), lean::utf_to_utf16(file).c_str(),
+		MOVEFILE_REPLACE_EXISTING | ((bWriteThrough) ? MOVEFILE_WRITE_THROUGH : 0)))
+	{
+		// NOTE: Capture error before cleaning up
+		DWORD error = ::GetLastError();
+		DiscardFile(tempFile);
+		::SetLastError(error);
+
+		LEAN_THROW_WIN_ERROR_CTX("MoveFileExW()", file.c_str());
+	}
+}
+
+// Deletes the given temporary file, ignoring errors.
+void DiscardFile(const utf8_ntri &tempFile)
+{
+	::DeleteFileW(lean::utf_to_utf16(tempFile).c_str());
+}
+
+// Writes the given data to a temporary file & commits it to the given file once complete.
+void CommitFile(const utf8_ntri &file, const void *data, uint8 size, bool bWriteThrough)
+{
+	Exchange::utf8_string tempFile = GetTempFile(file);
+
+	try
+	{
+		lean::raw_file rawFile(tempFile, lean::file::write, lean::file::overwrite, lean::file::sequential);
+		rawFile.write(static_cast<const char*>(data), static_cast<size_t>(size));
+	}
+	catch (...)
+	{
+		DiscardFile(tempFile);
+		throw;
+	}
+
+	CommitFile(tempFile, file, bWriteThrough);
+}
+
+} // namespace
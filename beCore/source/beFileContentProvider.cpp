@@ -11,6 +11,12 @@
 namespace beCore
 {
 
+// Constructor.
+FileContentProvider::DefaultContentProvider(FileRevisionMode::T revisionMode)
+	: m_revisionMode(revisionMode)
+{
+}
+
 // Gets the content identified by the given path.
 lean::com_ptr<Content, true> FileContentProvider::GetContent(const utf8_ntri &file)
 {
@@ -20,7 +26,7 @@ lean::com_ptr<Content, true> FileContentProvider::GetContent(const utf8_ntri &fi
 // Gets a revision number for the content identified by the given path.
 uint8 FileContentProvider::GetRevision(const utf8_ntri &file) const
 {
-	return lean::file_revision(file);
+	return GetFileRevision(file, m_revisionMode);
 }
 
 // Constructs and returns a clone of this path resolver.
@@ -0,0 +1,117 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beFileRevision.h"
+#include "beCore/beContentHash.h"
+
+#include <unordered_map>
+
+#include <lean/io/filesystem.h>
+#include <lean/concurrent/critical_section.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Cached content revision of one file.
+struct FileRevisionInfo
+{
+	uint8 timestamp;	///< Modification time of the file when last hashed.
+	uint8 hash;			///< Hash of the file's contents.
+	uint8 revision;		///< Modification time of the last write that changed the hash.
+
+	FileRevisionInfo()
+		: timestamp(0),
+		hash(0),
+		revision(0) { }
+};
+
+/// Content revisions of all files queried so far.
+struct FileRevisionCache
+{
+	typedef std::unordered_map<utf8_string, FileRevisionInfo> file_map;
+	file_map files;
+
+	lean::critical_section lock;
+};
+
+FileRevisionCache g_fileRevisionCache;
+
+/// Gets the content revision of the given file.
+uint8 GetContentRevision(const utf8_ntri &file)
+{
+	const uint8 timestamp = lean::file_revision(file);
+	const utf8_string path = lean::absolute_path<utf8_string>(file);
+
+	if (!timestamp)
+	{
+		// Forget files that have been removed
+		lean::scoped_cs_lock lock(g_fileRevisionCache.lock);
+		g_fileRevisionCache.files.erase(path);
+		return 0;
+	}
+
+	{
+		// Cache accessed concurrently
+		lean::scoped_cs_lock lock(g_fileRevisionCache.lock);
+
+		FileRevisionCache::file_map::const_iterator itFile = g_fileRevisionCache.files.find(path);
+
+		// Untouched files need not be hashed again
+		if (itFile != g_fileRevisionCache.files.end() && itFile->second.timestamp == timestamp)
+			return itFile->second.revision;
+	}
+
+	uint8 hash;
+
+	// NOTE: Hash outside lock, may take a while for large files
+	try
+	{
+		hash = HashFileContent(path);
+	}
+	catch (...)
+	{
+		// Files may be locked while being written, keep the last known revision & retry on the next query
+		// -> Falling back to the timestamp would flip revisions back & forth, triggering spurious reloads
+		lean::scoped_cs_lock lock(g_fileRevisionCache.lock);
+
+		FileRevisionCache::file_map::const_iterator itFile = g_fileRevisionCache.files.find(path);
+
+		return (itFile != g_fileRevisionCache.files.end())
+			? itFile->second.revision
+			// Nothing known yet, any change will be reported once the file has been hashed
+			: timestamp;
+	}
+
+	// Cache accessed concurrently
+	lean::scoped_cs_lock lock(g_fileRevisionCache.lock);
+
+	FileRevisionInfo &info = g_fileRevisionCache.files[path];
+
+	// Keep revision if only touched
+	if (!info.revision || info.hash != hash)
+	{
+		info.hash = hash;
+		info.revision = timestamp;
+	}
+	info.timestamp = timestamp;
+
+	return info.revision;
+}
+
+} // namespace
+
+// Gets a revision number for the given file, 0 if the file does not exist.
+uint8 GetFileRevision(const utf8_ntri &file, FileRevisionMode::T mode)
+{
+	if (mode == FileRevisionMode::ContentHash)
+		return GetContentRevision(file);
+	else
+		return lean::file_revision(file);
+}
+
+} // namespace
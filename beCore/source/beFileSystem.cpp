@@ -4,6 +4,7 @@
 
 #include "beCoreInternal/stdafx.h"
 #include "beCore/beFileSystem.h"
+#include "beCore/beContentPack.h"
 
 #include <lean/io/filesystem.h>
 #include <lean/xml/xml_file.h>
@@ -211,7 +212,8 @@ LEAN_INLINE beCore::Exchange::utf8_string beCore::FileSystem::Impl::Search(const
 		{
 			lean::utf8_string potentialResult = lean::absolute_path<lean::utf8_string>(file, *itPath);
 
-			if (lean::file_exists(potentialResult))
+			// NOTE: Pack lookup is in-memory, only stat loose files if not packed
+			if (IsPackedFile(potentialResult) || lean::file_exists(potentialResult))
 			{
 				result.assign(potentialResult.begin(), potentialResult.end());
 				break;
@@ -223,7 +225,7 @@ LEAN_INLINE beCore::Exchange::utf8_string beCore::FileSystem::Impl::Search(const
 	{
 		lean::utf8_string potentialResult = lean::absolute_path<lean::utf8_string>(file, location);
 
-		if (lean::file_exists(potentialResult))
+		if (IsPackedFile(potentialResult) || lean::file_exists(potentialResult))
 			result.assign(potentialResult.begin(), potentialResult.end());
 	}
 
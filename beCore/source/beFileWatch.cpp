@@ -4,8 +4,10 @@
 
 #include "beCoreInternal/stdafx.h"
 #include "beCore/beFileWatch.h"
+#include "beCore/beFileRevision.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/ptr_container/ptr_map_adapter.hpp>
 
 #include <lean/tags/noncopyable.h>
@@ -18,7 +20,6 @@
 #include <lean/functional/callable.h>
 
 #include <lean/concurrent/critical_section.h>
-#include <lean/concurrent/event.h>
 
 #include <lean/functional/algorithm.h>
 
@@ -28,6 +29,14 @@ namespace beCore
 namespace
 {
 
+/// Default time in ms after the last change to a directory before observers are notified.
+const uint4 DefaultCoalescingWindow = 250;
+/// Maximum notification delay in multiples of the coalescing window, keeps continuously changing files from starving.
+const uint4 MaxCoalescingDelay = 8;
+
+/// Set of changed files.
+typedef std::unordered_set<utf8_string> file_set;
+
 /// Directory.
 class Directory : public lean::tags::noncopyable
 {
@@ -60,6 +69,16 @@ private:
 
 	lean::critical_section m_observerLock;
 
+	// Changes pending notification, observation thread only
+	file_set m_changedFiles;
+	bool m_bAllFilesChanged;
+	bool m_bDirectoryChanged;
+	DWORD m_firstChangeTime;
+	DWORD m_lastChangeTime;
+
+	/// Records the time of a change.
+	void ChangeRecorded(DWORD changeTime);
+
 protected:
 	/// Gets the revision of the given file.
 	virtual lean::uint8 GetRevision(const lean::utf8_ntri &file) const = 0;
@@ -69,6 +88,13 @@ protected:
 	/// Called when a directory observer has been added.
 	virtual void DirectoryObserverAdded() = 0;
 
+	/// Records a change to the given file. Observation thread only.
+	void MarkFileChanged(const utf8_string &fileKey, DWORD changeTime);
+	/// Records changes to an unknown number of files. Observation thread only.
+	void MarkAllFilesChanged(DWORD changeTime);
+	/// Records a change to the directory structure. Observation thread only.
+	void MarkDirectoryChanged(DWORD changeTime);
+
 public:
 	/// Constructor.
 	Directory(FileWatch::M *watch, const utf8_ntri &directory);
@@ -85,32 +111,50 @@ public:
 	// Removes the given observer, no longer to be called when this directory is modified.
 	void RemoveObserver(DirectoryObserver *pObserver);
 
-	/// Notifies file observers about modifications to the files they are observing. 
-	virtual void FilesChanged();
-	/// Notifies directory observers about modifications to the directory they are observing. 
+	/// Notifies file observers about modifications to the given files they are observing, all files if nullptr.
+	virtual void FilesChanged(const file_set *pChangedFiles);
+	/// Notifies directory observers about modifications to the directory they are observing.
 	virtual void DirectoryChanged();
 
-	/// Gets the handle to a change notification event or NULL, if unavailable.
-	virtual HANDLE GetFileChangeNotification() const = 0;
-	/// Gets the handle to a change notification event or NULL, if unavailable.
-	virtual HANDLE GetDirectoryChangeNotification() const = 0;
+	/// Gets the time in ms until pending changes are due for notification, INFINITE if none pending. Observation thread only.
+	DWORD GetNotificationDelay(DWORD currentTime, DWORD coalescingWindow) const;
+	/// Notifies observers about all pending changes. Observation thread only.
+	void NotifyObservers();
 
 	/// Gets the directory.
 	const utf8_string& GetDirectory() const { return m_directory; }
 };
 
-struct close_change_notification_handle_policy
+struct close_handle_policy
+{
+	static LEAN_INLINE HANDLE invalid() { return INVALID_HANDLE_VALUE; }
+	static LEAN_INLINE void release(HANDLE handle) { ::CloseHandle(handle); }
+};
+
+struct close_completion_port_policy
 {
 	static LEAN_INLINE HANDLE invalid() { return NULL; }
-	static LEAN_INLINE void release(HANDLE handle) { ::FindCloseChangeNotification(handle); }
+	static LEAN_INLINE void release(HANDLE handle) { ::CloseHandle(handle); }
 };
 
 // Filesystem directory.
 class FileSystemDirectory : public Directory
 {
 private:
-	lean::handle_guard<HANDLE, close_change_notification_handle_policy> m_hFileChangeNotification;
-	lean::handle_guard<HANDLE, close_change_notification_handle_policy> m_hDirectoryChangeNotification;
+	lean::handle_guard<HANDLE, close_handle_policy> m_hDirectory;
+
+	/// Change notification buffer size, changes are lost & all files re-checked on overflow.
+	static const DWORD BufferSize = 16384;
+	DWORD m_buffer[BufferSize / sizeof(DWORD)];
+	OVERLAPPED m_overlapped;
+
+	volatile bool m_bObserved;
+	bool m_bWatching;
+	bool m_bStopping;
+	bool m_bFailed;
+
+	/// Issues an asynchronous change notification request.
+	void Watch();
 
 protected:
 	/// Gets the revision of the given file.
@@ -127,50 +171,85 @@ public:
 	/// Destructor.
 	virtual ~FileSystemDirectory();
 
-	// Notifies file observers about modifications to the files they are observing. 
-	virtual void FilesChanged();
-	// Notifies observers about modifications to the directories they are observing. 
-	virtual void DirectoryChanged();
+	/// Starts watching this directory via the given completion port, if observed. Observation thread only.
+	void StartWatching(HANDLE hCompletionPort);
+	/// Cancels watching this directory. Observation thread only.
+	void StopWatching();
+	/// Processes completed change notifications & keeps watching. Observation thread only.
+	void WatchCompleted(DWORD error, DWORD bytesTransferred);
 
-	/// Gets the handle to a change notification event or NULL, if unavailable.
-	virtual HANDLE GetFileChangeNotification() const;
-	/// Gets the handle to a change notification event or NULL, if unavailable.
-	virtual HANDLE GetDirectoryChangeNotification() const;
+	/// Checks if a change notification request is outstanding.
+	bool IsWatching() const { return m_bWatching; }
 };
 
 /// Observes files & directories.
 void ObservationThread(FileWatch::M &m);
 
+/// Creates an I/O completion port.
+HANDLE CreateCompletionPort()
+{
+	HANDLE hCompletionPort = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+	if (hCompletionPort == NULL)
+		LEAN_THROW_WIN_ERROR_MSG("CreateIoCompletionPort()");
+
+	return hCompletionPort;
+}
+
 } // namespace
 
 /// Implementation of the file system class internals.
 struct FileWatch::M
 {
-	typedef boost::ptr_map_adapter< Directory, std::unordered_map<utf8_string, void*> > directory_map;
+	typedef boost::ptr_map_adapter< FileSystemDirectory, std::unordered_map<utf8_string, void*> > directory_map;
 	directory_map directories;
 
 	lean::critical_section directoryLock;
 
+	// All directories are watched through one completion port
+	lean::handle_guard<HANDLE, close_completion_port_policy> hCompletionPort;
+
 	volatile bool bShuttingDown;
-	lean::event updateFilesEvent;
-	lean::event updateDirectoriesEvent;
+	volatile uint4 coalescingWindow;
+	volatile FileRevisionMode::T revisionMode;
 
 	lean::thread observationThread;
 
 	/// Constructor.
-	M();
+	M(FileRevisionMode::T revisionMode);
 };
 
 // Constructor.
-LEAN_INLINE FileWatch::M::M()
-	: bShuttingDown(false),
+LEAN_INLINE FileWatch::M::M(FileRevisionMode::T revisionMode)
+	: hCompletionPort( CreateCompletionPort() ),
+	bShuttingDown(false),
+	coalescingWindow(DefaultCoalescingWindow),
+	revisionMode(revisionMode),
 	observationThread( lean::make_callable(this, &ObservationThread) )
 {
 }
 
+namespace
+{
+
+/// Wakes up the observation thread.
+void WakeObservationThread(FileWatch::M &m)
+{
+	if (!::PostQueuedCompletionStatus(m.hCompletionPort, 0, 0, nullptr))
+		LEAN_LOG_WIN_ERROR_CTX("PostQueuedCompletionStatus()", "Waking up file change observation thread");
+}
+
+/// Notifies observation thread about new observers.
+void ObservationChanged(FileWatch::M &m)
+{
+	WakeObservationThread(m);
+}
+
+} // namespace
+
 // Constructor.
-FileWatch::FileWatch()
-	: m(new M())
+FileWatch::FileWatch(FileRevisionMode::T revisionMode)
+	: m(new M(revisionMode))
 {
 }
 
@@ -179,8 +258,7 @@ FileWatch::~FileWatch()
 {
 	// ORDER: Signal update AFTER all modifications have been completed
 	m->bShuttingDown = true;
-	m->updateFilesEvent.set();
-	m->updateDirectoriesEvent.set();
+	WakeObservationThread(*m);
 
 	// Wait for observation thread to exit gracefully
 	m->observationThread.join();
@@ -189,18 +267,6 @@ FileWatch::~FileWatch()
 namespace
 {
 
-/// Notifies file observation thread about new directories.
-void FileObservationChanged(FileWatch::M &m)
-{
-	m.updateFilesEvent.set();
-}
-
-/// Notifies directory observation thread about new directories.
-void DirectoryObservationChanged(FileWatch::M &m)
-{
-	m.updateDirectoriesEvent.set();
-}
-
 /// Gets the given directory.
 FileWatch::M::directory_map::iterator GetDirectory(FileWatch::M &m, const utf8_string &directory)
 {
@@ -259,6 +325,32 @@ void FileWatch::RemoveObserver(const lean::utf8_ntri &unresolvedDirectory, Direc
 		itDirectory->second->RemoveObserver(pObserver);
 }
 
+// Sets the time in ms to wait for further changes before notifying observers.
+void FileWatch::SetCoalescingWindow(uint4 milliseconds)
+{
+	m->coalescingWindow = milliseconds;
+	// Re-schedule pending notifications
+	WakeObservationThread(*m);
+}
+
+// Gets the time in ms to wait for further changes before notifying observers.
+uint4 FileWatch::GetCoalescingWindow() const
+{
+	return m->coalescingWindow;
+}
+
+// Sets whether observers are notified whenever files are written or only when their contents change.
+void FileWatch::SetRevisionMode(FileRevisionMode::T mode)
+{
+	m->revisionMode = mode;
+}
+
+// Gets whether observers are notified whenever files are written or only when their contents change.
+FileRevisionMode::T FileWatch::GetRevisionMode() const
+{
+	return m->revisionMode;
+}
+
 // Gets the file watch.
 FileWatch& GetFileWatch()
 {
@@ -274,82 +366,97 @@ void ObservationThread(FileWatch::M &m)
 {
 	try
 	{
-		std::vector<Directory*> directories;
-		std::vector<HANDLE> events;
+		std::vector<FileSystemDirectory*> dueDirectories;
 
 		while (!m.bShuttingDown)
 		{
-			events.clear();
-			directories.clear();
+			const DWORD currentTime = ::GetTickCount();
+			const DWORD coalescingWindow = m.coalescingWindow;
+			DWORD timeout = INFINITE;
+
+			dueDirectories.clear();
 
 			{
 				// Don't modify directory map while accessed from this thread
 				lean::scoped_cs_lock lock(m.directoryLock);
 
-				const size_t directoryCount = m.directories.size();
-
-				directories.reserve(2 * directoryCount + 2);
-				events.reserve(2 * directoryCount + 2);
-
-				// Interrupt waiting when there are updates outside this thread
-				directories.push_back(nullptr);
-				events.push_back(m.updateFilesEvent.native_handle());
-
-				directories.push_back(nullptr);
-				events.push_back(m.updateDirectoriesEvent.native_handle());
-
 				for (FileWatch::M::directory_map::iterator itDirectory = m.directories.begin();
 					itDirectory != m.directories.end(); ++itDirectory)
 				{
-					Directory *pDirectory = itDirectory->second;
-					
-					HANDLE hFileChangeNotification = pDirectory->GetFileChangeNotification();
-					HANDLE hDirectoryChangeNotification = pDirectory->GetDirectoryChangeNotification();
-
-					if (hFileChangeNotification != NULL)
-					{
-						// Store changed notification event handles along with their corresponding directory instances
-						directories.push_back(pDirectory);
-						events.push_back(hFileChangeNotification);
-					}
-
-					if (hDirectoryChangeNotification != NULL)
-					{
-						// Store changed notification event handles along with their corresponding directory instances
-						directories.push_back(pDirectory);
-						events.push_back(hDirectoryChangeNotification);
-					}
+					FileSystemDirectory *pDirectory = itDirectory->second;
+
+					// Directories observed for the first time
+					pDirectory->StartWatching(m.hCompletionPort);
+
+					DWORD delay = pDirectory->GetNotificationDelay(currentTime, coalescingWindow);
+
+					if (delay == 0)
+						dueDirectories.push_back(pDirectory);
+					else
+						timeout = min(timeout, delay);
 				}
 			}
 
-			DWORD dwSignal = ::WaitForMultipleObjects(static_cast<DWORD>(events.size()), &events[0], false, INFINITE);
+			// NOTE: Directories are never removed, notify outside lock
+			for (std::vector<FileSystemDirectory*>::iterator itDirectory = dueDirectories.begin();
+				itDirectory != dueDirectories.end(); ++itDirectory)
+				(*itDirectory)->NotifyObservers();
 
-			if (dwSignal == WAIT_FAILED)
-				LEAN_LOG_WIN_ERROR_CTX("WaitForMultipleObjects()", "Waiting on file changed notifications");
+			if (!dueDirectories.empty())
+				// Observers may take a while, re-check timing
+				continue;
 
-			// Exclude update events (index 0 & 1)
-			if (WAIT_OBJECT_0 + 2 <= dwSignal && dwSignal < WAIT_OBJECT_0 + events.size())
-			{
-				LEAN_ASSERT(events.size() == directories.size());
-				
-				// Get the directory that triggered the changed notification event
-				Directory *directory = directories[dwSignal - WAIT_OBJECT_0];
+			DWORD bytesTransferred = 0;
+			ULONG_PTR completionKey = 0;
+			OVERLAPPED *pOverlapped = nullptr;
 
-				LEAN_ASSERT(directory);
+			BOOL bCompleted = ::GetQueuedCompletionStatus(m.hCompletionPort, &bytesTransferred, &completionKey, &pOverlapped, timeout);
+			DWORD error = (bCompleted) ? ERROR_SUCCESS : ::GetLastError();
 
-				// MONITOR: HACK: TODO: Ugly way to avoid write conflicts ...
-				Sleep(500);
+			// Change notification completed (successfully or not)
+			if (pOverlapped)
+				reinterpret_cast<FileSystemDirectory*>(completionKey)->WatchCompleted(error, bytesTransferred);
+			// Otherwise woken up or timed out
+			else if (error != ERROR_SUCCESS && error != WAIT_TIMEOUT)
+				LEAN_LOG_WIN_ERROR_CTX("GetQueuedCompletionStatus()", "Waiting on file changed notifications");
+		}
 
-				// Update files or directories
-				if (events[dwSignal - WAIT_OBJECT_0] == directory->GetFileChangeNotification())
-					directory->FilesChanged();
-				else
-					directory->DirectoryChanged();
-			}
+		size_t watchCount = 0;
 
-			// ORDER: Reset BEFORE re-checking shut down flag
-			m.updateFilesEvent.reset();
-			m.updateDirectoriesEvent.reset();
+		{
+			// Don't modify directory map while accessed from this thread
+			lean::scoped_cs_lock lock(m.directoryLock);
+
+			// NOTE: Outstanding requests are bound to this thread, cancel them here
+			for (FileWatch::M::directory_map::iterator itDirectory = m.directories.begin();
+				itDirectory != m.directories.end(); ++itDirectory)
+				if (itDirectory->second->IsWatching())
+				{
+					itDirectory->second->StopWatching();
+					++watchCount;
+				}
+		}
+
+		// Buffers need to stay valid until all cancelled requests have completed
+		while (watchCount > 0)
+		{
+			DWORD bytesTransferred = 0;
+			ULONG_PTR completionKey = 0;
+			OVERLAPPED *pOverlapped = nullptr;
+
+			BOOL bCompleted = ::GetQueuedCompletionStatus(m.hCompletionPort, &bytesTransferred, &completionKey, &pOverlapped, INFINITE);
+
+			if (pOverlapped)
+			{
+				reinterpret_cast<FileSystemDirectory*>(completionKey)->WatchCompleted(
+					(bCompleted) ? ERROR_SUCCESS : ::GetLastError(), bytesTransferred);
+				--watchCount;
+			}
+			else if (!bCompleted)
+			{
+				LEAN_LOG_WIN_ERROR_CTX("GetQueuedCompletionStatus()", "Cancelling file changed notifications");
+				break;
+			}
 		}
 	}
 	catch (const std::exception &exc)
@@ -362,10 +469,29 @@ void ObservationThread(FileWatch::M &m)
 	}
 }
 
+/// Gets a case-insensitive key for the given file name.
+utf8_string GetFileKey(lean::utf16_string fileName)
+{
+	if (!fileName.empty())
+		::CharLowerBuffW(&fileName[0], static_cast<DWORD>(fileName.size()));
+
+	return lean::utf_to_utf8(fileName);
+}
+
+/// Gets a case-insensitive key for the given file.
+utf8_string GetFileKey(const lean::utf8_ntri &file)
+{
+	return GetFileKey( lean::utf_to_utf16(lean::get_filename<lean::utf8_string>(file)) );
+}
+
 // Constructor.
 Directory::Directory(FileWatch::M *watch, const utf8_ntri &directory)
 	: m_watch(watch),
-	m_directory( directory.to<utf8_string>() )
+	m_directory( directory.to<utf8_string>() ),
+	m_bAllFilesChanged(false),
+	m_bDirectoryChanged(false),
+	m_firstChangeTime(0),
+	m_lastChangeTime(0)
 {
 }
 
@@ -383,18 +509,20 @@ bool Directory::AddObserver(const lean::utf8_ntri &file, FileObserver *pObserver
 		return false;
 	}
 
-	lean::utf8_string fileName = lean::get_filename<lean::utf8_string>(file);
+	lean::utf8_string fileKey = GetFileKey(file);
 
 	// Do not modify observers while processing changed notifications
 	lean::scoped_cs_lock lock(m_observerLock);
 
-	for (file_observer_map::iterator it = m_fileObservers.lower_bound(fileName), itEnd = m_fileObservers.upper_bound(fileName); it != itEnd; ++it)
+	std::pair<file_observer_map::iterator, file_observer_map::iterator> observers = m_fileObservers.equal_range(fileKey);
+
+	for (file_observer_map::iterator it = observers.first; it != observers.second; ++it)
 		// Keep matching observer
 		if (it->second.pObserver == pObserver)
-			return true; 
+			return true;
 
 	m_fileObservers.insert( file_observer_map::value_type(
-			fileName,
+			fileKey,
 			FileObserverInfo(file, GetRevision(file), pObserver)
 		) );
 
@@ -405,17 +533,19 @@ bool Directory::AddObserver(const lean::utf8_ntri &file, FileObserver *pObserver
 // Removes the given observer no longer to be called when the given file is modified.
 void Directory::RemoveObserver(const lean::utf8_ntri &file, FileObserver *pObserver)
 {
-	lean::utf8_string fileName = lean::get_filename<lean::utf8_string>(file);
+	lean::utf8_string fileKey = GetFileKey(file);
 
 	// Do not modify observers while processing changed notifications
 	lean::scoped_cs_lock lock(m_observerLock);
 
-	const file_observer_map::iterator itObserverInfoEnd = m_fileObservers.upper_bound(fileName);
+	std::pair<file_observer_map::iterator, file_observer_map::iterator> observers = m_fileObservers.equal_range(fileKey);
 
-	for (file_observer_map::iterator it = m_fileObservers.lower_bound(fileName), itEnd = m_fileObservers.upper_bound(fileName); it != itEnd; ++it)
+	for (file_observer_map::iterator it = observers.first; it != observers.second; )
 		// Erase ALL matching observation entries
 		if (it->second.pObserver == pObserver)
-			m_fileObservers.erase(it);
+			it = m_fileObservers.erase(it);
+		else
+			++it;
 }
 
 // Adds the given observer to be called when this directory has been modified.
@@ -431,7 +561,7 @@ bool Directory::AddObserver(DirectoryObserver *pObserver)
 	lean::scoped_cs_lock lock(m_observerLock);
 
 	lean::push_unique(m_directoryObservers, pObserver);
-	
+
 	DirectoryObserverAdded();
 	return true;
 }
@@ -441,12 +571,12 @@ void Directory::RemoveObserver(DirectoryObserver *pObserver)
 {
 	// Do not modify observers while processing changed notifications
 	lean::scoped_cs_lock lock(m_observerLock);
-	
+
 	lean::remove(m_directoryObservers, pObserver);
 }
 
-// Notifies file observers about modifications to the files they are observing. 
-void Directory::FilesChanged()
+// Notifies file observers about modifications to the given files they are observing, all files if nullptr.
+void Directory::FilesChanged(const file_set *pChangedFiles)
 {
 	// Do not modify observers while processing changed notifications
 	lean::scoped_cs_lock lock(m_observerLock);
@@ -456,6 +586,10 @@ void Directory::FilesChanged()
 	for (file_observer_map::iterator itObserverInfo = m_fileObservers.begin();
 		itObserverInfo != itObserverInfoEnd; ++itObserverInfo)
 	{
+		// Skip files not touched
+		if (pChangedFiles && pChangedFiles->find(itObserverInfo->first) == pChangedFiles->end())
+			continue;
+
 		FileObserverInfo &info = itObserverInfo->second;
 
 		// Source of revision depends on type of directory
@@ -483,7 +617,7 @@ void Directory::FilesChanged()
 	}
 }
 
-// Notifies directory observers about modifications to the directory they are observing. 
+// Notifies directory observers about modifications to the directory they are observing.
 void Directory::DirectoryChanged()
 {
 	// Do not modify observers while processing changed notifications
@@ -507,100 +641,237 @@ void Directory::DirectoryChanged()
 	}
 }
 
-/// Creates a file change notification handle for the given directory.
-HANDLE CreateChangeNotification(const lean::utf8_ntri &directory, bool bDirectory)
+// Records the time of a change.
+void Directory::ChangeRecorded(DWORD changeTime)
 {
-	HANDLE hChangeNotification = ::FindFirstChangeNotificationW(
-			lean::utf_to_utf16(directory).c_str(),
-			bDirectory,
-			(bDirectory) 
-				? FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
-				: FILE_NOTIFY_CHANGE_LAST_WRITE
-		);
+	if (!m_bAllFilesChanged && !m_bDirectoryChanged && m_changedFiles.empty())
+		m_firstChangeTime = changeTime;
 
-	if (hChangeNotification == INVALID_HANDLE_VALUE || hChangeNotification == (HANDLE)ERROR_INVALID_FUNCTION)
-	{
-		LEAN_LOG_WIN_ERROR_CTX("FindFirstChangeNotification()", directory.c_str());
-		// Convert to generic error value
-		hChangeNotification = NULL;
-	}
-	
-	return hChangeNotification;
+	m_lastChangeTime = changeTime;
+}
+
+// Records a change to the given file. Observation thread only.
+void Directory::MarkFileChanged(const utf8_string &fileKey, DWORD changeTime)
+{
+	ChangeRecorded(changeTime);
+
+	if (!m_bAllFilesChanged)
+		m_changedFiles.insert(fileKey);
+}
+
+// Records changes to an unknown number of files. Observation thread only.
+void Directory::MarkAllFilesChanged(DWORD changeTime)
+{
+	ChangeRecorded(changeTime);
+
+	m_bAllFilesChanged = true;
+	m_changedFiles.clear();
+}
+
+// Records a change to the directory structure. Observation thread only.
+void Directory::MarkDirectoryChanged(DWORD changeTime)
+{
+	ChangeRecorded(changeTime);
+
+	m_bDirectoryChanged = true;
+}
+
+// Gets the time in ms until pending changes are due for notification, INFINITE if none pending. Observation thread only.
+DWORD Directory::GetNotificationDelay(DWORD currentTime, DWORD coalescingWindow) const
+{
+	if (!m_bAllFilesChanged && !m_bDirectoryChanged && m_changedFiles.empty())
+		return INFINITE;
+
+	// NOTE: Unsigned differences robust to tick count wrap-around
+	const DWORD sinceLast = currentTime - m_lastChangeTime;
+	const DWORD sinceFirst = currentTime - m_firstChangeTime;
+	const DWORD maxDelay = MaxCoalescingDelay * coalescingWindow;
+
+	// Wait for changes to settle, but not forever
+	if (sinceLast >= coalescingWindow || sinceFirst >= maxDelay)
+		return 0;
+
+	return min(coalescingWindow - sinceLast, maxDelay - sinceFirst);
+}
+
+// Notifies observers about all pending changes. Observation thread only.
+void Directory::NotifyObservers()
+{
+	if (m_bAllFilesChanged || !m_changedFiles.empty())
+		FilesChanged( (m_bAllFilesChanged) ? nullptr : &m_changedFiles );
+
+	if (m_bDirectoryChanged)
+		DirectoryChanged();
+
+	m_changedFiles.clear();
+	m_bAllFilesChanged = false;
+	m_bDirectoryChanged = false;
 }
 
 // Constructor.
 FileSystemDirectory::FileSystemDirectory(FileWatch::M *watch, const lean::utf8_ntri &directory)
-	: Directory(watch, directory)
+	: Directory(watch, directory),
+	m_bObserved(false),
+	m_bWatching(false),
+	m_bStopping(false),
+	m_bFailed(false)
 {
 }
 
 // Destructor.
 FileSystemDirectory::~FileSystemDirectory()
 {
+	// ASSERT: Observation thread has cancelled all outstanding requests
+	LEAN_ASSERT(!m_bWatching);
 }
 
 // Gets the revision of the given file.
 lean::uint8 FileSystemDirectory::GetRevision(const lean::utf8_ntri &file) const
 {
-	return lean::file_revision(file);
+	return GetFileRevision(file, m_watch->revisionMode);
 }
 
 // Called when a file observer has been added.
 void FileSystemDirectory::FileObserverAdded()
 {
-	if (m_hFileChangeNotification == NULL)
+	if (!m_bObserved)
 	{
-		m_hFileChangeNotification = CreateChangeNotification(GetDirectory(), false);
-		FileObservationChanged(*m_watch);
+		m_bObserved = true;
+		ObservationChanged(*m_watch);
 	}
 }
 
 // Called when a directory observer has been added.
 void FileSystemDirectory::DirectoryObserverAdded()
 {
-	if (m_hDirectoryChangeNotification == NULL)
+	if (!m_bObserved)
 	{
-		m_hDirectoryChangeNotification = CreateChangeNotification(GetDirectory(), true);
-		DirectoryObservationChanged(*m_watch);
+		m_bObserved = true;
+		ObservationChanged(*m_watch);
 	}
 }
 
-// Gets the handle to a change notification event or NULL, if unavailable.
-HANDLE FileSystemDirectory::GetFileChangeNotification() const
+// Starts watching this directory via the given completion port, if observed. Observation thread only.
+void FileSystemDirectory::StartWatching(HANDLE hCompletionPort)
 {
-	return m_hFileChangeNotification;
-}
+	if (!m_bObserved || m_bWatching || m_bStopping || m_bFailed)
+		return;
 
-// Gets the handle to a change notification event or NULL, if unavailable.
-HANDLE FileSystemDirectory::GetDirectoryChangeNotification() const
-{
-	return m_hDirectoryChangeNotification;
+	if (m_hDirectory == INVALID_HANDLE_VALUE)
+	{
+		m_hDirectory = ::CreateFileW(
+				lean::utf_to_utf16(GetDirectory()).c_str(),
+				FILE_LIST_DIRECTORY,
+				FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+				NULL
+			);
+
+		if (m_hDirectory == INVALID_HANDLE_VALUE)
+		{
+			LEAN_LOG_WIN_ERROR_CTX("CreateFileW()", GetDirectory().c_str());
+			// Don't retry on every wake-up
+			m_bFailed = true;
+			return;
+		}
+
+		// Completion key identifies this directory
+		if (!::CreateIoCompletionPort(m_hDirectory, hCompletionPort, reinterpret_cast<ULONG_PTR>(this), 0))
+		{
+			LEAN_LOG_WIN_ERROR_CTX("CreateIoCompletionPort()", GetDirectory().c_str());
+			m_bFailed = true;
+			return;
+		}
+	}
+
+	Watch();
 }
 
-// Notifies file observers about modifications to the files they are observing. 
-void FileSystemDirectory::FilesChanged()
+// Issues an asynchronous change notification request.
+void FileSystemDirectory::Watch()
 {
-	if (m_hFileChangeNotification != NULL)
+	memset(&m_overlapped, 0, sizeof(m_overlapped));
+
+	BOOL bIssued = ::ReadDirectoryChangesW(
+			m_hDirectory,
+			m_buffer, BufferSize,
+			false,
+			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME,
+			nullptr, &m_overlapped, nullptr
+		);
+
+	if (bIssued)
+		m_bWatching = true;
+	else
 	{
-		if (!::FindNextChangeNotification(m_hFileChangeNotification))
-			LEAN_LOG_WIN_ERROR_CTX("FindNextChangeNotification()", GetDirectory().c_str());
+		LEAN_LOG_WIN_ERROR_CTX("ReadDirectoryChangesW()", GetDirectory().c_str());
+		m_bFailed = true;
 	}
+}
 
-	Directory::FilesChanged();
+// Cancels watching this directory. Observation thread only.
+void FileSystemDirectory::StopWatching()
+{
+	m_bStopping = true;
+
+	if (m_bWatching && !::CancelIo(m_hDirectory))
+		LEAN_LOG_WIN_ERROR_CTX("CancelIo()", GetDirectory().c_str());
 }
 
-// Notifies file observers about modifications to the directory they are observing. 
-void FileSystemDirectory::DirectoryChanged()
+// Processes completed change notifications & keeps watching. Observation thread only.
+void FileSystemDirectory::WatchCompleted(DWORD error, DWORD bytesTransferred)
 {
-	if (m_hDirectoryChangeNotification != NULL)
+	m_bWatching = false;
+
+	if (m_bStopping || error == ERROR_OPERATION_ABORTED)
+		return;
+
+	if (error != ERROR_SUCCESS)
 	{
-		if (!::FindNextChangeNotification(m_hDirectoryChangeNotification))
-			LEAN_LOG_WIN_ERROR_CTX("FindNextChangeNotification()", GetDirectory().c_str());
+		LEAN_LOG_ERROR_CTX("Waiting on file changed notifications failed", GetDirectory().c_str());
+		m_bFailed = true;
+		return;
 	}
 
-	Directory::DirectoryChanged();
+	const DWORD changeTime = ::GetTickCount();
+
+	// Buffer overflow, individual changes lost
+	if (bytesTransferred == 0)
+	{
+		MarkAllFilesChanged(changeTime);
+		MarkDirectoryChanged(changeTime);
+	}
+	else
+	{
+		const char *buffer = reinterpret_cast<const char*>(m_buffer);
+
+		for (DWORD bufferOffset = 0; ; )
+		{
+			const FILE_NOTIFY_INFORMATION &info = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buffer + bufferOffset);
+
+			// NOTE: Bursts of changes to the same file collapse into one entry
+			MarkFileChanged(
+					GetFileKey( lean::utf16_string(info.FileName, info.FileNameLength / sizeof(WCHAR)) ),
+					changeTime
+				);
+
+			// Files added, removed or renamed
+			if (info.Action != FILE_ACTION_MODIFIED)
+				MarkDirectoryChanged(changeTime);
+
+			if (info.NextEntryOffset == 0)
+				break;
+
+			bufferOffset += info.NextEntryOffset;
+		}
+	}
+
+	// Keep watching
+	Watch();
 }
 
 } // namespace
 
-} // namespace
\ No newline at end of file
+} // namespace
@@ -4,7 +4,6 @@
 
 #include "beCoreInternal/stdafx.h"
 #include "beCore/beIdentifiers.h"
-#include <algorithm>
 
 namespace beCore
 {
@@ -21,25 +20,48 @@ Identifiers::~Identifiers()
 
 // Adds the given identifier to this identifier manager.
 uint4 Identifiers::GetID(const utf8_ntri &name)
+{
+	return GetID( InternAtom(name) );
+}
+
+// Adds the given identifier to this identifier manager.
+uint4 Identifiers::GetID(const utf8_ntri &name) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetID( FindAtom(name) );
+}
+
+// Adds the given identifier to this identifier manager.
+uint4 Identifiers::GetID(Atom name)
 {
 	uint4 id = static_cast<const Identifiers*>(this)->GetID(name);
 
-	if (id == InvalidID)
+	if (id == InvalidID && name != InvalidAtom)
 	{
 		id = static_cast<uint4>( m_identifiers.size() );
-		m_identifiers.push_back( name.to<utf8_string>() );
+		m_identifiers.push_back(name);
+
+		try
+		{
+			m_ids[name] = id;
+		}
+		catch (...)
+		{
+			m_identifiers.pop_back();
+			throw;
+		}
 	}
 
 	return id;
 }
 
-// Adds the given identifier to this identifier manager.
-uint4 Identifiers::GetID(const utf8_ntri &name) const
+// Gets the ID of the given identifier, InvalidID if unknown.
+uint4 Identifiers::GetID(Atom name) const
 {
-	identifier_vector::const_iterator it = std::find(m_identifiers.begin(), m_identifiers.end(), name);
+	id_map::const_iterator it = m_ids.find(name);
 
-	return (it != m_identifiers.end())
-		? static_cast<uint4>( it - m_identifiers.begin() )
+	return (it != m_ids.end())
+		? it->second
 		: InvalidID;
 }
 
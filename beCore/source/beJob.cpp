@@ -7,6 +7,7 @@
 
 #include "beCore/beTask.h"
 #include "beCore/beThreadPool.h"
+#include "beCoreInternal/beSchedulerTrace.h"
 
 #include <lean/concurrent/atomic.h>
 #include <lean/concurrent/spin_lock.h>
@@ -22,6 +23,11 @@ class beCore::Job::Impl : private beCore::Task
 private:
 	Job *m_pJob;
 	JobType::T m_type;
+	const char *m_name;
+
+	TaskPriority::T m_priority;
+	bool m_bInheritPriority;
+	TaskPriority::T m_runPriority;
 	
 	Impl *m_pParent;
 	Impl *m_pNextSibling;
@@ -64,7 +70,7 @@ private:
 
 public:
 	/// Initializes synchronization primitives.
-	Impl(Job *pJob, JobType::T type);
+	Impl(Job *pJob, JobType::T type, const char *name);
 
 	/// Adds a child job. This method is thread-safe.
 	bool AddJob(Job *pJob);
@@ -76,11 +82,22 @@ public:
 	LEAN_INLINE ThreadPool* GetThreadPool() const { return m_pPool; }
 	/// Gets the job type.
 	LEAN_INLINE JobType::T GetType() const { return m_type; }
+	/// Gets the job name.
+	LEAN_INLINE const char* GetName() const { return m_name; }
+
+	/// Sets the priority of this job's tasks.
+	LEAN_INLINE void SetPriority(TaskPriority::T priority)
+	{
+		m_priority = priority;
+		m_bInheritPriority = false;
+	}
+	/// Gets the priority of this job's tasks.
+	LEAN_INLINE TaskPriority::T GetPriority() const { return m_priority; }
 };
 
 // Constructs an empty job.
-beCore::Job::Job(JobType::T type)
-	: m_impl( new Impl(this, type) )
+beCore::Job::Job(JobType::T type, const char *name)
+	: m_impl( new Impl(this, type, name) )
 {
 }
 
@@ -107,10 +124,33 @@ beCore::JobType::T beCore::Job::GetType() const
 	return m_impl->GetType();
 }
 
+// Gets the job name, nullptr if unnamed.
+const char* beCore::Job::GetName() const
+{
+	return m_impl->GetName();
+}
+
+// Sets the priority of this job's tasks.
+void beCore::Job::SetPriority(TaskPriority::T priority)
+{
+	m_impl->SetPriority(priority);
+}
+
+// Gets the priority of this job's tasks.
+beCore::TaskPriority::T beCore::Job::GetPriority() const
+{
+	return m_impl->GetPriority();
+}
+
 // Initializes synchronization primitives.
-beCore::Job::Impl::Impl(Job *pJob, JobType::T type)
+beCore::Job::Impl::Impl(Job *pJob, JobType::T type, const char *name)
 		: m_pJob(pJob),
 		m_type(type),
+		m_name(name),
+
+		m_priority(TaskPriority::Normal),
+		m_bInheritPriority(true),
+		m_runPriority(TaskPriority::Normal),
 		
 		m_pParent(nullptr),
 		m_pNextSibling(nullptr),
@@ -154,6 +194,9 @@ LEAN_INLINE void beCore::Job::Impl::Run(ThreadPool *pPool)
 		return;
 	}
 	
+	// Top-level jobs have nothing to inherit
+	m_runPriority = m_priority;
+
 	// Registering ourselves as our own child takes care of proper waiting and termination
 	AddRunningChild();
 	lean::scope_annex runningChildGuard = lean::make_scope_annex(this, &Impl::RemoveRunningChild);
@@ -187,8 +230,12 @@ LEAN_INLINE void beCore::Job::Impl::DoRun(ThreadPool *pPool)
 {
 	lean::atomic_set(m_pPool, pPool);
 
-	// Parent always run BEFORE children (sequentially)
-	m_pJob->Run();
+	{
+		BE_SCHEDULER_TRACE( SchedulerTraceScope traceScope((m_name) ? m_name : "Job", SchedulerCounter::None) );
+
+		// Parent always run BEFORE children (sequentially)
+		m_pJob->Run();
+	}
 
 	RunChildren();
 }
@@ -287,6 +334,15 @@ void beCore::Job::Impl::RunChildren()
 	// Only process if job range valid
 	if (!GetAndUnlinkChildren(pFirstJobImpl, pLastJobImpl))
 		return;
+
+	// Propagate priority BEFORE running any children
+	for (Impl *pJobImpl = pFirstJobImpl; ; pJobImpl = const_cast<Impl *volatile &>(pJobImpl->m_pNextSibling))
+	{
+		pJobImpl->m_runPriority = (pJobImpl->m_bInheritPriority) ? m_runPriority : pJobImpl->m_priority;
+
+		if (pJobImpl == pLastJobImpl)
+			break;
+	}
 	
 	if (m_type == JobType::Sequential)
 	{
@@ -327,7 +383,7 @@ void beCore::Job::Impl::RunChildren()
 
 			// Run() always calls RemoveRunningChild() by calling ChildTerminated() via Terminate()
 			AddRunningChild();
-			m_pPool->AddTask(pJobImpl);
+			m_pPool->AddTask(pJobImpl, pJobImpl->m_runPriority);
 
 			pJobImpl = pNextJobImpl;
 		}
@@ -392,6 +448,19 @@ LEAN_INLINE int beCore::Job::Impl::GetRunningChildCount()
 // Waits for all children currently running to terminate.
 LEAN_INLINE void beCore::Job::Impl::WaitForChildren()
 {
+	// Nothing to wait for
+	if (m_childrenRunning <= 0)
+		return;
+
+	BE_SCHEDULER_TRACE( SchedulerWaitScope traceScope );
+
+	// Only help out with tasks of this job's priority or higher, waits must not be held up by less urgent work
+	const TaskPriority::T helpPriority = m_runPriority;
+
+	// Help out with pending tasks instead of blocking this thread
+	// -> Nested parallel jobs would otherwise block several workers while runnable tasks remain queued
+	while (m_childrenRunning > 0 && m_pPool->RunPendingTask(helpPriority));
+
 	// Only wait if the job has not yet terminated
 	// -> Allows for lazy signaling to minimize syscalls
 	// -> Allows lazy signal to recover from ALL waiting threads
@@ -415,6 +484,8 @@ LEAN_INLINE void beCore::Job::Impl::WaitForChildren()
 			}
 		}
 
+		// NOTE: Nothing left to help with, tasks added from here on are picked up by the other threads
+		// -> Block until signaled by the last child, never poll
 		m_childrenDone.wait();
 		
 		// Reset signal as soon as all waiting threads have been released
@@ -0,0 +1,904 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beNumericText.h"
+
+#include <cstring>
+#include <climits>
+#include <sstream>
+#include <locale>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Unnormalized 64-bit floating-point value, f * 2^e.
+struct DiyFp
+{
+	uint8 f;
+	int e;
+
+	/// Constructor.
+	DiyFp(uint8 f, int e)
+		: f(f), e(e) { }
+};
+
+/// Subtracts y from x, both required to have the same exponent.
+LEAN_INLINE DiyFp Sub(const DiyFp &x, const DiyFp &y)
+{
+	LEAN_ASSERT(x.e == y.e && x.f >= y.f);
+	return DiyFp(x.f - y.f, x.e);
+}
+
+/// Multiplies x & y, rounding the 128-bit product to 64 bits.
+DiyFp Mul(const DiyFp &x, const DiyFp &y)
+{
+	const uint8 uLo = x.f & 0xFFFFFFFFULL;
+	const uint8 uHi = x.f >> 32;
+	const uint8 vLo = y.f & 0xFFFFFFFFULL;
+	const uint8 vHi = y.f >> 32;
+
+	const uint8 p0 = uLo * vLo;
+	const uint8 p1 = uLo * vHi;
+	const uint8 p2 = uHi * vLo;
+	const uint8 p3 = uHi * vHi;
+
+	uint8 q = (p0 >> 32) + (p1 & 0xFFFFFFFFULL) + (p2 & 0xFFFFFFFFULL);
+	// Round half up
+	q += 1ULL << 31;
+
+	return DiyFp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+}
+
+/// Shifts the highest bit set into the highest bit.
+LEAN_INLINE DiyFp Normalize(DiyFp x)
+{
+	LEAN_ASSERT(x.f != 0);
+
+	while ((x.f >> 63) == 0)
+	{
+		x.f <<= 1;
+		--x.e;
+	}
+
+	return x;
+}
+
+/// Shifts the given value to the given exponent, which is required to be smaller.
+LEAN_INLINE DiyFp NormalizeTo(const DiyFp &x, int e)
+{
+	LEAN_ASSERT(x.e >= e);
+	return DiyFp(x.f << (x.e - e), e);
+}
+
+/// Normalized value & boundaries of the interval of values rounding to the same floating-point value.
+struct Boundaries
+{
+	DiyFp w;
+	DiyFp minus;
+	DiyFp plus;
+
+	/// Constructor.
+	Boundaries(const DiyFp &w, const DiyFp &minus, const DiyFp &plus)
+		: w(w), minus(minus), plus(plus) { }
+};
+
+/// Computes the boundaries of the given positive finite non-zero value.
+template <class Float, class Bits>
+Boundaries ComputeBoundaries(Float value)
+{
+	const int Precision = std::numeric_limits<Float>::digits;
+	const int Bias = std::numeric_limits<Float>::max_exponent - 1 + (Precision - 1);
+	const int MinExp = 1 - Bias;
+	const uint8 HiddenBit = 1ULL << (Precision - 1);
+
+	Bits bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	const uint8 E = bits >> (Precision - 1);
+	const uint8 F = bits & (HiddenBit - 1);
+
+	const DiyFp v = (E == 0)
+		? DiyFp(F, MinExp)
+		: DiyFp(F + HiddenBit, static_cast<int>(E) - Bias);
+
+	// NOTE: Lower boundary closer if the significand is a power of two, except for the smallest normalized exponent
+	const bool bLowerCloser = (F == 0 && E > 1);
+
+	const DiyFp plus = Normalize( DiyFp(2 * v.f + 1, v.e - 1) );
+	const DiyFp minus = (bLowerCloser)
+		? DiyFp(4 * v.f - 1, v.e - 2)
+		: DiyFp(2 * v.f - 1, v.e - 1);
+
+	return Boundaries( Normalize(v), NormalizeTo(minus, plus.e), plus );
+}
+
+/// Cached power of ten, f * 2^e ~ 10^k.
+struct CachedPower
+{
+	uint8 f;
+	int e;
+	int k;
+};
+
+/// Normalized powers of ten from 10^-300 to 10^324 in steps of 8.
+const CachedPower CachedPowers[] =
+{
+	{ 0xAB70FE17C79AC6CAULL, -1060, -300 },
+	{ 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+	{ 0xBE5691EF416BD60CULL, -1007, -284 },
+	{ 0x8DD01FAD907FFC3CULL,  -980, -276 },
+	{ 0xD3515C2831559A83ULL,  -954, -268 },
+	{ 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+	{ 0xEA9C227723EE8BCBULL,  -901, -252 },
+	{ 0xAECC49914078536DULL,  -874, -244 },
+	{ 0x823C12795DB6CE57ULL,  -847, -236 },
+	{ 0xC21094364DFB5637ULL,  -821, -228 },
+	{ 0x9096EA6F3848984FULL,  -794, -220 },
+	{ 0xD77485CB25823AC7ULL,  -768, -212 },
+	{ 0xA086CFCD97BF97F4ULL,  -741, -204 },
+	{ 0xEF340A98172AACE5ULL,  -715, -196 },
+	{ 0xB23867FB2A35B28EULL,  -688, -188 },
+	{ 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+	{ 0xC5DD44271AD3CDBAULL,  -635, -172 },
+	{ 0x936B9FCEBB25C996ULL,  -608, -164 },
+	{ 0xDBAC6C247D62A584ULL,  -582, -156 },
+	{ 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+	{ 0xF3E2F893DEC3F126ULL,  -529, -140 },
+	{ 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+	{ 0x87625F056C7C4A8BULL,  -475, -124 },
+	{ 0xC9BCFF6034C13053ULL,  -449, -116 },
+	{ 0x964E858C91BA2655ULL,  -422, -108 },
+	{ 0xDFF9772470297EBDULL,  -396, -100 },
+	{ 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+	{ 0xF8A95FCF88747D94ULL,  -343,  -84 },
+	{ 0xB94470938FA89BCFULL,  -316,  -76 },
+	{ 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+	{ 0xCDB02555653131B6ULL,  -263,  -60 },
+	{ 0x993FE2C6D07B7FACULL,  -236,  -52 },
+	{ 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+	{ 0xAA242499697392D3ULL,  -183,  -36 },
+	{ 0xFD87B5F28300CA0EULL,  -157,  -28 },
+	{ 0xBCE5086492111AEBULL,  -130,  -20 },
+	{ 0x8CBCCC096F5088CCULL,  -103,  -12 },
+	{ 0xD1B71758E219652CULL,   -77,   -4 },
+	{ 0x9C40000000000000ULL,   -50,    4 },
+	{ 0xE8D4A51000000000ULL,   -24,   12 },
+	{ 0xAD78EBC5AC620000ULL,     3,   20 },
+	{ 0x813F3978F8940984ULL,    30,   28 },
+	{ 0xC097CE7BC90715B3ULL,    56,   36 },
+	{ 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+	{ 0xD5D238A4ABE98068ULL,   109,   52 },
+	{ 0x9F4F2726179A2245ULL,   136,   60 },
+	{ 0xED63A231D4C4FB27ULL,   162,   68 },
+	{ 0xB0DE65388CC8ADA8ULL,   189,   76 },
+	{ 0x83C7088E1AAB65DBULL,   216,   84 },
+	{ 0xC45D1DF942711D9AULL,   242,   92 },
+	{ 0x924D692CA61BE758ULL,   269,  100 },
+	{ 0xDA01EE641A708DEAULL,   295,  108 },
+	{ 0xA26DA3999AEF774AULL,   322,  116 },
+	{ 0xF209787BB47D6B85ULL,   348,  124 },
+	{ 0xB454E4A179DD1877ULL,   375,  132 },
+	{ 0x865B86925B9BC5C2ULL,   402,  140 },
+	{ 0xC83553C5C8965D3DULL,   428,  148 },
+	{ 0x952AB45CFA97A0B3ULL,   455,  156 },
+	{ 0xDE469FBD99A05FE3ULL,   481,  164 },
+	{ 0xA59BC234DB398C25ULL,   508,  172 },
+	{ 0xF6C69A72A3989F5CULL,   534,  180 },
+	{ 0xB7DCBF5354E9BECEULL,   561,  188 },
+	{ 0x88FCF317F22241E2ULL,   588,  196 },
+	{ 0xCC20CE9BD35C78A5ULL,   614,  204 },
+	{ 0x98165AF37B2153DFULL,   641,  212 },
+	{ 0xE2A0B5DC971F303AULL,   667,  220 },
+	{ 0xA8D9D1535CE3B396ULL,   694,  228 },
+	{ 0xFB9B7CD9A4A7443CULL,   720,  236 },
+	{ 0xBB764C4CA7A44410ULL,   747,  244 },
+	{ 0x8BAB8EEFB6409C1AULL,   774,  252 },
+	{ 0xD01FEF10A657842CULL,   800,  260 },
+	{ 0x9B10A4E5E9913129ULL,   827,  268 },
+	{ 0xE7109BFBA19C0C9DULL,   853,  276 },
+	{ 0xAC2820D9623BF429ULL,   880,  284 },
+	{ 0x80444B5E7AA7CF85ULL,   907,  292 },
+	{ 0xBF21E44003ACDD2DULL,   933,  300 },
+	{ 0x8E679C2F5E44FF8FULL,   960,  308 },
+	{ 0xD433179D9C8CB841ULL,   986,  316 },
+	{ 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+};
+
+const int CachedPowersMinDecExp = -300;
+const int CachedPowersDecStep = 8;
+
+/// Target exponent range of the scaled boundaries, allows for digit generation using 32-bit integer & 64-bit fraction.
+const int Alpha = -60;
+const int Gamma = -32;
+
+/// Gets a cached power of ten c, such that Alpha <= e + c.e + 64 <= Gamma.
+const CachedPower& GetCachedPower(int e)
+{
+	// NOTE: ceil(log10(2)) via fixed point, 78913 / 2^18 ~ log10(2)
+	const int f = Alpha - e - 1;
+	const int k = (f * 78913) / (1 << 18) + (f > 0);
+
+	const int index = (-CachedPowersMinDecExp + k + (CachedPowersDecStep - 1)) / CachedPowersDecStep;
+	LEAN_ASSERT(0 <= index && index < static_cast<int>(lean::arraylen(CachedPowers)));
+
+	const CachedPower &cached = CachedPowers[index];
+	LEAN_ASSERT(Alpha <= cached.e + e + 64 && cached.e + e + 64 <= Gamma);
+
+	return cached;
+}
+
+/// Gets the largest power of ten <= n, returns the number of decimal digits of n.
+LEAN_INLINE int FindLargestPow10(uint4 n, uint4 &pow10)
+{
+	if (n >= 1000000000) { pow10 = 1000000000; return 10; }
+	else if (n >= 100000000) { pow10 = 100000000; return 9; }
+	else if (n >= 10000000) { pow10 = 10000000; return 8; }
+	else if (n >= 1000000) { pow10 = 1000000; return 7; }
+	else if (n >= 100000) { pow10 = 100000; return 6; }
+	else if (n >= 10000) { pow10 = 10000; return 5; }
+	else if (n >= 1000) { pow10 = 1000; return 4; }
+	else if (n >= 100) { pow10 = 100; return 3; }
+	else if (n >= 10) { pow10 = 10; return 2; }
+	else { pow10 = 1; return 1; }
+}
+
+/// Moves the last digit towards w while staying inside the rounding interval.
+LEAN_INLINE void RoundDigits(utf8_t *digits, int length, uint8 dist, uint8 delta, uint8 rest, uint8 tenK)
+{
+	while (rest < dist && delta - rest >= tenK
+		&& (rest + tenK < dist || dist - rest > rest + tenK - dist))
+	{
+		--digits[length - 1];
+		rest += tenK;
+	}
+}
+
+/// Generates the shortest digits in [minus, plus] closest to w, (Grisu2, Florian Loitsch).
+void GenerateDigits(utf8_t *digits, int &length, int &decimalExponent, const DiyFp &minus, const DiyFp &w, const DiyFp &plus)
+{
+	uint8 delta = Sub(plus, minus).f;
+	uint8 dist = Sub(plus, w).f;
+
+	// NOTE: Split into integral part p1 & fractional part p2
+	const DiyFp one(1ULL << -plus.e, plus.e);
+
+	uint4 p1 = static_cast<uint4>(plus.f >> -one.e);
+	uint8 p2 = plus.f & (one.f - 1);
+
+	uint4 pow10;
+	int n = FindLargestPow10(p1, pow10);
+
+	while (n > 0)
+	{
+		const uint4 d = p1 / pow10;
+		p1 %= pow10;
+
+		digits[length++] = static_cast<utf8_t>('0' + d);
+		--n;
+
+		const uint8 rest = (static_cast<uint8>(p1) << -one.e) + p2;
+
+		if (rest <= delta)
+		{
+			decimalExponent += n;
+			RoundDigits(digits, length, dist, delta, rest, static_cast<uint8>(pow10) << -one.e);
+			return;
+		}
+
+		pow10 /= 10;
+	}
+
+	int m = 0;
+
+	for (;;)
+	{
+		p2 *= 10;
+		const uint8 d = p2 >> -one.e;
+		p2 &= one.f - 1;
+
+		digits[length++] = static_cast<utf8_t>('0' + d);
+		++m;
+
+		delta *= 10;
+		dist *= 10;
+
+		if (p2 <= delta)
+			break;
+	}
+
+	decimalExponent -= m;
+	RoundDigits(digits, length, dist, delta, p2, one.f);
+}
+
+/// Generates the shortest digits that round to the given positive finite non-zero value.
+template <class Float, class Bits>
+void Grisu2(utf8_t *digits, int &length, int &decimalExponent, Float value)
+{
+	const Boundaries b = ComputeBoundaries<Float, Bits>(value);
+	const CachedPower &cached = GetCachedPower(b.plus.e);
+	const DiyFp c(cached.f, cached.e);
+
+	const DiyFp w = Mul(b.w, c);
+	const DiyFp wMinus = Mul(b.minus, c);
+	const DiyFp wPlus = Mul(b.plus, c);
+
+	// NOTE: Shrink interval by one ulp to account for multiplication error
+	const DiyFp minus(wMinus.f + 1, wMinus.e);
+	const DiyFp plus(wPlus.f - 1, wPlus.e);
+
+	length = 0;
+	decimalExponent = -cached.k;
+	GenerateDigits(digits, length, decimalExponent, minus, w, plus);
+}
+
+/// Appends the given decimal exponent.
+utf8_t* WriteExponent(utf8_t *begin, int e)
+{
+	if (e < 0)
+	{
+		*begin++ = '-';
+		e = -e;
+	}
+	else
+		*begin++ = '+';
+
+	if (e >= 100)
+	{
+		*begin++ = static_cast<utf8_t>('0' + e / 100);
+		e %= 100;
+		*begin++ = static_cast<utf8_t>('0' + e / 10);
+	}
+	else if (e >= 10)
+		*begin++ = static_cast<utf8_t>('0' + e / 10);
+
+	*begin++ = static_cast<utf8_t>('0' + e % 10);
+
+	return begin;
+}
+
+/// Formats the given digits in place, fixed-point if the decimal point falls into (-4, 15], exponent notation otherwise.
+utf8_t* FormatDigits(utf8_t *begin, int length, int decimalExponent)
+{
+	const int MinExp = -4;
+	const int MaxExp = 15;
+
+	const int k = length;
+	const int n = length + decimalExponent;
+
+	// digits[000]
+	if (k <= n && n <= MaxExp)
+	{
+		memset(begin + k, '0', n - k);
+		return begin + n;
+	}
+
+	// dig.its
+	if (0 < n && n <= MaxExp)
+	{
+		memmove(begin + (n + 1), begin + n, k - n);
+		begin[n] = '.';
+		return begin + (k + 1);
+	}
+
+	// 0.[000]digits
+	if (MinExp < n && n <= 0)
+	{
+		memmove(begin + (2 - n), begin, k);
+		begin[0] = '0';
+		begin[1] = '.';
+		memset(begin + 2, '0', -n);
+		return begin + (2 - n + k);
+	}
+
+	// d[.igits]e+123
+	if (k == 1)
+		begin += 1;
+	else
+	{
+		memmove(begin + 2, begin + 1, k - 1);
+		begin[1] = '.';
+		begin += 1 + k;
+	}
+
+	*begin++ = 'e';
+	return WriteExponent(begin, n - 1);
+}
+
+/// Writes the given special value.
+LEAN_INLINE utf8_t* WriteString(utf8_t *begin, const char *str)
+{
+	while (*str)
+		*begin++ = *str++;
+	return begin;
+}
+
+/// Writes the shortest round-trip representation of the given value.
+template <class Float, class Bits>
+utf8_t* WriteShortest(utf8_t *begin, Float value)
+{
+	const int Precision = std::numeric_limits<Float>::digits;
+	const int ExponentBits = sizeof(Bits) * 8 - Precision;
+	const Bits ExponentMask = static_cast<Bits>((1ULL << ExponentBits) - 1) << (Precision - 1);
+	const Bits SignMask = static_cast<Bits>(1ULL << (sizeof(Bits) * 8 - 1));
+
+	Bits bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	if ((bits & ExponentMask) == ExponentMask)
+	{
+		if ((bits & ~(ExponentMask | SignMask)) != 0)
+			return WriteString(begin, "nan");
+		else
+			return WriteString(begin, (bits & SignMask) ? "-inf" : "inf");
+	}
+
+	if (bits & SignMask)
+	{
+		*begin++ = '-';
+		value = -value;
+	}
+
+	if (value == 0)
+	{
+		*begin++ = '0';
+		return begin;
+	}
+
+	int length, decimalExponent;
+	Grisu2<Float, Bits>(begin, length, decimalExponent, value);
+
+	return FormatDigits(begin, length, decimalExponent);
+}
+
+/// Checks if the given character is a decimal digit.
+LEAN_INLINE bool IsDigit(utf8_t c)
+{
+	return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+/// Loads eight characters.
+LEAN_INLINE uint8 LoadEightChars(const utf8_t *it)
+{
+	// NOTE: Little endian
+	uint8 chunk;
+	memcpy(&chunk, it, sizeof(chunk));
+	return chunk;
+}
+
+/// Checks if all of the given eight characters are decimal digits (SWAR).
+LEAN_INLINE bool IsEightDigits(uint8 chunk)
+{
+	return (((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+}
+
+/// Converts the given eight decimal digits at once (SWAR).
+LEAN_INLINE uint4 ParseEightDigits(uint8 chunk)
+{
+	const uint8 Mask = 0x000000FF000000FFULL;
+	const uint8 Mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+	const uint8 Mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+
+	chunk -= 0x3030303030303030ULL;
+	// Pairs of digits
+	chunk = (chunk * 10) + (chunk >> 8);
+	// Combine pairs of pairs
+	chunk = (((chunk & Mask) * Mul1) + (((chunk >> 16) & Mask) * Mul2)) >> 32;
+
+	return static_cast<uint4>(chunk);
+}
+
+/// Maximum number of decimal digits that always fit into 64 bits.
+const int MaxMantissaDigits = 19;
+
+/// Decimal number, mantissa * 10^exponent.
+struct DecimalNumber
+{
+	uint8 mantissa;
+	int exponent;
+	int digitCount;
+	bool bNegative;
+	bool bTruncated;
+
+	/// Constructor.
+	DecimalNumber()
+		: mantissa(0),
+		exponent(0),
+		digitCount(0),
+		bNegative(false),
+		bTruncated(false) { }
+};
+
+/// Accumulates the given run of digits, fractional digits decrement the exponent.
+const utf8_t* ParseMantissaDigits(const utf8_t *it, const utf8_t *end, DecimalNumber &number, int fraction)
+{
+	// Leading zeroes carry no precision
+	if (number.mantissa == 0)
+		for (; it < end && *it == '0'; ++it)
+			number.exponent -= fraction;
+
+	while (end - it >= 8 && number.digitCount + 8 <= MaxMantissaDigits)
+	{
+		const uint8 chunk = LoadEightChars(it);
+
+		if (!IsEightDigits(chunk))
+			break;
+
+		number.mantissa = number.mantissa * 100000000ULL + ParseEightDigits(chunk);
+		number.digitCount += 8;
+		number.exponent -= 8 * fraction;
+		it += 8;
+	}
+
+	for (; it < end && IsDigit(*it); ++it)
+		if (number.digitCount < MaxMantissaDigits)
+		{
+			number.mantissa = number.mantissa * 10 + (*it - '0');
+			++number.digitCount;
+			number.exponent -= fraction;
+		}
+		else
+		{
+			// NOTE: Digits beyond precision only scale integral part
+			number.bTruncated |= (*it != '0');
+			number.exponent += 1 - fraction;
+		}
+
+	return it;
+}
+
+/// Parses a decimal number of the form [+-]digits[.digits][(e|E)[+-]digits].
+const utf8_t* ParseDecimal(const utf8_t *begin, const utf8_t *end, DecimalNumber &number)
+{
+	const utf8_t *it = begin;
+
+	if (it < end && (*it == '-' || *it == '+'))
+		number.bNegative = (*it++ == '-');
+
+	const utf8_t *integralBegin = it;
+	it = ParseMantissaDigits(it, end, number, 0);
+	bool bHasDigits = (it != integralBegin);
+
+	if (it < end && *it == '.')
+	{
+		const utf8_t *fractionBegin = ++it;
+		it = ParseMantissaDigits(it, end, number, 1);
+		bHasDigits |= (it != fractionBegin);
+	}
+
+	if (!bHasDigits)
+		return nullptr;
+
+	if (it < end && (*it == 'e' || *it == 'E'))
+	{
+		const utf8_t *expIt = it + 1;
+		bool bNegativeExp = false;
+
+		if (expIt < end && (*expIt == '-' || *expIt == '+'))
+			bNegativeExp = (*expIt++ == '-');
+
+		// NOTE: Otherwise, 'e' is not part of the number
+		if (expIt < end && IsDigit(*expIt))
+		{
+			int exp = 0;
+
+			for (; expIt < end && IsDigit(*expIt); ++expIt)
+				// Clamp to avoid overflow, result is +-0 or +-inf anyways
+				if (exp < 100000)
+					exp = exp * 10 + (*expIt - '0');
+
+			number.exponent += (bNegativeExp) ? -exp : exp;
+			it = expIt;
+		}
+	}
+
+	return it;
+}
+
+/// Compares the given range of characters to the given lower-case string, ignoring case.
+const utf8_t* MatchNoCase(const utf8_t *begin, const utf8_t *end, const char *str)
+{
+	for (; *str; ++begin, ++str)
+		if (begin == end || (*begin | 0x20) != *str)
+			return nullptr;
+	return begin;
+}
+
+/// Parses inf, infinity & nan.
+template <class Float>
+const utf8_t* ParseSpecial(const utf8_t *begin, const utf8_t *end, Float &value)
+{
+	const utf8_t *it = begin;
+	bool bNegative = false;
+
+	if (it < end && (*it == '-' || *it == '+'))
+		bNegative = (*it++ == '-');
+
+	const utf8_t *specialEnd = MatchNoCase(it, end, "nan");
+
+	if (specialEnd)
+		value = std::numeric_limits<Float>::quiet_NaN();
+	else
+	{
+		specialEnd = MatchNoCase(it, end, "inf");
+
+		if (specialEnd)
+		{
+			value = (bNegative) ? -std::numeric_limits<Float>::infinity() : std::numeric_limits<Float>::infinity();
+
+			if (const utf8_t *infinityEnd = MatchNoCase(it, end, "infinity"))
+				specialEnd = infinityEnd;
+		}
+	}
+
+	return specialEnd;
+}
+
+/// Exactly representable powers of ten.
+const double ExactPowers10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// Parses the given number the slow way.
+template <class Float>
+const utf8_t* ParseFallback(const utf8_t *begin, const utf8_t *end, Float &value)
+{
+	std::basic_istringstream<utf8_t> stream( utf8_string(begin, end) );
+	stream.imbue(std::locale::classic());
+
+	Float result;
+	stream >> result;
+
+	// NOTE: Overflow handling of streams varies, never let out-of-range numbers through as inf
+	if (stream.fail() || !(result - result == 0))
+		return nullptr;
+
+	value = result;
+	return end;
+}
+
+/// Scales the given exact mantissa by the given exactly representable power of ten, in one correctly rounded operation.
+LEAN_INLINE double ScaleExact(uint8 mantissa, int exponent)
+{
+	// NOTE: Signed conversion is faster, mantissa known to fit into 53 bits
+	const double m = static_cast<double>( static_cast<long long>(mantissa) );
+	return (exponent < 0) ? m / ExactPowers10[-exponent] : m * ExactPowers10[exponent];
+}
+
+/// Checks if the given positive value lies exactly halfway between the given nearest float and its other neighbor.
+LEAN_INLINE bool IsFloatMidpoint(double value, float nearest)
+{
+	const double nearestValue = nearest;
+
+	if (nearestValue == value)
+		return false;
+
+	uint4 bits;
+	memcpy(&bits, &nearest, sizeof(bits));
+	bits += (value > nearestValue) ? 1 : -1;
+
+	float neighbor;
+	memcpy(&neighbor, &bits, sizeof(neighbor));
+
+	// NOTE: Exact, adjacent floats differ in one bit beyond single precision
+	return (nearestValue + neighbor) * 0.5 == value;
+}
+
+/// Parses an unsigned integer, nullptr on overflow.
+const utf8_t* ParseUnsigned(const utf8_t *it, const utf8_t *end, unsigned long long &value)
+{
+	const utf8_t *digitsBegin = it;
+	unsigned long long result = 0;
+
+	// NOTE: Leading zeroes count towards the digits that cannot overflow, simply falls back to the checked loop
+	while (end - it >= 8 && (it - digitsBegin) + 8 <= MaxMantissaDigits)
+	{
+		const uint8 chunk = LoadEightChars(it);
+
+		if (!IsEightDigits(chunk))
+			break;
+
+		result = result * 100000000ULL + ParseEightDigits(chunk);
+		it += 8;
+	}
+
+	for (; it < end && IsDigit(*it); ++it)
+	{
+		const uint4 digit = *it - '0';
+
+		if (result > (ULLONG_MAX - digit) / 10)
+			return nullptr;
+
+		result = result * 10 + digit;
+	}
+
+	if (it == digitsBegin)
+		return nullptr;
+
+	value = result;
+	return it;
+}
+
+} // namespace
+
+// Writes the shortest round-trip representation of the given value.
+utf8_t* WriteFloat(utf8_t *begin, float value)
+{
+	return WriteShortest<float, uint4>(begin, value);
+}
+
+// Writes the shortest round-trip representation of the given value.
+utf8_t* WriteDouble(utf8_t *begin, double value)
+{
+	return WriteShortest<double, uint8>(begin, value);
+}
+
+// Writes the given value in decimal form.
+utf8_t* WriteInteger(utf8_t *begin, long long value)
+{
+	if (value < 0)
+	{
+		*begin++ = '-';
+		// NOTE: Negate unsigned to handle minimum value
+		return WriteUnsigned(begin, 0ULL - static_cast<unsigned long long>(value));
+	}
+	else
+		return WriteUnsigned(begin, static_cast<unsigned long long>(value));
+}
+
+// Writes the given value in decimal form.
+utf8_t* WriteUnsigned(utf8_t *begin, unsigned long long value)
+{
+	utf8_t digits[20];
+	utf8_t *digitsBegin = digits + lean::arraylen(digits);
+
+	do
+	{
+		*--digitsBegin = static_cast<utf8_t>('0' + value % 10);
+		value /= 10;
+	}
+	while (value != 0);
+
+	const size_t length = digits + lean::arraylen(digits) - digitsBegin;
+	memcpy(begin, digitsBegin, length);
+
+	return begin + length;
+}
+
+// Reads a value from the given range of characters.
+const utf8_t* ReadFloat(const utf8_t *begin, const utf8_t *end, float &value)
+{
+	DecimalNumber number;
+	const utf8_t *it = ParseDecimal(begin, end, number);
+
+	if (!it)
+		return ParseSpecial(begin, end, value);
+
+	if (!number.bTruncated)
+	{
+		if (number.mantissa == 0)
+		{
+			value = (number.bNegative) ? -0.0f : 0.0f;
+			return it;
+		}
+
+		if (number.mantissa <= (1ULL << 53) && -22 <= number.exponent && number.exponent <= 22)
+		{
+			const double exact = ScaleExact(number.mantissa, number.exponent);
+			const float result = static_cast<float>(exact);
+
+			// NOTE: Rounding twice only goes wrong if the double result hits a midpoint between two floats exactly
+			if (!IsFloatMidpoint(exact, result))
+			{
+				value = (number.bNegative) ? -result : result;
+				return it;
+			}
+		}
+	}
+
+	return ParseFallback(begin, it, value);
+}
+
+// Reads a value from the given range of characters.
+const utf8_t* ReadDouble(const utf8_t *begin, const utf8_t *end, double &value)
+{
+	DecimalNumber number;
+	const utf8_t *it = ParseDecimal(begin, end, number);
+
+	if (!it)
+		return ParseSpecial(begin, end, value);
+
+	if (!number.bTruncated)
+	{
+		if (number.mantissa == 0)
+		{
+			value = (number.bNegative) ? -0.0 : 0.0;
+			return it;
+		}
+
+		// NOTE: Both operands exact, one correctly rounded operation (Clinger's fast path)
+		if (number.mantissa <= (1ULL << 53) && -22 <= number.exponent && number.exponent <= 22)
+		{
+			const double result = ScaleExact(number.mantissa, number.exponent);
+			value = (number.bNegative) ? -result : result;
+			return it;
+		}
+	}
+
+	return ParseFallback(begin, it, value);
+}
+
+// Reads a value from the given range of characters.
+const utf8_t* ReadInteger(const utf8_t *begin, const utf8_t *end, long long &value)
+{
+	bool bNegative = false;
+
+	if (begin < end && (*begin == '-' || *begin == '+'))
+		bNegative = (*begin++ == '-');
+
+	unsigned long long magnitude;
+	begin = ParseUnsigned(begin, end, magnitude);
+
+	if (!begin || magnitude > static_cast<unsigned long long>(LLONG_MAX) + bNegative)
+		return nullptr;
+
+	// NOTE: Negate unsigned to handle minimum value
+	value = static_cast<long long>( (bNegative) ? 0ULL - magnitude : magnitude );
+	return begin;
+}
+
+// Reads a value from the given range of characters.
+const utf8_t* ReadUnsigned(const utf8_t *begin, const utf8_t *end, unsigned long long &value)
+{
+	if (begin < end && *begin == '+')
+		++begin;
+
+	return ParseUnsigned(begin, end, value);
+}
+
+namespace Impl
+{
+
+// Writes the given range of characters to the given stream.
+bool WriteNumericText(std::basic_ostream<utf8_t> &stream, const utf8_t *begin, const utf8_t *end)
+{
+	stream.write(begin, end - begin);
+	return !stream.fail();
+}
+
+// Extracts the next whitespace-separated token from the given stream.
+bool ReadNumericToken(std::basic_istream<utf8_t> &stream, utf8_t *buffer, size_t bufferSize, const utf8_t *&tokenEnd)
+{
+	typedef std::basic_istream<utf8_t>::traits_type traits_type;
+
+	stream >> std::ws;
+
+	size_t length = 0;
+
+	for (;;)
+	{
+		const traits_type::int_type c = stream.peek();
+
+		if (traits_type::eq_int_type(c, traits_type::eof())
+			|| c == ' ' || c == '\t' || c == '\n' || c == '\r')
+			break;
+
+		if (length == bufferSize)
+			return false;
+
+		buffer[length++] = traits_type::to_char_type(stream.get());
+	}
+
+	tokenEnd = buffer + length;
+	return (length != 0);
+}
+
+} // namespace
+
+} // namespace
@@ -0,0 +1,63 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/bePackContentProvider.h"
+#include "beCore/beContentPack.h"
+#include "beCore/beFileContent.h"
+
+#include <lean/io/filesystem.h>
+
+namespace beCore
+{
+
+// Constructor.
+PackContentProvider::PackContentProvider(bool bLooseOverrides, FileRevisionMode::T revisionMode)
+#ifdef BE_CORE_LOOSE_CONTENT_OVERRIDES
+	: m_bLooseOverrides(bLooseOverrides),
+#else
+	// NOTE: Development feature, shipping builds never stat packed files
+	: m_bLooseOverrides(false),
+#endif
+	m_revisionMode(revisionMode)
+{
+}
+
+// Gets the content identified by the given path.
+lean::com_ptr<Content, true> PackContentProvider::GetContent(const utf8_ntri &file)
+{
+	// NOTE: Pack lookup is in-memory, loose files only checked for packed files
+	lean::resource_ptr<ContentPack> pack = FindContentPack(file);
+
+	if (pack && (!m_bLooseOverrides || !lean::file_exists(file)))
+		return pack->GetContent(*pack->Find(file));
+
+	// NOTE: Throws if neither loose nor packed
+	return lean::bind_com( new FileContent(file) );
+}
+
+// Gets a revision number for the content identified by the given path.
+uint8 PackContentProvider::GetRevision(const utf8_ntri &file) const
+{
+	lean::resource_ptr<ContentPack> pack = FindContentPack(file);
+
+	// NOTE: Packed files change with their archive only
+	if (pack && (!m_bLooseOverrides || !lean::file_exists(file)))
+		return pack->GetRevision();
+
+	return GetFileRevision(file, m_revisionMode);
+}
+
+// Constructs and returns a clone of this path resolver.
+PackContentProvider* PackContentProvider::clone() const
+{
+	return new PackContentProvider(*this);
+}
+// Destroys an include manager.
+void PackContentProvider::destroy() const
+{
+	delete this;
+}
+
+} // namespace
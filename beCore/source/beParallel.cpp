@@ -0,0 +1,160 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beParallel.h"
+
+#include "beCore/beTask.h"
+#include "beCore/beThreadPool.h"
+
+#include <lean/concurrent/atomic.h>
+#include <lean/concurrent/event.h>
+
+#include <exception>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Maximum number of chunks a range is split into.
+const uint4 MaxChunkCount = 128;
+/// Number of chunks per thread, allows for some load balancing.
+const uint4 ChunksPerThread = 4;
+
+struct ChunkTask;
+
+/// Shared state of one parallel loop.
+struct ParallelLoop
+{
+	ThreadPool *pPool;
+	ParallelBody *pBody;
+	Range<uint4> range;
+	uint4 chunkCount;
+	TaskPriority::T priority;
+
+	volatile int pendingChunks;
+	lean::event done;
+
+	volatile int failed;
+	std::exception_ptr exception;
+
+	ChunkTask *tasks;
+};
+
+/// Processes a range of chunks, recursively splitting off halves for other threads to steal.
+struct ChunkTask : public Task
+{
+	ParallelLoop *loop;
+	uint4 chunkBegin;
+	uint4 chunkEnd;
+
+	/// Runs the task.
+	void Run()
+	{
+		ParallelLoop &loop = *this->loop;
+
+		try
+		{
+			// Split lazily, idle threads pick up the upper halves
+			// NOTE: Split points are unique, each task slot is only ever used once
+			while (chunkEnd - chunkBegin > 1)
+			{
+				uint4 chunkMid = chunkBegin + (chunkEnd - chunkBegin) / 2;
+
+				ChunkTask &split = loop.tasks[chunkMid];
+				split.loop = &loop;
+				split.chunkBegin = chunkMid;
+				split.chunkEnd = chunkEnd;
+				loop.pPool->AddTask(&split, loop.priority);
+
+				chunkEnd = chunkMid;
+			}
+
+			// Skip remaining chunks once the loop has failed
+			if (!loop.failed)
+				loop.pBody->Run(chunkBegin, GetParallelChunk(loop.range, loop.chunkCount, chunkBegin));
+		}
+		catch (...)
+		{
+			// Keep the first exception, rethrown by the calling thread
+			if (lean::atomic_test_and_set(loop.failed, 0, 1))
+				loop.exception = std::current_exception();
+		}
+
+		// NOTE: Chunks not yet split off when failing are released here as well
+		uint4 chunksDone = chunkEnd - chunkBegin;
+
+		// ORDER: Exception stored BEFORE chunks are released
+		// WARNING: Loop state may be destroyed as soon as the last chunk has been signaled
+		while (chunksDone-- > 0)
+			if (lean::atomic_decrement(loop.pendingChunks) == 0)
+				loop.done.set();
+	}
+};
+
+} // namespace
+
+// Gets the number of chunks the given range will be split into for the given thread pool.
+uint4 GetParallelChunkCount(const ThreadPool *pPool, Range<uint4> range, uint4 grainSize)
+{
+	const uint4 count = Size4(range);
+
+	if (!pPool || pPool->GetThreadCount() == 0 || count <= grainSize || range.End < range.Begin)
+		return 1;
+
+	if (grainSize == 0)
+		grainSize = 1;
+
+	// Calling thread helps out, too
+	uint4 chunkCount = (count + grainSize - 1) / grainSize;
+	uint4 maxChunkCount = min( ChunksPerThread * (static_cast<uint4>(pPool->GetThreadCount()) + 1), MaxChunkCount );
+
+	return min(chunkCount, maxChunkCount);
+}
+
+// Runs the given body on all chunks of the given range, in parallel on the given thread pool.
+void ParallelForChunks(ThreadPool *pPool, Range<uint4> range, uint4 grainSize, ParallelBody &body, TaskPriority::T priority)
+{
+	const uint4 chunkCount = GetParallelChunkCount(pPool, range, grainSize);
+
+	// Small ranges not worth the overhead
+	if (chunkCount <= 1)
+	{
+		if (range.Begin < range.End)
+			body.Run(0, range);
+		return;
+	}
+
+	ChunkTask tasks[MaxChunkCount];
+
+	ParallelLoop loop;
+	loop.pPool = pPool;
+	loop.pBody = &body;
+	loop.range = range;
+	loop.chunkCount = chunkCount;
+	loop.priority = priority;
+	loop.pendingChunks = static_cast<int>(chunkCount);
+	loop.failed = 0;
+	loop.tasks = tasks;
+
+	// Start splitting in the calling thread
+	tasks[0].loop = &loop;
+	tasks[0].chunkBegin = 0;
+	tasks[0].chunkEnd = chunkCount;
+	tasks[0].Run();
+
+	// Help out while chunks are pending, never with tasks less urgent than the loop
+	while (loop.pendingChunks > 0 && pPool->RunPendingTask(priority));
+
+	// Block until the last chunk has been processed
+	// NOTE: Always wait for the signal, queued chunks point to the loop state on this stack
+	loop.done.wait();
+
+	if (loop.failed)
+		std::rethrow_exception(loop.exception);
+}
+
+} // namespace
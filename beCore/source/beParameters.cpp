@@ -6,6 +6,9 @@
 #include "beCore/beParameters.h"
 #include "beCore/beParameterSet.h"
 
+#include <cstring>
+#include <algorithm>
+
 namespace beCore
 {
 
@@ -88,7 +91,8 @@ ParameterLayout::ParameterLayout()
 
 // Constructor.
 ParameterLayout::ParameterLayout(const ParameterLayout &right)
-	: m_parameters( right.m_parameters )
+	: m_parameters( right.m_parameters ),
+	m_slots( right.m_slots )
 {
 }
 
@@ -100,22 +104,94 @@ ParameterLayout::~ParameterLayout()
 // Adds a parameter of the given name, returning its parameter ID.
 uint4 ParameterLayout::Add(const utf8_ntri &name)
 {
-	uint4 parameterID = GetID(name);
+	return Add( InternAtom(name) );
+}
 
-	if (parameterID == InvalidID)
+// Adds a parameter of the given name, returning its parameter ID.
+uint4 ParameterLayout::Add(Atom name)
+{
+	if (name == InvalidAtom)
+		return InvalidID;
+
+	const uint4 hash = GetAtomHash(name);
+	uint4 slotIdx = Probe(name, hash);
+
+	if (slotIdx != InvalidID && m_slots[slotIdx].parameterID != InvalidID)
+		return m_slots[slotIdx].parameterID;
+
+	const uint4 parameterID = static_cast<uint4>( m_parameters.size() );
+	m_parameters.push_back(name);
+
+	// Keep load factor below 1/2
+	if (2 * m_parameters.size() > m_slots.size())
 	{
-		parameterID = static_cast<uint4>( m_parameters.size() );
-		m_parameters.push_back( name.to<utf8_string>() );
+		Slot emptySlot = { 0, InvalidID };
+		m_slots.assign( std::max<size_t>(2 * m_slots.size(), 16), emptySlot );
+
+		for (uint4 i = 0, count = static_cast<uint4>( m_parameters.size() ); i < count; ++i)
+		{
+			const uint4 rehash = GetAtomHash(m_parameters[i]);
+			Slot &slot = m_slots[Probe(m_parameters[i], rehash)];
+			slot.hash = rehash;
+			slot.parameterID = i;
+		}
+	}
+	else
+	{
+		Slot &slot = m_slots[slotIdx];
+		slot.hash = hash;
+		slot.parameterID = parameterID;
 	}
 
 	return parameterID;
 }
 
+// Gets the slot of the given name, first empty slot in its probe sequence if not found.
+uint4 ParameterLayout::Probe(const HashedString &name) const
+{
+	if (m_slots.empty())
+		return InvalidID;
+
+	const uint4 mask = static_cast<uint4>( m_slots.size() ) - 1;
+	uint4 slotIdx = name.Hash & mask;
+
+	for (; m_slots[slotIdx].parameterID != InvalidID; slotIdx = (slotIdx + 1) & mask)
+	{
+		const Slot &slot = m_slots[slotIdx];
+
+		if (slot.hash == name.Hash)
+		{
+			utf8_ntr slotName = GetAtomString(m_parameters[slot.parameterID]);
+
+			if (slotName.size() == name.Length && memcmp(slotName.c_str(), name.String, name.Length) == 0)
+				break;
+		}
+	}
+
+	return slotIdx;
+}
+
+// Gets the slot of the given atom, first empty slot in its probe sequence if not found.
+uint4 ParameterLayout::Probe(Atom name, uint4 hash) const
+{
+	if (m_slots.empty())
+		return InvalidID;
+
+	const uint4 mask = static_cast<uint4>( m_slots.size() ) - 1;
+	uint4 slotIdx = hash & mask;
+
+	for (; m_slots[slotIdx].parameterID != InvalidID; slotIdx = (slotIdx + 1) & mask)
+		if (m_parameters[m_slots[slotIdx].parameterID] == name)
+			break;
+
+	return slotIdx;
+}
+
 // Gets the name of the parameter identified by the given ID.
 utf8_ntr ParameterLayout::GetName(uint4 parameterID) const
 {
 	return (parameterID < m_parameters.size())
-		? utf8_ntr(m_parameters[parameterID])
+		? GetAtomString(m_parameters[parameterID])
 		: utf8_ntr("");
 }
 
@@ -128,31 +204,76 @@ uint4 ParameterLayout::GetCount() const
 // Gets the parameter identified by the given name.
 uint4 ParameterLayout::GetID(const utf8_ntri &name) const
 {
-	for (parameter_vector::const_iterator itParameter = m_parameters.begin();
-		itParameter != m_parameters.end(); ++itParameter)
-		if (*itParameter == name)
-			return static_cast<uint4>( itParameter - m_parameters.begin() );
+	return GetID( HashedString(name) );
+}
 
-	return InvalidID;
+// Gets the parameter identified by the given name.
+uint4 ParameterLayout::GetID(const HashedString &name) const
+{
+	// NOTE: Compares strings of the layout directly, no need to look up (& lock) the global atom table
+	uint4 slotIdx = Probe(name);
+	return (slotIdx != InvalidID) ? m_slots[slotIdx].parameterID : InvalidID;
+}
+
+// Gets the parameter identified by the given name.
+uint4 ParameterLayout::GetID(Atom name) const
+{
+	if (name == InvalidAtom)
+		return InvalidID;
+
+	uint4 slotIdx = Probe(name, GetAtomHash(name));
+	return (slotIdx != InvalidID) ? m_slots[slotIdx].parameterID : InvalidID;
 }
 
 
 // Constructor.
 ParameterSet::ParameterSet(const ParameterLayout *pLayout)
-	: m_pLayout( LEAN_ASSERT_NOT_NULL(pLayout) )
+	: m_pLayout( LEAN_ASSERT_NOT_NULL(pLayout) ),
+	m_inlineCapacity( InlineArenaSize ),
+	m_inlineValues( m_inlineArena )
 {
+	memset(m_inlineArena, 0, sizeof(m_inlineArena));
+	ReserveInline( m_pLayout->GetCount() );
 }
 
 // Constructor.
 ParameterSet::ParameterSet(const ParameterSet &right)
 	: m_pLayout( right.m_pLayout ),
+	m_inlineCapacity( InlineArenaSize ),
+	m_inlineValues( m_inlineArena ),
 	m_parameters( right.m_parameters )
 {
+	memset(m_inlineArena, 0, sizeof(m_inlineArena));
+	ReserveInline( right.m_inlineCapacity );
+	// NOTE: Values stored in place are trivially copyable
+	memcpy(m_inlineValues, right.m_inlineValues, sizeof(InlineValue) * right.m_inlineCapacity);
 }
 
 // Destructor.
 ParameterSet::~ParameterSet()
 {
+	if (m_inlineValues != m_inlineArena)
+		delete[] m_inlineValues;
+}
+
+// Makes room for the given number of values stored in place.
+void ParameterSet::ReserveInline(uint4 count)
+{
+	if (count > m_inlineCapacity)
+	{
+		// Parameter layout may grow further
+		uint4 newCapacity = std::max(count, 2 * m_inlineCapacity);
+		InlineValue *newValues = new InlineValue[newCapacity];
+
+		memcpy(newValues, m_inlineValues, sizeof(InlineValue) * m_inlineCapacity);
+		memset(newValues + m_inlineCapacity, 0, sizeof(InlineValue) * (newCapacity - m_inlineCapacity));
+
+		if (m_inlineValues != m_inlineArena)
+			delete[] m_inlineValues;
+
+		m_inlineValues = newValues;
+		m_inlineCapacity = newCapacity;
+	}
 }
 
 // Assigns the given value to the parameter identified by the given ID.
@@ -168,7 +289,32 @@ void ParameterSet::SetAnyValue(uint4 parameterID, const lean::any *pValue)
 
 		// Clones the given value
 		m_parameters[parameterID] = pValue;
+
+		if (parameterID < m_inlineCapacity)
+			m_inlineValues[parameterID].type = nullptr;
+	}
+}
+
+// Prepares storing a value of the given type in place, returning a pointer to its storage or nullptr if ID invalid.
+void* ParameterSet::SetInlineValue(uint4 parameterID, const std::type_info &type)
+{
+	const uint4 parameterCount = m_pLayout->GetCount();
+
+	if (parameterID < parameterCount)
+	{
+		// Parameter layout may have changed
+		ReserveInline(parameterCount);
+
+		// Drop values previously stored out of place
+		if (parameterID < m_parameters.size())
+			m_parameters[parameterID] = static_cast<const lean::any*>(nullptr);
+
+		InlineValue &inlineValue = m_inlineValues[parameterID];
+		inlineValue.type = &type;
+		return inlineValue.data.bytes;
 	}
+	else
+		return nullptr;
 }
 
 // Gets the value of the parameter identified by the given ID.
@@ -4,7 +4,9 @@
 
 #include "beCoreInternal/stdafx.h"
 #include "beCore/bePersistentIDs.h"
-#include <lean/functional/algorithm.h>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 #include <lean/logging/errors.h>
 
 namespace beCore
@@ -13,27 +15,282 @@ namespace beCore
 namespace
 {
 
-struct ReferenceOrder
+/// Reference slot.
+struct Slot
 {
-	LEAN_INLINE bool operator ()(const PersistentIDs::Reference &left, const PersistentIDs::Reference &right) const
+	void *pointer;
+	const std::type_info *type;	///< Null if unoccupied.
+};
+
+/// Number of IDs per page (log2).
+const uint4 PageBits = 10;
+/// Number of IDs per page.
+const uint4 PageSize = 1U << PageBits;
+/// IDs beyond this limit are stored in the hash index.
+const uint8 DirectIDLimit = 1ULL << 26;
+/// Maximum number of empty pages kept for re-use.
+const size_t MaxFreePages = 8;
+
+/// Page of reference slots.
+struct Page
+{
+	Slot slots[PageSize];
+	uint4 count;			///< Number of occupied slots.
+};
+
+/// Range of free IDs.
+struct IDRange
+{
+	uint8 Begin;
+	uint8 End;
+
+	/// Constructor.
+	IDRange(uint8 begin, uint8 end)
+		: Begin(begin),
+		End(end) { }
+};
+
+/// Orders ranges by end.
+struct RangeEndOrder
+{
+	LEAN_INLINE bool operator ()(const IDRange &left, const IDRange &right) const
+	{
+		return left.End < right.End;
+	}
+	LEAN_INLINE bool operator ()(const IDRange &left, uint8 rightID) const
 	{
-		return left.id < right.id;
+		return left.End < rightID;
 	}
-	LEAN_INLINE bool operator ()(uint8 leftID, const PersistentIDs::Reference &right) const
+};
+
+/// Orders ranges by begin.
+struct RangeBeginOrder
+{
+	LEAN_INLINE bool operator ()(const IDRange &left, const IDRange &right) const
 	{
-		return leftID < right.id;
+		return left.Begin < right.Begin;
 	}
-	LEAN_INLINE bool operator ()(const PersistentIDs::Reference &left, uint8 rightID) const
+	LEAN_INLINE bool operator ()(uint8 leftID, const IDRange &right) const
 	{
-		return left.id < rightID;
+		return leftID < right.Begin;
 	}
 };
 
-}
+typedef std::vector<Page*> page_vector;
+typedef std::unordered_map<uint8, Slot> slot_map;
+typedef std::vector<IDRange> range_vector;
+
+} // namespace
+
+/// Persistent ID internals.
+struct PersistentIDs::M
+{
+	// NOTE: Direct-indexed by ID >> PageBits, nullptr for pages without references
+	page_vector pages;
+	page_vector freePages;
+	slot_map sparseSlots;
+
+	// NOTE: Sorted & disjoint, adjacent ranges are merged
+	range_vector freeRanges;
+
+	/// Destructor.
+	~M()
+	{
+		for (page_vector::const_iterator it = pages.begin(); it != pages.end(); ++it)
+			delete *it;
+		for (page_vector::const_iterator it = freePages.begin(); it != freePages.end(); ++it)
+			delete *it;
+	}
+
+	/// Gets the page of the given ID, allocating it if missing.
+	Page& AcquirePage(size_t pageIdx)
+	{
+		if (pageIdx >= pages.size())
+			pages.resize(pageIdx + 1, nullptr);
+
+		Page *&page = pages[pageIdx];
+
+		if (!page)
+		{
+			if (!freePages.empty())
+			{
+				page = freePages.back();
+				freePages.pop_back();
+			}
+			else
+				page = new Page();
+		}
+
+		return *page;
+	}
+
+	/// Releases the given empty page.
+	void ReleasePage(size_t pageIdx)
+	{
+		Page *page = pages[pageIdx];
+		pages[pageIdx] = nullptr;
+
+		if (freePages.size() < MaxFreePages)
+			freePages.push_back(page);
+		else
+			delete page;
+	}
+
+	/// Gets the slot of the given ID, nullptr if unoccupied.
+	const Slot* Find(uint8 id) const
+	{
+		if (id < DirectIDLimit)
+		{
+			size_t pageIdx = static_cast<size_t>(id >> PageBits);
+			Page *page = (pageIdx < pages.size()) ? pages[pageIdx] : nullptr;
+			Slot *slot = (page) ? &page->slots[id & (PageSize - 1)] : nullptr;
+			return (slot && slot->type) ? slot : nullptr;
+		}
+		else
+		{
+			slot_map::const_iterator itSlot = sparseSlots.find(id);
+			return (itSlot != sparseSlots.end()) ? &itSlot->second : nullptr;
+		}
+	}
+	/// Gets the slot of the given ID, nullptr if unoccupied.
+	LEAN_INLINE Slot* Find(uint8 id)
+	{
+		return const_cast<Slot*>( static_cast<const M&>(*this).Find(id) );
+	}
+
+	/// Gets the slot of the given ID, occupying it with an empty reference if unoccupied.
+	Slot& Acquire(uint8 id)
+	{
+		Slot *slot;
+
+		if (id < DirectIDLimit)
+		{
+			Page &page = AcquirePage(static_cast<size_t>(id >> PageBits));
+			slot = &page.slots[id & (PageSize - 1)];
+
+			if (!slot->type)
+				++page.count;
+		}
+		else
+			slot = &sparseSlots[id];
+
+		if (!slot->type)
+		{
+			slot->pointer = nullptr;
+			slot->type = &typeid(void);
+		}
+
+		return *slot;
+	}
+
+	/// Frees the slot of the given ID.
+	void Erase(uint8 id)
+	{
+		if (id < DirectIDLimit)
+		{
+			size_t pageIdx = static_cast<size_t>(id >> PageBits);
+			Page *page = (pageIdx < pages.size()) ? pages[pageIdx] : nullptr;
+			Slot *slot = (page) ? &page->slots[id & (PageSize - 1)] : nullptr;
+
+			if (slot && slot->type)
+			{
+				slot->pointer = nullptr;
+				slot->type = nullptr;
+
+				if (--page->count == 0)
+					ReleasePage(pageIdx);
+			}
+		}
+		else
+			sparseSlots.erase(id);
+	}
+
+	/// Frees the slots of all IDs in the given range.
+	void EraseRange(uint8 beginID, uint8 endID)
+	{
+		uint8 directEndID = std::min(endID, DirectIDLimit);
+
+		for (uint8 id = beginID; id < directEndID; )
+		{
+			size_t pageIdx = static_cast<size_t>(id >> PageBits);
+			uint8 pageEndID = std::min( static_cast<uint8>(pageIdx + 1) << PageBits, directEndID );
+
+			// Skip missing pages
+			if (pageIdx < pages.size() && pages[pageIdx])
+				for (; id < pageEndID && pages[pageIdx]; ++id)
+					Erase(id);
+
+			id = pageEndID;
+		}
+
+		if (endID > DirectIDLimit && !sparseSlots.empty())
+		{
+			for (slot_map::iterator it = sparseSlots.begin(); it != sparseSlots.end(); )
+				if (beginID <= it->first && it->first < endID)
+					it = sparseSlots.erase(it);
+				else
+					++it;
+		}
+	}
+
+	/// Adds the given range of IDs to the free list.
+	void AddFreeRange(uint8 beginID, uint8 endID)
+	{
+		// Merge with all overlapping & adjacent ranges
+		range_vector::iterator itFirst = std::lower_bound(freeRanges.begin(), freeRanges.end(), beginID, RangeEndOrder());
+		range_vector::iterator itLast = itFirst;
+
+		for (; itLast != freeRanges.end() && itLast->Begin <= endID; ++itLast)
+		{
+			beginID = std::min(beginID, itLast->Begin);
+			endID = std::max(endID, itLast->End);
+		}
+
+		if (itFirst != itLast)
+		{
+			itFirst->Begin = beginID;
+			itFirst->End = endID;
+			freeRanges.erase(itFirst + 1, itLast);
+		}
+		else
+			freeRanges.insert(itFirst, IDRange(beginID, endID));
+	}
+
+	/// Removes the given ID from the free list.
+	void TakeFreeID(uint8 id)
+	{
+		range_vector::iterator itRange = std::upper_bound(freeRanges.begin(), freeRanges.end(), id, RangeBeginOrder());
+
+		if (itRange == freeRanges.begin())
+			return;
+
+		--itRange;
+
+		if (id >= itRange->End)
+			return;
+
+		if (id == itRange->Begin)
+			++itRange->Begin;
+		else if (id + 1 == itRange->End)
+			--itRange->End;
+		else
+		{
+			// Split
+			uint8 endID = itRange->End;
+			itRange->End = id;
+			freeRanges.insert(itRange + 1, IDRange(id + 1, endID));
+			return;
+		}
+
+		if (itRange->Begin == itRange->End)
+			freeRanges.erase(itRange);
+	}
+};
 
 // Constructor.
 PersistentIDs::PersistentIDs(uint8 startID)
-	: m_nextID(startID)
+	: m( new M() ),
+	m_nextID(startID)
 {
 }
 
@@ -45,6 +302,18 @@ PersistentIDs::~PersistentIDs()
 // Reserves an ID.
 uint8 PersistentIDs::ReserveID()
 {
+	// Re-use released IDs first
+	if (!m->freeRanges.empty())
+	{
+		IDRange &range = m->freeRanges.front();
+		uint8 id = range.Begin++;
+
+		if (range.Begin == range.End)
+			m->freeRanges.erase(m->freeRanges.begin());
+
+		return id;
+	}
+
 	return m_nextID++;
 }
 
@@ -61,89 +330,136 @@ void PersistentIDs::SkipIDs(uint8 nextID)
 		m_nextID = nextID;
 }
 
+// Reserves the given number of consecutive IDs, returning the first one.
+uint8 PersistentIDs::ReserveIDs(uint8 count)
+{
+	// NOTE: First ID of an empty range might be handed out again by ReserveID()
+	if (count == 0)
+		LEAN_THROW_ERROR_MSG("Cannot reserve 0 persistent IDs");
+
+	// Re-use the first released range that is large enough
+	for (range_vector::iterator it = m->freeRanges.begin(); it != m->freeRanges.end(); ++it)
+		if (it->End - it->Begin >= count)
+		{
+			uint8 firstID = it->Begin;
+			it->Begin += count;
+
+			if (it->Begin == it->End)
+				m->freeRanges.erase(it);
+
+			return firstID;
+		}
+
+	if (count >= InvalidID - m_nextID)
+		LEAN_THROW_ERROR_MSG("Persistent IDs exhausted");
+
+	uint8 firstID = m_nextID;
+	m_nextID += count;
+	ReserveStorage(firstID, m_nextID);
+	return firstID;
+}
+
+// Allocates storage for references to all IDs in the given range up front.
+void PersistentIDs::ReserveStorage(uint8 beginID, uint8 endID)
+{
+	// NOTE: Sparse IDs are hashed individually, nothing to allocate
+	endID = std::min(endID, DirectIDLimit);
+
+	if (beginID < endID)
+	{
+		size_t beginPageIdx = static_cast<size_t>(beginID >> PageBits);
+		size_t endPageIdx = static_cast<size_t>((endID - 1) >> PageBits) + 1;
+
+		if (endPageIdx > m->pages.size())
+			m->pages.resize(endPageIdx, nullptr);
+
+		for (size_t pageIdx = beginPageIdx; pageIdx < endPageIdx; ++pageIdx)
+			m->AcquirePage(pageIdx);
+	}
+}
+
+// Unsets all references in the given range & returns the IDs for re-use.
+void PersistentIDs::ReleaseIDs(uint8 beginID, uint8 endID)
+{
+	// NOTE: IDs never handed out cannot be released
+	endID = std::min(endID, m_nextID);
+
+	if (beginID < endID)
+	{
+		m->EraseRange(beginID, endID);
+		m->AddFreeRange(beginID, endID);
+	}
+}
+
 // Adds a new reference.
 uint8 PersistentIDs::AddReference(void *ptr, const std::type_info &type)
 {
-	m_references.push_back( Reference(m_nextID, ptr, type) );
-	return m_nextID++;
+	uint8 id = ReserveID();
+
+	Slot &slot = m->Acquire(id);
+	slot.pointer = ptr;
+	slot.type = &type;
+
+	return id;
 }
 
 // Updates a reference.
 bool PersistentIDs::SetReference(uint8 id, void *ptr, const std::type_info &type, bool bNoOverwrite)
 {
-	if (id >= m_nextID)
+	if (id == InvalidID)
 	{
-		if (id != InvalidID)
-		{
-			// Jump ahead
-			m_nextID = id;
-
-			// Append
-			lean::check( AddReference(ptr, type) == id );
-			return true;
-		}
-		else
-		{
-			LEAN_LOG_ERROR_MSG("Cannot set reference for InvalidID");
-			LEAN_ASSERT_DEBUG( id != InvalidID );
-			return false;
-		}
+		LEAN_LOG_ERROR_MSG("Cannot set reference for InvalidID");
+		LEAN_ASSERT_DEBUG( id != InvalidID );
+		return false;
 	}
-	else
-	{
-		ref_vector::iterator itReference = lean::find_sorted(
-				m_references.begin(), m_references.end(),
-				id, ReferenceOrder()
-			);
 
-		// Update
-		if (itReference != m_references.end())
-		{
-			if (!bNoOverwrite || !itReference->pointer)
-			{
-				itReference->pointer = ptr;
-				itReference->type = &type;
-			}
-			else
-				return (itReference->pointer == ptr);
-		}
-		// Insert
-		else
-			lean::push_sorted( m_references, Reference(id, ptr, type), ReferenceOrder() );
+	// Jump ahead
+	if (id >= m_nextID)
+		m_nextID = id + 1;
+	// ID no longer free
+	else if (!m->freeRanges.empty())
+		m->TakeFreeID(id);
 
-		return true;
-	}
+	Slot &slot = m->Acquire(id);
+
+	if (bNoOverwrite && slot.pointer)
+		return (slot.pointer == ptr);
+
+	slot.pointer = ptr;
+	slot.type = &type;
+	return true;
 }
 
 // Gets a reference.
 void* PersistentIDs::GetReference(uint8 id, const std::type_info &type) const
 {
-	ref_vector::const_iterator itReference = lean::find_sorted(
-			m_references.begin(), m_references.end(),
-			id, ReferenceOrder()
-		);
+	const Slot *slot = m->Find(id);
 
-	return (itReference != m_references.end() && *itReference->type == type)
-		? itReference->pointer
+	return (slot && *slot->type == type)
+		? slot->pointer
 		: nullptr;
 }
 
+// Checks if the given ID is referenced.
+bool PersistentIDs::IsReferenced(uint8 id) const
+{
+	const Slot *slot = m->Find(id);
+	return slot && slot->pointer != nullptr;
+}
+
 // Unsets a reference.
 void PersistentIDs::UnsetReference(uint8 id, const void *ptr, bool bErase)
 {
-	ref_vector::iterator itReference = lean::find_sorted(
-			m_references.begin(), m_references.end(),
-			id, ReferenceOrder()
-		);
+	Slot *slot = m->Find(id);
 
-	if (itReference != m_references.end() && (!ptr || itReference->pointer == ptr))
+	if (slot && (!ptr || slot->pointer == ptr))
 	{
 		if (bErase)
-			m_references.erase(itReference);
+			m->Erase(id);
 		else
 		{
-			itReference->pointer = nullptr;
-			itReference->type = &typeid(void);
+			slot->pointer = nullptr;
+			slot->type = &typeid(void);
 		}
 	}
 }
@@ -5,31 +5,45 @@
 #include "beCoreInternal/stdafx.h"
 #include "beCore/bePropertySerialization.h"
 #include "beCore/beTextSerializer.h"
+#include "beCore/beValueTypes.h"
 
 #include <lean/functional/predicates.h>
 #include <lean/xml/utility.h>
 #include <lean/xml/numeric.h>
 #include <sstream>
+#include <vector>
 
 #include <lean/logging/log.h>
 
 namespace beCore
 {
 
-// Visits the given values.
-void PropertySerializer::Visit(const PropertyProvider &provider, uint4 propertyID, const PropertyDesc &desc, const void *values)
+namespace
+{
+
+/// Document attribute enabling typed binary property values. Attributes of the document node are never printed.
+const utf8_t BinaryValuesAttributeName[] = "binaryPropertyValues";
+/// Name of property nodes storing typed binary values.
+const utf8_t BinaryPropertyNodeName[] = "b";
+
+/// Checks if the given property node stores typed binary values.
+LEAN_INLINE bool IsBinaryProperty(const rapidxml::xml_node<lean::utf8_t> &node)
+{
+	return node.name_size() == 1 && node.name()[0] == BinaryPropertyNodeName[0];
+}
+
+/// Formats the given values as text allocated in the given document.
+const utf8_t* FormatValues(rapidxml::xml_document<utf8_t> &document, const ValueTypeDesc &typeDesc, const void *values, uint4 count)
 {
-	rapidxml::xml_document<> &document = *LEAN_ASSERT_NOT_NULL(Parent->document());
-	
 	const utf8_t *value = nullptr;
 
-	const TextSerializer *pSerializer = desc.TypeDesc->Text;
+	const TextSerializer *pSerializer = typeDesc.Text;
 
 	if (pSerializer)
 	{
 		static const size_t StackBufferSize = 2048;
 
-		size_t maxLength = pSerializer->GetMaxLength(desc.Count);
+		size_t maxLength = pSerializer->GetMaxLength(count);
 
 		// Use stack to speed up small allocations
 		// NOTE: 0 means unpredictable
@@ -39,7 +53,7 @@ void PropertySerializer::Visit(const PropertyProvider &provider, uint4 propertyI
 			
 			// Serialize
 			// NOTE: Required to be null-terminated -> xml
-			utf8_t *bufferEnd = pSerializer->Write(buffer, desc.TypeDesc->Info.type, values, desc.Count);
+			utf8_t *bufferEnd = pSerializer->Write(buffer, typeDesc.Info.type, values, count);
 			*bufferEnd++ = 0;
 
 			size_t length = bufferEnd - buffer;
@@ -47,6 +61,19 @@ void PropertySerializer::Visit(const PropertyProvider &provider, uint4 propertyI
 			
 			value = document.allocate_string(buffer, length);
 		}
+		// Serialize large predictable values straight into the document
+		else if (maxLength != 0)
+		{
+			utf8_t *buffer = document.allocate_string(nullptr, maxLength + 1);
+
+			// NOTE: Required to be null-terminated -> xml
+			utf8_t *bufferEnd = pSerializer->Write(buffer, typeDesc.Info.type, values, count);
+			*bufferEnd++ = 0;
+
+			LEAN_ASSERT(static_cast<size_t>(bufferEnd - buffer) <= maxLength + 1);
+
+			value = buffer;
+		}
 		// Take generic route, otherwise
 		else
 		{
@@ -54,22 +81,136 @@ void PropertySerializer::Visit(const PropertyProvider &provider, uint4 propertyI
 			stream.imbue(std::locale::classic());
 
 			// Serialize
-			pSerializer->Write(stream, desc.TypeDesc->Info.type, values, desc.Count);
+			pSerializer->Write(stream, typeDesc.Info.type, values, count);
 
 			value = document.allocate_string( stream.str().c_str() );
 		}
 	}
 	else
-		LEAN_LOG_ERROR("No serializer available for type \"" << desc.TypeDesc->Name.c_str());
+		LEAN_LOG_ERROR("No serializer available for type \"" << typeDesc.Name.c_str());
+
+	return value;
+}
+
+} // namespace
+
+// Visits the given values.
+void PropertySerializer::Visit(const PropertyProvider &provider, uint4 propertyID, const PropertyDesc &desc, const void *values)
+{
+	AppendProperty(*Parent, Properties->GetPropertyName(propertyID), desc, values, IncludeType);
+}
+
+// Stores property values appended to the given document as typed binary values instead of text from now on, where possible.
+void SetBinaryPropertyValues(rapidxml::xml_document<lean::utf8_t> &document)
+{
+	if (!HasBinaryPropertyValues(document))
+		lean::append_attribute<utf8_t>(document, document, BinaryValuesAttributeName, "1");
+}
+
+// Checks if property values appended to the given document are stored as typed binary values.
+bool HasBinaryPropertyValues(const rapidxml::xml_document<lean::utf8_t> &document)
+{
+	return document.first_attribute(BinaryValuesAttributeName) != nullptr;
+}
+
+// Converts all typed binary property values stored in the given XML node & its children to text.
+void ConvertPropertyValuesToText(rapidxml::xml_node<lean::utf8_t> &node)
+{
+	std::vector<uint8> values;
+
+	for (rapidxml::xml_node<lean::utf8_t> *child = node.first_node(); child; child = child->next_sibling())
+	{
+		if (IsBinaryProperty(*child))
+		{
+			const ValueTypeDesc *pTypeDesc = GetValueTypes().GetDesc( lean::get_attribute(*child, "t") );
+			uint4 count = lean::get_int_attribute(*child, "c", 0);
+
+			// NOTE: Check size first, never allocate for corrupted counts
+			if (pTypeDesc && pTypeDesc->Plain && count > 0 && child->value_size() == pTypeDesc->Info.property_type->size(count))
+			{
+				const lean::property_type &propertyType = *pTypeDesc->Info.property_type;
+
+				// NOTE: Binary values may be unaligned, copy before formatting
+				values.resize( (propertyType.size(count) + sizeof(uint8) - 1) / sizeof(uint8) );
+				propertyType.construct(&values[0], count);
+
+				if (ReadPropertyValues(*child, *pTypeDesc, &values[0], count))
+				{
+					child->value( FormatValues(*LEAN_ASSERT_NOT_NULL(child->document()), *pTypeDesc, &values[0], count) );
+					child->name("p");
+				}
+
+				propertyType.destruct(&values[0], count);
+			}
+			else
+				LEAN_LOG_ERROR_XCTX("Invalid binary property value", lean::get_attribute(*child, "t").c_str(), lean::get_attribute(*child, "n").c_str());
+		}
+		else
+			ConvertPropertyValuesToText(*child);
+	}
+}
+
+// Reads the given number of values of the given type from the given property node.
+bool ReadPropertyValues(const rapidxml::xml_node<lean::utf8_t> &node, const ValueTypeDesc &typeDesc, void *values, uint4 count)
+{
+	if (IsBinaryProperty(node))
+	{
+		// NOTE: Binary values only valid for the exact type & count they were stored with
+		if (typeDesc.Plain && lean::get_attribute(node, "t") == typeDesc.Name
+			&& static_cast<uint4>(lean::get_int_attribute(node, "c", 0)) == count
+			&& node.value_size() == typeDesc.Info.property_type->size(count))
+		{
+			memcpy(values, node.value(), node.value_size());
+			return true;
+		}
+		else
+			LEAN_LOG_ERROR_XCTX("Binary property value type mismatch", typeDesc.Name.c_str(), lean::get_attribute(node, "n").c_str());
+	}
+	else if (const TextSerializer *pSerializer = typeDesc.Text)
+	{
+		if (pSerializer->Read(node.value(), node.value() + node.value_size(), typeDesc.Info.type, values, count))
+			return true;
+		// TODO: error logging?
+	}
+	else
+		LEAN_LOG_ERROR("No serializer available for type \"" << typeDesc.Name.c_str());
+
+	return false;
+}
+
+// Appends a property node of the given name & values to the given XML node.
+void AppendProperty(rapidxml::xml_node<lean::utf8_t> &parent, const utf8_ntri &name, const PropertyDesc &desc, const void *values, bool bWithType)
+{
+	rapidxml::xml_document<> &document = *LEAN_ASSERT_NOT_NULL(parent.document());
+
+	// Store plain values bytewise, if requested
+	if (desc.TypeDesc->Plain && desc.Count > 0 && HasBinaryPropertyValues(document))
+	{
+		size_t size = desc.TypeDesc->Info.property_type->size(desc.Count);
+		utf8_t *data = document.allocate_string(nullptr, size);
+		memcpy(data, values, size);
+
+		rapidxml::xml_node<utf8_t> &Node = *lean::allocate_node<utf8_t>(document, BinaryPropertyNodeName);
+		Node.value(data, size);
+		// ORDER: Name first, properties matched by first attribute
+		lean::append_attribute(document, Node, "n", name);
+		// NOTE: Type & count always required to validate binary values
+		lean::append_attribute(document, Node, "t", desc.TypeDesc->Name);
+		lean::append_int_attribute(document, Node, "c", desc.Count);
+		parent.append_node(&Node);
+		return;
+	}
+
+	const utf8_t *value = FormatValues(document, *desc.TypeDesc, values, desc.Count);
 
 	rapidxml::xml_node<utf8_t> &Node = *lean::allocate_node(document, "p", value);
-	lean::append_attribute(document, Node, "n", Properties->GetPropertyName(propertyID));
-	if (IncludeType)
+	lean::append_attribute(document, Node, "n", name);
+	if (bWithType)
 	{
 		lean::append_attribute(document, Node, "t", desc.TypeDesc->Name);
 		lean::append_int_attribute(document, Node, "c", desc.Count);
 	}
-	Parent->append_node(&Node);
+	parent.append_node(&Node);
 }
 
 // Gets the property name.
@@ -107,18 +248,7 @@ uint4 PropertyDeserializer::ValueCount() const
 // Visits the given values.
 bool PropertyDeserializer::Visit(const PropertyProvider &provider, uint4 propertyID, const PropertyDesc &desc, void *values)
 {
-	const TextSerializer *pSerializer = desc.TypeDesc->Text;
-
-	if (pSerializer)
-	{
-		if (pSerializer->Read(Node->value(), Node->value() + Node->value_size(), desc.TypeDesc->Info.type, values, desc.Count))
-			return true;
-		// TODO: error logging?
-	}
-	else
-		LEAN_LOG_ERROR("No serializer available for type \"" << desc.TypeDesc->Name.c_str());
-
-	return false;
+	return ReadPropertyValues(*Node, *desc.TypeDesc, values, desc.Count);
 }
 
 // Saves the given property provider to the given XML node.
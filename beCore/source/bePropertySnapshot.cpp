@@ -0,0 +1,237 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/bePropertySnapshot.h"
+#include "beCore/bePropertySerialization.h"
+#include "beCore/bePropertyVisitor.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <lean/xml/utility.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Node captured properties are written to.
+struct CapturedNode
+{
+	rapidxml::xml_node<utf8_t> *Parent;		///< Node to insert the properties node into.
+	rapidxml::xml_node<utf8_t> *Previous;	///< Last child of the parent node when captured, nullptr if none.
+	rapidxml::xml_node<utf8_t> *Properties;	///< Properties node, nullptr until written.
+};
+
+/// Captured property value.
+struct CapturedValue
+{
+	uint4 Node;							///< Index of the captured node to append the value to.
+	const utf8_t *Name;					///< Null-terminated property name.
+	PropertyDesc Desc;					///< Property type.
+	void *Values;						///< Constructed property values.
+};
+
+typedef std::vector<CapturedNode> captured_node_vector;
+typedef std::vector<CapturedValue> captured_value_vector;
+typedef std::vector<char*> block_vector;
+
+/// Size of one block of captured data.
+const size_t BlockSize = 64 * 1024;
+/// Alignment of captured values.
+const size_t ValueAlignment = 16;
+
+} // namespace
+
+/// Property snapshot internals.
+struct PropertySnapshot::M
+{
+	captured_node_vector nodes;
+	captured_value_vector values;
+	uint4 writtenNodeCount;
+	uint4 writtenCount;
+
+	// NOTE: Values never move once constructed, blocks are never reallocated
+	block_vector blocks;
+	char *blockPos;
+	size_t blockFree;
+	size_t dataSize;
+
+	/// Constructor.
+	M()
+		: writtenNodeCount(0),
+		writtenCount(0),
+		blockPos(nullptr),
+		blockFree(0),
+		dataSize(0) { }
+	/// Destructor.
+	~M()
+	{
+		Clear();
+	}
+
+	/// Allocates the given number of bytes.
+	void* Allocate(size_t size)
+	{
+		size = (size + ValueAlignment - 1) & ~(ValueAlignment - 1);
+
+		if (size > blockFree)
+		{
+			size_t blockSize = std::max(size, BlockSize);
+			blocks.reserve(blocks.size() + 1);
+			char *block = new char[blockSize + ValueAlignment];
+			blocks.push_back(block);
+
+			blockPos = reinterpret_cast<char*>( (reinterpret_cast<size_t>(block) + ValueAlignment - 1) & ~(ValueAlignment - 1) );
+			blockFree = blockSize;
+		}
+
+		void *data = blockPos;
+		blockPos += size;
+		blockFree -= size;
+		dataSize += size;
+		return data;
+	}
+
+	/// Destructs all values & frees all blocks.
+	void Clear()
+	{
+		for (captured_value_vector::const_iterator it = values.begin(); it != values.end(); ++it)
+			it->Desc.TypeDesc->Info.property_type->destruct(it->Values, it->Desc.Count);
+		values.clear();
+		writtenCount = 0;
+		nodes.clear();
+		writtenNodeCount = 0;
+
+		for (block_vector::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+			delete[] *it;
+		blocks.clear();
+		blockPos = nullptr;
+		blockFree = 0;
+		dataSize = 0;
+	}
+};
+
+namespace
+{
+
+/// Copies property values.
+struct PropertyCapturer : public PropertyVisitor
+{
+	PropertySnapshot::M *m;
+	uint4 Node;
+
+	/// Constructor.
+	PropertyCapturer(PropertySnapshot::M &m, uint4 nodeIdx)
+		: m(&m),
+		Node(nodeIdx) { }
+
+	/// Visits the given values.
+	void Visit(const PropertyProvider &provider, uint4 propertyID, const PropertyDesc &desc, const void *values) LEAN_OVERRIDE
+	{
+		const lean::property_type &propertyType = *desc.TypeDesc->Info.property_type;
+
+		utf8_ntr name = provider.GetPropertyName(propertyID);
+		utf8_t *nameCopy = static_cast<utf8_t*>( m->Allocate(name.size() + 1) );
+		memcpy(nameCopy, name.c_str(), name.size());
+		nameCopy[name.size()] = 0;
+
+		CapturedValue value = { Node, nameCopy, desc, m->Allocate(propertyType.size(desc.Count)) };
+		propertyType.construct(value.Values, desc.Count);
+		// ORDER: Keep track of constructed values right away, destructed on clear
+		m->values.push_back(value);
+
+		// NOTE: Visited values are raw temporaries, take a typed copy
+		if (!provider.GetProperty(propertyID, desc.TypeDesc->Info.type, value.Values, desc.Count))
+		{
+			propertyType.destruct(value.Values, desc.Count);
+			m->values.pop_back();
+		}
+	}
+};
+
+} // namespace
+
+// Constructor.
+PropertySnapshot::PropertySnapshot()
+	: m( new M() )
+{
+}
+
+// Destructor.
+PropertySnapshot::~PropertySnapshot()
+{
+}
+
+// Captures all persistent properties of the given provider.
+void PropertySnapshot::CaptureProperties(const PropertyProvider &properties, rapidxml::xml_node<utf8_t> &node)
+{
+	const uint4 propertyCount = properties.GetPropertyCount();
+
+	if (propertyCount > 0)
+	{
+		// NOTE: Properties node only created when written, remember where it goes
+		CapturedNode capturedNode = { &node, node.last_node(), nullptr };
+		m->nodes.push_back(capturedNode);
+
+		PropertyCapturer capturer(*m, static_cast<uint4>(m->nodes.size() - 1));
+
+		for (uint4 i = 0; i < propertyCount; ++i)
+			properties.ReadProperty(i, capturer, PropertyVisitFlags::PersistentOnly);
+	}
+}
+
+// Writes all values captured since the last call to the XML nodes they were captured for.
+void PropertySnapshot::WriteProperties()
+{
+	const uint4 nodeCount = static_cast<uint4>(m->nodes.size());
+
+	for (uint4 i = m->writtenNodeCount; i < nodeCount; ++i)
+	{
+		CapturedNode &capturedNode = m->nodes[i];
+		rapidxml::xml_node<utf8_t> &parent = *capturedNode.Parent;
+
+		capturedNode.Properties = lean::allocate_node<utf8_t>(*parent.document(), "properties");
+		// ORDER: Insert right behind the children present when captured, exactly where SaveProperties() would have appended
+		parent.insert_node(
+				(capturedNode.Previous) ? capturedNode.Previous->next_sibling() : parent.first_node(),
+				capturedNode.Properties
+			);
+	}
+
+	m->writtenNodeCount = nodeCount;
+
+	const uint4 valueCount = static_cast<uint4>(m->values.size());
+
+	for (uint4 i = m->writtenCount; i < valueCount; ++i)
+	{
+		const CapturedValue &value = m->values[i];
+		AppendProperty(*m->nodes[value.Node].Properties, utf8_ntr(value.Name), value.Desc, value.Values);
+	}
+
+	m->writtenCount = valueCount;
+}
+
+// Releases all captured values.
+void PropertySnapshot::Clear()
+{
+	m->Clear();
+}
+
+// Gets the number of values captured.
+uint4 PropertySnapshot::GetValueCount() const
+{
+	return static_cast<uint4>(m->values.size());
+}
+
+// Gets the number of bytes of value data captured.
+size_t PropertySnapshot::GetDataSize() const
+{
+	return m->dataSize;
+}
+
+} // namespace
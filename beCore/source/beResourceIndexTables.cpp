@@ -0,0 +1,439 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beResourceIndexTables.h"
+#include "beCore/beContentHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Minimum number of hash table slots.
+const uint4 MinTableCapacity = 16;
+
+/// Hashes the given pointer.
+LEAN_INLINE uint4 HashPointer(const void *ptr)
+{
+	uint8 hash = static_cast<uint8>( reinterpret_cast<uintptr_t>(ptr) ) * 0x9E3779B97F4A7C15ULL;
+	return static_cast<uint4>(hash >> 32);
+}
+
+/// Hashes the given string.
+LEAN_INLINE uint8 HashString(const utf8_ntri &string)
+{
+	return HashContent(string.c_str(), string.size());
+}
+
+/// Checks if the given strings are equal.
+LEAN_INLINE bool StringsEqual(const utf8_string &left, const utf8_ntri &right)
+{
+	return left.size() == right.size() && memcmp(left.c_str(), right.c_str(), right.size()) == 0;
+}
+
+/// Compares the given string to the given string.
+LEAN_INLINE int CompareStrings(const utf8_string &left, const utf8_ntri &right)
+{
+	return left.compare(0, utf8_string::npos, right.c_str(), right.size());
+}
+
+/// Checks if the table needs to grow to take one more element.
+LEAN_INLINE bool NeedsToGrow(uint4 count, size_t capacity)
+{
+	// NOTE: Keep load factor below 1/2, probe sequences stay short
+	return 2 * (static_cast<size_t>(count) + 1) > capacity;
+}
+
+/// Checks if an element at the given slot may be moved to the given empty slot without breaking its probe sequence.
+LEAN_INLINE bool MayShiftBack(uint4 emptySlot, uint4 slot, uint4 homeSlot)
+{
+	return (emptySlot <= slot)
+		? (homeSlot <= emptySlot || homeSlot > slot)
+		: (homeSlot <= emptySlot && homeSlot > slot);
+}
+
+/// Orders strings by value.
+struct StringOrder
+{
+	typedef std::pair<const utf8_string*, uint4> value_type;
+
+	LEAN_INLINE bool operator ()(const value_type &left, const value_type &right) const
+	{
+		return *left.first < *right.first;
+	}
+};
+
+} // namespace
+
+// Constructor.
+ResourcePointerTable::ResourcePointerTable()
+	: m_count(0),
+	m_nullValue(InvalidIndex)
+{
+}
+
+// Destructor.
+ResourcePointerTable::~ResourcePointerTable()
+{
+}
+
+// Gets the slot of the given key, first empty slot in its probe sequence if not found.
+uint4 ResourcePointerTable::Probe(const void *key) const
+{
+	const uint4 mask = static_cast<uint4>(m_slots.size()) - 1;
+	uint4 slotIdx = HashPointer(key) & mask;
+
+	while (m_slots[slotIdx].key && m_slots[slotIdx].key != key)
+		slotIdx = (slotIdx + 1) & mask;
+
+	return slotIdx;
+}
+
+// Grows the hash table to the given capacity.
+void ResourcePointerTable::Rehash(uint4 capacity)
+{
+	Slot emptySlot = { nullptr, InvalidIndex };
+	slot_vector slots(capacity, emptySlot);
+
+	slots.swap(m_slots);
+
+	for (slot_vector::const_iterator it = slots.begin(); it != slots.end(); ++it)
+		if (it->key)
+			m_slots[Probe(it->key)] = *it;
+}
+
+// Gets the index mapped to the given pointer, InvalidIndex if none.
+uint4 ResourcePointerTable::Find(const void *key) const
+{
+	if (!key)
+		return m_nullValue;
+	
+	if (m_slots.empty())
+		return InvalidIndex;
+
+	const Slot &slot = m_slots[Probe(key)];
+	return (slot.key) ? slot.value : InvalidIndex;
+}
+
+// Maps the given pointer to the given index, if not mapped yet. Returns the index the pointer is now mapped to.
+uint4 ResourcePointerTable::Insert(const void *key, uint4 value)
+{
+	if (!key)
+	{
+		if (m_nullValue == InvalidIndex)
+			m_nullValue = value;
+		return m_nullValue;
+	}
+
+	if (NeedsToGrow(m_count, m_slots.size()))
+		Rehash( max(static_cast<uint4>(2 * m_slots.size()), MinTableCapacity) );
+
+	Slot &slot = m_slots[Probe(key)];
+
+	if (!slot.key)
+	{
+		slot.key = key;
+		slot.value = value;
+		++m_count;
+	}
+
+	return slot.value;
+}
+
+// Removes the given pointer.
+void ResourcePointerTable::Erase(const void *key)
+{
+	if (!key)
+	{
+		m_nullValue = InvalidIndex;
+		return;
+	}
+
+	if (m_slots.empty())
+		return;
+
+	const uint4 mask = static_cast<uint4>(m_slots.size()) - 1;
+	uint4 emptyIdx = Probe(key);
+
+	if (!m_slots[emptyIdx].key)
+		return;
+
+	// Shift back subsequent elements, no tombstones required
+	for (uint4 slotIdx = (emptyIdx + 1) & mask; m_slots[slotIdx].key; slotIdx = (slotIdx + 1) & mask)
+		if (MayShiftBack(emptyIdx, slotIdx, HashPointer(m_slots[slotIdx].key) & mask))
+		{
+			m_slots[emptyIdx] = m_slots[slotIdx];
+			emptyIdx = slotIdx;
+		}
+
+	m_slots[emptyIdx].key = nullptr;
+	--m_count;
+}
+
+// Constructor.
+ResourceStringTable::ResourceStringTable()
+	: m_count(0),
+	m_bSorted(true)
+{
+}
+
+// Destructor.
+ResourceStringTable::~ResourceStringTable()
+{
+}
+
+// Gets the slot of the given string, first empty slot in its probe sequence if not found.
+uint4 ResourceStringTable::Probe(const utf8_ntri &string, uint8 hash) const
+{
+	const uint4 mask = static_cast<uint4>(m_slots.size()) - 1;
+	const uint4 shortHash = static_cast<uint4>(hash);
+	uint4 slotIdx = shortHash & mask;
+
+	for (; m_slots[slotIdx].record != InvalidIndex; slotIdx = (slotIdx + 1) & mask)
+	{
+		const Slot &slot = m_slots[slotIdx];
+
+		// NOTE: Compare hashes first, strings only touched on likely match
+		if (slot.hash == shortHash && StringsEqual(m_records[slot.record].string, string))
+			break;
+	}
+
+	return slotIdx;
+}
+
+// Grows the hash table to the given capacity.
+void ResourceStringTable::Rehash(uint4 capacity)
+{
+	const uint4 mask = capacity - 1;
+
+	Slot emptySlot = { 0, InvalidIndex };
+	slot_vector slots(capacity, emptySlot);
+
+	// NOTE: Hashes stored, strings never touched
+	for (slot_vector::const_iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+		if (it->record != InvalidIndex)
+		{
+			uint4 slotIdx = it->hash & mask;
+
+			while (slots[slotIdx].record != InvalidIndex)
+				slotIdx = (slotIdx + 1) & mask;
+
+			slots[slotIdx] = *it;
+		}
+
+	slots.swap(m_slots);
+}
+
+// Rebuilds the sorted view, if out of date.
+void ResourceStringTable::Sort() const
+{
+	if (m_bSorted)
+		return;
+
+	// NOTE: Const readers may race to rebuild the sorted view, modifications are never concurrent
+	lean::scoped_cs_lock lock(m_sortLock);
+
+	// Double check, another reader may have rebuilt the view in the meantime
+	if (m_bSorted)
+		return;
+
+	std::vector<StringOrder::value_type> order;
+	order.reserve(m_count);
+
+	for (uint4 recordIdx = 0, recordCount = static_cast<uint4>(m_records.size()); recordIdx < recordCount; ++recordIdx)
+		if (m_records[recordIdx].bUsed)
+			order.push_back( StringOrder::value_type(&m_records[recordIdx].string, recordIdx) );
+
+	std::sort(order.begin(), order.end(), StringOrder());
+
+	m_sorted.resize(order.size());
+
+	for (uint4 pos = 0, count = static_cast<uint4>(order.size()); pos < count; ++pos)
+	{
+		m_sorted[pos] = order[pos].second;
+		m_records[order[pos].second].sortedPos = pos;
+	}
+
+	// ORDER: Publish AFTER the sorted view has been rebuilt
+	m_bSorted = true;
+}
+
+// Gets the record of the given string, InvalidIndex if none.
+uint4 ResourceStringTable::Find(const utf8_ntri &string) const
+{
+	if (m_slots.empty())
+		return InvalidIndex;
+
+	return m_slots[Probe(string, HashString(string))].record;
+}
+
+// Adds the given string mapped to the given index, if not present yet. Returns the record of the given string.
+uint4 ResourceStringTable::Insert(const utf8_ntri &string, uint4 value)
+{
+	if (NeedsToGrow(m_count, m_slots.size()))
+		Rehash( max(static_cast<uint4>(2 * m_slots.size()), MinTableCapacity) );
+
+	const uint8 hash = HashString(string);
+	const uint4 slotIdx = Probe(string, hash);
+
+	if (m_slots[slotIdx].record != InvalidIndex)
+		return m_slots[slotIdx].record;
+
+	uint4 recordIdx;
+
+	// Re-use records of erased strings
+	if (!m_freeRecords.empty())
+	{
+		recordIdx = m_freeRecords.back();
+		m_records[recordIdx].string.assign(string.begin(), string.end());
+		m_freeRecords.pop_back();
+	}
+	else
+	{
+		recordIdx = static_cast<uint4>(m_records.size());
+		m_records.push_back( Record() );
+
+		try
+		{
+			m_records.back().string.assign(string.begin(), string.end());
+		}
+		catch (...)
+		{
+			m_records.pop_back();
+			throw;
+		}
+	}
+
+	Record &record = m_records[recordIdx];
+	record.hash = hash;
+	record.value = value;
+	record.sortedPos = InvalidIndex;
+	record.bUsed = true;
+
+	Slot &slot = m_slots[slotIdx];
+	slot.hash = static_cast<uint4>(hash);
+	slot.record = recordIdx;
+
+	++m_count;
+	m_bSorted = false;
+
+	return recordIdx;
+}
+
+// Removes the given record.
+void ResourceStringTable::Erase(uint4 recordIdx)
+{
+	Record &record = m_records[recordIdx];
+	LEAN_ASSERT(record.bUsed);
+
+	const uint4 mask = static_cast<uint4>(m_slots.size()) - 1;
+	uint4 emptyIdx = static_cast<uint4>(record.hash) & mask;
+
+	while (m_slots[emptyIdx].record != recordIdx)
+		emptyIdx = (emptyIdx + 1) & mask;
+
+	// Shift back subsequent elements, no tombstones required
+	for (uint4 slotIdx = (emptyIdx + 1) & mask; m_slots[slotIdx].record != InvalidIndex; slotIdx = (slotIdx + 1) & mask)
+		if (MayShiftBack(emptyIdx, slotIdx, m_slots[slotIdx].hash & mask))
+		{
+			m_slots[emptyIdx] = m_slots[slotIdx];
+			emptyIdx = slotIdx;
+		}
+
+	m_slots[emptyIdx].record = InvalidIndex;
+
+	record.string.clear();
+	record.value = InvalidIndex;
+	record.bUsed = false;
+	m_freeRecords.push_back(recordIdx);
+
+	--m_count;
+	m_bSorted = false;
+}
+
+// Gets the first record in order, InvalidIndex if none.
+uint4 ResourceStringTable::First() const
+{
+	Sort();
+	return (!m_sorted.empty()) ? m_sorted.front() : InvalidIndex;
+}
+
+// Gets the last record in order, InvalidIndex if none.
+uint4 ResourceStringTable::Last() const
+{
+	Sort();
+	return (!m_sorted.empty()) ? m_sorted.back() : InvalidIndex;
+}
+
+// Gets the next record in order, InvalidIndex if none.
+uint4 ResourceStringTable::Next(uint4 record) const
+{
+	Sort();
+	uint4 pos = m_records[record].sortedPos + 1;
+	return (pos < m_sorted.size()) ? m_sorted[pos] : InvalidIndex;
+}
+
+// Gets the previous record in order, last record if InvalidIndex.
+uint4 ResourceStringTable::Prev(uint4 record) const
+{
+	if (record == InvalidIndex)
+		return Last();
+
+	Sort();
+	uint4 pos = m_records[record].sortedPos;
+	return (pos > 0) ? m_sorted[pos - 1] : InvalidIndex;
+}
+
+// Gets the first record not ordered before the given string, InvalidIndex if none.
+uint4 ResourceStringTable::LowerBound(const utf8_ntri &string) const
+{
+	Sort();
+
+	uint4 first = 0, count = static_cast<uint4>(m_sorted.size());
+
+	while (count > 0)
+	{
+		uint4 half = count / 2;
+
+		if (CompareStrings(m_records[m_sorted[first + half]].string, string) < 0)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+			count = half;
+	}
+
+	return (first < m_sorted.size()) ? m_sorted[first] : InvalidIndex;
+}
+
+// Gets the first record ordered after the given string, InvalidIndex if none.
+uint4 ResourceStringTable::UpperBound(const utf8_ntri &string) const
+{
+	Sort();
+
+	uint4 first = 0, count = static_cast<uint4>(m_sorted.size());
+
+	while (count > 0)
+	{
+		uint4 half = count / 2;
+
+		if (CompareStrings(m_records[m_sorted[first + half]].string, string) <= 0)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+			count = half;
+	}
+
+	return (first < m_sorted.size()) ? m_sorted[first] : InvalidIndex;
+}
+
+} // namespace
@@ -0,0 +1,183 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCoreInternal/beSchedulerTrace.h"
+
+#ifdef BE_CORE_SCHEDULER_TRACING
+
+#include <ostream>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Scheduler trace of the current thread.
+__declspec(thread) SchedulerThreadTrace *g_pCurrentSchedulerTrace = nullptr;
+
+/// Writes the given string as JSON string literal.
+void WriteJSONString(std::basic_ostream<utf8_t> &stream, const char *str)
+{
+	stream << '"';
+
+	for (; *str; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			stream << '\\';
+		stream << *str;
+	}
+
+	stream << '"';
+}
+
+} // namespace
+
+// Gets the current high-resolution tick count.
+uint8 GetSchedulerTicks()
+{
+	LARGE_INTEGER ticks;
+	::QueryPerformanceCounter(&ticks);
+	return static_cast<uint8>(ticks.QuadPart);
+}
+
+// Converts the given number of ticks into seconds.
+double SchedulerTicksToSeconds(uint8 ticks)
+{
+	static LARGE_INTEGER frequency;
+
+	if (!frequency.QuadPart)
+		::QueryPerformanceFrequency(&frequency);
+
+	return static_cast<double>(ticks) / static_cast<double>(frequency.QuadPart);
+}
+
+// Gets the scheduler trace of the current thread, nullptr if none.
+SchedulerThreadTrace* GetCurrentSchedulerTrace()
+{
+	return g_pCurrentSchedulerTrace;
+}
+
+// Sets the scheduler trace of the current thread.
+void SetCurrentSchedulerTrace(SchedulerThreadTrace *pTrace)
+{
+	g_pCurrentSchedulerTrace = pTrace;
+}
+
+// Constructor.
+SchedulerThreadTrace::SchedulerThreadTrace()
+	: m_pTrace(nullptr),
+	m_events(new Event[Capacity]),
+	m_eventCount(0),
+	m_taskTicks(0)
+{
+	Reset();
+}
+
+// Clears all events & counters.
+void SchedulerThreadTrace::Reset()
+{
+	m_eventCount = 0;
+
+	for (int i = 0; i < SchedulerCounter::Count; ++i)
+		m_counters[i] = 0;
+}
+
+// Constructor.
+SchedulerTrace::SchedulerTrace(size_t threadCount)
+	: m_threadCount(threadCount),
+	m_threads(new SchedulerThreadTrace[threadCount]),
+	m_bEnabled(false),
+	m_baseTicks(GetSchedulerTicks()),
+	m_maxQueueDepth(0)
+{
+	for (size_t i = 0; i < threadCount; ++i)
+		m_threads[i].Attach(this);
+}
+
+// Destructor.
+SchedulerTrace::~SchedulerTrace()
+{
+}
+
+// Gets the statistics of the given worker thread, all threads if invalid.
+ThreadPoolStats SchedulerTrace::GetStats(size_t workerIdx) const
+{
+	ThreadPoolStats stats;
+	uint8 runTicks = 0, idleTicks = 0, waitTicks = 0;
+
+	for (size_t i = 0; i < m_threadCount; ++i)
+		if (workerIdx >= m_threadCount || workerIdx == i)
+		{
+			const SchedulerThreadTrace &thread = m_threads[i];
+
+			stats.TaskCount += thread.GetCounter(SchedulerCounter::Tasks);
+			stats.StealCount += thread.GetCounter(SchedulerCounter::Steals);
+			stats.ParkCount += thread.GetCounter(SchedulerCounter::Parks);
+			runTicks += thread.GetCounter(SchedulerCounter::RunTicks);
+			idleTicks += thread.GetCounter(SchedulerCounter::IdleTicks);
+			waitTicks += thread.GetCounter(SchedulerCounter::WaitTicks);
+		}
+
+	stats.RunSeconds = SchedulerTicksToSeconds(runTicks);
+	stats.IdleSeconds = SchedulerTicksToSeconds(idleTicks);
+	stats.WaitSeconds = SchedulerTicksToSeconds(waitTicks);
+	stats.MaxQueueDepth = m_maxQueueDepth;
+
+	return stats;
+}
+
+// Clears all events & statistics.
+void SchedulerTrace::Reset()
+{
+	for (size_t i = 0; i < m_threadCount; ++i)
+		m_threads[i].Reset();
+
+	m_maxQueueDepth = 0;
+	m_baseTicks = GetSchedulerTicks();
+}
+
+// Writes all recorded events in Chrome trace event JSON format.
+void SchedulerTrace::WriteChromeTrace(std::basic_ostream<utf8_t> &stream) const
+{
+	const double ticksToMicroseconds = SchedulerTicksToSeconds(1) * 1.0e6;
+	bool bFirst = true;
+
+	stream << "{\"traceEvents\":[";
+
+	for (size_t threadIdx = 0; threadIdx < m_threadCount; ++threadIdx)
+	{
+		const SchedulerThreadTrace &thread = m_threads[threadIdx];
+
+		const uint4 eventEnd = thread.GetEventCount();
+		const uint4 eventBegin = (eventEnd > SchedulerThreadTrace::Capacity) ? eventEnd - SchedulerThreadTrace::Capacity : 0;
+
+		for (uint4 eventIdx = eventBegin; eventIdx < eventEnd; ++eventIdx)
+		{
+			const SchedulerThreadTrace::Event &event = thread.GetEvent(eventIdx);
+
+			// Skip events recorded before the last reset
+			if (event.begin < m_baseTicks)
+				continue;
+
+			if (!bFirst)
+				stream << ',';
+			bFirst = false;
+
+			stream << "\n{\"name\":";
+			WriteJSONString(stream, event.name);
+			stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << threadIdx
+				<< ",\"ts\":" << static_cast<double>(event.begin - m_baseTicks) * ticksToMicroseconds
+				<< ",\"dur\":" << static_cast<double>(event.end - event.begin) * ticksToMicroseconds
+				<< '}';
+		}
+	}
+
+	stream << "\n]}\n";
+}
+
+} // namespace
+
+#endif
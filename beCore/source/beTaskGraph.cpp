@@ -0,0 +1,372 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beTaskGraph.h"
+
+#include "beCore/beTask.h"
+#include "beCore/beThreadPool.h"
+
+#include <lean/concurrent/atomic.h>
+#include <lean/concurrent/event.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <lean/logging/errors.h>
+#include <lean/logging/log.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Task graph node.
+struct Node : public Task
+{
+	TaskGraph::M *graph;
+	Task *pTask;
+
+	uint4 predecessorCount;
+	volatile int pendingPredecessors;
+
+	uint4 successorOffset;
+	uint4 successorCount;
+
+	/// Constructor.
+	Node(TaskGraph::M *graph, Task *pTask)
+		: graph(graph),
+		pTask(pTask),
+		predecessorCount(0),
+		pendingPredecessors(0),
+		successorOffset(0),
+		successorCount(0) { }
+
+	/// Runs this node & all continuations that become ready.
+	void Run();
+};
+
+/// Dependency edge.
+typedef std::pair<uint4, uint4> edge;
+
+/// Interval in ms after which threads waiting for the graph check for pending tasks to help out with.
+const DWORD HelpingWaitInterval = 1;
+
+} // namespace
+
+/// Implementation of the task graph class internals.
+struct TaskGraph::M
+{
+	typedef std::vector<Node> node_vector;
+	node_vector nodes;
+
+	typedef std::vector<edge> edge_vector;
+	edge_vector edges;
+
+	typedef std::vector<uint4> index_vector;
+	index_vector successors;
+	index_vector roots;
+	bool bDirty;
+
+	ThreadPool *pPool;
+	TaskPriority::T priority;
+	volatile int pendingNodes;
+	lean::event done;
+	// NOTE: Only cleared AFTER done has been signaled, pendingNodes reaches zero earlier
+	volatile int running;
+
+	/// Constructor.
+	M()
+		: bDirty(false),
+		pPool(nullptr),
+		priority(TaskPriority::Normal),
+		pendingNodes(0),
+		done(true),
+		running(0) { }
+
+	/// Builds successor lists & root nodes from the dependencies added, if changed.
+	void Finalize();
+	/// Called when a node has finished running.
+	void NodeDone();
+};
+
+namespace
+{
+
+// Runs this node & all continuations that become ready.
+void Node::Run()
+{
+	Node *pNode = this;
+
+	do
+	{
+		pNode->pTask->Run();
+
+		TaskGraph::M &m = *pNode->graph;
+		Node *pContinuation = nullptr;
+
+		for (uint4 i = 0; i < pNode->successorCount; ++i)
+		{
+			Node &successor = m.nodes[ m.successors[pNode->successorOffset + i] ];
+
+			// Last predecessor to finish schedules the successor
+			if (lean::atomic_decrement(successor.pendingPredecessors) == 0)
+			{
+				// Continue with one successor in this thread, schedule all others
+				if (pContinuation)
+					m.pPool->AddTask(pContinuation, m.priority);
+
+				pContinuation = &successor;
+			}
+		}
+
+		// ORDER: Successors already pending, graph cannot finish early
+		// WARNING: Graph may be destroyed as soon as the last node has finished
+		m.NodeDone();
+
+		pNode = pContinuation;
+	}
+	while (pNode);
+}
+
+} // namespace
+
+// Builds successor lists & root nodes from the dependencies added, if changed.
+void TaskGraph::M::Finalize()
+{
+	if (!bDirty)
+		return;
+
+	// Group & deduplicate dependencies by predecessor
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+	const uint4 nodeCount = static_cast<uint4>(nodes.size());
+
+	for (node_vector::iterator itNode = nodes.begin(); itNode != nodes.end(); ++itNode)
+	{
+		itNode->predecessorCount = 0;
+		itNode->successorOffset = 0;
+		itNode->successorCount = 0;
+	}
+
+	successors.clear();
+	successors.reserve(edges.size());
+
+	for (edge_vector::const_iterator itEdge = edges.begin(); itEdge != edges.end(); ++itEdge)
+	{
+		Node &predecessor = nodes[itEdge->first];
+
+		if (predecessor.successorCount == 0)
+			predecessor.successorOffset = static_cast<uint4>(successors.size());
+
+		successors.push_back(itEdge->second);
+		++predecessor.successorCount;
+		++nodes[itEdge->second].predecessorCount;
+	}
+
+	roots.clear();
+
+	for (uint4 nodeIdx = 0; nodeIdx < nodeCount; ++nodeIdx)
+		if (nodes[nodeIdx].predecessorCount == 0)
+			roots.push_back(nodeIdx);
+
+	// Make sure all nodes are reachable (Kahn)
+	{
+		index_vector pending(nodeCount);
+		index_vector ready(roots);
+		uint4 visitedCount = 0;
+
+		for (uint4 nodeIdx = 0; nodeIdx < nodeCount; ++nodeIdx)
+			pending[nodeIdx] = nodes[nodeIdx].predecessorCount;
+
+		while (!ready.empty())
+		{
+			const Node &node = nodes[ready.back()];
+			ready.pop_back();
+			++visitedCount;
+
+			for (uint4 i = 0; i < node.successorCount; ++i)
+			{
+				uint4 successorIdx = successors[node.successorOffset + i];
+
+				if (--pending[successorIdx] == 0)
+					ready.push_back(successorIdx);
+			}
+		}
+
+		if (visitedCount != nodeCount)
+			LEAN_THROW_ERROR_MSG("Task graph contains cyclic dependencies");
+	}
+
+	bDirty = false;
+}
+
+// Called when a node has finished running.
+LEAN_INLINE void TaskGraph::M::NodeDone()
+{
+	if (lean::atomic_decrement(pendingNodes) == 0)
+	{
+		done.set();
+		// ORDER: Release graph only AFTER signaling, otherwise a stale signal might complete the next run
+		lean::atomic_set(running, 0);
+	}
+}
+
+// Constructs an empty task graph.
+TaskGraph::TaskGraph()
+	: m(new M())
+{
+}
+
+// Destructor. Waits for the graph to finish running.
+TaskGraph::~TaskGraph()
+{
+	Wait();
+}
+
+// Adds the given task, returning its node ID. The task is NOT owned by this graph.
+uint4 TaskGraph::AddTask(Task *pTask)
+{
+	if (!pTask)
+	{
+		LEAN_LOG_ERROR("nullptr task passed.");
+		return InvalidID;
+	}
+
+	if (!IsDone())
+	{
+		LEAN_LOG_ERROR("Tasks cannot be added while the graph is running.");
+		return InvalidID;
+	}
+
+	uint4 nodeID = static_cast<uint4>(m->nodes.size());
+	m->nodes.push_back( Node(m.getptr(), pTask) );
+	m->bDirty = true;
+
+	return nodeID;
+}
+
+// Makes the given successor node wait for the given predecessor node to finish.
+bool TaskGraph::AddDependency(uint4 predecessorID, uint4 successorID)
+{
+	const uint4 nodeCount = static_cast<uint4>(m->nodes.size());
+
+	if (predecessorID >= nodeCount || successorID >= nodeCount || predecessorID == successorID)
+	{
+		LEAN_LOG_ERROR("Invalid task dependency.");
+		return false;
+	}
+
+	if (!IsDone())
+	{
+		LEAN_LOG_ERROR("Dependencies cannot be added while the graph is running.");
+		return false;
+	}
+
+	m->edges.push_back( edge(predecessorID, successorID) );
+	m->bDirty = true;
+
+	return true;
+}
+
+// Starts running all tasks on the given thread pool with the given priority, returning immediately.
+bool TaskGraph::Start(ThreadPool *pPool, TaskPriority::T priority)
+{
+	if (!pPool)
+	{
+		LEAN_LOG_ERROR("Nullptr thread pool passed.");
+		LEAN_ASSERT_DEBUG(pPool);
+		return false;
+	}
+
+	if (!IsDone())
+	{
+		LEAN_LOG_ERROR("Task graph cannot be run twice at the same time.");
+		return false;
+	}
+
+	m->Finalize();
+
+	if (m->nodes.empty())
+		return true;
+
+	// NOTE: No allocations from here on, graph may be re-run every frame
+	for (M::node_vector::iterator itNode = m->nodes.begin(); itNode != m->nodes.end(); ++itNode)
+		itNode->pendingPredecessors = itNode->predecessorCount;
+
+	m->pPool = pPool;
+	m->priority = priority;
+	lean::atomic_set(m->running, 1);
+	m->done.reset();
+	// ORDER: Set pending count BEFORE any node is scheduled
+	lean::atomic_set(m->pendingNodes, static_cast<int>(m->nodes.size()));
+
+	for (M::index_vector::const_iterator itRoot = m->roots.begin(); itRoot != m->roots.end(); ++itRoot)
+		pPool->AddTask(&m->nodes[*itRoot], priority);
+
+	return true;
+}
+
+// Runs all tasks on the given thread pool with the given priority, returning when all tasks have finished.
+void TaskGraph::Run(ThreadPool *pPool, TaskPriority::T priority)
+{
+	if (Start(pPool, priority))
+		Wait();
+}
+
+// Waits for all tasks started to finish.
+void TaskGraph::Wait()
+{
+	if (m->pPool)
+	{
+		// Only help out with tasks of the graph's priority or higher, waits must not be held up by less urgent work
+		const TaskPriority::T helpPriority = m->priority;
+
+		// Help out with pending tasks instead of blocking this thread
+		while (!IsDone() && m->pPool->RunPendingTask(helpPriority));
+
+		// Keep helping while nodes are still running, as they may spawn further tasks
+		while (::WaitForSingleObject(m->done.native_handle(), HelpingWaitInterval) == WAIT_TIMEOUT)
+			while (!IsDone() && m->pPool->RunPendingTask(helpPriority));
+	}
+	else
+		m->done.wait();
+
+	// Signaled right before the last node releases the graph, wait for the release
+	// -> Graph may be restarted or destroyed as soon as this method returns
+	while (!IsDone())
+		::YieldProcessor();
+}
+
+// Checks if all tasks started have finished.
+bool TaskGraph::IsDone() const
+{
+	return (m->running == 0);
+}
+
+// Removes all tasks & dependencies.
+void TaskGraph::Clear()
+{
+	if (!IsDone())
+	{
+		LEAN_LOG_ERROR("Task graph cannot be cleared while running.");
+		return;
+	}
+
+	m->nodes.clear();
+	m->edges.clear();
+	m->successors.clear();
+	m->roots.clear();
+	m->bDirty = false;
+}
+
+// Gets the number of tasks.
+uint4 TaskGraph::GetTaskCount() const
+{
+	return static_cast<uint4>(m->nodes.size());
+}
+
+} // namespace
@@ -4,6 +4,7 @@
 
 #include "beCoreInternal/stdafx.h"
 #include "beCore/beThreadPool.h"
+#include "beCoreInternal/beSchedulerTrace.h"
 
 #include <lean/concurrent/thread.h>
 
@@ -14,15 +15,194 @@
 
 #include <lean/functional/callable.h>
 #include <lean/smart/scope_guard.h>
+#include <lean/smart/scoped_ptr.h>
 
 #include <deque>
+#include <ostream>
 
 #include <lean/logging/log.h>
 
+namespace beCore
+{
+
+namespace
+{
+
+/// Bounded lock-free task deque (Chase-Lev). Only the owning worker may push & pop, any thread may steal.
+class TaskDeque : public lean::noncopyable
+{
+public:
+	/// Maximum number of tasks held, overflowing tasks need to be scheduled elsewhere.
+	static const int Capacity = 1024;
+
+private:
+	static const int Mask = Capacity - 1;
+
+	// Keep owner & thieves off each other's cache lines
+	volatile int m_top;
+	char m_topPadding[64 - sizeof(int)];
+	volatile int m_bottom;
+	char m_bottomPadding[64 - sizeof(int)];
+
+	Task *volatile m_tasks[Capacity];
+
+public:
+	/// Constructs an empty deque.
+	TaskDeque()
+		: m_top(0),
+		m_bottom(0) { }
+
+	/// Pushes the given task onto the bottom of this deque, returns false if full. Owner only.
+	LEAN_INLINE bool Push(Task *pTask)
+	{
+		int bottom = m_bottom;
+
+		if (bottom - m_top >= Capacity)
+			return false;
+
+		m_tasks[bottom & Mask] = pTask;
+
+		// ORDER: Volatile store publishes the task to thieves AFTER it has been written
+		m_bottom = bottom + 1;
+		return true;
+	}
+
+	/// Pops the most recently pushed task, nullptr if empty. Owner only.
+	LEAN_INLINE Task* Pop()
+	{
+		int bottom = m_bottom - 1;
+
+		// ORDER: Full barrier, thieves MUST see the reservation BEFORE we read top
+		lean::atomic_set(m_bottom, bottom);
+
+		int top = m_top;
+
+		// Empty, restore
+		if (bottom - top < 0)
+		{
+			m_bottom = top;
+			return nullptr;
+		}
+
+		Task *pTask = m_tasks[bottom & Mask];
+
+		// Last task might be contested by thieves
+		if (bottom == top)
+		{
+			if (!lean::atomic_test_and_set(m_top, top, top + 1))
+				pTask = nullptr;
+
+			m_bottom = top + 1;
+		}
+
+		return pTask;
+	}
+
+	/// Steals the least recently pushed task, nullptr if empty or contested. This method is thread-safe.
+	LEAN_INLINE Task* Steal()
+	{
+		// ORDER: Volatile loads, read top BEFORE bottom
+		int top = m_top;
+		int bottom = m_bottom;
+
+		if (bottom - top <= 0)
+			return nullptr;
+
+		Task *pTask = m_tasks[top & Mask];
+
+		// Lost the race against the owner or another thief otherwise
+		return lean::atomic_test_and_set(m_top, top, top + 1)
+			? pTask
+			: nullptr;
+	}
+
+	/// Checks if this deque appears to be empty. This method is thread-safe.
+	LEAN_INLINE bool Empty() const
+	{
+		return m_bottom - m_top <= 0;
+	}
+};
+
+/// Parks idle workers until new tasks arrive (eventcount-style). Idle workers announce their intention
+/// to park BEFORE re-checking for tasks, so a task added in between always results in a wake-up.
+class ParkingLot : public lean::noncopyable
+{
+private:
+	volatile int m_nWaiting;
+	lean::semaphore m_wakeUp;
+
+public:
+	/// Constructor.
+	ParkingLot()
+		: m_nWaiting(0),
+		m_wakeUp(0) { }
+
+	/// Announces that the calling thread is about to park. Re-check all task sources afterwards.
+	LEAN_INLINE void PrepareWait()
+	{
+		lean::atomic_increment(m_nWaiting);
+	}
+	/// Parks the calling thread until woken up. Only call after PrepareWait().
+	LEAN_INLINE void CommitWait()
+	{
+		m_wakeUp.lock();
+	}
+	/// Withdraws the calling thread's intention to park.
+	LEAN_INLINE void CancelWait()
+	{
+		// NOTE: Slot might already have been consumed by a notification, leaving one
+		// excess wake-up that merely causes one harmless spurious check later on
+		for (int nWaiting; (nWaiting = m_nWaiting) > 0; )
+			if (lean::atomic_test_and_set(m_nWaiting, nWaiting, nWaiting - 1))
+				break;
+	}
+
+	/// Wakes up one parked thread, if any. This method is thread-safe.
+	LEAN_INLINE void NotifyOne()
+	{
+		// Waiting count accessed concurrently
+		for (int nWaiting; (nWaiting = m_nWaiting) > 0; )
+			if (lean::atomic_test_and_set(m_nWaiting, nWaiting, nWaiting - 1))
+			{
+				m_wakeUp.unlock();
+				break;
+			}
+	}
+	/// Unconditionally releases the given number of threads, parked or about to park.
+	LEAN_INLINE void Release(int count)
+	{
+		while (count-- > 0)
+			m_wakeUp.unlock();
+	}
+};
+
+/// Number of stealing rounds an idle worker tries before parking.
+const int StealRounds = 64;
+
+} // namespace
+
+} // namespace
+
 /// Implements a thread pool.
 class beCore::ThreadPool::Impl
 {
 private:
+	/// Work-stealing worker state.
+	struct Worker
+	{
+		Impl *pPool;
+		TaskDeque tasks;
+		uint4 stealSeed;
+
+		/// Constructor.
+		Worker()
+			: pPool(nullptr),
+			stealSeed(0) { }
+	};
+
+	const ThreadPoolMode::T m_mode;
+	const size_t m_threadCount;
+
 	volatile int m_nActiveThreads;
 	volatile bool m_bShuttingDown;
 
@@ -30,11 +210,28 @@ private:
 	lean::event m_threadsTerminated;
 
 	lean::critical_section m_tasksLock;
-	std::deque<Task*> m_tasks;
+	std::deque<Task*> m_tasks[TaskPriority::Count];
+	volatile int m_nQueuedTasks[TaskPriority::Count];
+
+	volatile int m_nBackgroundThreads;
+	volatile int m_nMaxBackgroundThreads;
 
 	volatile int m_nIdleCount;
 	lean::semaphore m_idleBlock;
 
+	lean::scoped_ptr<Worker[]> m_workers;
+	volatile int m_nWorkerSlots;
+	ParkingLot m_parking;
+
+#ifdef BE_CORE_SCHEDULER_TRACING
+	SchedulerTrace m_trace;
+#endif
+
+	/// Runs the given task. Releases one background thread slot afterwards, if throttled.
+	void RunTask(Task *pTask, bool bThrottled);
+	/// Wakes up one idle worker thread, if any. This method is thread-safe.
+	void WakeWorker();
+
 	/// Launches a new worker thread. This method is thread-safe.
 	void LaunchWorker();
 	/// To be called when a worker thread terminates. This method is thread-safe.
@@ -45,23 +242,77 @@ private:
 
 	/// Schedules the next tasks. This method is thread-safe.
 	void WorkerThread();
-
-	/// Gets the next task scheduled for execution, nullptr if no such task. This method is thread-safe.
-	Task* NextTask();
+	/// Schedules the next tasks from the shared queue.
+	void SharedWorkerLoop();
+	/// Schedules the next tasks from the local deque, the shared queue & other workers.
+	void StealingWorkerLoop(Worker &worker);
+
+	/// Gets the next queued task of the given or higher priority, nullptr if no such task. Background tasks are subject
+	/// to the background thread limit if throttling requested, bThrottled set if a slot was taken. This method is thread-safe.
+	Task* NextTask(TaskPriority::T lowestPriority, bool bThrottle, bool &bThrottled);
+	/// Gets the next task of the given or higher priority to be executed by the given worker, nullptr if no such task.
+	Task* NextTask(Worker &worker, TaskPriority::T lowestPriority, bool bThrottle, bool &bThrottled);
+	/// Steals a task from any worker but the given one, nullptr if no task could be stolen.
+	Task* StealTask(uint4 &seed, const Worker *pThief);
+
+	/// Adds the given task to the shared queue of the given priority. This method is thread-safe.
+	void QueueTask(Task *pTask, TaskPriority::T priority);
 
 public:
 	/// Constructs the given number of threads.
-	Impl(size_t threadCount);
+	Impl(size_t threadCount, ThreadPoolMode::T mode);
 	/// Waits for all active threads to terminate.
 	~Impl();
 
 	/// Adds the given task to be executed when a thread becomes available. This method is thread-safe.
-	void AddTask(Task *pTask);
+	void AddTask(Task *pTask, TaskPriority::T priority);
+	/// Runs one pending task of the given or higher priority on the calling thread, returns false if no task was pending. This method is thread-safe.
+	bool RunPendingTask(TaskPriority::T lowestPriority);
+
+	/// Sets the maximum number of worker threads running background tasks at the same time. This method is thread-safe.
+	void SetBackgroundThreadLimit(size_t threadCount);
+	/// Gets the maximum number of worker threads running background tasks at the same time.
+	LEAN_INLINE size_t GetBackgroundThreadLimit() const { return static_cast<size_t>(m_nMaxBackgroundThreads); }
+
+	/// Gets the scheduling mode.
+	LEAN_INLINE ThreadPoolMode::T GetMode() const { return m_mode; }
+	/// Gets the number of worker threads.
+	LEAN_INLINE size_t GetThreadCount() const { return m_threadCount; }
+	/// Gets the current number of tasks in the shared queues.
+	LEAN_INLINE uint4 GetQueueDepth() const
+	{
+		int queueDepth = 0;
+
+		for (int i = 0; i < TaskPriority::Count; ++i)
+			queueDepth += m_nQueuedTasks[i];
+
+		return static_cast<uint4>( max(queueDepth, 0) );
+	}
+
+#ifdef BE_CORE_SCHEDULER_TRACING
+	/// Gets the scheduler trace.
+	LEAN_INLINE SchedulerTrace& GetTrace() { return m_trace; }
+	/// Gets the scheduler trace.
+	LEAN_INLINE const SchedulerTrace& GetTrace() const { return m_trace; }
+#endif
 };
 
+namespace beCore
+{
+
+namespace
+{
+
+/// Work-stealing worker of the current thread, nullptr if not a work-stealing pool thread.
+__declspec(thread) void *g_pCurrentWorker = nullptr;
+
+} // namespace
+
+} // namespace
+
 // Constructs a thread pool maintaining the given number of threads.
-beCore::ThreadPool::ThreadPool(size_t threadCount)
-	: m_impl(new Impl(threadCount))
+beCore::ThreadPool::ThreadPool(size_t threadCount, ThreadPoolMode::T mode)
+	: m_impl(new Impl(threadCount, mode))
 {
 }
 
@@ -71,20 +322,120 @@ beCore::ThreadPool::~ThreadPool()
 }
 
 // Adds the given task to be executed when a thread becomes available. This method is thread-safe.
-void beCore::ThreadPool::AddTask(Task *pTask)
+void beCore::ThreadPool::AddTask(Task *pTask, TaskPriority::T priority)
+{
+	m_impl->AddTask(pTask, priority);
+}
+
+// Runs one pending task of the given or higher priority on the calling thread, returns false if no task was pending.
+bool beCore::ThreadPool::RunPendingTask(TaskPriority::T lowestPriority)
+{
+	return m_impl->RunPendingTask(lowestPriority);
+}
+
+// Sets the maximum number of worker threads running background tasks at the same time. This method is thread-safe.
+void beCore::ThreadPool::SetBackgroundThreadLimit(size_t threadCount)
 {
-	m_impl->AddTask(pTask);
+	m_impl->SetBackgroundThreadLimit(threadCount);
+}
+
+// Gets the maximum number of worker threads running background tasks at the same time.
+size_t beCore::ThreadPool::GetBackgroundThreadLimit() const
+{
+	return m_impl->GetBackgroundThreadLimit();
+}
+
+// Gets the scheduling mode.
+beCore::ThreadPoolMode::T beCore::ThreadPool::GetMode() const
+{
+	return m_impl->GetMode();
+}
+
+// Gets the number of worker threads.
+size_t beCore::ThreadPool::GetThreadCount() const
+{
+	return m_impl->GetThreadCount();
+}
+
+// Enables or disables recording of scheduler events & statistics on worker threads.
+bool beCore::ThreadPool::EnableTracing(bool bEnable)
+{
+#ifdef BE_CORE_SCHEDULER_TRACING
+	m_impl->GetTrace().Enable(bEnable);
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Gets the statistics of all worker threads.
+beCore::ThreadPoolStats beCore::ThreadPool::GetStats() const
+{
+	return GetWorkerStats(static_cast<size_t>(-1));
+}
+
+// Gets the statistics of the given worker thread.
+beCore::ThreadPoolStats beCore::ThreadPool::GetWorkerStats(size_t workerIdx) const
+{
+#ifdef BE_CORE_SCHEDULER_TRACING
+	ThreadPoolStats stats = m_impl->GetTrace().GetStats(workerIdx);
+#else
+	ThreadPoolStats stats;
+#endif
+	stats.QueueDepth = m_impl->GetQueueDepth();
+	return stats;
+}
+
+// Clears all statistics & recorded events.
+void beCore::ThreadPool::ResetTrace()
+{
+#ifdef BE_CORE_SCHEDULER_TRACING
+	m_impl->GetTrace().Reset();
+#endif
+}
+
+// Writes the most recently recorded events in Chrome trace event JSON format (chrome://tracing).
+void beCore::ThreadPool::WriteChromeTrace(std::basic_ostream<utf8_t> &stream) const
+{
+#ifdef BE_CORE_SCHEDULER_TRACING
+	m_impl->GetTrace().WriteChromeTrace(stream);
+#else
+	stream << "{\"traceEvents\":[]}\n";
+#endif
 }
 
 // Constructs the given number of threads.
-beCore::ThreadPool::Impl::Impl(size_t threadCount)
-	: m_nActiveThreads(0),
+beCore::ThreadPool::Impl::Impl(size_t threadCount, ThreadPoolMode::T mode)
+	: m_mode(mode),
+	m_threadCount(threadCount),
+
+	m_nActiveThreads(0),
 	m_bShuttingDown(false),
 	m_threadsTerminated(true),
 
+	m_nBackgroundThreads(0),
+	// Keep one thread free for more urgent tasks by default
+	m_nMaxBackgroundThreads( (threadCount > 1) ? static_cast<int>(threadCount - 1) : 1 ),
+
 	m_nIdleCount(0),
-	m_idleBlock(0)
+	m_idleBlock(0),
+
+	m_workers( (mode == ThreadPoolMode::WorkStealing) ? new Worker[threadCount] : nullptr ),
+	m_nWorkerSlots(0)
+#ifdef BE_CORE_SCHEDULER_TRACING
+	, m_trace(threadCount)
+#endif
 {
+	for (int i = 0; i < TaskPriority::Count; ++i)
+		m_nQueuedTasks[i] = 0;
+
+	if (m_workers)
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			m_workers[i].pPool = this;
+			m_workers[i].stealSeed = static_cast<uint4>(i) * 2654435761U + 1;
+		}
+
 	try
 	{
 		for (size_t i = 0; i < threadCount; ++i)
@@ -104,7 +455,7 @@ beCore::ThreadPool::Impl::~Impl()
 }
 
 // Adds the given task to be executed when a thread becomes available. This method is thread-safe.
-LEAN_INLINE void beCore::ThreadPool::Impl::AddTask(Task *pTask)
+LEAN_INLINE void beCore::ThreadPool::Impl::AddTask(Task *pTask, TaskPriority::T priority)
 {
 	if (!pTask)
 	{
@@ -112,11 +463,34 @@ LEAN_INLINE void beCore::ThreadPool::Impl::AddTask(Task *pTask)
 		return;
 	}
 
+	if (static_cast<unsigned int>(priority) >= TaskPriority::Count)
 	{
-		// Tasks accessed concurrently
-		lean::scoped_cs_lock lock(m_tasksLock);
+		LEAN_LOG_ERROR("Invalid task priority passed, falling back to normal priority.");
+		priority = TaskPriority::Normal;
+	}
+
+	Worker *pWorker = static_cast<Worker*>(g_pCurrentWorker);
+
+	// Normal tasks spawned by our own workers stay local, external tasks, other priorities & overflow are queued
+	if (m_mode != ThreadPoolMode::WorkStealing || priority != TaskPriority::Normal
+		|| !pWorker || pWorker->pPool != this || !pWorker->tasks.Push(pTask))
+		QueueTask(pTask, priority);
+
+	WakeWorker();
+}
+
+// Wakes up one idle worker thread, if any. This method is thread-safe.
+LEAN_INLINE void beCore::ThreadPool::Impl::WakeWorker()
+{
+	// ORDER: Full barrier, new tasks MUST be visible BEFORE the idle counts are read
+	// -> Plain stores may otherwise be delayed past the following loads, a worker announcing
+	//    itself idle in between might then miss both the new task & the wake-up
+	::MemoryBarrier();
 
-		m_tasks.push_back(pTask);
+	if (m_mode == ThreadPoolMode::WorkStealing)
+	{
+		m_parking.NotifyOne();
+		return;
 	}
 
 	// Wait until up to date
@@ -131,51 +505,235 @@ LEAN_INLINE void beCore::ThreadPool::Impl::AddTask(Task *pTask)
 	}
 }
 
-// Gets the next task scheduled for execution, nullptr if no such task. This method is thread-safe.
-beCore::Task* beCore::ThreadPool::Impl::NextTask()
+// Adds the given task to the shared queue of the given priority. This method is thread-safe.
+LEAN_INLINE void beCore::ThreadPool::Impl::QueueTask(Task *pTask, TaskPriority::T priority)
 {
-	Task *pTask = nullptr;
-	
 	// Tasks accessed concurrently
 	lean::scoped_cs_lock lock(m_tasksLock);
-	
-	if (!m_tasks.empty())
+
+	m_tasks[priority].push_back(pTask);
+	lean::atomic_increment(m_nQueuedTasks[priority]);
+
+	BE_SCHEDULER_TRACE( m_trace.QueueDepthChanged(GetQueueDepth()) );
+}
+
+// Gets the next queued task of the given or higher priority, nullptr if no such task. This method is thread-safe.
+beCore::Task* beCore::ThreadPool::Impl::NextTask(TaskPriority::T lowestPriority, bool bThrottle, bool &bThrottled)
+{
+	bThrottled = false;
+
+	for (int priority = TaskPriority::Critical; priority <= lowestPriority; ++priority)
+	{
+		// Don't bother locking an empty queue
+		if (m_nQueuedTasks[priority] <= 0)
+			continue;
+
+		const bool bLimited = bThrottle && priority == TaskPriority::Background;
+
+		// Leave background tasks queued while enough threads are busy with them
+		if (bLimited && m_nBackgroundThreads >= m_nMaxBackgroundThreads)
+			break;
+
+		// Tasks accessed concurrently
+		lean::scoped_cs_lock lock(m_tasksLock);
+
+		std::deque<Task*> &tasks = m_tasks[priority];
+
+		// Double check, background thread slots only ever taken in lock
+		if (!tasks.empty() && (!bLimited || m_nBackgroundThreads < m_nMaxBackgroundThreads))
+		{
+			Task *pTask = tasks.front();
+			tasks.pop_front();
+			lean::atomic_decrement(m_nQueuedTasks[priority]);
+
+			if (bLimited)
+			{
+				lean::atomic_increment(m_nBackgroundThreads);
+				bThrottled = true;
+			}
+
+			return pTask;
+		}
+	}
+
+	return nullptr;
+}
+
+// Gets the next task of the given or higher priority to be executed by the given worker, nullptr if no such task.
+beCore::Task* beCore::ThreadPool::Impl::NextTask(Worker &worker, TaskPriority::T lowestPriority, bool bThrottle, bool &bThrottled)
+{
+	// Prefer critical work, then most recent local work (cache-hot), then external work, then other workers' oldest work
+	// NOTE: Local deques only ever hold normal tasks
+	Task *pTask = NextTask(TaskPriority::Critical, bThrottle, bThrottled);
+
+	if (lowestPriority >= TaskPriority::Normal)
 	{
-		pTask = m_tasks.front();
-		m_tasks.pop_front();
+		if (!pTask)
+			pTask = worker.tasks.Pop();
+
+		if (!pTask)
+			pTask = NextTask(TaskPriority::Normal, bThrottle, bThrottled);
+
+		if (!pTask)
+			pTask = StealTask(worker.stealSeed, &worker);
+
+		// Background work only when there is nothing else to do
+		if (!pTask && lowestPriority >= TaskPriority::Background)
+			pTask = NextTask(TaskPriority::Background, bThrottle, bThrottled);
 	}
 
 	return pTask;
 }
 
+// Steals a task from any worker but the given one, nullptr if no task could be stolen.
+beCore::Task* beCore::ThreadPool::Impl::StealTask(uint4 &seed, const Worker *pThief)
+{
+	const uint4 workerCount = static_cast<uint4>(m_threadCount);
+
+	// Randomize victim order to spread contention (xorshift)
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+
+	for (uint4 i = 0, victimIdx = seed % workerCount; i < workerCount; ++i, victimIdx = (victimIdx + 1) % workerCount)
+	{
+		Worker &victim = m_workers[victimIdx];
+
+		if (&victim != pThief)
+		{
+			Task *pTask = victim.tasks.Steal();
+
+			if (pTask)
+			{
+				BE_SCHEDULER_TRACE( CountSchedulerEvent(SchedulerCounter::Steals) );
+				return pTask;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+// Runs one pending task of the given or higher priority on the calling thread, returns false if no task was pending. This method is thread-safe.
+bool beCore::ThreadPool::Impl::RunPendingTask(TaskPriority::T lowestPriority)
+{
+	Task *pTask;
+	bool bThrottled = false;
+
+	// NOTE: Never throttle helping threads, they are blocked on the work they help with anyways
+	if (m_mode == ThreadPoolMode::WorkStealing)
+	{
+		Worker *pWorker = static_cast<Worker*>(g_pCurrentWorker);
+
+		if (pWorker && pWorker->pPool == this)
+			pTask = NextTask(*pWorker, lowestPriority, false, bThrottled);
+		else
+		{
+			pTask = NextTask(min(lowestPriority, TaskPriority::Normal), false, bThrottled);
+
+			if (!pTask && lowestPriority >= TaskPriority::Normal && m_threadCount > 0)
+			{
+				// Any seed will do, external threads rarely steal
+				uint4 seed = static_cast<uint4>( reinterpret_cast<uintptr_t>(&pTask) >> 4 ) | 1;
+				pTask = StealTask(seed, nullptr);
+			}
+
+			if (!pTask && lowestPriority >= TaskPriority::Background)
+				pTask = NextTask(TaskPriority::Background, false, bThrottled);
+		}
+	}
+	else
+		pTask = NextTask(lowestPriority, false, bThrottled);
+
+	if (pTask)
+		RunTask(pTask, bThrottled);
+
+	return (pTask != nullptr);
+}
+
+// Sets the maximum number of worker threads running background tasks at the same time. This method is thread-safe.
+void beCore::ThreadPool::Impl::SetBackgroundThreadLimit(size_t threadCount)
+{
+	lean::atomic_set(m_nMaxBackgroundThreads, static_cast<int>( min(threadCount, m_threadCount) ));
+
+	// Background tasks held back by the previous limit might be runnable now
+	if (m_nQueuedTasks[TaskPriority::Background] > 0)
+		for (size_t i = 0; i < m_threadCount; ++i)
+			WakeWorker();
+}
+
+// Runs the given task. Releases one background thread slot afterwards, if throttled.
+LEAN_INLINE void beCore::ThreadPool::Impl::RunTask(Task *pTask, bool bThrottled)
+{
+	{
+		BE_SCHEDULER_TRACE( CountSchedulerEvent(SchedulerCounter::Tasks) );
+		BE_SCHEDULER_TRACE( SchedulerTraceScope traceScope("Task", SchedulerCounter::RunTicks) );
+
+		pTask->Run();
+	}
+
+	if (bThrottled)
+	{
+		lean::atomic_decrement(m_nBackgroundThreads);
+
+		// Background tasks might have been held back by the limit
+		if (m_nQueuedTasks[TaskPriority::Background] > 0)
+			WakeWorker();
+	}
+}
+
 // Schedules the next tasks. This method is thread-safe.
 void beCore::ThreadPool::Impl::WorkerThread()
 {
 	// Properly terminate thread on uncaught exceptions
 	lean::scope_annex terminateGuard = lean::make_scope_annex(this, &Impl::WorkerTerminated);
 
+	int workerIdx = lean::atomic_increment(m_nWorkerSlots) - 1;
+	LEAN_ASSERT(static_cast<size_t>(workerIdx) < m_threadCount);
+
+	BE_SCHEDULER_TRACE( SetCurrentSchedulerTrace(&m_trace.GetThread(workerIdx)) );
+
+	if (m_mode == ThreadPoolMode::WorkStealing)
+	{
+		Worker &worker = m_workers[workerIdx];
+		g_pCurrentWorker = &worker;
+
+		StealingWorkerLoop(worker);
+
+		g_pCurrentWorker = nullptr;
+	}
+	else
+		SharedWorkerLoop();
+
+	BE_SCHEDULER_TRACE( SetCurrentSchedulerTrace(nullptr) );
+}
+
+// Schedules the next tasks from the shared queue.
+void beCore::ThreadPool::Impl::SharedWorkerLoop()
+{
 	while (!m_bShuttingDown)
 	{
-		Task *pTask = NextTask();
-		
+		bool bThrottled;
+		Task *pTask = NextTask(TaskPriority::Background, true, bThrottled);
+
 		if (pTask)
 			// Instantly run next task
-			pTask->Run();
+			RunTask(pTask, bThrottled);
 		else
 		{
 			// Spin for a short while, waiting for the next task
 			for (int i = 0; !pTask && i < 4096; ++i)
-				pTask = NextTask();
+				pTask = NextTask(TaskPriority::Background, true, bThrottled);
 
 			if (pTask)
 				// If we're lucky, we've got another task now
-				pTask->Run();
+				RunTask(pTask, bThrottled);
 			else
 			{
 				// Activate incoming task signaling
 				lean::atomic_increment(m_nIdleCount);
 
-				pTask = NextTask();
+				pTask = NextTask(TaskPriority::Background, true, bThrottled);
 
 				// Double check
 				// -> A job might have been added before we signaled idle state
@@ -187,13 +745,59 @@ void beCore::ThreadPool::Impl::WorkerThread()
 					lean::atomic_decrement(m_nIdleCount);
 
 					// If we're lucky, we've got another task now
-					pTask->Run();
+					RunTask(pTask, bThrottled);
 				}
 				else
+				{
+					BE_SCHEDULER_TRACE( CountSchedulerEvent(SchedulerCounter::Parks) );
+					BE_SCHEDULER_TRACE( SchedulerTraceScope traceScope("Idle", SchedulerCounter::IdleTicks) );
+
 					// Wait for busier days otherwise, without wasting any further resources
 					m_idleBlock.lock();
+				}
+			}
+		}
+	}
+}
+
+// Schedules the next tasks from the local deque, the shared queue & other workers.
+void beCore::ThreadPool::Impl::StealingWorkerLoop(Worker &worker)
+{
+	while (!m_bShuttingDown)
+	{
+		bool bThrottled;
+		Task *pTask = NextTask(worker, TaskPriority::Background, true, bThrottled);
+
+		// Try stealing for a short while, local & shared checks are lock-free
+		for (int i = 0; !pTask && i < StealRounds; ++i)
+		{
+			::YieldProcessor();
+			pTask = NextTask(worker, TaskPriority::Background, true, bThrottled);
+		}
+
+		if (!pTask)
+		{
+			// ORDER: Announce parking BEFORE double-checking
+			// -> Tasks added from here on are guaranteed to wake us up
+			m_parking.PrepareWait();
+
+			pTask = NextTask(worker, TaskPriority::Background, true, bThrottled);
+
+			if (pTask || m_bShuttingDown)
+				m_parking.CancelWait();
+			else
+			{
+				BE_SCHEDULER_TRACE( CountSchedulerEvent(SchedulerCounter::Parks) );
+				BE_SCHEDULER_TRACE( SchedulerTraceScope traceScope("Idle", SchedulerCounter::IdleTicks) );
+
+				// Wait for busier days otherwise, without wasting any further resources
+				m_parking.CommitWait();
+				continue;
 			}
 		}
+
+		if (pTask)
+			RunTask(pTask, bThrottled);
 	}
 }
 
@@ -215,6 +819,10 @@ void beCore::ThreadPool::Impl::ShutDownWorkers()
 		m_idleBlock.unlock();
 	}
 
+	// Wake up ALL parked threads
+	if (m_mode == ThreadPoolMode::WorkStealing)
+		m_parking.Release(m_nActiveThreads);
+
 	m_threadsTerminated.wait();
 }
 
@@ -22,11 +22,11 @@ ValueTypes::~ValueTypes()
 }
 
 // Adds the given component type, returning a unique address for this type.
-const ValueTypeDesc& ValueTypes::AddType(const lean::property_type_info &typeInfo)
+const ValueTypeDesc& ValueTypes::AddType(const lean::property_type_info &typeInfo, bool bPlain)
 {
 	utf8_nt typeName( typeInfo.type.name() );
 	std::pair<typename_map::iterator, bool> it = m_typeNames.insert(
-			std::make_pair( typeName, ValueTypeDesc(typeInfo) )
+			std::make_pair( typeName, ValueTypeDesc(typeInfo, nullptr, bPlain) )
 		);
 
 	if (!it.second)
@@ -0,0 +1,280 @@
+/*****************************************************/
+/* breeze Engine Core Module    (c) Tobias Zirr 2011 */
+/*****************************************************/
+
+#include "beCoreInternal/stdafx.h"
+#include "beCore/beXMLStreamWriter.h"
+#include "beCore/beFileCommit.h"
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <lean/io/raw_file.h>
+#include <lean/io/filesystem.h>
+#include <lean/smart/scoped_ptr.h>
+#include <lean/rapidxml/rapidxml_print.hpp>
+
+#include <lean/logging/errors.h>
+
+namespace beCore
+{
+
+namespace
+{
+
+/// Element begun but not yet ended.
+struct OpenElement
+{
+	utf8_string open;		///< Start tag, printed as if followed by child elements.
+	utf8_string close;		///< End tag matching the start tag.
+	utf8_string empty;		///< Self-closing tag, printed if no children follow.
+	bool bOpened;			///< Start tag written.
+
+	/// Constructor.
+	OpenElement()
+		: bOpened(false) { }
+};
+
+typedef std::vector<OpenElement> open_element_vector;
+
+} // namespace
+
+/// XML stream writer internals.
+struct XMLStreamWriter::M
+{
+	utf8_string targetFile;
+	utf8_string tempFile;
+	lean::scoped_ptr<lean::raw_file> file;
+	int printFlags;
+
+	std::vector<char> buffer;
+	size_t bufferSize;
+	uint8 flushedSize;
+
+	open_element_vector elements;
+
+	rapidxml::xml_document<utf8_t> scratch;
+	rapidxml::xml_document<utf8_t> tags;
+
+	/// Constructor.
+	M(const utf8_ntri &file, int printFlags, size_t bufferSize)
+		: targetFile(file.to<utf8_string>()),
+		tempFile(GetTempFile(file).c_str()),
+		file( new lean::raw_file(tempFile, lean::file::write, lean::file::overwrite, lean::file::sequential) ),
+		printFlags(printFlags),
+		bufferSize( std::max(bufferSize, static_cast<size_t>(1)) ),
+		flushedSize(0)
+	{
+		buffer.reserve(this->bufferSize);
+	}
+
+	/// Writes all buffered output to file.
+	void Flush()
+	{
+		LEAN_ASSERT(file);
+
+		if (!buffer.empty())
+		{
+			file->write(&buffer[0], buffer.size());
+			flushedSize += buffer.size();
+			buffer.clear();
+		}
+	}
+
+	/// Appends the given character.
+	LEAN_INLINE void Put(utf8_t c)
+	{
+		buffer.push_back(c);
+
+		if (buffer.size() >= bufferSize)
+			Flush();
+	}
+
+	/// Appends the given string.
+	void Put(const utf8_string &str)
+	{
+		for (utf8_string::const_iterator it = str.begin(), itEnd = str.end(); it != itEnd; ++it)
+			Put(*it);
+	}
+
+	/// Writes the start tag of the innermost open element, if not done yet.
+	void OpenInnermost()
+	{
+		if (!elements.empty())
+		{
+			OpenElement &element = elements.back();
+
+			if (!element.bOpened)
+			{
+				Put(element.open);
+				element.bOpened = true;
+			}
+		}
+	}
+
+	/// Gets the indentation of the next child node.
+	int GetIndent() const
+	{
+		return static_cast<int>(elements.size());
+	}
+};
+
+namespace
+{
+
+/// Output iterator appending to the stream writer buffer.
+class BufferIterator
+{
+private:
+	XMLStreamWriter::M *m;
+
+public:
+	typedef std::output_iterator_tag iterator_category;
+	typedef void value_type;
+	typedef void difference_type;
+	typedef void pointer;
+	typedef void reference;
+
+	/// Constructor.
+	explicit BufferIterator(XMLStreamWriter::M &m)
+		: m(&m) { }
+
+	/// Appends the given character.
+	BufferIterator& operator =(utf8_t c) { m->Put(c); return *this; }
+	/// Does nothing.
+	BufferIterator& operator *() { return *this; }
+	/// Does nothing.
+	BufferIterator& operator ++() { return *this; }
+	/// Does nothing.
+	BufferIterator operator ++(int) { return *this; }
+};
+
+/// Prints the given node into the given string.
+void PrintNode(utf8_string &str, const rapidxml::xml_node<utf8_t> &node, int flags, int indent)
+{
+	rapidxml::internal::print_node(std::back_inserter(str), &node, flags, indent);
+}
+
+} // namespace
+
+// Opens the given file for writing.
+XMLStreamWriter::XMLStreamWriter(const utf8_ntri &file, int printFlags, size_t bufferSize)
+	: m( new M(file, printFlags, bufferSize) )
+{
+}
+
+// Discards all output not committed.
+XMLStreamWriter::~XMLStreamWriter()
+{
+	// NOTE: Never flush here, might be unwinding from an incomplete document
+	if (m->file)
+	{
+		m->file = nullptr;
+		DiscardFile(m->tempFile);
+	}
+}
+
+// Begins an element of the given node's name & attributes.
+void XMLStreamWriter::BeginElement(const rapidxml::xml_node<utf8_t> &node)
+{
+	LEAN_ASSERT(node.type() == rapidxml::node_element);
+
+	m->OpenInnermost();
+
+	rapidxml::xml_document<utf8_t> &tags = m->tags;
+	tags.clear();
+
+	// NOTE: Shallow copy shares all strings with the given node
+	rapidxml::xml_node<utf8_t> &element = *tags.allocate_node(rapidxml::node_element, node.name(), nullptr, node.name_size(), 0);
+
+	for (const rapidxml::xml_attribute<utf8_t> *attribute = node.first_attribute(); attribute; attribute = attribute->next_attribute())
+		element.append_attribute(
+				tags.allocate_attribute(attribute->name(), attribute->value(), attribute->name_size(), attribute->value_size())
+			);
+
+	const int indent = m->GetIndent();
+
+	m->elements.push_back( OpenElement() );
+	OpenElement &openElement = m->elements.back();
+
+	PrintNode(openElement.empty, element, m->printFlags, indent);
+
+	// NOTE: Print with placeholder child, split start & end tags around the placeholder
+	rapidxml::xml_node<utf8_t> &placeholder = *tags.allocate_node(rapidxml::node_element, "_", nullptr, 1, 0);
+	element.append_node(&placeholder);
+
+	utf8_string full, child;
+	PrintNode(full, element, m->printFlags, indent);
+	PrintNode(child, placeholder, m->printFlags, indent + 1);
+
+	size_t childPos = full.rfind(child);
+	LEAN_ASSERT(childPos != utf8_string::npos);
+
+	openElement.open.assign(full, 0, childPos);
+	openElement.close.assign(full, childPos + child.size(), utf8_string::npos);
+
+	tags.clear();
+}
+
+// Ends the innermost element begun.
+void XMLStreamWriter::EndElement()
+{
+	LEAN_ASSERT(!m->elements.empty());
+
+	OpenElement &element = m->elements.back();
+	m->Put( (element.bOpened) ? element.close : element.empty );
+	m->elements.pop_back();
+}
+
+// Writes the given node including all of its children.
+void XMLStreamWriter::WriteNode(const rapidxml::xml_node<utf8_t> &node)
+{
+	m->OpenInnermost();
+	rapidxml::internal::print_node(BufferIterator(*m), &node, m->printFlags, m->GetIndent());
+}
+
+// Writes all children of the given node.
+void XMLStreamWriter::WriteChildren(const rapidxml::xml_node<utf8_t> &node)
+{
+	for (const rapidxml::xml_node<utf8_t> *child = node.first_node(); child; child = child->next_sibling())
+		WriteNode(*child);
+}
+
+// Gets a scratch document that nodes may be built in before they are written.
+rapidxml::xml_document<utf8_t>& XMLStreamWriter::Scratch()
+{
+	return m->scratch;
+}
+
+// Frees all nodes & strings allocated from the scratch document.
+void XMLStreamWriter::ClearScratch()
+{
+	m->scratch.clear();
+}
+
+// Writes all buffered output to file.
+void XMLStreamWriter::Flush()
+{
+	m->Flush();
+}
+
+// Writes all buffered output & replaces the given file by the complete output.
+void XMLStreamWriter::Commit()
+{
+	LEAN_ASSERT(m->elements.empty());
+
+	m->Flush();
+	// ORDER: Close before replacing the target file
+	m->file = nullptr;
+
+	CommitFile(m->tempFile, m->targetFile);
+}
+
+// Gets the number of bytes written so far.
+uint8 XMLStreamWriter::GetSize() const
+{
+	return m->flushedSize + m->buffer.size();
+}
+
+} // namespace
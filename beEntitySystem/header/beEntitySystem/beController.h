@@ -23,6 +23,8 @@ class LEAN_INTERFACE Controller : public beCore::UnRefCounted< beCore::NoPropert
 public:
 	/// Gets the reflection properties.
 	static Properties GetControllerProperties() { return Properties(); }
+	/// Gets the reflection properties, empty unless hidden by controllers exposing their properties statically.
+	static Properties GetOwnProperties() { return Properties(); }
 	/// Gets the reflection properties.
 	Properties GetReflectionProperties() const { return Properties(); }
 
@@ -30,6 +30,9 @@ public:
 	/// Saves the given controller to the given XML node.
 	BE_ENTITYSYSTEM_API virtual void Save(const Controller *pController, rapidxml::xml_node<lean::utf8_t> &node,
 		beCore::ParameterSet &parameters, beCore::SerializationQueue<beCore::SaveJob> &queue) const LEAN_OVERRIDE;
+
+	/// Gets the reflection properties of the controllers loaded, empty if unknown ahead of construction.
+	virtual Controller::Properties GetControllerProperties() const { return Controller::Properties(); }
 };
 
 } // namespace
@@ -104,6 +104,11 @@ public:
 	BE_ENTITYSYSTEM_API static void RemoveEntity(Entity *pEntity);
 	/// Reserves space for the given number of entities.
 	BE_ENTITYSYSTEM_API void Reserve(uint4 entityCount);
+	/// Expects the given number of entities to be added next, e.g. when loading. Once any of these entities requests a
+	/// new persistent ID, IDs for all entities still expected are reserved at once. Releases any earlier reservation.
+	BE_ENTITYSYSTEM_API void ReservePersistentIDs(uint4 entityCount);
+	/// Releases all persistent IDs reserved by ReservePersistentIDs() that have not been handed out to entities yet.
+	BE_ENTITYSYSTEM_API void ReleasePersistentIDs();
 
 	/// Controller range type.
 	typedef beCore::Range<Entity *const *> Range;
@@ -211,6 +216,21 @@ public:
 	BE_ENTITYSYSTEM_API static void SetPersistentID(EntityHandle entity, uint8 persistentID);
 	/// Gets the persistent ID.
 	BE_ENTITYSYSTEM_API static uint8 GetPersistentID(const EntityHandle entity);
+
+	/// Marks the given entity as modified since the last save. Changes to entity transformation, properties, state
+	/// & controller lists are tracked automatically, changes internal to controllers need to be marked explicitly.
+	BE_ENTITYSYSTEM_API static void MarkModified(EntityHandle entity);
+	/// Checks if the given entity has been modified since the last save.
+	BE_ENTITYSYSTEM_API static bool IsModified(const EntityHandle entity);
+
+	/// Persistent ID range type.
+	typedef beCore::Range<const uint8*> PersistentIDRange;
+	/// Gets the persistent IDs of all entities removed (or re-identified) since the last save.
+	BE_ENTITYSYSTEM_API PersistentIDRange GetRemovedSinceSave() const;
+	/// Checks if changes since the last save cannot be identified by persistent IDs, e.g. anonymous entities removed.
+	BE_ENTITYSYSTEM_API bool RequiresFullSave() const;
+	/// Marks all entities as saved.
+	BE_ENTITYSYSTEM_API void MarkSaved();
 	
 	/// Gets the ID.
 	LEAN_INLINE static uint4 GetCurrentID(const EntityHandle entity) { return entity.Index; }
@@ -344,6 +364,11 @@ public:
 	/// Gets the persistent ID.
 	LEAN_INLINE uint8 GetPersistentID() const { return Entities::GetPersistentID(m_handle); }
 
+	/// Marks this entity as modified since the last save.
+	LEAN_INLINE void MarkModified() { Entities::MarkModified(m_handle); }
+	/// Checks if this entity has been modified since the last save.
+	LEAN_INLINE bool IsModified() const { return Entities::IsModified(m_handle); }
+
 	/// Gets the ID.
 	LEAN_INLINE uint4 GetCurrentID() const { return Entities::GetCurrentID(m_handle); }
 	/// Gets the custom ID.
@@ -14,6 +14,8 @@ namespace beCore
 	class ParameterSet;
 	class SaveJobs;
 	class LoadJobs;
+	class ThreadPool;
+	class XMLStreamWriter;
 }
 
 namespace beEntitySystem
@@ -34,9 +36,19 @@ public:
 /// Saves the given number of entities to the given xml node.
 BE_ENTITYSYSTEM_API void SaveEntities(const Entity *const *entities, uint4 entityCount, rapidxml::xml_node<utf8_t> &parentNode,
 	beCore::ParameterSet *pParameters = nullptr, beCore::SaveJobs *pQueue = nullptr);
+/// Saves the given number of entities to the given XML stream, as children of its innermost open element. Each entity
+/// is written & freed as soon as it has been serialized, output is identical to that of the DOM version.
+BE_ENTITYSYSTEM_API void SaveEntities(const Entity *const *entities, uint4 entityCount, beCore::XMLStreamWriter &writer,
+	beCore::ParameterSet *pParameters = nullptr, beCore::SaveJobs *pQueue = nullptr);
 /// Loads all entities from the given xml node.
 BE_ENTITYSYSTEM_API void LoadEntities(Entities* entities, const rapidxml::xml_node<lean::utf8_t> &parentNode,
 	beCore::ParameterSet &parameters, beCore::LoadJobs *pQueue = nullptr, EntityInserter *pInserter = nullptr);
+/// Loads all entities from the given xml node. Entity & controller properties are parsed in batches on the given thread pool,
+/// entities & controllers are then constructed in document order on the calling thread. Results are identical to
+/// those of LoadEntities(). Falls back to serial loading if no pool given. Properties of controllers whose serializers
+/// do not know their property sets ahead of construction are still loaded on the calling thread.
+BE_ENTITYSYSTEM_API void LoadEntitiesParallel(Entities* entities, const rapidxml::xml_node<lean::utf8_t> &parentNode,
+	beCore::ParameterSet &parameters, beCore::ThreadPool *pPool, beCore::LoadJobs *pQueue = nullptr, EntityInserter *pInserter = nullptr);
 
 } // namespace
 
@@ -9,10 +9,64 @@
 #include "beEntitySystem.h"
 #include <beCore/beComponentSerializer.h>
 #include "beEntities.h"
+#include "beController.h"
+#include <vector>
 
 namespace beEntitySystem
 {
 
+/// Entity & controller property values parsed ahead of entity construction, e.g. on worker threads.
+class StagedEntityProperties
+{
+public:
+	/// Staged property value.
+	struct Value
+	{
+		uint4 PropertyID;	///< Entity or controller property ID.
+		uint4 Offset;		///< Offset of the value data, in 8-byte units.
+	};
+
+	/// Staged entity or controller.
+	struct Object
+	{
+		beCore::ReflectionPropertyProvider::Properties Properties;	///< Properties staged for, empty if not staged.
+		uint4 Values;												///< Index of the first staged value.
+	};
+
+private:
+	typedef std::vector<Value> value_vector;
+	value_vector m_values;
+	std::vector<uint8> m_data;
+	typedef std::vector<Object> object_vector;
+	object_vector m_objects;
+	std::vector<uint4> m_entities;
+
+	/// Parses the properties stored in the given node, returns the index of the staged object.
+	uint4 ParseObject(const rapidxml::xml_node<lean::utf8_t> &node, beCore::ReflectionPropertyProvider::Properties properties);
+	/// Writes the property values of the given staged object to the given provider, returns false if not staged for its properties.
+	bool ApplyObject(uint4 objectIdx, beCore::ReflectionPropertyProvider &provider) const;
+
+public:
+	/// Constructor.
+	BE_ENTITYSYSTEM_API StagedEntityProperties();
+	/// Destructor.
+	BE_ENTITYSYSTEM_API ~StagedEntityProperties();
+
+	/// Parses the properties stored in the given entity node & its controller nodes, returns the index of the staged entity.
+	/// Different staging objects may be filled on different threads concurrently.
+	BE_ENTITYSYSTEM_API uint4 Parse(const rapidxml::xml_node<lean::utf8_t> &node);
+	/// Writes the property values of the given staged entity to the given entity, returns false if not staged.
+	BE_ENTITYSYSTEM_API bool Apply(uint4 stagedIdx, Entity &entity) const;
+	/// Writes the property values of the given controller of the given staged entity to the given controller,
+	/// returns false if not staged (e.g. controller properties unknown ahead of construction).
+	BE_ENTITYSYSTEM_API bool ApplyController(uint4 stagedIdx, uint4 controllerIdx, Controller &controller) const;
+
+	/// Removes all staged entities.
+	BE_ENTITYSYSTEM_API void Clear();
+	/// Gets the number of staged entities.
+	LEAN_INLINE uint4 GetCount() const { return static_cast<uint4>(m_entities.size()); }
+};
+
 /// Entity serializer.
 class EntitySerializer : public beCore::ComponentSerializer<Entity>
 {
@@ -57,6 +57,9 @@ public:
 	/// Constructor.
 	GenericControllerSerializer()
 		: AbstractGenericControllerSerializer(Controller::GetComponentType()) { }
+
+	/// Gets the reflection properties of the controllers loaded.
+	beEntitySystem::Controller::Properties GetControllerProperties() const LEAN_OVERRIDE { return Controller::GetOwnProperties(); }
 };
 
 } // namespace
@@ -110,6 +110,9 @@ public:
 	/// Constructor.
 	GenericGroupControllerSerializer()
 		: typename GenericGroupControllerSerializer::AbstractGenericGroupControllerSerializer(Controller::GetComponentType()) { }
+
+	/// Gets the reflection properties of the controllers loaded.
+	beEntitySystem::Controller::Properties GetControllerProperties() const LEAN_OVERRIDE { return Controller::GetOwnProperties(); }
 };
 
 } // namespace
@@ -9,6 +9,12 @@
 #include "beEntitySystem.h"
 #include <beCore/beParameterSet.h>
 
+// Prototypes
+namespace beCore
+{
+	class PropertySnapshot;
+}
+
 namespace beEntitySystem
 {
 
@@ -18,6 +24,7 @@ BE_ENTITYSYSTEM_API beCore::ParameterLayout& GetSerializationParameters();
 // Prototypes
 class World;
 class Entity;
+class StagedEntityProperties;
 
 /// Scene parameter IDs.
 struct EntitySystemParameterIDs
@@ -25,14 +32,21 @@ struct EntitySystemParameterIDs
 	uint4 World;
 	uint4 Entity;
 	uint4 NoOverwrite;
+	uint4 StagedEntity;
+	uint4 StagedController;
+	uint4 PropertySnapshot;
 
 	/// Non-initializing constructor.
 	EntitySystemParameterIDs() { }
 	/// Constructor.
-	EntitySystemParameterIDs(uint4 worldID, uint4 entityID, uint4 noOverwriteID)
+	EntitySystemParameterIDs(uint4 worldID, uint4 entityID, uint4 noOverwriteID, uint4 stagedEntityID, uint4 stagedControllerID,
+		uint4 propertySnapshotID)
 			: World(worldID),
 			Entity(entityID),
-			NoOverwrite(noOverwriteID) { }
+			NoOverwrite(noOverwriteID),
+			StagedEntity(stagedEntityID),
+			StagedController(stagedControllerID),
+			PropertySnapshot(propertySnapshotID) { }
 };
 
 /// Scene parameters.
@@ -51,6 +65,38 @@ struct EntitySystemParameters
 			Entity(pEntity) { }
 };
 
+/// Entity properties parsed ahead of loading the next entity.
+struct StagedEntity
+{
+	const StagedEntityProperties *Properties;	///< Staged properties, nullptr if none.
+	uint4 Index;								///< Index of the staged entity.
+
+	/// Default constructor.
+	StagedEntity()
+		: Properties(), Index() { }
+	/// Constructor.
+	StagedEntity(const StagedEntityProperties *pProperties, uint4 idx)
+		: Properties(pProperties),
+		Index(idx) { }
+};
+
+/// Controller properties parsed ahead of loading the next controller.
+struct StagedController
+{
+	const StagedEntityProperties *Properties;	///< Staged properties, nullptr if none.
+	uint4 EntityIndex;							///< Index of the staged entity.
+	uint4 Index;								///< Index of the controller in the staged entity.
+
+	/// Default constructor.
+	StagedController()
+		: Properties(), EntityIndex(), Index() { }
+	/// Constructor.
+	StagedController(const StagedEntityProperties *pProperties, uint4 entityIdx, uint4 idx)
+		: Properties(pProperties),
+		EntityIndex(entityIdx),
+		Index(idx) { }
+};
+
 /// Gets the serialization parameter IDs.
 BE_ENTITYSYSTEM_API const EntitySystemParameterIDs& GetEntitySystemParameterIDs();
 
@@ -69,6 +115,21 @@ BE_ENTITYSYSTEM_API void SetNoOverwriteParameter(beCore::ParameterSet &parameter
 /// Gets the given entity system parameters in the given parameter set.
 BE_ENTITYSYSTEM_API  bool GetNoOverwriteParameter(const beCore::ParameterSet &parameters);
 
+/// Sets the properties staged for the next entity to be loaded in the given parameter set.
+BE_ENTITYSYSTEM_API void SetStagedEntityParameter(beCore::ParameterSet &parameters, const StagedEntity &stagedEntity);
+/// Gets the properties staged for the next entity to be loaded in the given parameter set.
+BE_ENTITYSYSTEM_API StagedEntity GetStagedEntityParameter(const beCore::ParameterSet &parameters);
+
+/// Sets the properties staged for the next controller to be loaded in the given parameter set.
+BE_ENTITYSYSTEM_API void SetStagedControllerParameter(beCore::ParameterSet &parameters, const StagedController &stagedController);
+/// Gets the properties staged for the next controller to be loaded in the given parameter set.
+BE_ENTITYSYSTEM_API StagedController GetStagedControllerParameter(const beCore::ParameterSet &parameters);
+
+/// Sets the snapshot that properties are captured in instead of being saved right away in the given parameter set.
+BE_ENTITYSYSTEM_API void SetPropertySnapshotParameter(beCore::ParameterSet &parameters, beCore::PropertySnapshot *pSnapshot);
+/// Gets the snapshot that properties are captured in instead of being saved right away in the given parameter set.
+BE_ENTITYSYSTEM_API beCore::PropertySnapshot* GetPropertySnapshotParameter(const beCore::ParameterSet &parameters);
+
 } // namespace
 
 #endif
\ No newline at end of file
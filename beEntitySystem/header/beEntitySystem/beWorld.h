@@ -20,6 +20,9 @@
 namespace beCore
 {
 	class ParameterSet;
+	class XMLStreamWriter;
+	class PropertySnapshot;
+	class ThreadPool;
 }
 
 namespace beEntitySystem
@@ -29,16 +32,19 @@ namespace beEntitySystem
 class Entity;
 class Entities;
 class Assets;
+class WorldSnapshot;
 
 /// World description.
 struct WorldDesc
 {
 	// TODO: Remove
 	int4 CellSize;		///< Size of one world cell.
+	beCore::ThreadPool *LoadPool;	///< Pool entities are parsed on when loading, nullptr for serial loading.
 
 	/// Constructor.
-	WorldDesc(int4 cellSize = 10000)
-		: CellSize(cellSize) { }
+	WorldDesc(int4 cellSize = 10000, beCore::ThreadPool *pLoadPool = nullptr)
+		: CellSize(cellSize),
+		LoadPool(pLoadPool) { }
 };
 
 /// World class.
@@ -49,20 +55,25 @@ private:
 	WorldDesc m_desc;
 	
 	beCore::PersistentIDs m_persistentIDs;
+	uint8 m_saveID;
 
 	lean::scoped_ptr<Entities> m_entities;
 	lean::scoped_ptr<WorldControllers> m_controllers;
 //	lean::scoped_ptr<Assets> m_assets;
 
-	/// Saves the world to the given xml node.
-	void SaveWorld(rapidxml::xml_node<lean::utf8_t> &node) const;
+	/// Saves the world attributes & all global state to the given xml node, stamped with the given save ID unless 0.
+	void SaveWorldState(rapidxml::xml_node<lean::utf8_t> &node, beCore::ParameterSet &parameters, uint8 saveID) const;
+	/// Saves the world to the given xml node, capturing properties in the given snapshot rather than saving them, if any.
+	void SaveWorld(rapidxml::xml_node<lean::utf8_t> &node, beCore::PropertySnapshot *pProperties = nullptr) const;
+	/// Saves the world to the given XML stream, stamped with the given save ID unless 0.
+	void SaveWorld(beCore::XMLStreamWriter &writer, uint8 saveID = 0) const;
 	/// Loads the world from the given xml node.
 	void LoadWorld(const rapidxml::xml_node<lean::utf8_t> &node, beCore::ParameterSet &parameters);
 
 public:
 	/// Creates an empty world.
 	BE_ENTITYSYSTEM_API explicit World(const utf8_ntri &name, lean::move_ptr<WorldControllers> pControllers = nullptr, const WorldDesc &desc = WorldDesc());
-	/// Loads the world from the given file.
+	/// Loads the world from the given file, either XML or binary.
 	BE_ENTITYSYSTEM_API explicit World(const utf8_ntri &name, const utf8_ntri &file, beCore::ParameterSet &parameters, lean::move_ptr<WorldControllers> pControllers = nullptr, const WorldDesc &desc = WorldDesc());
 	/// Loads the world from the given XML node.
 	BE_ENTITYSYSTEM_API explicit World(const utf8_ntri &name, const rapidxml::xml_node<lean::utf8_t> &node, beCore::ParameterSet &parameters, lean::move_ptr<WorldControllers> pControllers = nullptr, const WorldDesc &desc = WorldDesc());
@@ -87,16 +98,37 @@ public:
 	/// Gets the asset manager.
 //	BE_ENTITYSYSTEM_API const beEntitySystem::Assets& Assets() const{ return *m_assets; }
 
-	/// Saves the world to the given file.
-	BE_ENTITYSYSTEM_API void Serialize(const lean::utf8_ntri &file) const;
+	/// Saves the world to the given file. The file is not stamped as a base file, no deltas are written until the next
+	/// call to SerializeBase(), as the file might have replaced the base file.
+	BE_ENTITYSYSTEM_API void Serialize(const lean::utf8_ntri &file);
+	/// Saves the world to the given file in binary form. The file is not stamped as a base file, no deltas are written
+	/// until the next call to SerializeBase(), as the file might have replaced the base file.
+	BE_ENTITYSYSTEM_API void SerializeBinary(const lean::utf8_ntri &file);
 	/// Saves the world to the given XML node.
 	BE_ENTITYSYSTEM_API void Serialize(rapidxml::xml_node<lean::utf8_t> &node) const;
+	/// Replaces the given snapshot by a snapshot of the current state of this world, which may then be written to file
+	/// on any thread. Only copies raw property values, deferring the bulk of the serialization work.
+	BE_ENTITYSYSTEM_API void Snapshot(WorldSnapshot &snapshot) const;
+	/// Saves the world to the given file in full, stamped with a new save ID, & marks the world saved. All deltas
+	/// written afterwards refer to this save, deltas written before no longer apply to the given file.
+	BE_ENTITYSYSTEM_API void SerializeBase(const lean::utf8_ntri &file);
+	/// Appends all entity changes since the last save to the given delta file & marks the world saved. Returns false
+	/// without writing anything if the changes cannot be identified by persistent IDs or if the world was neither
+	/// loaded from nor saved to a stamped base file, a full save is required then. Deltas are stamped with the save ID
+	/// of the base file & only apply to that file, see SerializeBase() & CompactWorld().
+	BE_ENTITYSYSTEM_API bool SerializeDelta(const lean::utf8_ntri &deltaFile);
+	/// Marks the world saved, e.g. after a full save. Any previous delta file no longer applies, no deltas are written
+	/// until the next call to SerializeBase().
+	BE_ENTITYSYSTEM_API void MarkSaved();
 
 	/// Gets the world's persistent IDs.
 	LEAN_INLINE beCore::PersistentIDs& PersistentIDs() { return m_persistentIDs; }
 	/// Gets the world's persistent IDs.
 	LEAN_INLINE const beCore::PersistentIDs& PersistentIDs() const { return m_persistentIDs; }
 
+	/// Gets the save ID of the base file deltas are written for, 0 if none.
+	LEAN_INLINE uint8 GetSaveID() const { return m_saveID; }
+
 	/// Gets the world's cell size.
 	LEAN_INLINE int4 GetCellSize() { return m_desc.CellSize; }
 
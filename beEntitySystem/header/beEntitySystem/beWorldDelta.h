@@ -0,0 +1,45 @@
+/************************************************************/
+/* breeze Engine Entity System Module  (c) Tobias Zirr 2011 */
+/************************************************************/
+
+#pragma once
+#ifndef BE_ENTITYSYSTEM_WORLDDELTA
+#define BE_ENTITYSYSTEM_WORLDDELTA
+
+#include "beEntitySystem.h"
+#include <lean/rapidxml/rapidxml.hpp>
+
+namespace beEntitySystem
+{
+
+class World;
+
+/// Gets a new save ID identifying a full save, never 0 & always greater than the given previous save ID.
+BE_ENTITYSYSTEM_API uint8 NewWorldSaveID(uint8 prevSaveID);
+
+/// Applies the given world delta node to the given world node. Entity records replace those of equal persistent ID
+/// or are appended, removed entities are erased. Named resources replace those of equal name, other sections are
+/// replaced as a whole. Nodes are cloned, strings are shared with the given delta node.
+BE_ENTITYSYSTEM_API void ApplyWorldDelta(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_node<utf8_t> &deltaNode);
+/// Applies all world delta nodes in the given document to the given world node, in order. Deltas not stamped with the
+/// save ID of the given world, e.g. deltas written before the last full save, are skipped. Returns the number of deltas
+/// applied.
+BE_ENTITYSYSTEM_API uint4 ApplyWorldDeltas(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_document<utf8_t> &deltaDocument);
+
+/// Merges all deltas in the given delta file into the given world file, writing a full world to the given output file.
+/// Output is binary if the given world file is binary, XML otherwise. Output may overwrite the world file, existing
+/// output is only replaced once complete. Output is stamped with a new save ID if any deltas were applied, the given
+/// delta file no longer applies to it then.
+BE_ENTITYSYSTEM_API uint4 CompactWorld(const utf8_ntri &worldFile, const utf8_ntri &deltaFile, const utf8_ntri &outputFile);
+
+/// Checks if the given world is equivalent to the given reference world, i.e. contains the same attributes, the same
+/// entities in the same order & the same sections, ignoring the order of sections & of named resources. Named resources
+/// only present in the given world are ignored, as deltas never remove resources.
+BE_ENTITYSYSTEM_API bool WorldsEquivalent(const rapidxml::xml_node<utf8_t> &world, const rapidxml::xml_node<utf8_t> &referenceWorld);
+/// Checks if applying the given delta file to the given world file yields a world equivalent to a full save of the
+/// given world, i.e. if the world was saved correctly by SerializeBase() & SerializeDelta(). Expensive, for validation.
+BE_ENTITYSYSTEM_API bool WorldDeltasEquivalent(const World &world, const utf8_ntri &worldFile, const utf8_ntri &deltaFile);
+
+} // namespace
+
+#endif
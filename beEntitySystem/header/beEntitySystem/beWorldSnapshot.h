@@ -0,0 +1,62 @@
+/************************************************************/
+/* breeze Engine Entity System Module  (c) Tobias Zirr 2011 */
+/************************************************************/
+
+#pragma once
+#ifndef BE_ENTITYSYSTEM_WORLDSNAPSHOT
+#define BE_ENTITYSYSTEM_WORLDSNAPSHOT
+
+#include "beEntitySystem.h"
+#include <lean/tags/noncopyable.h>
+#include <lean/pimpl/pimpl_ptr.h>
+#include <lean/rapidxml/rapidxml.hpp>
+
+// Prototypes
+namespace beCore
+{
+	class PropertySnapshot;
+}
+
+namespace beEntitySystem
+{
+
+/// Immutable copy of the saved state of a world, see World::Snapshot(). Taking a snapshot only copies the structure
+/// of the world & raw property values, formatting & writing to file may then happen on any other thread while the
+/// world keeps changing.
+class WorldSnapshot : public lean::noncopyable
+{
+public:
+	struct M;
+
+private:
+	lean::pimpl_ptr<M> m;
+
+public:
+	/// Constructs an empty snapshot.
+	BE_ENTITYSYSTEM_API WorldSnapshot();
+	/// Destructor.
+	BE_ENTITYSYSTEM_API ~WorldSnapshot();
+
+	/// Writes the snapshot to the given file. Output matches World::Serialize(). Not thread-safe, but may be called
+	/// on any thread once the snapshot has been taken.
+	BE_ENTITYSYSTEM_API void Serialize(const utf8_ntri &file);
+	/// Writes the snapshot to the given file in binary form. Output matches World::SerializeBinary(). Not thread-safe,
+	/// but may be called on any thread once the snapshot has been taken.
+	BE_ENTITYSYSTEM_API void SerializeBinary(const utf8_ntri &file);
+
+	/// Releases all snapshot data.
+	BE_ENTITYSYSTEM_API void Clear();
+	/// Checks if a snapshot has been taken.
+	BE_ENTITYSYSTEM_API bool IsEmpty() const;
+
+	/// Gets the snapshot document.
+	BE_ENTITYSYSTEM_API rapidxml::xml_document<utf8_t>& Document();
+	/// Gets the property values captured but not yet written to the snapshot document.
+	BE_ENTITYSYSTEM_API beCore::PropertySnapshot& Properties();
+	/// Gets the property values captured but not yet written to the snapshot document.
+	BE_ENTITYSYSTEM_API const beCore::PropertySnapshot& Properties() const;
+};
+
+} // namespace
+
+#endif
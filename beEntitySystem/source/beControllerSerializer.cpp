@@ -6,7 +6,11 @@
 #include "beEntitySystem/beControllerSerializer.h"
 #include "beEntitySystem/beController.h"
 
+#include "beEntitySystem/beSerializationParameters.h"
+#include "beEntitySystem/beEntitySerializer.h"
+
 #include <beCore/bePropertySerialization.h>
+#include <beCore/bePropertySnapshot.h>
 
 namespace beEntitySystem
 {
@@ -27,10 +31,17 @@ void ControllerSerializer::Load(Controller *pController, const rapidxml::xml_nod
 								beCore::ParameterSet &parameters,
 								beCore::SerializationQueue<beCore::LoadJob> &queue) const
 {
+	// NOTE: Staged properties only valid for this controller, not for any controllers loaded by it
+	StagedController stagedController = GetStagedControllerParameter(parameters);
+	if (stagedController.Properties)
+		SetStagedControllerParameter(parameters, StagedController());
+
 	ComponentSerializer<Controller>::Load(pController, node, parameters, queue);
 
 	// Properties
-	LoadProperties(*pController, node);
+	if (!stagedController.Properties
+		|| !stagedController.Properties->ApplyController(stagedController.EntityIndex, stagedController.Index, *pController))
+		LoadProperties(*pController, node);
 }
 
 // Saves the given controller to the given XML node.
@@ -43,7 +54,10 @@ void ControllerSerializer::Save(const Controller *pController, rapidxml::xml_nod
 	ComponentSerializer<Controller>::Save(pController, node, parameters, queue);
 
 	// Properties
-	SaveProperties(*pController, node);
+	if (beCore::PropertySnapshot *pSnapshot = GetPropertySnapshotParameter(parameters))
+		pSnapshot->CaptureProperties(*pController, node);
+	else
+		SaveProperties(*pController, node);
 }
 
 } // namespace
\ No newline at end of file
@@ -86,11 +86,13 @@ public:
 		bool Attached : 1;
 		bool Visible : 1;
 		bool Serialized : 1;
+		bool Modified : 1;
 
 		State()
 			: Attached(true),
 			Visible(true),
-			Serialized(true) { }
+			Serialized(true),
+			Modified(true) { }
 	};
 
 	struct ChangedFlags
@@ -174,11 +176,24 @@ public:
 	lvec3 nextPositionBase;
 	bool positionBaseChanged;
 
+	typedef std::vector<uint8> persistent_id_vector;
+	persistent_id_vector removedSinceSave;
+	bool anonymousRemovedSinceSave;
+
+	// Persistent IDs reserved in bulk for entities being loaded
+	uint4 expectedEntityCount;
+	uint8 reservedIDBegin;
+	uint8 reservedIDEnd;
+
 	M(beCore::PersistentIDs *persistentIDs)
 		: persistentIDs( LEAN_ASSERT_NOT_NULL(persistentIDs) ),
 		customBaseID(0),
 		positionBase(0),
-		positionBaseChanged(false) { }
+		positionBaseChanged(false),
+		anonymousRemovedSinceSave(false),
+		expectedEntityCount(0),
+		reservedIDBegin(0),
+		reservedIDEnd(0) { }
 
 	/// Gets the number of child components.
 	uint4 GetComponentCount() const
@@ -210,10 +225,19 @@ public:
 namespace
 {
 
+LEAN_INLINE void ScheduleSave(Entities::M &m, uint4 internalIdx)
+{
+	LEAN_FREE_PIMPL(Entities);
+	m.entities(M::state)[internalIdx].Modified = true;
+}
+
 void ScheduleFlush(Entities::M &m, uint4 internalIdx)
 {
 	LEAN_FREE_PIMPL(Entities);
 
+	// NOTE: Any change implies flush, outlives flushing until saved
+	ScheduleSave(m, internalIdx);
+
 	uint1 &changed = m.entities(M::changedFlags)[internalIdx];
 	if (!changed)
 	{
@@ -239,6 +263,30 @@ void ScheduleSync(Entities::M &m, uint4 internalIdx)
 	}
 }
 
+/// Gets a new persistent ID, reserving IDs for all entities still expected at once.
+uint8 GetNewPersistentID(Entities::M &m)
+{
+	if (m.reservedIDBegin == m.reservedIDEnd && m.expectedEntityCount > 0)
+	{
+		// NOTE: Requesting entity no longer counted as expected
+		uint4 idCount = m.expectedEntityCount + 1;
+		m.reservedIDBegin = m.persistentIDs->ReserveIDs(idCount);
+		m.reservedIDEnd = m.reservedIDBegin + idCount;
+		m.expectedEntityCount = 0;
+	}
+
+	// NOTE: Stored IDs loaded since may have taken reserved IDs
+	while (m.reservedIDBegin < m.reservedIDEnd)
+	{
+		uint8 persistentID = m.reservedIDBegin++;
+
+		if (!m.persistentIDs->IsReferenced(persistentID))
+			return persistentID;
+	}
+
+	return m.persistentIDs->ReserveID();
+}
+
 } // namespace
 
 // Creates a collection of entities.
@@ -252,8 +300,11 @@ Entity* Entities::AddEntity(utf8_ntri name, uint8 persistentID)
 {
 	LEAN_STATIC_PIMPL();
 
+	if (m.expectedEntityCount > 0)
+		--m.expectedEntityCount;
+
 	if (persistentID == NewPersistentID)
-		persistentID = m.persistentIDs->ReserveID();
+		persistentID = GetNewPersistentID(m);
 
 	// Create tracking handle
 	uint4 internalIdx = static_cast<uint4>(m.entities.size());
@@ -342,6 +393,12 @@ void Entities::RemoveEntity(Entity *pEntity)
 		if (reg.pOwner)
 			SetOwner(entity, nullptr);
 
+		// Keep track of removal for incremental saves
+		if (reg.PersistentID != AnonymousPersistentID)
+			m.removedSinceSave.push_back(reg.PersistentID);
+		else if (m.entities(M::state)[entity.Index].Serialized)
+			m.anonymousRemovedSinceSave = true;
+
 		// Remove persistent entity
 		m.persistentIDs->UnsetReference(reg.PersistentID, pEntity);
 	}
@@ -373,6 +430,40 @@ void Entities::Reserve(uint4 entityCount)
 	m.controllerPool.reserve(entityCount + entityCount / 2);
 }
 
+// Expects the given number of entities to be added next.
+void Entities::ReservePersistentIDs(uint4 entityCount)
+{
+	LEAN_STATIC_PIMPL();
+
+	ReleasePersistentIDs();
+	// NOTE: IDs reserved on first demand, entities added with existing IDs need none
+	m.expectedEntityCount = entityCount;
+}
+
+// Releases all persistent IDs reserved in bulk that have not been handed out yet.
+void Entities::ReleasePersistentIDs()
+{
+	LEAN_STATIC_PIMPL();
+
+	// NOTE: Never handed out, never saved, but stored IDs loaded since may have taken some
+	while (m.reservedIDBegin < m.reservedIDEnd)
+	{
+		uint8 unusedEnd = m.reservedIDBegin;
+
+		while (unusedEnd < m.reservedIDEnd && !m.persistentIDs->IsReferenced(unusedEnd))
+			++unusedEnd;
+
+		if (m.reservedIDBegin < unusedEnd)
+			m.persistentIDs->ReleaseIDs(m.reservedIDBegin, unusedEnd);
+
+		// Skip taken ID
+		m.reservedIDBegin = unusedEnd + 1;
+	}
+
+	m.reservedIDBegin = m.reservedIDEnd = 0;
+	m.expectedEntityCount = 0;
+}
+
 // Gets all entities.
 Entities::Range Entities::GetEntities()
 {
@@ -535,6 +626,9 @@ void Entities::RemoveControllers(EntityHandle entity, EntityController *const* r
 		m.entities(M::controllers)[internalIdx].Begin -= removedCount;
 		m.entities(M::controllers)[internalIdx].End -= removedCount;
 	}
+
+	if (removedCount)
+		ScheduleSave(m, entity.Index);
 }
 
 // Gets all controllers.
@@ -563,9 +657,12 @@ EntityController* Entities::GetController(const EntityHandle entity, const beCor
 namespace
 {
 
-void PropertyChanged(const Entities::M &m, uint4 internalIdx)
+void PropertyChanged(Entities::M &m, uint4 internalIdx)
 {
 	LEAN_FREE_PIMPL(Entities);
+
+	ScheduleSave(m, internalIdx);
+
 	const bec::ComponentObserverCollection &observers = m.entities(M::observers)[internalIdx];
 
 	if (observers.HasObservers())
@@ -870,7 +967,17 @@ bool Entities::IsVisible(const EntityHandle entity)
 void Entities::SetSerialized(EntityHandle entity, bool bSerialized)
 {
 	BE_STATIC_PIMPL_HANDLE(entity);
-	m.entities(M::state)[entity.Index].Serialized = bSerialized;
+	M::State &state = m.entities(M::state)[entity.Index];
+
+	if (bSerialized != state.Serialized)
+	{
+		// NOTE: Entities no longer serialized need to be removed from incremental saves
+		if (state.Serialized && m.entities(M::registry)[entity.Index].PersistentID == AnonymousPersistentID)
+			m.anonymousRemovedSinceSave = true;
+
+		state.Serialized = bSerialized;
+		ScheduleSave(m, entity.Index);
+	}
 }
 
 // Gets whether the entity is serialized.
@@ -972,6 +1079,7 @@ void Entities::Detach(EntityHandle entity)
 			m.controllerPool[controllers.End]->Detach(handle);
 
 		state.Attached = false;
+		ScheduleSave(m, entity.Index);
 	}
 }
 // Checks whether the given entity is attached.
@@ -1002,7 +1110,7 @@ void Entities::SetPersistentID(EntityHandle entity, uint8 persistentID)
 	M::Registry &entityReg = m.entities[entity.Index];
 
 	if (persistentID == NewPersistentID)
-		persistentID = m.persistentIDs->ReserveID();
+		persistentID = GetNewPersistentID(m);
 
 	if (persistentID != entityReg.PersistentID)
 	{
@@ -1015,6 +1123,14 @@ void Entities::SetPersistentID(EntityHandle entity, uint8 persistentID)
 			uint8 oldPersistentID = entityReg.PersistentID;
 			entityReg.PersistentID = persistentID;
 			m.persistentIDs->UnsetReference(oldPersistentID, handle);
+
+			// Keep track of the old ID for incremental saves
+			if (oldPersistentID != AnonymousPersistentID)
+				m.removedSinceSave.push_back(oldPersistentID);
+			else if (m.entities(M::state)[entity.Index].Serialized)
+				m.anonymousRemovedSinceSave = true;
+
+			ScheduleSave(m, entity.Index);
 		}
 		else
 			LEAN_LOG_ERROR_CTX("Persistent entity ID collision", entityReg.Name.c_str());
@@ -1027,6 +1143,49 @@ uint8 Entities::GetPersistentID(const EntityHandle entity)
 	return m.entities(M::registry)[entity.Index].PersistentID;
 }
 
+// Marks the given entity as modified since the last save.
+void Entities::MarkModified(EntityHandle entity)
+{
+	BE_STATIC_PIMPL_HANDLE(entity);
+	ScheduleSave(m, entity.Index);
+}
+
+// Checks if the given entity has been modified since the last save.
+bool Entities::IsModified(const EntityHandle entity)
+{
+	BE_STATIC_PIMPL_HANDLE_CONST(entity);
+	return m.entities(M::state)[entity.Index].Modified;
+}
+
+// Gets the persistent IDs of all entities removed since the last save.
+Entities::PersistentIDRange Entities::GetRemovedSinceSave() const
+{
+	LEAN_STATIC_PIMPL_CONST();
+	return beCore::MakeRangeN<PersistentIDRange::index_type>(
+			(m.removedSinceSave.empty()) ? nullptr : &m.removedSinceSave[0],
+			m.removedSinceSave.size()
+		);
+}
+
+// Checks if changes since the last save cannot be identified by persistent IDs.
+bool Entities::RequiresFullSave() const
+{
+	LEAN_STATIC_PIMPL_CONST();
+	return m.anonymousRemovedSinceSave;
+}
+
+// Marks all entities as saved.
+void Entities::MarkSaved()
+{
+	LEAN_STATIC_PIMPL();
+
+	for (uint4 internalIdx = 0, entityCount = (uint4) m.entities.size(); internalIdx < entityCount; ++internalIdx)
+		m.entities(M::state)[internalIdx].Modified = false;
+
+	m.removedSinceSave.clear();
+	m.anonymousRemovedSinceSave = false;
+}
+
 // Sets the custom ID.
 void Entities::SetCustomIDBase(uint4 baseID)
 {
@@ -11,6 +11,10 @@
 #include "beEntitySystem/beSerialization.h"
 #include "beEntitySystem/beSerializationTasks.h"
 
+#include <beCore/beParallel.h>
+#include <beCore/beXMLStreamWriter.h>
+#include <vector>
+
 #include <lean/xml/utility.h>
 #include <lean/smart/scoped_ptr.h>
 #include <lean/logging/errors.h>
@@ -65,6 +69,151 @@ void SaveEntities(const Entity *const *entities, uint4 entityCount, rapidxml::xm
 		pPrivateSaveJobs->Save(parentNode, *pParameters);
 }
 
+// Saves the given number of entities to the given XML stream.
+void SaveEntities(const Entity *const *entities, uint4 entityCount, beCore::XMLStreamWriter &writer,
+				  beCore::ParameterSet *pParameters, beCore::SaveJobs *pQueue)
+{
+	rapidxml::xml_document<utf8_t> &document = writer.Scratch();
+
+	writer.BeginElement( *lean::allocate_node<utf8_t>(document, "entities") );
+	writer.ClearScratch();
+
+	lean::scoped_ptr<beCore::ParameterSet> pPrivateParameters;
+
+	if (!pParameters)
+	{
+		pPrivateParameters = new beCore::ParameterSet(&GetSerializationParameters());
+		pParameters = pPrivateParameters.get();
+	}
+
+	lean::scoped_ptr<beCore::SaveJobs> pPrivateSaveJobs;
+
+	if (!pQueue)
+	{
+		pPrivateSaveJobs = new beCore::SaveJobs();
+		pQueue = pPrivateSaveJobs.get();
+	}
+
+	const EntitySerialization &entitySerialization = GetEntitySerialization();
+
+	for (const Entity *const *itEntity = entities, *const *itEntityEnd = entities + entityCount; itEntity < itEntityEnd; ++itEntity)
+	{
+		const Entity *entity = *itEntity;
+
+		if (entity->IsAttached() && entity->IsSerialized())
+		{
+			rapidxml::xml_node<utf8_t> &entityNode = *lean::allocate_node<utf8_t>(document, "e");
+			// ORDER: Append FIRST, otherwise parent document == nullptr
+			document.append_node(&entityNode);
+
+			entitySerialization.Save(entity, entityNode, *pParameters, *pQueue);
+
+			writer.WriteNode(entityNode);
+			// NOTE: Memory bounded by the largest entity rather than the number of entities
+			writer.ClearScratch();
+		}
+	}
+
+	writer.EndElement();
+
+	// Execute any additionally scheduled save jobs
+	if (pPrivateSaveJobs)
+	{
+		// NOTE: Save jobs only ever append to their root, stream whatever was appended
+		rapidxml::xml_node<utf8_t> &jobRoot = *lean::allocate_node<utf8_t>(document, "_");
+		// ORDER: Append FIRST, otherwise parent document == nullptr
+		document.append_node(&jobRoot);
+
+		pPrivateSaveJobs->Save(jobRoot, *pParameters);
+
+		writer.WriteChildren(jobRoot);
+		writer.ClearScratch();
+	}
+}
+
+namespace
+{
+
+/// Number of entities parsed per batch.
+const uint4 EntityBatchSize = 256;
+
+/// Loads the entity stored in the given xml node.
+void LoadEntity(const EntitySerialization &entitySerialization, const rapidxml::xml_node<utf8_t> &entityNode,
+				beCore::ParameterSet &parameters, beCore::LoadJobs &queue, EntityInserter *pInserter)
+{
+	lean::scoped_ptr<Entity> pEntity = entitySerialization.Load(entityNode, parameters, queue);
+
+	if (pEntity)
+	{
+		if (pInserter)
+			pInserter->Add(pEntity);
+
+		// Success
+		pEntity.detach();
+	}
+	else
+		LEAN_LOG_ERROR_CTX("LoadEntities()", EntitySerializer::GetName(entityNode));
+}
+
+/// Parses the entity & controller properties of batches of entities.
+class EntityPropertyParser : public beCore::ParallelBody
+{
+private:
+	const rapidxml::xml_node<utf8_t> *const *m_entityNodes;
+	StagedEntityProperties *m_batches;
+
+public:
+	/// Constructor.
+	EntityPropertyParser(const rapidxml::xml_node<utf8_t> *const *entityNodes, StagedEntityProperties *batches)
+		: m_entityNodes(entityNodes),
+		m_batches(batches) { }
+
+	/// Parses the given batch.
+	void Run(uint4 chunkIdx, beCore::Range<uint4> chunk)
+	{
+		StagedEntityProperties &batch = m_batches[chunkIdx];
+
+		for (uint4 i = chunk.Begin; i < chunk.End; ++i)
+			batch.Parse(*m_entityNodes[i]);
+	}
+};
+
+/// Reserves persistent IDs for the given number of entities to be loaded, releasing those not handed out on destruction.
+struct PersistentIDReservation
+{
+	Entities &entities;
+
+	/// Constructor.
+	PersistentIDReservation(Entities &entities, uint4 entityCount)
+		: entities(entities)
+	{
+		entities.ReservePersistentIDs(entityCount);
+	}
+	/// Destructor.
+	~PersistentIDReservation()
+	{
+		entities.ReleasePersistentIDs();
+	}
+};
+
+/// Resets the staged entity & controller parameters on destruction.
+struct StagedEntityGuard
+{
+	beCore::ParameterSet &parameters;
+
+	/// Constructor.
+	StagedEntityGuard(beCore::ParameterSet &parameters)
+		: parameters(parameters) { }
+	/// Destructor.
+	~StagedEntityGuard()
+	{
+		SetStagedEntityParameter(parameters, StagedEntity());
+		SetStagedControllerParameter(parameters, StagedController());
+	}
+};
+
+} // namespace
+
 // Loads all entities from the given xml node.
 void LoadEntities(Entities *entities, const rapidxml::xml_node<lean::utf8_t> &parentNode,
 				  beCore::ParameterSet &parameters, beCore::LoadJobs *pQueue, EntityInserter *pInserter)
@@ -87,21 +236,80 @@ void LoadEntities(Entities *entities, const rapidxml::xml_node<lean::utf8_t> &pa
 		if (pInserter)
 			pInserter->Reserve(predictedCount);
 
+		PersistentIDReservation persistentIDs(*entities, predictedCount);
+
 		for (const rapidxml::xml_node<utf8_t> *pEntityNode = pEntitiesNode->first_node();
 			pEntityNode; pEntityNode = pEntityNode->next_sibling())
+			LoadEntity(entitySerialization, *pEntityNode, parameters, *pQueue, pInserter);
+	}
+
+	// Execute any additionally scheduled load jobs
+	if (pPrivateLoadJobs)
+		pPrivateLoadJobs->Load(parentNode, parameters);
+}
+
+// Loads all entities from the given xml node, parsing entity properties in parallel.
+void LoadEntitiesParallel(Entities *entities, const rapidxml::xml_node<lean::utf8_t> &parentNode,
+						  beCore::ParameterSet &parameters, beCore::ThreadPool *pPool, beCore::LoadJobs *pQueue, EntityInserter *pInserter)
+{
+	if (!pPool)
+	{
+		LoadEntities(entities, parentNode, parameters, pQueue, pInserter);
+		return;
+	}
+
+	lean::scoped_ptr<beCore::LoadJobs> pPrivateLoadJobs;
+
+	if (!pQueue)
+	{
+		pPrivateLoadJobs = new beCore::LoadJobs();
+		pQueue = pPrivateLoadJobs.get();
+	}
+
+	const EntitySerialization &entitySerialization = GetEntitySerialization();
+
+	std::vector<const rapidxml::xml_node<utf8_t>*> entityNodes;
+
+	for (const rapidxml::xml_node<utf8_t> *pEntitiesNode = parentNode.first_node("entities");
+		pEntitiesNode; pEntitiesNode = pEntitiesNode->next_sibling("entities"))
+	{
+		uint4 predictedCount = lean::node_count(*pEntitiesNode);
+		entities->Reserve(predictedCount);
+		if (pInserter)
+			pInserter->Reserve(predictedCount);
+
+		entityNodes.reserve(entityNodes.size() + predictedCount);
+
+		for (const rapidxml::xml_node<utf8_t> *pEntityNode = pEntitiesNode->first_node();
+			pEntityNode; pEntityNode = pEntityNode->next_sibling())
+			entityNodes.push_back(pEntityNode);
+	}
+
+	if (!entityNodes.empty())
+	{
+		const beCore::Range<uint4> range(0, static_cast<uint4>(entityNodes.size()));
+		const uint4 batchCount = beCore::GetParallelChunkCount(pPool, range, EntityBatchSize);
+
+		// Parse properties into per-batch staging
+		// NOTE: Controller properties staged per controller type, resources referenced by controllers still loaded by their serializers
+		std::vector<StagedEntityProperties> batches(batchCount);
+		EntityPropertyParser parser(&entityNodes[0], &batches[0]);
+		beCore::ParallelForChunks(pPool, range, EntityBatchSize, parser);
+
+		// NOTE: Never leave staged properties behind, staging destroyed on return
+		StagedEntityGuard stagedEntityGuard(parameters);
+		PersistentIDReservation persistentIDs(*entities, range.End);
+
+		// ORDER: Construct entities & controllers in document order, exactly as loaded serially
+		for (uint4 batchIdx = 0; batchIdx < batchCount; ++batchIdx)
 		{
-			lean::scoped_ptr<Entity> pEntity = entitySerialization.Load(*pEntityNode, parameters, *pQueue);
+			const beCore::Range<uint4> batch = beCore::GetParallelChunk(range, batchCount, batchIdx);
 
-			if (pEntity)
+			for (uint4 i = batch.Begin; i < batch.End; ++i)
 			{
-				if (pInserter)
-					pInserter->Add(pEntity);
-
-				// Success
-				pEntity.detach();
+				SetStagedEntityParameter(parameters, StagedEntity(&batches[batchIdx], i - batch.Begin));
+				LoadEntity(entitySerialization, *entityNodes[i], parameters, *pQueue, pInserter);
 			}
-			else
-				LEAN_LOG_ERROR_CTX("LoadEntities()", EntitySerializer::GetName(*pEntityNode));
 		}
 	}
 
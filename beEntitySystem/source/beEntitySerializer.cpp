@@ -13,12 +13,18 @@
 
 #include "beEntitySystem/beSerializationParameters.h"
 #include <beCore/bePropertySerialization.h>
+#include <beCore/bePropertySnapshot.h>
+#include <beCore/beReflectionProperties.h>
+#include <beCore/beValueType.h>
 #include <beCore/beParameters.h>
 
 #include "beEntitySystem/beSerialization.h"
 
 #include <lean/xml/utility.h>
 #include <lean/logging/errors.h>
+#include <lean/logging/log.h>
+
+#include <cstring>
 
 namespace beEntitySystem
 {
@@ -45,18 +51,27 @@ Entities* GetEntities(const beCore::ParameterSet &parameters)
 
 
 // Loads all controllers from the given xml node.
-void LoadControllers(Entity *entity, const rapidxml::xml_node<lean::utf8_t> &node, 
+void LoadControllers(Entity *entity, const rapidxml::xml_node<lean::utf8_t> &node, const StagedEntity &stagedEntity,
 	beCore::ParameterSet &parameters, beCore::SerializationQueue<beCore::LoadJob> &queue)
 {
 	const EntityControllerSerialization &controllerSerialization = GetEntityControllerSerialization();
+	uint4 controllerIdx = 0;
 
+	// ORDER: Same order as StagedEntityProperties::Parse()
 	for (const rapidxml::xml_node<utf8_t> *pControllersNode = node.first_node("controllers");
 		pControllersNode; pControllersNode = pControllersNode->next_sibling("controllers"))
 		for (const rapidxml::xml_node<utf8_t> *pControllerNode = pControllersNode->first_node();
-			pControllerNode; pControllerNode = pControllerNode->next_sibling())
+			pControllerNode; pControllerNode = pControllerNode->next_sibling(), ++controllerIdx)
 		{
+			if (stagedEntity.Properties)
+				SetStagedControllerParameter(parameters, StagedController(stagedEntity.Properties, stagedEntity.Index, controllerIdx));
+
 			lean::scoped_ptr<EntityController> pController = controllerSerialization.Load(*pControllerNode, parameters, queue);
 
+			// NOTE: Never leave staged properties to controllers that did not consume them
+			if (stagedEntity.Properties)
+				SetStagedControllerParameter(parameters, StagedController());
+
 			if (pController)
 				entity->AddController(pController.move_ptr());
 			else
@@ -106,10 +121,15 @@ lean::scoped_ptr<Entity, lean::critical_ref> EntitySerializer::Create(const beCo
 lean::scoped_ptr<Entity, lean::critical_ref> EntitySerializer::Load(const rapidxml::xml_node<lean::utf8_t> &node,
 	beCore::ParameterSet &parameters, beCore::SerializationQueue<beCore::LoadJob> &queue) const
 {
-	lean::scoped_ptr<Entity> entity( GetEntities(parameters)->AddEntity() );
+	// NOTE: Stored IDs set on load, avoid reserving IDs only to drop them right away
+	lean::scoped_ptr<Entity> entity( GetEntities(parameters)->AddEntity("<unnamed>", Entities::AnonymousPersistentID) );
 	entity->SetName( GetName(node) );
 
 	Load(entity.get(), node, parameters, queue);
+
+	// Entities whose stored IDs collide with existing entities still get new IDs
+	if (entity->GetPersistentID() == Entities::AnonymousPersistentID && EntitySerializer::GetID(node) != Entities::AnonymousPersistentID)
+		entity->SetPersistentID(Entities::NewPersistentID);
 	
 	return entity.transfer();
 }
@@ -122,11 +142,18 @@ void EntitySerializer::Load(Entity *entity, const rapidxml::xml_node<lean::utf8_
 	entity->SetPersistentID( EntitySerializer::GetID(node) );
 
 	// Properties
-	LoadProperties(*entity, node);
+	StagedEntity stagedEntity = GetStagedEntityParameter(parameters);
+
+	// NOTE: Staged properties only valid for this entity, not for any entities loaded by its controllers
+	if (stagedEntity.Properties)
+		SetStagedEntityParameter(parameters, StagedEntity());
+
+	if (!stagedEntity.Properties || !stagedEntity.Properties->Apply(stagedEntity.Index, *entity))
+		LoadProperties(*entity, node);
 
 	// Controllers
 	SetEntityParameter(parameters, entity);
-	LoadControllers(entity, node, parameters, queue);
+	LoadControllers(entity, node, stagedEntity, parameters, queue);
 }
 
 // Saves the given entity object to the given XML node.
@@ -138,12 +165,194 @@ void EntitySerializer::Save(const Entity *entity, rapidxml::xml_node<lean::utf8_
 	SetID(entity->GetPersistentID(), node);
 
 	// Properties
-	SaveProperties(*entity, node);
+	if (beCore::PropertySnapshot *pSnapshot = GetPropertySnapshotParameter(parameters))
+		pSnapshot->CaptureProperties(*entity, node);
+	else
+		SaveProperties(*entity, node);
 	
 	// Controllers
 	SaveControllers(entity, node, parameters, queue);
 }
 
+namespace
+{
+
+/// Writes staged property values.
+struct StagedPropertyWriter : public beCore::PropertyVisitor
+{
+	const void *Data;
+
+	/// Constructor.
+	StagedPropertyWriter(const void *data)
+		: Data(data) { }
+
+	/// Visits the given values.
+	bool Visit(const beCore::PropertyProvider &provider, uint4 propertyID, const beCore::PropertyDesc &desc, void *values) LEAN_OVERRIDE
+	{
+		memcpy(values, Data, desc.TypeDesc->Info.property_type->size(desc.Count));
+		return true;
+	}
+};
+
+} // namespace
+
+// Constructor.
+StagedEntityProperties::StagedEntityProperties()
+{
+}
+
+// Destructor.
+StagedEntityProperties::~StagedEntityProperties()
+{
+}
+
+// Parses the properties stored in the given node, returns the index of the staged object.
+uint4 StagedEntityProperties::ParseObject(const rapidxml::xml_node<lean::utf8_t> &node, beCore::ReflectionPropertyProvider::Properties properties)
+{
+	const uint4 objectIdx = static_cast<uint4>(m_objects.size());
+	const uint4 valuesBegin = static_cast<uint4>(m_values.size());
+	const size_t dataBegin = m_data.size();
+	uint4 propertyCount = static_cast<uint4>(properties.size());
+
+	// NOTE: Matches properties in the same way as LoadProperties(), skipping properties WriteProperty() would skip
+	for (const rapidxml::xml_node<lean::utf8_t> *propertiesNode = node.first_node("properties");
+		propertiesNode; propertiesNode = propertiesNode->next_sibling("properties"))
+		for (const rapidxml::xml_node<lean::utf8_t> *propertyNode = propertiesNode->first_node();
+			propertyNode; propertyNode = propertyNode->next_sibling())
+		{
+			const utf8_t *nodeName = propertyNode->first_attribute() ? propertyNode->first_attribute()->value() : propertyNode->name();
+
+			for (uint4 propertyID = 0; propertyID < propertyCount; ++propertyID)
+			{
+				const beCore::ReflectionProperty &desc = properties[propertyID];
+
+				if (nodeName == utf8_ntr(desc.name))
+				{
+					if (!desc.setter.valid() || !(desc.persistence & beCore::PropertyPersistence::Read))
+						break;
+
+					// NOTE: Values staged bytewise, objects with non-plain persistent properties loaded from XML instead
+					if (!desc.type_info->Plain)
+					{
+						m_values.resize(valuesBegin);
+						m_data.resize(dataBegin);
+						properties = beCore::ReflectionPropertyProvider::Properties();
+						propertyCount = 0;
+						break;
+					}
+
+					const lean::property_type &propertyType = *desc.type_info->Info.property_type;
+					const size_t dataOffset = m_data.size();
+					m_data.resize( dataOffset + (propertyType.size(desc.count) + sizeof(uint8) - 1) / sizeof(uint8) );
+
+					void *values = &m_data[dataOffset];
+					propertyType.construct(values, desc.count);
+
+					// NOTE: Values stored either as text or as typed binary values (see SetBinaryPropertyValues())
+					if (beCore::ReadPropertyValues(*propertyNode, *desc.type_info, values, desc.count))
+					{
+						Value value = { propertyID, static_cast<uint4>(dataOffset) };
+						m_values.push_back(value);
+					}
+					else
+						m_data.resize(dataOffset);
+
+					break;
+				}
+			}
+		}
+
+	Object object = { properties, valuesBegin };
+	m_objects.push_back(object);
+
+	return objectIdx;
+}
+
+// Parses the properties stored in the given entity node & its controller nodes, returns the index of the staged entity.
+uint4 StagedEntityProperties::Parse(const rapidxml::xml_node<lean::utf8_t> &node)
+{
+	const uint4 stagedIdx = static_cast<uint4>(m_entities.size());
+	m_entities.push_back( ParseObject(node, Entity::GetOwnProperties()) );
+
+	const EntityControllerSerialization &controllerSerialization = GetEntityControllerSerialization();
+	const ControllerSerializer *pLastSerializer = nullptr;
+	utf8_ntr lastType("");
+
+	// ORDER: Same order as LoadControllers()
+	for (const rapidxml::xml_node<utf8_t> *pControllersNode = node.first_node("controllers");
+		pControllersNode; pControllersNode = pControllersNode->next_sibling("controllers"))
+		for (const rapidxml::xml_node<utf8_t> *pControllerNode = pControllersNode->first_node();
+			pControllerNode; pControllerNode = pControllerNode->next_sibling())
+		{
+			utf8_ntr type = ControllerSerializer::GetType(*pControllerNode);
+
+			// NOTE: Controllers of one type tend to cluster, look up serializers per run of controller types
+			if (type != lastType)
+			{
+				pLastSerializer = controllerSerialization.GetSerializer(type);
+				lastType = type;
+			}
+
+			// NOTE: Controllers of unknown layout are staged empty & loaded from XML
+			ParseObject(*pControllerNode, (pLastSerializer) ? pLastSerializer->GetControllerProperties() : Controller::Properties());
+		}
+
+	return stagedIdx;
+}
+
+// Writes the property values of the given staged object to the given provider.
+bool StagedEntityProperties::ApplyObject(uint4 objectIdx, beCore::ReflectionPropertyProvider &provider) const
+{
+	LEAN_ASSERT(objectIdx < m_objects.size());
+
+	const Object &object = m_objects[objectIdx];
+	beCore::ReflectionPropertyProvider::Properties properties = provider.GetReflectionProperties();
+
+	// NOTE: Property IDs only valid for the exact properties staged for
+	if (object.Properties.empty() || object.Properties.begin() != properties.begin() || object.Properties.size() != properties.size())
+		return false;
+
+	const uint4 valuesEnd = (objectIdx + 1 < m_objects.size()) ? m_objects[objectIdx + 1].Values : static_cast<uint4>(m_values.size());
+
+	for (uint4 i = object.Values; i < valuesEnd; ++i)
+	{
+		const Value &value = m_values[i];
+		StagedPropertyWriter writer(&m_data[value.Offset]);
+		provider.WriteProperty(value.PropertyID, writer, beCore::PropertyVisitFlags::PersistentOnly);
+	}
+
+	return true;
+}
+
+// Writes the property values of the given staged entity to the given entity.
+bool StagedEntityProperties::Apply(uint4 stagedIdx, Entity &entity) const
+{
+	LEAN_ASSERT(stagedIdx < m_entities.size());
+
+	return ApplyObject(m_entities[stagedIdx], entity);
+}
+
+// Writes the property values of the given controller of the given staged entity to the given controller.
+bool StagedEntityProperties::ApplyController(uint4 stagedIdx, uint4 controllerIdx, Controller &controller) const
+{
+	LEAN_ASSERT(stagedIdx < m_entities.size());
+
+	// Controllers staged right behind their entity
+	const uint4 objectIdx = m_entities[stagedIdx] + 1 + controllerIdx;
+	const uint4 objectEnd = (stagedIdx + 1 < m_entities.size()) ? m_entities[stagedIdx + 1] : static_cast<uint4>(m_objects.size());
+
+	return objectIdx < objectEnd && ApplyObject(objectIdx, controller);
+}
+
+// Removes all staged entities.
+void StagedEntityProperties::Clear()
+{
+	m_values.clear();
+	m_data.clear();
+	m_objects.clear();
+	m_entities.clear();
+}
+
 namespace
 {
 	
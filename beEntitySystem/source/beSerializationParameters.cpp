@@ -23,7 +23,10 @@ const EntitySystemParameterIDs& GetEntitySystemParameterIDs()
 	static EntitySystemParameterIDs parameterIDs(
 			layout.Add("beEntitySystem.World"),
 			layout.Add("beEntitySystem.Entity"),
-			layout.Add("beEntitySystem.NoOverwrite")
+			layout.Add("beEntitySystem.NoOverwrite"),
+			layout.Add("beEntitySystem.StagedEntity"),
+			layout.Add("beEntitySystem.StagedController"),
+			layout.Add("beEntitySystem.PropertySnapshot")
 		);
 
 	return parameterIDs;
@@ -89,5 +92,59 @@ bool GetNoOverwriteParameter(const beCore::ParameterSet &parameters)
 	return parameters.GetValueDefault< bool >(layout, parameterIDs.NoOverwrite, false);
 }
 
+// Sets the properties staged for the next entity to be loaded in the given parameter set.
+void SetStagedEntityParameter(beCore::ParameterSet &parameters, const StagedEntity &stagedEntity)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	parameters.SetValue(layout, parameterIDs.StagedEntity, stagedEntity);
+}
+
+// Gets the properties staged for the next entity to be loaded in the given parameter set.
+StagedEntity GetStagedEntityParameter(const beCore::ParameterSet &parameters)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	return parameters.GetValueDefault< StagedEntity >(layout, parameterIDs.StagedEntity, StagedEntity());
+}
+
+// Sets the properties staged for the next controller to be loaded in the given parameter set.
+void SetStagedControllerParameter(beCore::ParameterSet &parameters, const StagedController &stagedController)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	parameters.SetValue(layout, parameterIDs.StagedController, stagedController);
+}
+
+// Gets the properties staged for the next controller to be loaded in the given parameter set.
+StagedController GetStagedControllerParameter(const beCore::ParameterSet &parameters)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	return parameters.GetValueDefault< StagedController >(layout, parameterIDs.StagedController, StagedController());
+}
+
+// Sets the snapshot that properties are captured in instead of being saved right away in the given parameter set.
+void SetPropertySnapshotParameter(beCore::ParameterSet &parameters, beCore::PropertySnapshot *pSnapshot)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	parameters.SetValue(layout, parameterIDs.PropertySnapshot, pSnapshot);
+}
+
+// Gets the snapshot that properties are captured in instead of being saved right away in the given parameter set.
+beCore::PropertySnapshot* GetPropertySnapshotParameter(const beCore::ParameterSet &parameters)
+{
+	const beCore::ParameterLayout &layout = GetSerializationParameters();
+	const EntitySystemParameterIDs& parameterIDs = GetEntitySystemParameterIDs();
+
+	return parameters.GetValueDefault< beCore::PropertySnapshot* >(layout, parameterIDs.PropertySnapshot, nullptr);
+}
+
 
 } // namespace
@@ -13,10 +13,21 @@
 #include "beEntitySystem/beEntitySerialization.h"
 #include "beEntitySystem/beSerializationParameters.h"
 #include "beEntitySystem/beSerializationTasks.h"
+#include "beEntitySystem/beWorldSnapshot.h"
+#include "beEntitySystem/beWorldDelta.h"
 
 #include <lean/functional/algorithm.h>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <beCore/beBinaryDocument.h>
+#include <beCore/bePropertySerialization.h>
+#include <beCore/beXMLStreamWriter.h>
 
 #include <lean/xml/xml_file.h>
+#include <lean/rapidxml/rapidxml_print.hpp>
+#include <lean/io/raw_file.h>
 #include <lean/xml/utility.h>
 #include <lean/xml/numeric.h>
 
@@ -29,18 +40,34 @@ namespace beEntitySystem
 World::World(const utf8_ntri &name, lean::move_ptr<WorldControllers> pTmpControllers, const WorldDesc &desc)
 	: m_name(name.to<utf8_string>()),
 	m_desc(desc),
+	m_saveID(0),
 	m_entities( CreateEntities(&m_persistentIDs) ),
 	m_controllers( (pTmpControllers.peek()) ? pTmpControllers.transfer() : new WorldControllers() )
 {
 }
 
-// Loads the world from the given file.
+// Loads the world from the given file, either XML or binary.
 World::World(const utf8_ntri &name, const utf8_ntri &file, beCore::ParameterSet &parameters, lean::move_ptr<WorldControllers> pTmpControllers, const WorldDesc &desc)
 	: m_name(name.to<utf8_string>()),
 	m_desc(desc),
+	m_saveID(0),
 	m_entities( CreateEntities(&m_persistentIDs) ),
 	m_controllers( (pTmpControllers.peek()) ? pTmpControllers.transfer() : new WorldControllers() )
 {
+	if (beCore::IsBinaryDocument(file))
+	{
+		// NOTE: Binary document mapped, strings remain valid until loaded
+		beCore::BinaryDocument binary(file);
+		rapidxml::xml_node<lean::utf8_t> *root = binary.Document().first_node("world");
+
+		if (root)
+			LoadWorld(*root, parameters);
+		else
+			LEAN_THROW_ERROR_CTX("No world node found", file.c_str());
+
+		return;
+	}
+
 	lean::xml_file<lean::utf8_t> xml(file);
 	rapidxml::xml_node<lean::utf8_t> *root = xml.document().first_node("world");
 
@@ -54,6 +81,7 @@ World::World(const utf8_ntri &name, const utf8_ntri &file, beCore::ParameterSet
 World::World(const utf8_ntri &name, const rapidxml::xml_node<lean::utf8_t> &node, beCore::ParameterSet &parameters, lean::move_ptr<WorldControllers> pTmpControllers, const WorldDesc &desc)
 	: m_name(name.to<utf8_string>()),
 	m_desc(desc),
+	m_saveID(0),
 	m_entities( CreateEntities(&m_persistentIDs) ),
 	m_controllers( (pTmpControllers.peek()) ? pTmpControllers.transfer() : new WorldControllers() )
 {
@@ -73,17 +101,50 @@ void World::Commit()
 }
 
 // Saves the world to the given file.
-void World::Serialize(const lean::utf8_ntri &file) const
+void World::Serialize(const lean::utf8_ntri &file)
+{
+	// NOTE: Stream entities straight to file, never hold the entire document in memory
+	beCore::XMLStreamWriter writer(file);
+	SaveWorld(writer);
+	// NOTE: Existing file only replaced once the entire world has been written
+	writer.Commit();
+
+	// NOTE: File might have replaced the stamped base file, deltas need a new base
+	m_saveID = 0;
+}
+
+// Saves the world to the given file in full, stamped with a new save ID.
+void World::SerializeBase(const lean::utf8_ntri &file)
+{
+	uint8 saveID = NewWorldSaveID(m_saveID);
+
+	beCore::XMLStreamWriter writer(file);
+	SaveWorld(writer, saveID);
+	writer.Commit();
+
+	// ORDER: Only refer to the new save once complete
+	m_saveID = saveID;
+	m_entities->MarkSaved();
+}
+
+// Saves the world to the given file in binary form.
+void World::SerializeBinary(const lean::utf8_ntri &file)
 {
 	lean::xml_file<lean::utf8_t> xml;
 
+	// NOTE: Property values stored as typed binary values, never formatted as text
+	beCore::SetBinaryPropertyValues(xml.document());
+
 	rapidxml::xml_node<lean::utf8_t> &root = *lean::allocate_node<utf8_t>(xml.document(), "world");
 	// ORDER: Append FIRST, otherwise parent document == nullptr
 	xml.document().append_node(&root);
 	
 	Serialize(root);
 
-	xml.save(file);
+	beCore::SaveBinaryDocument(xml.document(), file);
+
+	// NOTE: File might have replaced the stamped base file, deltas need a new base
+	m_saveID = 0;
 }
 
 // Saves the world to the given XML node.
@@ -92,21 +153,149 @@ void World::Serialize(rapidxml::xml_node<lean::utf8_t> &node) const
 	SaveWorld(node);
 }
 
-// Saves the world to the given xml node.
-void World::SaveWorld(rapidxml::xml_node<utf8_t> &worldNode) const
+// Replaces the given snapshot by a snapshot of the current state of this world.
+void World::Snapshot(WorldSnapshot &snapshot) const
+{
+	snapshot.Clear();
+
+	rapidxml::xml_document<utf8_t> &document = snapshot.Document();
+
+	rapidxml::xml_node<lean::utf8_t> &root = *lean::allocate_node<utf8_t>(document, "world");
+	// ORDER: Append FIRST, otherwise parent document == nullptr
+	document.append_node(&root);
+
+	SaveWorld(root, &snapshot.Properties());
+}
+
+// Appends all entity changes since the last save to the given delta file.
+bool World::SerializeDelta(const lean::utf8_ntri &deltaFile)
+{
+	// NOTE: Deltas without a stamped base file might be applied to any file
+	if (!m_saveID || m_entities->RequiresFullSave())
+		return false;
+
+	std::vector<const Entity*> changedEntities;
+	std::vector<uint8> removedIDs;
+
+	{
+		Entities::PersistentIDRange removedSinceSave = m_entities->GetRemovedSinceSave();
+		removedIDs.assign(removedSinceSave.Begin, removedSinceSave.End);
+	}
+
+	Entities::Range entities = m_entities->GetEntities();
+
+	for (Entity *const *itEntity = entities.Begin; itEntity < entities.End; ++itEntity)
+	{
+		const Entity *entity = *itEntity;
+
+		if (entity->IsModified())
+		{
+			uint8 persistentID = entity->GetPersistentID();
+
+			if (entity->IsAttached() && entity->IsSerialized())
+			{
+				// NOTE: Anonymous entities cannot be matched against the last full save
+				if (persistentID == Entities::AnonymousPersistentID)
+					return false;
+
+				changedEntities.push_back(entity);
+			}
+			// NOTE: Entities no longer saved need to be removed
+			else if (persistentID != Entities::AnonymousPersistentID)
+				removedIDs.push_back(persistentID);
+		}
+	}
+
+	lean::xml_file<lean::utf8_t> xml;
+	rapidxml::xml_document<utf8_t> &document = xml.document();
+
+	rapidxml::xml_node<utf8_t> &deltaNode = *lean::allocate_node<utf8_t>(document, "worlddelta");
+	// ORDER: Append FIRST, otherwise parent document == nullptr
+	document.append_node(&deltaNode);
+
+	lean::append_int_attribute<utf8_t>(document, deltaNode, "baseSaveID", m_saveID);
+	lean::append_attribute<utf8_t>(document, deltaNode, "name", m_name);
+	lean::append_int_attribute<utf8_t>(document, deltaNode, "nextPersistentID", m_persistentIDs.GetNextID());
+
+	beCore::ParameterSet parameters(&GetSerializationParameters());
+
+	// NOTE: Global state is small, always saved in full
+	GetResourceSaveTasks().Save(deltaNode, parameters);
+	GetWorldSaveTasks().Save(deltaNode, parameters);
+
+	if (!removedIDs.empty())
+	{
+		rapidxml::xml_node<utf8_t> &removedNode = *lean::allocate_node<utf8_t>(document, "removed");
+		// ORDER: Append FIRST, otherwise parent document == nullptr
+		deltaNode.append_node(&removedNode);
+
+		for (std::vector<uint8>::const_iterator itID = removedIDs.begin(); itID != removedIDs.end(); ++itID)
+		{
+			rapidxml::xml_node<utf8_t> &entityNode = *lean::allocate_node<utf8_t>(document, "e");
+			lean::append_int_attribute<utf8_t>(document, entityNode, "id", *itID);
+			removedNode.append_node(&entityNode);
+		}
+	}
+
+	beCore::SaveJobs saveJobs;
+
+	SaveEntities(
+			(changedEntities.empty()) ? nullptr : &changedEntities[0], Size4(changedEntities),
+			deltaNode, &parameters, &saveJobs
+		);
+
+	// Execute any additionally scheduled save jobs, e.g. resources of changed entities
+	saveJobs.Save(deltaNode, parameters);
+
+	utf8_string text;
+	rapidxml::print(std::back_inserter(text), document);
+
+	{
+		// NOTE: Append-only, deltas are applied in order
+		lean::raw_file rawFile(deltaFile, lean::file::write, lean::file::append, lean::file::sequential);
+		rawFile.write(text.c_str(), text.size());
+	}
+
+	m_entities->MarkSaved();
+	return true;
+}
+
+// Marks the world saved.
+void World::MarkSaved()
+{
+	// NOTE: Saved file unknown, might not be the stamped base file
+	m_saveID = 0;
+	m_entities->MarkSaved();
+}
+
+// Saves the world attributes & all global state to the given xml node.
+void World::SaveWorldState(rapidxml::xml_node<utf8_t> &worldNode, beCore::ParameterSet &parameters, uint8 saveID) const
 {
 	rapidxml::xml_document<utf8_t> &document = *worldNode.document();
 
+	// NOTE: Identifies the base file deltas refer to
+	if (saveID)
+		lean::append_int_attribute<utf8_t>(document, worldNode, "saveID", saveID);
 	lean::append_attribute<utf8_t>(document, worldNode, "name", m_name);
 	
 	// NOTE: Never re-use persistent IDs again
 	lean::append_int_attribute<utf8_t>(document, worldNode, "nextPersistentID", m_persistentIDs.GetNextID());
 
-	beCore::ParameterSet parameters(&GetSerializationParameters());
-	
 	// Execute generic save tasks first
 	GetResourceSaveTasks().Save(worldNode, parameters);
 	GetWorldSaveTasks().Save(worldNode, parameters);
+}
+
+// Saves the world to the given xml node.
+void World::SaveWorld(rapidxml::xml_node<utf8_t> &worldNode, beCore::PropertySnapshot *pProperties) const
+{
+	beCore::ParameterSet parameters(&GetSerializationParameters());
+
+	// NOTE: Entity & controller properties captured for later, all other nodes complete
+	if (pProperties)
+		SetPropertySnapshotParameter(parameters, pProperties);
+	
+	SaveWorldState(worldNode, parameters, 0);
 	
 	beCore::SaveJobs saveJobs;
 
@@ -117,13 +306,69 @@ void World::SaveWorld(rapidxml::xml_node<utf8_t> &worldNode) const
 	saveJobs.Save(worldNode, parameters);
 }
 
+// Saves the world to the given XML stream.
+void World::SaveWorld(beCore::XMLStreamWriter &writer, uint8 saveID) const
+{
+	rapidxml::xml_document<utf8_t> &document = writer.Scratch();
+
+	rapidxml::xml_node<utf8_t> &worldNode = *lean::allocate_node<utf8_t>(document, "world");
+	// ORDER: Append FIRST, otherwise parent document == nullptr
+	document.append_node(&worldNode);
+
+	beCore::ParameterSet parameters(&GetSerializationParameters());
+	SaveWorldState(worldNode, parameters, saveID);
+
+	// ORDER: Tasks may have added attributes, begin element afterwards
+	writer.BeginElement(worldNode);
+	writer.WriteChildren(worldNode);
+	writer.ClearScratch();
+	
+	beCore::SaveJobs saveJobs;
+
+	Entities::ConstRange entities = m_entities->GetEntities();
+	SaveEntities(&entities[0], Size4(entities), writer, &parameters, &saveJobs);
+
+	// Execute any additionally scheduled save jobs
+	{
+		rapidxml::xml_node<utf8_t> &jobRoot = *lean::allocate_node<utf8_t>(document, "world");
+		// ORDER: Append FIRST, otherwise parent document == nullptr
+		document.append_node(&jobRoot);
+
+		// NOTE: Save jobs only ever append to their root, stream whatever was appended
+		saveJobs.Save(jobRoot, parameters);
+
+		writer.WriteChildren(jobRoot);
+		writer.ClearScratch();
+	}
+
+	writer.EndElement();
+}
+
 // Loads the world from the given xml node.
 void World::LoadWorld(const rapidxml::xml_node<lean::utf8_t> &worldNode, beCore::ParameterSet &parameters)
 {
 	lean::get_attribute<utf8_t>(worldNode, "name", m_name);
 
+	uint8 nextPersistentID = lean::get_int_attribute<utf8_t>(worldNode, "nextPersistentID", m_persistentIDs.GetNextID());
+	// NOTE: Deltas only written for stamped base files
+	m_saveID = lean::get_int_attribute<utf8_t>(worldNode, "saveID", static_cast<uint8>(0));
+
+	// Allocate reference storage for all loaded entities at once
+	{
+		uint8 entityCount = 0;
+
+		for (const rapidxml::xml_node<utf8_t> *pEntitiesNode = worldNode.first_node("entities");
+			pEntitiesNode; pEntitiesNode = pEntitiesNode->next_sibling("entities"))
+			entityCount += lean::node_count(*pEntitiesNode);
+
+		uint8 beginID = m_persistentIDs.GetNextID();
+
+		// NOTE: Never trust the file, allocate no more storage than there are entities, remaining pages allocated lazily
+		if (nextPersistentID > beginID)
+			m_persistentIDs.ReserveStorage(beginID, beginID + std::min(nextPersistentID - beginID, entityCount));
+	}
 	// NOTE: Never re-use persistent IDs again
-	m_persistentIDs.SkipIDs( lean::get_int_attribute<utf8_t>(worldNode, "nextPersistentID", m_persistentIDs.GetNextID()) );
+	m_persistentIDs.SkipIDs(nextPersistentID);
 
 	// NOTE: Caller has no way of setting this right!
 	SetEntitySystemParameters(
@@ -136,10 +381,13 @@ void World::LoadWorld(const rapidxml::xml_node<lean::utf8_t> &worldNode, beCore:
 	GetWorldLoadTasks().Load(worldNode, parameters);
 
 	beCore::LoadJobs loadJobs;
-	LoadEntities(m_entities.get(), worldNode, parameters, &loadJobs);
+	LoadEntitiesParallel(m_entities.get(), worldNode, parameters, m_desc.LoadPool, &loadJobs);
 
 	// Execute any additionally scheduled load jobs
 	loadJobs.Load(worldNode, parameters);
+
+	// NOTE: Loaded state is the saved state
+	m_entities->MarkSaved();
 }
 
 // Sets the name.
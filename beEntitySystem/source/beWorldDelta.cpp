@@ -0,0 +1,439 @@
+/************************************************************/
+/* breeze Engine Entity System Module  (c) Tobias Zirr 2011 */
+/************************************************************/
+
+#include "beEntitySystemInternal/stdafx.h"
+#include "beEntitySystem/beWorldDelta.h"
+#include "beEntitySystem/beWorld.h"
+#include "beEntitySystem/beEntities.h"
+#include "beEntitySystem/beEntitySerializer.h"
+
+#include <beCore/beBinaryDocument.h>
+#include <beCore/bePropertySerialization.h>
+#include <beCore/beXMLStreamWriter.h>
+#include <beCore/beFileCommit.h>
+
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+#include <lean/xml/xml_file.h>
+#include <lean/xml/utility.h>
+#include <lean/xml/numeric.h>
+
+#include <lean/logging/errors.h>
+
+namespace beEntitySystem
+{
+
+namespace
+{
+
+typedef std::unordered_map<uint8, rapidxml::xml_node<utf8_t>*> entity_map;
+typedef std::unordered_map<utf8_string, rapidxml::xml_node<utf8_t>*> resource_map;
+typedef std::unordered_map<utf8_string, const rapidxml::xml_node<utf8_t>*> const_resource_map;
+
+/// Compares the given strings.
+LEAN_INLINE bool Equal(const utf8_t *a, size_t aSize, const utf8_t *b, size_t bSize)
+{
+	return rapidxml::internal::compare(a, aSize, b, bSize, true);
+}
+
+/// Checks if the given node has the given name.
+LEAN_INLINE bool HasName(const rapidxml::xml_node<utf8_t> &node, const utf8_ntri &name)
+{
+	return Equal(node.name(), node.name_size(), name.c_str(), name.size());
+}
+
+/// Gets the key of the given resource node, composed of its first attribute.
+utf8_string GetResourceKey(const rapidxml::xml_node<utf8_t> &node)
+{
+	const rapidxml::xml_attribute<utf8_t> *keyAttribute = LEAN_ASSERT_NOT_NULL( node.first_attribute() );
+
+	utf8_string key(keyAttribute->name(), keyAttribute->name_size());
+	key.push_back(0);
+	key.append(keyAttribute->value(), keyAttribute->value_size());
+	return key;
+}
+
+/// Checks if all child elements of the given section are named by their first attribute.
+bool IsResourceSection(const rapidxml::xml_node<utf8_t> &section)
+{
+	for (const rapidxml::xml_node<utf8_t> *node = section.first_node(); node; node = node->next_sibling())
+		if (node->type() == rapidxml::node_element && !node->first_attribute())
+			return false;
+
+	return true;
+}
+
+/// Replaces the given node by the given replacement.
+void ReplaceNode(rapidxml::xml_node<utf8_t> &parent, rapidxml::xml_node<utf8_t> *node, rapidxml::xml_node<utf8_t> *replacement)
+{
+	parent.insert_node(node, replacement);
+	parent.remove_node(node);
+}
+
+/// Overwrites & adds the attributes of the given source node.
+void MergeAttributes(rapidxml::xml_node<utf8_t> &target, const rapidxml::xml_node<utf8_t> &source)
+{
+	rapidxml::xml_document<utf8_t> &document = *target.document();
+
+	for (const rapidxml::xml_attribute<utf8_t> *attribute = source.first_attribute(); attribute; attribute = attribute->next_attribute())
+	{
+		// NOTE: Save ID of the base file, never part of the world
+		if (Equal(attribute->name(), attribute->name_size(), "baseSaveID", lean::ntarraylen("baseSaveID")))
+			continue;
+
+		rapidxml::xml_attribute<utf8_t> *existing = target.first_attribute(attribute->name(), attribute->name_size());
+
+		if (existing)
+			existing->value(attribute->value(), attribute->value_size());
+		else
+			target.append_attribute(
+					document.allocate_attribute(attribute->name(), attribute->value(), attribute->name_size(), attribute->value_size())
+				);
+	}
+}
+
+/// Merges the given delta section into the given world node.
+void MergeSection(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_node<utf8_t> &section)
+{
+	rapidxml::xml_document<utf8_t> &document = *worldNode.document();
+	rapidxml::xml_node<utf8_t> *target = worldNode.first_node(section.name(), section.name_size());
+
+	// Replace named resources one by one
+	if (target && IsResourceSection(section) && IsResourceSection(*target))
+	{
+		resource_map resources;
+
+		for (rapidxml::xml_node<utf8_t> *node = target->first_node(); node; node = node->next_sibling())
+			if (node->type() == rapidxml::node_element)
+				resources[GetResourceKey(*node)] = node;
+
+		for (const rapidxml::xml_node<utf8_t> *node = section.first_node(); node; node = node->next_sibling())
+			if (node->type() == rapidxml::node_element)
+			{
+				rapidxml::xml_node<utf8_t> *clone = document.clone_node(node);
+				rapidxml::xml_node<utf8_t> *&existing = resources[GetResourceKey(*node)];
+
+				if (existing)
+					ReplaceNode(*target, existing, clone);
+				else
+					target->append_node(clone);
+
+				existing = clone;
+			}
+	}
+	// Replace other sections as a whole
+	else
+	{
+		rapidxml::xml_node<utf8_t> *clone = document.clone_node(&section);
+
+		if (target)
+			ReplaceNode(worldNode, target, clone);
+		else
+			worldNode.append_node(clone);
+	}
+}
+
+/// Merges the given removed & changed entities into the given world node.
+void MergeEntities(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_node<utf8_t> *removedNode, const rapidxml::xml_node<utf8_t> *entitiesNode)
+{
+	rapidxml::xml_document<utf8_t> &document = *worldNode.document();
+	rapidxml::xml_node<utf8_t> *target = worldNode.first_node("entities");
+
+	if (!target)
+	{
+		target = lean::allocate_node<utf8_t>(document, "entities");
+		worldNode.append_node(target);
+	}
+
+	entity_map entities;
+
+	for (rapidxml::xml_node<utf8_t> *node = target->first_node(); node; node = node->next_sibling())
+	{
+		uint8 persistentID = EntitySerializer::GetID(*node);
+
+		if (persistentID != Entities::AnonymousPersistentID)
+			entities[persistentID] = node;
+	}
+
+	// ORDER: Remove first, persistent IDs may have moved to other entities
+	if (removedNode)
+		for (const rapidxml::xml_node<utf8_t> *node = removedNode->first_node(); node; node = node->next_sibling())
+		{
+			entity_map::iterator itEntity = entities.find( EntitySerializer::GetID(*node) );
+
+			if (itEntity != entities.end())
+			{
+				target->remove_node(itEntity->second);
+				entities.erase(itEntity);
+			}
+		}
+
+	if (entitiesNode)
+		for (const rapidxml::xml_node<utf8_t> *node = entitiesNode->first_node(); node; node = node->next_sibling())
+		{
+			rapidxml::xml_node<utf8_t> *clone = document.clone_node(node);
+			uint8 persistentID = EntitySerializer::GetID(*node);
+
+			entity_map::iterator itEntity = entities.find(persistentID);
+
+			// NOTE: Changed entities keep their place, new entities are appended in order of creation
+			if (itEntity != entities.end())
+			{
+				ReplaceNode(*target, itEntity->second, clone);
+				itEntity->second = clone;
+			}
+			else
+			{
+				target->append_node(clone);
+
+				if (persistentID != Entities::AnonymousPersistentID)
+					entities[persistentID] = clone;
+			}
+		}
+}
+
+/// Gets the world node of the given document.
+rapidxml::xml_node<utf8_t>& GetWorldNode(rapidxml::xml_document<utf8_t> &document, const utf8_ntri &file)
+{
+	rapidxml::xml_node<utf8_t> *worldNode = document.first_node("world");
+
+	if (!worldNode)
+		LEAN_THROW_ERROR_CTX("No world node found", file.c_str());
+
+	return *worldNode;
+}
+
+/// Gets the save ID the given world node is stamped with, 0 if none.
+LEAN_INLINE uint8 GetSaveID(const rapidxml::xml_node<utf8_t> &worldNode)
+{
+	return lean::get_int_attribute<utf8_t>(worldNode, "saveID", static_cast<uint8>(0));
+}
+
+/// Stamps the given world node with the given save ID, removes the save ID if 0.
+void SetSaveID(rapidxml::xml_node<utf8_t> &worldNode, uint8 saveID)
+{
+	if (rapidxml::xml_attribute<utf8_t> *saveIDAttribute = worldNode.first_attribute("saveID"))
+		worldNode.remove_attribute(saveIDAttribute);
+
+	if (saveID)
+		lean::append_int_attribute<utf8_t>(*worldNode.document(), worldNode, "saveID", saveID);
+}
+
+/// Checks if the given nodes are equal, including all attributes & children.
+bool NodesEqual(const rapidxml::xml_node<utf8_t> &a, const rapidxml::xml_node<utf8_t> &b)
+{
+	if (a.type() != b.type()
+		|| !Equal(a.name(), a.name_size(), b.name(), b.name_size())
+		|| !Equal(a.value(), a.value_size(), b.value(), b.value_size()))
+		return false;
+
+	const rapidxml::xml_attribute<utf8_t> *aAttribute = a.first_attribute(), *bAttribute = b.first_attribute();
+
+	for (; aAttribute && bAttribute; aAttribute = aAttribute->next_attribute(), bAttribute = bAttribute->next_attribute())
+		if (!Equal(aAttribute->name(), aAttribute->name_size(), bAttribute->name(), bAttribute->name_size())
+			|| !Equal(aAttribute->value(), aAttribute->value_size(), bAttribute->value(), bAttribute->value_size()))
+			return false;
+
+	if (aAttribute || bAttribute)
+		return false;
+
+	const rapidxml::xml_node<utf8_t> *aChild = a.first_node(), *bChild = b.first_node();
+
+	for (; aChild && bChild; aChild = aChild->next_sibling(), bChild = bChild->next_sibling())
+		if (!NodesEqual(*aChild, *bChild))
+			return false;
+
+	return !aChild && !bChild;
+}
+
+/// Checks if the given sections are equivalent. Named resources only present in the given compacted section are ignored.
+bool SectionsEquivalent(const rapidxml::xml_node<utf8_t> &compacted, const rapidxml::xml_node<utf8_t> &full)
+{
+	if (HasName(full, "entities") || !IsResourceSection(compacted) || !IsResourceSection(full))
+		return NodesEqual(compacted, full);
+
+	const_resource_map resources;
+
+	for (const rapidxml::xml_node<utf8_t> *node = compacted.first_node(); node; node = node->next_sibling())
+		if (node->type() == rapidxml::node_element)
+			resources[GetResourceKey(*node)] = node;
+
+	for (const rapidxml::xml_node<utf8_t> *node = full.first_node(); node; node = node->next_sibling())
+		if (node->type() == rapidxml::node_element)
+		{
+			const_resource_map::const_iterator itResource = resources.find( GetResourceKey(*node) );
+
+			if (itResource == resources.end() || !NodesEqual(*itResource->second, *node))
+				return false;
+		}
+
+	return true;
+}
+
+} // namespace
+
+// Applies the given world delta node to the given world node.
+void ApplyWorldDelta(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_node<utf8_t> &deltaNode)
+{
+	MergeAttributes(worldNode, deltaNode);
+
+	for (const rapidxml::xml_node<utf8_t> *section = deltaNode.first_node(); section; section = section->next_sibling())
+		if (section->type() == rapidxml::node_element && !HasName(*section, "entities") && !HasName(*section, "removed"))
+			MergeSection(worldNode, *section);
+
+	MergeEntities(worldNode, deltaNode.first_node("removed"), deltaNode.first_node("entities"));
+}
+
+// Gets a new save ID identifying a full save.
+uint8 NewWorldSaveID(uint8 prevSaveID)
+{
+	FILETIME time;
+	::GetSystemTimeAsFileTime(&time);
+	
+	uint8 saveID = static_cast<uint8>(time.dwHighDateTime) << 32U | time.dwLowDateTime;
+	// NOTE: Clock may be reset, never repeat the previous save ID
+	return std::max(saveID, prevSaveID + 1);
+}
+
+// Applies all world delta nodes in the given document to the given world node, in order.
+uint4 ApplyWorldDeltas(rapidxml::xml_node<utf8_t> &worldNode, const rapidxml::xml_document<utf8_t> &deltaDocument)
+{
+	const uint8 saveID = GetSaveID(worldNode);
+	uint4 deltaCount = 0;
+	uint4 staleDeltaCount = 0;
+
+	for (const rapidxml::xml_node<utf8_t> *deltaNode = deltaDocument.first_node("worlddelta");
+		deltaNode; deltaNode = deltaNode->next_sibling("worlddelta"))
+	{
+		// NOTE: Deltas written for other saves would revert or duplicate changes
+		if (!saveID || lean::get_int_attribute<utf8_t>(*deltaNode, "baseSaveID", static_cast<uint8>(0)) != saveID)
+		{
+			++staleDeltaCount;
+			continue;
+		}
+
+		ApplyWorldDelta(worldNode, *deltaNode);
+		++deltaCount;
+	}
+
+	if (staleDeltaCount)
+		LEAN_LOG_ERROR_MSG("Skipped world deltas not written for this world save");
+
+	return deltaCount;
+}
+
+// Merges all deltas in the given delta file into the given world file.
+uint4 CompactWorld(const utf8_ntri &worldFile, const utf8_ntri &deltaFile, const utf8_ntri &outputFile)
+{
+	lean::xml_file<utf8_t> deltas(deltaFile);
+	uint4 deltaCount;
+
+	if (beCore::IsBinaryDocument(worldFile))
+	{
+		std::vector<char> data;
+
+		{
+			beCore::BinaryDocument binary(worldFile);
+			rapidxml::xml_node<utf8_t> &worldNode = GetWorldNode(binary.Document(), worldFile);
+			deltaCount = ApplyWorldDeltas(worldNode, deltas.document());
+
+			// NOTE: Merged deltas must never be applied again
+			if (deltaCount)
+				SetSaveID(worldNode, NewWorldSaveID(GetSaveID(worldNode)));
+
+			// NOTE: Output may overwrite the mapped world file, write to memory first
+			beCore::WriteBinaryDocument(binary.Document(), data);
+		}
+
+		// NOTE: Never leave a partially written world behind
+		beCore::CommitFile(outputFile, &data[0], data.size());
+	}
+	else
+	{
+		lean::xml_file<utf8_t> world(worldFile);
+		rapidxml::xml_node<utf8_t> &worldNode = GetWorldNode(world.document(), worldFile);
+		deltaCount = ApplyWorldDeltas(worldNode, deltas.document());
+
+		// NOTE: Merged deltas must never be applied again
+		if (deltaCount)
+			SetSaveID(worldNode, NewWorldSaveID(GetSaveID(worldNode)));
+
+		// NOTE: Never leave a partially written world behind
+		beCore::XMLStreamWriter writer(outputFile);
+		writer.WriteChildren(world.document());
+		writer.Commit();
+	}
+
+	return deltaCount;
+}
+
+// Checks if the given worlds are equivalent.
+bool WorldsEquivalent(const rapidxml::xml_node<utf8_t> &world, const rapidxml::xml_node<utf8_t> &referenceWorld)
+{
+	for (const rapidxml::xml_attribute<utf8_t> *attribute = world.first_attribute(); attribute; attribute = attribute->next_attribute())
+	{
+		const rapidxml::xml_attribute<utf8_t> *referenceAttribute = referenceWorld.first_attribute(attribute->name(), attribute->name_size());
+
+		if (!referenceAttribute || !Equal(attribute->value(), attribute->value_size(), referenceAttribute->value(), referenceAttribute->value_size()))
+			return false;
+	}
+
+	for (const rapidxml::xml_attribute<utf8_t> *attribute = referenceWorld.first_attribute(); attribute; attribute = attribute->next_attribute())
+		if (!world.first_attribute(attribute->name(), attribute->name_size()))
+			return false;
+
+	for (const rapidxml::xml_node<utf8_t> *section = world.first_node(); section; section = section->next_sibling())
+	{
+		const rapidxml::xml_node<utf8_t> *referenceSection = referenceWorld.first_node(section->name(), section->name_size());
+
+		if (!referenceSection || !SectionsEquivalent(*section, *referenceSection))
+			return false;
+	}
+
+	for (const rapidxml::xml_node<utf8_t> *section = referenceWorld.first_node(); section; section = section->next_sibling())
+		if (!world.first_node(section->name(), section->name_size()))
+			return false;
+
+	return true;
+}
+
+// Checks if applying the given delta file to the given world file yields a world equivalent to a full save.
+bool WorldDeltasEquivalent(const World &world, const utf8_ntri &worldFile, const utf8_ntri &deltaFile)
+{
+	lean::xml_file<utf8_t> deltas(deltaFile);
+
+	lean::xml_file<utf8_t> reference;
+	rapidxml::xml_node<utf8_t> &referenceNode = *lean::allocate_node<utf8_t>(reference.document(), "world");
+	// ORDER: Append FIRST, otherwise parent document == nullptr
+	reference.document().append_node(&referenceNode);
+	world.Serialize(referenceNode);
+
+	if (beCore::IsBinaryDocument(worldFile))
+	{
+		beCore::BinaryDocument binary(worldFile);
+		rapidxml::xml_node<utf8_t> &worldNode = GetWorldNode(binary.Document(), worldFile);
+		ApplyWorldDeltas(worldNode, deltas.document());
+		
+		// NOTE: Full saves in memory are neither stamped nor binary
+		SetSaveID(worldNode, 0);
+		beCore::ConvertPropertyValuesToText(binary.Document());
+		
+		return WorldsEquivalent(worldNode, referenceNode);
+	}
+	else
+	{
+		lean::xml_file<utf8_t> base(worldFile);
+		rapidxml::xml_node<utf8_t> &worldNode = GetWorldNode(base.document(), worldFile);
+		ApplyWorldDeltas(worldNode, deltas.document());
+
+		// NOTE: Full saves in memory are never stamped
+		SetSaveID(worldNode, 0);
+
+		return WorldsEquivalent(worldNode, referenceNode);
+	}
+}
+
+} // namespace
@@ -0,0 +1,98 @@
+/************************************************************/
+/* breeze Engine Entity System Module  (c) Tobias Zirr 2011 */
+/************************************************************/
+
+#include "beEntitySystemInternal/stdafx.h"
+#include "beEntitySystem/beWorldSnapshot.h"
+
+#include <beCore/bePropertySnapshot.h>
+#include <beCore/beXMLStreamWriter.h>
+#include <beCore/beBinaryDocument.h>
+
+#include <lean/logging/errors.h>
+
+namespace beEntitySystem
+{
+
+/// World snapshot internals.
+struct WorldSnapshot::M
+{
+	rapidxml::xml_document<utf8_t> document;
+	beCore::PropertySnapshot properties;
+
+	/// Writes all captured property values to the snapshot document.
+	rapidxml::xml_node<utf8_t>& Complete()
+	{
+		rapidxml::xml_node<utf8_t> *pWorldNode = document.first_node("world");
+
+		if (!pWorldNode)
+			LEAN_THROW_ERROR_MSG("World snapshot is empty");
+
+		// NOTE: Deferred text formatting, the bulk of the serialization work
+		properties.WriteProperties();
+
+		return *pWorldNode;
+	}
+};
+
+// Constructs an empty snapshot.
+WorldSnapshot::WorldSnapshot()
+	: m( new M() )
+{
+}
+
+// Destructor.
+WorldSnapshot::~WorldSnapshot()
+{
+}
+
+// Writes the snapshot to the given file.
+void WorldSnapshot::Serialize(const utf8_ntri &file)
+{
+	rapidxml::xml_node<utf8_t> &worldNode = m->Complete();
+
+	beCore::XMLStreamWriter writer(file);
+	writer.WriteNode(worldNode);
+	writer.Commit();
+}
+
+// Writes the snapshot to the given file in binary form.
+void WorldSnapshot::SerializeBinary(const utf8_ntri &file)
+{
+	m->Complete();
+	beCore::SaveBinaryDocument(m->document, file);
+}
+
+// Releases all snapshot data.
+void WorldSnapshot::Clear()
+{
+	// ORDER: Captured values refer to document nodes
+	m->properties.Clear();
+	m->document.clear();
+}
+
+// Checks if a snapshot has been taken.
+bool WorldSnapshot::IsEmpty() const
+{
+	return !m->document.first_node();
+}
+
+// Gets the snapshot document.
+rapidxml::xml_document<utf8_t>& WorldSnapshot::Document()
+{
+	return m->document;
+}
+
+// Gets the property values captured but not yet written to the snapshot document.
+beCore::PropertySnapshot& WorldSnapshot::Properties()
+{
+	return m->properties;
+}
+
+// Gets the property values captured but not yet written to the snapshot document.
+const beCore::PropertySnapshot& WorldSnapshot::Properties() const
+{
+	return m->properties;
+}
+
+} // namespace
@@ -31,6 +31,8 @@ BE_GRAPHICS_DX11_API lean::com_ptr<ID3DBlob, true> CompileEffect(const lean::utf
 	const lean::utf8_ntri &debugName,
 	const D3D_SHADER_MACRO *pMacros,
 	ID3DInclude *pIncludeManager);
+/// Gets a key identifying the compiler version, target profile & flags effects are compiled with.
+BE_GRAPHICS_DX11_API uint8 GetEffectCompilerKey();
 
 /// Creates an effect from the given object code.
 BE_GRAPHICS_DX11_API lean::com_ptr<ID3DX11Effect, true> CreateEffect(const char *data, uint4 dataLength, ID3D11Device *pDevice);
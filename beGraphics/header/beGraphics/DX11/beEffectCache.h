@@ -37,7 +37,7 @@ private:
 public:
 	/// Constructor.
 	BE_GRAPHICS_DX11_API EffectCache(api::Device *pDevice, TextureCache *pTextureCache, const utf8_ntri &cacheDir,
-		const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider);
+		const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider, beCore::ThreadPool *pPool = nullptr);
 	/// Destructor.
 	BE_GRAPHICS_DX11_API ~EffectCache();
 
@@ -11,6 +11,7 @@
 #include "beEffect.h"
 #include "beTexture.h"
 #include "beMaterialConfig.h"
+#include <beCore/beResourceManager.h>
 #include <D3DX11Effect.h>
 #include <lean/smart/resource_ptr.h>
 #include <vector>
@@ -165,6 +166,9 @@ public:
 	BE_GRAPHICS_DX11_API bool IsComponentReplaceable(uint4 idx) const;
 	/// Sets the n-th component.
 	BE_GRAPHICS_DX11_API void SetComponent(uint4 idx, const lean::any &pComponent);
+
+	/// Gets the memory held by this material, including its constant buffers.
+	BE_GRAPHICS_DX11_API beCore::ResourceMemory GetMemory() const;
 	
 	/// Gets the implementation identifier.
 	LEAN_INLINE ImplementationID GetImplementationID() const { return DX11Implementation; }
@@ -46,6 +46,11 @@ public:
 	/// Commits changes / reacts to changes.
 	BE_GRAPHICS_DX11_API void Commit() LEAN_OVERRIDE;
 
+	/// Sets the memory budget.
+	BE_GRAPHICS_DX11_API void SetMemoryBudget(const beCore::ResourceMemory &budget) LEAN_OVERRIDE;
+	/// Gets memory & usage statistics.
+	BE_GRAPHICS_DX11_API beCore::ResourceCacheStats GetCacheStats() const LEAN_OVERRIDE;
+
 	/// Sets the component monitor.
 	BE_GRAPHICS_DX11_API void SetComponentMonitor(beCore::ComponentMonitor *componentMonitor) LEAN_OVERRIDE;
 	/// Gets the component monitor.
@@ -10,6 +10,7 @@
 #include "../beMaterialConfig.h"
 #include "beEffect.h"
 #include "beTexture.h"
+#include <beCore/beResourceManager.h>
 #include <D3DX11Effect.h>
 #include <lean/smart/resource_ptr.h>
 #include <vector>
@@ -189,6 +190,9 @@ public:
 	/// Sets the n-th component.
 	BE_GRAPHICS_DX11_API void SetComponent(uint4 idx, const lean::any &pComponent);
 
+	/// Gets the memory held by this material configuration.
+	BE_GRAPHICS_DX11_API beCore::ResourceMemory GetMemory() const;
+
 	/// Gets the revision.
 	LEAN_INLINE const MaterialConfigRevision* GetRevision() const { return m_revision; }
 
@@ -42,6 +42,11 @@ public:
 	/// Commits changes / reacts to changes.
 	BE_GRAPHICS_DX11_API void Commit() LEAN_OVERRIDE;
 
+	/// Sets the memory budget.
+	BE_GRAPHICS_DX11_API void SetMemoryBudget(const beCore::ResourceMemory &budget) LEAN_OVERRIDE;
+	/// Gets memory & usage statistics.
+	BE_GRAPHICS_DX11_API beCore::ResourceCacheStats GetCacheStats() const LEAN_OVERRIDE;
+
 /*	/// Gets a texture from the given file.
 	BE_GRAPHICS_DX11_API beGraphics::MaterialConfig* GetByFile(const lean::utf8_ntri &file) LEAN_OVERRIDE;
 */
@@ -88,6 +88,8 @@ BE_GRAPHICS_DX11_API TextureDesc GetDesc(ID3D11Resource *pTexture);
 
 /// Gets the type of the given texture.
 BE_GRAPHICS_DX11_API TextureType::T GetType(ID3D11Resource *pTexture);
+/// Gets the number of bytes of GPU memory held by the given texture.
+BE_GRAPHICS_DX11_API uint8 GetTextureMemory(ID3D11Resource *pTexture);
 
 /// Gets data from the given texture.
 BE_GRAPHICS_DX11_API bool ReadTextureData(ID3D11DeviceContext *context, ID3D11Resource *texture, void *bytes, uint4 rowByteCount, uint4 rowCount, uint4 sliceCount, uint4 subResource = 0);
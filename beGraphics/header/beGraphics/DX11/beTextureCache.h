@@ -39,6 +39,9 @@ public:
 
 	/// Gets a texture from the given file.
 	BE_GRAPHICS_DX11_API beGraphics::Texture* GetByFile(const lean::utf8_ntri &file, bool bSRGB = false) LEAN_OVERRIDE;
+	/// Gets a texture from the given file, returning a placeholder texture right away.
+	BE_GRAPHICS_DX11_API beGraphics::Texture* GetByFileAsync(const lean::utf8_ntri &file, bool bSRGB = false,
+		beCore::TaskPriority::T priority = beCore::TaskPriority::Background) LEAN_OVERRIDE;
 	
 	/// Gets a texture for the given texture view.
 	BE_GRAPHICS_DX11_API beGraphics::Texture* GetTexture(const beGraphics::TextureView *pTexture) const LEAN_OVERRIDE;
@@ -51,11 +54,23 @@ public:
 	/// Commits changes / reacts to changes.
 	BE_GRAPHICS_DX11_API void Commit();
 
+	/// Sets the memory budget.
+	BE_GRAPHICS_DX11_API void SetMemoryBudget(const beCore::ResourceMemory &budget) LEAN_OVERRIDE;
+	/// Gets memory & usage statistics.
+	BE_GRAPHICS_DX11_API beCore::ResourceCacheStats GetCacheStats() const LEAN_OVERRIDE;
+
 	/// Sets the component monitor.
 	BE_GRAPHICS_DX11_API void SetComponentMonitor(beCore::ComponentMonitor *componentMonitor) LEAN_OVERRIDE;
 	/// Gets the component monitor.
 	BE_GRAPHICS_DX11_API beCore::ComponentMonitor* GetComponentMonitor() const LEAN_OVERRIDE;
 
+	/// Sets the thread pool used for asynchronous loading, nullptr to load synchronously.
+	BE_GRAPHICS_DX11_API void SetLoadThreadPool(beCore::ThreadPool *pPool) LEAN_OVERRIDE;
+	/// Gets the thread pool used for asynchronous loading.
+	BE_GRAPHICS_DX11_API beCore::ThreadPool* GetLoadThreadPool() const LEAN_OVERRIDE;
+	/// Gets the number of asynchronous loads not yet published.
+	BE_GRAPHICS_DX11_API uint4 GetPendingLoadCount() const LEAN_OVERRIDE;
+
 	/// Gets the path resolver.
 	BE_GRAPHICS_DX11_API const beCore::PathResolver& GetPathResolver() const LEAN_OVERRIDE;
 
@@ -14,6 +14,7 @@
 #include <beCore/bePathResolver.h>
 #include <beCore/beContentProvider.h>
 #include <beCore/beComponentMonitor.h>
+#include <beCore/beThreadPool.h>
 #include <lean/smart/resource_ptr.h>
 
 namespace beGraphics
@@ -92,9 +93,9 @@ BE_GRAPHICS_API Exchange::utf8_string MangleFilename(const lean::utf8_ntri &file
 class Device;
 class TextureCache;
 
-/// Creates a new effect cache.
+/// Creates a new effect cache. Cached effects are decompressed on the given pool, if any.
 BE_GRAPHICS_API lean::resource_ptr<EffectCache, true> CreateEffectCache(const Device &device, TextureCache *pTextureCache, const utf8_ntri &cacheDir,
-	const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider);
+	const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider, beCore::ThreadPool *pPool = nullptr);
 
 }
 
@@ -14,6 +14,7 @@
 #include <beCore/bePathResolver.h>
 #include <beCore/beContentProvider.h>
 #include <beCore/beComponentMonitor.h>
+#include <beCore/beThreadPool.h>
 #include <lean/smart/resource_ptr.h>
 
 namespace beGraphics
@@ -33,6 +34,17 @@ public:
 		return GetView( GetByFile(file, bSRGB) ); 
 	}
 
+	/// Gets a texture from the given file, returning a placeholder texture right away & loading the actual texture on the
+	/// load thread pool. The placeholder is replaced on commit, requests no longer in use by then are dropped.
+	virtual Texture* GetByFileAsync(const lean::utf8_ntri &file, bool bSRGB = false,
+		beCore::TaskPriority::T priority = beCore::TaskPriority::Background) = 0;
+	/// Gets a texture view from the given file, returning a placeholder view right away.
+	LEAN_INLINE TextureView* GetViewByFileAsync(const lean::utf8_ntri &file, bool bSRGB = false,
+		beCore::TaskPriority::T priority = beCore::TaskPriority::Background)
+	{
+		return GetView( GetByFileAsync(file, bSRGB, priority) ); 
+	}
+
 	/// Gets a texture for the given texture view.
 	virtual Texture* GetTexture(const TextureView *pTexture) const = 0;
 	/// Gets a texture view for the given texture.
@@ -46,6 +58,13 @@ public:
 	/// Gets the component monitor.
 	virtual beCore::ComponentMonitor* GetComponentMonitor() const = 0;
 
+	/// Sets the thread pool used for asynchronous loading, nullptr to load synchronously.
+	virtual void SetLoadThreadPool(beCore::ThreadPool *pPool) = 0;
+	/// Gets the thread pool used for asynchronous loading.
+	virtual beCore::ThreadPool* GetLoadThreadPool() const = 0;
+	/// Gets the number of asynchronous loads not yet published.
+	virtual uint4 GetPendingLoadCount() const = 0;
+
 	/// Gets the path resolver.
 	virtual const beCore::PathResolver& GetPathResolver() const = 0;
 };
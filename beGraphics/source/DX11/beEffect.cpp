@@ -15,6 +15,8 @@
 
 #include <D3DCompiler.h>
 
+#include <beCore/beContentHash.h>
+
 #include <lean/logging/log.h>
 
 namespace beGraphics
@@ -23,6 +25,22 @@ namespace beGraphics
 namespace DX11
 {
 
+namespace
+{
+
+/// Target profile of all effects.
+const char EffectTarget[] = "fx_5_0";
+
+/// Flags all effects are compiled with.
+const UINT EffectCompileFlags = D3D10_SHADER_PACK_MATRIX_ROW_MAJOR | D3D10_SHADER_PARTIAL_PRECISION | D3D10_SHADER_ENABLE_STRICTNESS |
+#ifdef LEAN_DEBUG_BUILD
+	D3D10_SHADER_DEBUG | D3D10_SHADER_OPTIMIZATION_LEVEL2;
+#else
+	D3D10_SHADER_OPTIMIZATION_LEVEL3;
+#endif
+
+} // namespace
+
 // Compiles the given effect file's source to object code.
 lean::com_ptr<ID3DBlob, true> CompileEffect(const lean::utf8_ntri &fileName,
 	const D3D_SHADER_MACRO *pMacros,
@@ -78,13 +96,8 @@ lean::com_ptr<ID3DBlob, true> CompileEffect(const lean::utf8_t *source, uint4 so
 		pMacros,
 		pIncludeManager,
 		nullptr,
-		"fx_5_0",
-		D3D10_SHADER_PACK_MATRIX_ROW_MAJOR | D3D10_SHADER_PARTIAL_PRECISION | D3D10_SHADER_ENABLE_STRICTNESS | 
-#ifdef LEAN_DEBUG_BUILD
-		D3D10_SHADER_DEBUG | D3D10_SHADER_OPTIMIZATION_LEVEL2,
-#else
-		D3D10_SHADER_OPTIMIZATION_LEVEL3,
-#endif
+		EffectTarget,
+		EffectCompileFlags,
 		0,
 		pBytecode.rebind(),
 		pErrors.rebind() );
@@ -99,6 +112,19 @@ lean::com_ptr<ID3DBlob, true> CompileEffect(const lean::utf8_t *source, uint4 so
 	return pBytecode.transfer();
 }
 
+// Gets a key identifying the compiler version, target profile & flags effects are compiled with.
+uint8 GetEffectCompilerKey()
+{
+	// NOTE: Compiler DLL bound at link time, version fixed by the SDK headers
+	const UINT compilerVersion = D3D_COMPILER_VERSION;
+
+	beCore::ContentHasher hasher;
+	hasher.Update(&compilerVersion, sizeof(compilerVersion));
+	hasher.Update(EffectTarget, sizeof(EffectTarget));
+	hasher.Update(&EffectCompileFlags, sizeof(EffectCompileFlags));
+	return hasher.Finish();
+}
+
 // Reflects the given shader byte code.
 lean::com_ptr<ID3D11ShaderReflection, true> ReflectShader(const char *data, uint4 dataLength)
 {
@@ -24,13 +24,14 @@
 #include <beCore/beResourceManagerImpl.hpp>
 #include <beCore/beResourceIndex.h>
 #include <beCore/beFileWatch.h>
+#include <beCore/beArtifactStore.h>
+#include <beCore/beContentHash.h>
 
 #include <Effects11Lite/D3DEffectsLiteHooks.h>
 
 #include <lean/strings/hashing.h>
 
 #include <lean/io/raw_file.h>
-#include <lean/io/mapped_file.h>
 #include <lean/io/filesystem.h>
 
 #include <lean/logging/errors.h>
@@ -54,7 +55,7 @@ struct EffectCache::M
 	EffectCache *cache;
 	lean::com_ptr<api::Device> device;
 	lean::resource_ptr<TextureCache> pTextureCache;
-	utf8_string cacheDir;
+	beCore::ArtifactStore artifacts;
 
 	struct Info : public beCore::FileObserver
 	{
@@ -88,19 +89,35 @@ struct EffectCache::M
 	hook_vector unresolvedHooks;
 	hook_hash_map hookHashes;
 
+	/// Content hash of a dependency at one revision.
+	struct DependencyHash
+	{
+		uint8 revision;
+		uint8 hash;
+
+		DependencyHash()
+			: revision(0),
+			hash(0) { }
+	};
+	typedef std::unordered_map<utf8_string, DependencyHash> dependency_hash_map;
+	dependency_hash_map dependencyHashes;
+
 	beCore::FileWatch fileWatch;
 	typedef lean::simple_queue< std::deque< std::pair< lean::resource_ptr<Effect>, lean::resource_ptr<Effect> > > > replace_queue_t;
 	replace_queue_t replaceQueue;
 	lean::resource_ptr<beCore::ComponentMonitor> pComponentMonitor;
 
 	/// Constructor.
-	M(EffectCache *cache, api::Device *device, TextureCache *pTextureCache, const utf8_ntri &cacheDir, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
+	M(EffectCache *cache, api::Device *device, TextureCache *pTextureCache, const utf8_ntri &cacheDir, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider,
+		beCore::ThreadPool *pPool)
 		: cache(cache),
 		pTextureCache(pTextureCache),
 		device(device),
-		cacheDir( lean::canonical_path<utf8_string>(cacheDir) ),
+		artifacts( lean::canonical_path<utf8_string>(cacheDir), beCore::ArtifactStore::DefaultSizeBudget, pPool ),
 		resolver(resolver),
-		provider(contentProvider)
+		provider(contentProvider),
+		// NOTE: Only recompile effects whose sources have actually changed
+		fileWatch(beCore::FileRevisionMode::ContentHash)
 	{
 		LEAN_ASSERT(device != nullptr);
 	}
@@ -127,66 +144,91 @@ struct VectorIncludeTracker : public DX::IncludeTracker
 	}
 };
 
-/// Gets the name of the corresponding cache file.
-utf8_string GetCacheFile(const EffectCache::M &m, const lean::utf8_ntri &file)
+/// Version of compiled effect artifacts, increment whenever compiled effects change.
+const uint4 EffectArtifactVersion = 2;
+
+/// Computes the key of the dependency list of the given effect compiled using the given options.
+uint8 GetDependencyKey(const EffectCache::M &m, const beCore::Content &source, const D3D_SHADER_MACRO *pMacros,
+	const uint4 *hooks, uint4 hookCount)
 {
-	return lean::append_path<utf8_string>(
-		m.cacheDir,
-		lean::get_filename<utf8_string>(file).append(".fxc") );
+	beCore::ArtifactKey key("beGraphics.EffectDependencies", EffectArtifactVersion);
+	key.AddValue(GetEffectCompilerKey());
+	key.AddContent(source);
+
+	for (const D3D_SHADER_MACRO *pMacro = pMacros; pMacro && pMacro->Name; ++pMacro)
+	{
+		key.AddString(pMacro->Name);
+		key.AddString((pMacro->Definition) ? pMacro->Definition : "");
+	}
+
+	for (uint4 i = 0; i < hookCount; ++i)
+		key.AddString(m.unresolvedHooks[hooks[i]].get());
+
+	return key.Get();
 }
 
-/// Gets the name of the corresponding cache dependency file.
-utf8_string GetDependencyFile(const lean::utf8_ntri &cacheFile)
+/// Gets the content hash of the given dependency, only re-hashed when its revision changes.
+uint8 GetDependencyHash(EffectCache::M &m, const utf8_string &path)
 {
-	return cacheFile.c_str() + utf8_string(".deps");
+	const uint8 revision = m.provider->GetRevision(path);
+	EffectCache::M::DependencyHash &dependencyHash = m.dependencyHashes[path];
+
+	// NOTE: Providers without revisions always re-hash
+	if (!revision || dependencyHash.revision != revision)
+	{
+		lean::com_ptr<beCore::Content> pContent = m.provider->GetContent(path);
+		dependencyHash.hash = beCore::HashContent(pContent->Data(), static_cast<size_t>(pContent->Size()));
+		dependencyHash.revision = revision;
+	}
+
+	return dependencyHash.hash;
 }
 
-/// Gets the revision of all dependencies stored in the given dependency file.
-uint8 GetDependencyRevision(EffectCache::M &m, const lean::utf8_ntri &dependencyFile, std::vector<utf8_string> *pIncludeFiles)
+/// Computes the key of the compiled effect from the given dependency list, i.e. from the contents of all files the effect
+/// was compiled from. Returns false if any of the dependencies no longer exists.
+bool GetEffectKey(EffectCache::M &m, uint8 dependencyKey, const utf8_t *dependencies, const utf8_t *dependenciesEnd,
+	uint8 &effectKey, std::vector<utf8_string> *pIncludeFiles)
 {
-	uint8 dependencyRevision = 0;
+	beCore::ArtifactKey key("beGraphics.Effect", EffectArtifactVersion);
+	// NOTE: Dependency key covers compiler, macros & hooks
+	key.AddValue(dependencyKey);
 
-	try
-	{
-		lean::com_ptr<beCore::Content> pDependencyData = m.provider->GetContent(dependencyFile);
+	const utf8_t *dependenciesBase = dependencies;
 
-		const utf8_t *dependencies = reinterpret_cast<const utf8_t*>( pDependencyData->Bytes() );
-		const utf8_t *dependenciesBase = dependencies;
-		const utf8_t *dependenciesEnd = dependencies + pDependencyData->Size() / sizeof(utf8_t);
+	while (dependencies != dependenciesEnd)
+	{
+		// Read up to end or next zero delimiter
+		while (dependencies != dependenciesEnd && *dependencies)
+			++dependencies;
 
-		while (dependencies != dependenciesEnd)
+		// Ignore empty strings
+		if (dependencies != dependenciesBase)
 		{
-			// Read up to end or next zero delimiter
-			while (dependencies != dependenciesEnd && *dependencies)
-				++dependencies;
+			// NOTE: might not be null-terminated => construct string
+			utf8_string dependency(dependenciesBase, dependencies);
+			beCore::Exchange::utf8_string path = m.resolver->Resolve(dependency, false);
 
-			// Ignore empty strings
-			if (dependencies != dependenciesBase)
-			{
-				// NOTE: might not be null-terminated => construct string
-				beCore::Exchange::utf8_string path = m.resolver->Resolve( utf8_string(dependenciesBase, dependencies), false );
+			// Check if dependency still existent
+			if (path.empty())
+				return false;
 
-				// Check if dependency still existent
-				if (!path.empty())
-				{
-					dependencyRevision = max( dependencyRevision, m.provider->GetRevision(path) );
+			utf8_string resolvedPath(path.begin(), path.end());
 
-					if (pIncludeFiles)
-						pIncludeFiles->push_back( utf8_string(path.begin(), path.end()) );
-				}
-			}
+			// NOTE: Unresolved paths are independent of the location of the source tree
+			key.AddString(dependency);
+			key.AddValue( GetDependencyHash(m, resolvedPath) );
 
-			// Move on to next dependency string
-			if (dependencies != dependenciesEnd)
-				dependenciesBase = ++dependencies;
+			if (pIncludeFiles)
+				pIncludeFiles->push_back(resolvedPath);
 		}
-	}
-	catch (...)
-	{
-		LEAN_LOG_ERROR_CTX("Could not open cached effect dependency file", dependencyFile.c_str());
+
+		// Move on to next dependency string
+		if (dependencies != dependenciesEnd)
+			dependenciesBase = ++dependencies;
 	}
 
-	return dependencyRevision;
+	effectKey = key.Get();
+	return true;
 }
 
 struct IncludeManagerEL : D3DEffectsLite::Include
@@ -210,9 +252,8 @@ struct IncludeManagerEL : D3DEffectsLite::Include
 };
 
 // Compiles and caches the given effect.
-lean::com_ptr<ID3DBlob, true> CompileAndCacheEffect(EffectCache::M &m, const lean::utf8_ntri &file, const D3D_SHADER_MACRO *pMacros,
-		const uint4 *hooks, uint4 hookCount,
-		const lean::utf8_ntri &cacheFile, const lean::utf8_ntri &dependencyFile,
+lean::com_ptr<ID3DBlob, true> CompileAndCacheEffect(EffectCache::M &m, const lean::utf8_ntri &file, const beCore::Content &source,
+		const D3D_SHADER_MACRO *pMacros, const uint4 *hooks, uint4 hookCount, uint8 dependencyKey,
 		const lean::utf8_ntri &unresolvedFile, std::vector<utf8_string> *pIncludeFiles)
 {
 	typedef std::vector<utf8_string> file_vector;
@@ -223,12 +264,10 @@ lean::com_ptr<ID3DBlob, true> CompileAndCacheEffect(EffectCache::M &m, const lea
 	VectorIncludeTracker rawDependencyTracker(&rawDependencies);
 	DX::IncludeManager includeManager(*m.resolver, *m.provider, &includeTracker, &rawDependencyTracker);
 	
-	lean::com_ptr<bec::Content> rawContent = m.provider->GetContent(file);
-
 	// Extract hashed hook files
 	lean::dynamic_array<const char*> hookFiles(hookCount);
 	for (uint4 i = 0; i < hookCount; ++i)
-		hookFiles.push_back(m.unresolvedHooks[i]);
+		hookFiles.push_back(m.unresolvedHooks[hooks[i]]);
 
 	// Track main file
 	includeTracker.Track(file);
@@ -236,7 +275,7 @@ lean::com_ptr<ID3DBlob, true> CompileAndCacheEffect(EffectCache::M &m, const lea
 
 	// Apply hooks
 	IncludeManagerEL includeManagerEL(includeManager);
-	lean::com_ptr<D3DEffectsLite::Blob> hookedContent = D3DEffectsLite::HookEffect(rawContent->Data(), (UINT) rawContent->Size(),
+	lean::com_ptr<D3DEffectsLite::Blob> hookedContent = D3DEffectsLite::HookEffect(source.Data(), (UINT) source.Size(),
 		&includeManagerEL, &hookFiles[0], hookCount);
 
 	// Compile effect
@@ -244,68 +283,43 @@ lean::com_ptr<ID3DBlob, true> CompileAndCacheEffect(EffectCache::M &m, const lea
 
 	try
 	{
-		{
-			// Cache compiled effect
-			lean::mapped_file mappedFile(cacheFile, pData->GetBufferSize(), true, lean::file::overwrite, lean::file::sequential);
-			memcpy(mappedFile.data(), pData->GetBufferPointer(), pData->GetBufferSize());
-		}
+		// Store dependencies
+		// NOTE: Include zero delimiters
+		utf8_string dependencies;
 
-		try
-		{
-			// Dump dependencies
-			lean::raw_file rawDependencyFile(dependencyFile, lean::file::write, lean::file::overwrite, lean::file::sequential);
+		for (file_vector::const_iterator it = rawDependencies.begin(); it != rawDependencies.end(); ++it)
+			dependencies.append(it->c_str(), it->size() + 1);
 
-			for (file_vector::const_iterator it = rawDependencies.begin(); it != rawDependencies.end(); ++it)
-				// NOTE: Include zero delimiters
-				rawDependencyFile.write(it->c_str(), it->size() + 1);
-		}
-		catch (...)
-		{
-			LEAN_LOG_ERROR_CTX(
-				"Failed to dump dependencies effect to cache",
-				dependencyFile.c_str() );
-		}
+		m.artifacts.Store(dependencyKey, dependencies.data(), dependencies.size());
+
+		// Store compiled effect
+		uint8 effectKey;
+
+		if (GetEffectKey(m, dependencyKey, dependencies.data(), dependencies.data() + dependencies.size(), effectKey, nullptr))
+			// NOTE: Compressed, loading cached effects is bound by disk bandwidth
+			m.artifacts.Store(effectKey, pData->GetBufferPointer(), pData->GetBufferSize(), true);
 	}
 	catch (...)
 	{
 		LEAN_LOG_ERROR_CTX(
 			"Failed to write compiled effect to cache",
-			cacheFile.c_str() );
+			file.c_str() );
 	}
 
 	return pData.transfer();
 }
 
-// Re-compiles the given effect.
-lean::com_ptr<ID3DX11Effect, true> RecompileEffect(EffectCache::M &m, const lean::utf8_ntri &file, const D3D_SHADER_MACRO *pMacros, const uint4 *hooks, uint4 hookCount,
-		const lean::utf8_ntri &mangledFile, const lean::utf8_ntri &unresolvedFile, std::vector<utf8_string> *pIncludeFiles)
-{
-	utf8_string cacheFile = GetCacheFile(m, mangledFile);
-	utf8_string dependencyFile = GetDependencyFile(cacheFile);
-
-	if (pIncludeFiles)
-		pIncludeFiles->clear();
-
-	lean::com_ptr<ID3DBlob> pCompiledData = CompileAndCacheEffect(m, file, pMacros, hooks, hookCount,
-		cacheFile, dependencyFile, unresolvedFile, pIncludeFiles);
-	return CreateEffect(pCompiledData, m.device);
-}
-
 // Compiles or loads the given effect.
 lean::com_ptr<ID3DX11Effect, true> CompileOrLoadEffect(EffectCache::M &m, const lean::utf8_ntri &file, const D3D_SHADER_MACRO *pMacros, const uint4 *hooks, uint4 hookCount,
-		const lean::utf8_ntri &mangledFile, const lean::utf8_ntri &unresolvedFile, std::vector<utf8_string> *pIncludeFiles)
+		const lean::utf8_ntri &unresolvedFile, std::vector<utf8_string> *pIncludeFiles)
 {
 	lean::com_ptr<ID3DX11Effect> pEffect;
 
-	utf8_string cacheFile = GetCacheFile(m, mangledFile);
-	utf8_string dependencyFile = GetDependencyFile(cacheFile);
-
-	uint8 fileRevision = m.provider->GetRevision(file);
-	uint8 cacheRevision = m.provider->GetRevision(cacheFile);
+	if (pIncludeFiles)
+		pIncludeFiles->clear();
 
-	// Also walk cache dependencies to detect all relevant changes
-	if (cacheRevision >= fileRevision)
-		fileRevision = max( fileRevision, GetDependencyRevision(m, dependencyFile, pIncludeFiles) );
+	lean::com_ptr<beCore::Content> pSource = m.provider->GetContent(file);
+	uint8 dependencyKey = GetDependencyKey(m, *pSource, pMacros, hooks, hookCount);
 
 	// WARNING: Keep alive until effect has been created
 	{
@@ -315,25 +329,38 @@ lean::com_ptr<ID3DX11Effect, true> CompileOrLoadEffect(EffectCache::M &m, const
 		const char *pEffectData = nullptr;
 		uint4 effectDataSize = 0;
 
-		// Load from cache, if up-to-date, ...
-		if (cacheRevision >= fileRevision)
+		// Load from cache, if compiled from identical sources before, ...
+		try
 		{
-			try
+			lean::com_ptr<beCore::Content> pDependencies = m.artifacts.Load(dependencyKey);
+			uint8 effectKey;
+
+			if (pDependencies)
 			{
-				pCachedData = m.provider->GetContent(cacheFile);
-				pEffectData = pCachedData->Bytes();
-				effectDataSize = static_cast<uint4>( pCachedData->Size() );
+				const utf8_t *dependencies = reinterpret_cast<const utf8_t*>( pDependencies->Bytes() );
+
+				if (GetEffectKey(m, dependencyKey, dependencies, dependencies + pDependencies->Size() / sizeof(utf8_t), effectKey, pIncludeFiles))
+					pCachedData = m.artifacts.Load(effectKey);
 			}
-			catch (...)
+
+			if (pCachedData)
 			{
-				LEAN_LOG_ERROR_CTX("Error while trying to load cached effect", cacheFile.c_str());
+				pEffectData = pCachedData->Bytes();
+				effectDataSize = static_cast<uint4>( pCachedData->Size() );
 			}
 		}
+		catch (...)
+		{
+			LEAN_LOG_ERROR_CTX("Error while trying to load cached effect", file.c_str());
+		}
 
 		// ... recompile otherwise
 		if (!pEffectData)
 		{
-			pCompiledData = CompileAndCacheEffect(m, file, pMacros, hooks, hookCount, cacheFile, dependencyFile, unresolvedFile, pIncludeFiles);
+			if (pIncludeFiles)
+				pIncludeFiles->clear();
+
+			pCompiledData = CompileAndCacheEffect(m, file, *pSource, pMacros, hooks, hookCount, dependencyKey, unresolvedFile, pIncludeFiles);
 			pEffectData = static_cast<const char*>( pCompiledData->GetBufferPointer() );
 			effectDataSize = static_cast<uint4>(pCompiledData->GetBufferSize());
 		}
@@ -347,8 +374,9 @@ lean::com_ptr<ID3DX11Effect, true> CompileOrLoadEffect(EffectCache::M &m, const
 } // namespace
 
 // Constructor.
-EffectCache::EffectCache(ID3D11Device *device, TextureCache *pTextureCache, const utf8_ntri &cacheDir, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
-	: m( new M(this, device, pTextureCache, cacheDir, resolver, contentProvider) )
+EffectCache::EffectCache(ID3D11Device *device, TextureCache *pTextureCache, const utf8_ntri &cacheDir, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider,
+		beCore::ThreadPool *pPool)
+	: m( new M(this, device, pTextureCache, cacheDir, resolver, contentProvider, pPool) )
 {
 }
 
@@ -419,7 +447,7 @@ inline EffectCache::M::resources_t::file_iterator AddEffect(EffectCache::M &m, c
 		LEAN_LOG("Attempting to load effect \"" << mangledFile << "\"");
 
 		lean::resource_ptr<Effect> effect = new_resource Effect( 
-				CompileOrLoadEffect(m, path, &macros[0], &hooks[0], (uint4) hooks.size(), mangledFile, unresolvedFile, &includeFiles).get(),
+				CompileOrLoadEffect(m, path, &macros[0], &hooks[0], (uint4) hooks.size(), unresolvedFile, &includeFiles).get(),
 				m.pTextureCache
 			);
 
@@ -636,17 +664,12 @@ void EffectCache::Commit()
 {
 	LEAN_PIMPL();
 
-	bool bHasChanges = !m.replaceQueue.empty();
-
+	// NOTE: Dependents notified on replacement
 	while (!m.replaceQueue.empty())
 	{
 		M::replace_queue_t::value_type replacePair = m.replaceQueue.pop_front();
 		Replace(replacePair.first, replacePair.second);
 	}
-
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(Effect::GetComponentType());
 }
 
 // Method called whenever an observed effect has changed.
@@ -663,9 +686,9 @@ void EffectCache::M::Info::FileChanged(const lean::utf8_ntri &file, lean::uint8
 	file_vector includeFiles;
 
 	lean::resource_ptr<Effect> newEffect = new_resource Effect( 
-			RecompileEffect(
+			CompileOrLoadEffect(
 				m, info.resolvedFile, &info.macros[0], &info.hooks[0], (uint4) info.hooks.size(),
-				m.resourceIndex.GetFile(it), info.unresolvedFile, &includeFiles
+				info.unresolvedFile, &includeFiles
 			).get(),
 			m.pTextureCache
 		);
@@ -687,14 +710,15 @@ const beCore::PathResolver& EffectCache::GetPathResolver() const
 
 // Creates a new effect cache.
 lean::resource_ptr<EffectCache, true> CreateEffectCache(const Device &device, TextureCache *pTextureCache, const utf8_ntri &cacheDir, 
-	const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
+	const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider, beCore::ThreadPool *pPool)
 {
 	return new_resource DX11::EffectCache(
 			ToImpl(device),
 			ToImpl(pTextureCache),
 			cacheDir,
 			resolver,
-			contentProvider
+			contentProvider,
+			pPool
 		);
 }
 
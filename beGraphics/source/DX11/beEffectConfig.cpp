@@ -198,7 +198,7 @@ void GetTextures(API::Effect *effect, MaterialConfig::textures_t &textures, Effe
 
 		MaterialConfig::TextureData &data = textures(MaterialConfig::textureData)[textureIdx];
 		data.pTexture = (pTextureCache && pTextureFile)
-			? ToImpl(pTextureCache->GetViewByFile(pTextureFile, !isRaw))
+			? ToImpl(pTextureCache->GetViewByFileAsync(pTextureFile, !isRaw))
 			: nullptr;
 		data.bSet = true;
 	}
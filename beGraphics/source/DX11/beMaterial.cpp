@@ -1232,6 +1232,30 @@ void Material::SetComponent(uint4 idx, const lean::any &pComponent)
 			);
 }
 
+// Gets the memory held by this material.
+beCore::ResourceMemory Material::GetMemory() const
+{
+	beCore::ResourceMemory memory(0, sizeof(Material));
+
+	for (uint4 cbufIdx = 0, cbufCount = (uint4) m.data.constants.size(); cbufIdx < cbufCount; ++cbufIdx)
+	{
+		D3D11_BUFFER_DESC desc;
+		m.data.constants[cbufIdx].buffer->GetDesc(&desc);
+		memory.GPUBytes += desc.ByteWidth;
+	}
+
+	memory.CPUBytes += m.data.backingStore.size()
+		+ m.data.constants.size() * sizeof(Constants)
+		+ m.data.constantDataLinks.size() * sizeof(ConstantDataLink)
+		+ m.data.properties.size() * (sizeof(Property) + sizeof(PropertyData))
+		+ m.data.textures.size() * (sizeof(Texture) + sizeof(TextureData))
+		+ m.data.textureDataLinks.size() * sizeof(TextureDataLink)
+		+ m.dataSources.size() * sizeof(DataSource)
+		+ m.techniques.size() * sizeof(Technique);
+
+	return memory;
+}
+
 } // namespace
 
 // Creates a new material.
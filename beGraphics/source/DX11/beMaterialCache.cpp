@@ -15,11 +15,14 @@
 #include <beCore/beResourceManagerImpl.hpp>
 #include <beCore/beResourceIndex.h>
 #include <beCore/beFileWatch.h>
+#include <beCore/beResourceBudget.h>
 
 #include <lean/io/filesystem.h>
 
 #include <lean/logging/log.h>
 
+#include <algorithm>
+
 extern template beg::DX11::EffectCache::ResourceManagerImpl;
 extern template beg::DX11::EffectCache::FiledResourceManagerImpl;
 
@@ -46,13 +49,19 @@ struct MaterialCache::M // : public beCore::FileObserver
 	{
 		lean::resource_ptr<Material> resource;
 
+		beCore::ResourceMemory memory;
+		uint8 lastUse;
+
 		/// Constructor.
 		Info(Material *resource)
-			: resource(resource) { }
+			: resource(resource),
+			memory(resource->GetMemory()),
+			lastUse(0) { }
 	};
 
 	typedef beCore::ResourceIndex<beg::Material, Info> resources_t;
 	resources_t resourceIndex;
+	beCore::ResourceBudget budget;
 
 	beCore::FileWatch fileWatch;
 
@@ -91,11 +100,76 @@ LEAN_INLINE MaterialCache::M::Info MakeResourceInfo(MaterialCache::M &m, beg::Ma
 	return MaterialCache::M::Info(ToImpl(material));
 }
 
+/// Updates the memory held by the resource at the given resource index iterator.
+template <class Iterator>
+LEAN_INLINE void UpdateMemory(MaterialCache::M &m, Iterator it)
+{
+	beCore::ResourceMemory memory = it->resource->GetMemory();
+	m.budget.Replace(it->memory, memory);
+	it->memory = memory;
+}
+
 /// Sets the resource for the given resource index iterator.
 template <class Iterator>
-LEAN_INLINE void SetResource(MaterialCache::M&, Iterator it, beg::Material *resource)
+LEAN_INLINE void SetResource(MaterialCache::M &m, Iterator it, beg::Material *resource)
 {
 	it->resource = ToImpl(resource);
+	UpdateMemory(m, it);
+}
+
+/// Accounts for the given newly inserted resource.
+template <class Iterator>
+LEAN_INLINE void ResourceInserted(MaterialCache::M &m, Iterator it)
+{
+	m.budget.Add(it->memory);
+	it->lastUse = m.budget.Tick();
+}
+
+/// Checks if the given resource is referenced by anyone but the cache.
+template <class Iterator>
+LEAN_INLINE bool IsResourceUsed(const MaterialCache::M&, Iterator it)
+{
+	return it->resource->ref_count() > 1;
+}
+
+/// Updates the memory held by resources whose data has changed since insertion. Insertion, replacement & eviction
+/// are accounted for as they happen.
+void UpdateResidentMemory(MaterialCache::M &m)
+{
+	const beCore::ComponentMonitorChannel &data = m.pComponentMonitor->Data;
+	const beCore::ComponentType *type = beg::Material::GetComponentType();
+
+	// NOTE: Memory only needed to enforce budgets
+	if (!m.budget.IsLimited() || !data.HasChanged(type))
+		return;
+
+	if (data.AllChangesTracked(type))
+	{
+		beCore::ComponentMonitorChannel::Components changed = data.GetChanged(type);
+
+		for (const void *const *pChanged = changed.Begin; pChanged != changed.End; ++pChanged)
+		{
+			MaterialCache::M::resources_t::iterator it = m.resourceIndex.Find( static_cast<const beg::Material*>(*pChanged) );
+
+			if (it != m.resourceIndex.End())
+				UpdateMemory(m, it);
+		}
+	}
+	else
+		for (MaterialCache::M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
+			UpdateMemory(m, it);
+}
+
+/// Checks if any of the given components are among the given changed components.
+template <class Iterator>
+bool AnyChanged(Iterator begin, Iterator end, const beCore::ComponentMonitorChannel::Components &changed)
+{
+	// NOTE: Changed components sorted by address
+	for (; begin != end; ++begin)
+		if (std::binary_search(changed.Begin, changed.End, static_cast<const void*>(*begin)))
+			return true;
+
+	return false;
 }
 
 // Gets a texture from the given file.
@@ -135,12 +209,24 @@ void MaterialCache::Commit()
 {
 	LEAN_PIMPL();
 
+	if (m.pComponentMonitor)
+		UpdateResidentMemory(m);
+
+	// Evict materials no longer in use while over budget
+	beCore::EvictResources(m);
+
 	if (!m.pComponentMonitor ||
 		!m.pComponentMonitor->Replacement.HasChanged(Effect::GetComponentType()) &&
 		!m.pComponentMonitor->Replacement.HasChanged(MaterialConfig::GetComponentType()))
 		return;
 
-	bool bHasChanges = false;
+	const beCore::ComponentMonitorChannel &replacement = m.pComponentMonitor->Replacement;
+
+	// Only check materials depending on effects & configurations replaced, if known
+	bool bAllTracked = replacement.AllChangesTracked(Effect::GetComponentType()) &&
+		replacement.AllChangesTracked(MaterialConfig::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedEffects = replacement.GetChanged(Effect::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedConfigs = replacement.GetChanged(MaterialConfig::GetComponentType());
 
 	std::vector<const beg::Effect*> newEffects;
 	std::vector<beg::MaterialConfig*> newConfigs;
@@ -148,9 +234,18 @@ void MaterialCache::Commit()
 	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
 	{
 		Material *material = it->resource;
-		lean::resource_ptr<Material> newMaterial = material;
 
 		Material::Effects effects = material->GetEffects();
+		Material::Effects linkedEffects = material->GetLinkedEffects();
+		Material::Configurations configs = material->GetConfigurations();
+
+		if (bAllTracked &&
+			!AnyChanged(effects.begin(), effects.end(), changedEffects) &&
+			!AnyChanged(linkedEffects.begin(), linkedEffects.end(), changedEffects) &&
+			!AnyChanged(configs.begin(), configs.end(), changedConfigs))
+			continue;
+
+		lean::resource_ptr<Material> newMaterial = material;
 		newEffects.assign(effects.begin(), effects.end());
 		bool bEffectsChanged = false;
 
@@ -162,10 +257,9 @@ void MaterialCache::Commit()
 			}
 
 		// IMPORTANT: Also monitor linked effects
-		for (Material::Effects linkedEffects = material->GetLinkedEffects(); linkedEffects; ++linkedEffects)
+		for (; linkedEffects; ++linkedEffects)
 			bEffectsChanged |= (linkedEffects[0]->GetSuccessor() != nullptr);
 
-		Material::Configurations configs = material->GetConfigurations();
 		newConfigs.assign(configs.begin(), configs.end());
 		bool bConfigsChanged = false;
 
@@ -183,12 +277,29 @@ void MaterialCache::Commit()
 
 		if (newMaterial != material)
 			Replace(material, newMaterial);
-		bHasChanges |= bEffectsChanged | bConfigsChanged;
+
+		// Notify dependents
+		if (bEffectsChanged | bConfigsChanged)
+			m.pComponentMonitor->Replacement.AddChanged( Material::GetComponentType(), static_cast<beg::Material*>(material) );
 	}
+}
+
+// Sets the memory budget.
+void MaterialCache::SetMemoryBudget(const beCore::ResourceMemory &budget)
+{
+	LEAN_PIMPL();
+
+	m.budget.SetBudget(budget);
+
+	// Data changes only tracked while limited
+	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
+		UpdateMemory(m, it);
+}
 
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(Material::GetComponentType());
+// Gets memory & usage statistics.
+beCore::ResourceCacheStats MaterialCache::GetCacheStats() const
+{
+	return m->budget.GetStats();
 }
 
 } // namespace
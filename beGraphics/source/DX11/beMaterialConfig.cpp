@@ -360,6 +360,18 @@ void MaterialConfig::SetComponent(uint4 idx, const lean::any &pComponent)
 	SetTexture(idx, lean::any_cast<beGraphics::TextureView*>(pComponent));
 }
 
+// Gets the memory held by this material configuration.
+beCore::ResourceMemory MaterialConfig::GetMemory() const
+{
+	return beCore::ResourceMemory(
+			0,
+			sizeof(MaterialConfig)
+				+ m.backingStore.size()
+				+ m.properties.size() * (sizeof(Property) + sizeof(PropertyData))
+				+ m.textures.size() * (sizeof(Texture) + sizeof(TextureData))
+		);
+}
+
 } // namespace
 
 // Creates a material configuration.
@@ -13,11 +13,14 @@
 #include <beCore/beResourceManagerImpl.hpp>
 #include <beCore/beResourceIndex.h>
 #include <beCore/beFileWatch.h>
+#include <beCore/beResourceBudget.h>
 
 #include <lean/io/filesystem.h>
 
 #include <lean/logging/log.h>
 
+#include <algorithm>
+
 extern template beg::DX11::TextureCache::ResourceManagerImpl;
 extern template beg::DX11::TextureCache::FiledResourceManagerImpl;
 
@@ -40,13 +43,19 @@ struct MaterialConfigCache::M // : public beCore::FileObserver
 	{
 		lean::resource_ptr<MaterialConfig> resource;
 
+		beCore::ResourceMemory memory;
+		uint8 lastUse;
+
 		/// Constructor.
 		Info(MaterialConfig *resource)
-			: resource(resource) { }
+			: resource(resource),
+			memory(resource->GetMemory()),
+			lastUse(0) { }
 	};
 
 	typedef beCore::ResourceIndex<beg::MaterialConfig, Info> resources_t;
 	resources_t resourceIndex;
+	beCore::ResourceBudget budget;
 
 	beCore::FileWatch fileWatch;
 
@@ -83,11 +92,64 @@ LEAN_INLINE MaterialConfigCache::M::Info MakeResourceInfo(MaterialConfigCache::M
 	return MaterialConfigCache::M::Info(ToImpl(config));
 }
 
+/// Updates the memory held by the resource at the given resource index iterator.
+template <class Iterator>
+LEAN_INLINE void UpdateMemory(MaterialConfigCache::M &m, Iterator it)
+{
+	beCore::ResourceMemory memory = it->resource->GetMemory();
+	m.budget.Replace(it->memory, memory);
+	it->memory = memory;
+}
+
 /// Sets the resource for the given resource index iterator.
 template <class Iterator>
-LEAN_INLINE void SetResource(MaterialConfigCache::M&, Iterator it, beg::MaterialConfig *resource)
+LEAN_INLINE void SetResource(MaterialConfigCache::M &m, Iterator it, beg::MaterialConfig *resource)
 {
 	it->resource = ToImpl(resource);
+	UpdateMemory(m, it);
+}
+
+/// Accounts for the given newly inserted resource.
+template <class Iterator>
+LEAN_INLINE void ResourceInserted(MaterialConfigCache::M &m, Iterator it)
+{
+	m.budget.Add(it->memory);
+	it->lastUse = m.budget.Tick();
+}
+
+/// Checks if the given resource is referenced by anyone but the cache.
+template <class Iterator>
+LEAN_INLINE bool IsResourceUsed(const MaterialConfigCache::M&, Iterator it)
+{
+	return it->resource->ref_count() > 1;
+}
+
+/// Updates the memory held by resources whose data has changed since insertion. Insertion, replacement & eviction
+/// are accounted for as they happen.
+void UpdateResidentMemory(MaterialConfigCache::M &m)
+{
+	const beCore::ComponentMonitorChannel &data = m.pComponentMonitor->Data;
+	const beCore::ComponentType *type = beg::MaterialConfig::GetComponentType();
+
+	// NOTE: Memory only needed to enforce budgets
+	if (!m.budget.IsLimited() || !data.HasChanged(type))
+		return;
+
+	if (data.AllChangesTracked(type))
+	{
+		beCore::ComponentMonitorChannel::Components changed = data.GetChanged(type);
+
+		for (const void *const *pChanged = changed.Begin; pChanged != changed.End; ++pChanged)
+		{
+			MaterialConfigCache::M::resources_t::iterator it = m.resourceIndex.Find( static_cast<const beg::MaterialConfig*>(*pChanged) );
+
+			if (it != m.resourceIndex.End())
+				UpdateMemory(m, it);
+		}
+	}
+	else
+		for (MaterialConfigCache::M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
+			UpdateMemory(m, it);
 }
 
 // Sets the component monitor.
@@ -119,24 +181,36 @@ void MaterialConfigCache::Commit()
 {
 	LEAN_PIMPL();
 
+	if (m.pComponentMonitor)
+		UpdateResidentMemory(m);
+
+	// Evict material configurations no longer in use while over budget
+	beCore::EvictResources(m);
+
 	if (!m.pComponentMonitor ||
 		!m.pComponentMonitor->Replacement.HasChanged(TextureView::GetComponentType()))
 		return;
 
-	bool bHasChanges = false;
+	const beCore::ComponentMonitorChannel &replacement = m.pComponentMonitor->Replacement;
 
-	std::vector<const beg::Effect*> newEffects;
-	std::vector<beg::MaterialConfig*> newConfigs;
+	// Only check textures replaced, if known
+	bool bAllTracked = replacement.AllChangesTracked(TextureView::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(TextureView::GetComponentType());
 
 	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
 	{
 		MaterialConfig *material = it->resource;
+		bool bHasChanges = false;
 
 		for (uint4 i = 0, count = material->GetTextureCount(); i < count; ++i)
 		{
 			const beg::TextureView *texture = material->GetTexture(i);
 			bool bTextureChanged = false;
 
+			// NOTE: Changed textures sorted by address
+			if (bAllTracked && !std::binary_search(changed.Begin, changed.End, static_cast<const void*>(texture)))
+				continue;
+
 			while (const beg::TextureView *successor = texture->GetSuccessor())
 			{
 				texture = successor;
@@ -149,11 +223,29 @@ void MaterialConfigCache::Commit()
 				bHasChanges = true;
 			}
 		}
+
+		// Notify dependents
+		if (bHasChanges)
+			m.pComponentMonitor->Data.AddChanged( MaterialConfig::GetComponentType(), static_cast<beg::MaterialConfig*>(material) );
 	}
+}
+
+// Sets the memory budget.
+void MaterialConfigCache::SetMemoryBudget(const beCore::ResourceMemory &budget)
+{
+	LEAN_PIMPL();
+
+	m.budget.SetBudget(budget);
 
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Data.AddChanged(MaterialConfig::GetComponentType());
+	// Data changes only tracked while limited
+	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
+		UpdateMemory(m, it);
+}
+
+// Gets memory & usage statistics.
+beCore::ResourceCacheStats MaterialConfigCache::GetCacheStats() const
+{
+	return m->budget.GetStats();
 }
 
 } // namespace
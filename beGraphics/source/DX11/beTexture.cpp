@@ -606,6 +606,64 @@ TextureDesc GetDesc(ID3D11Resource *pTexture)
 	return TextureDesc();
 }
 
+// Gets the number of bytes of GPU memory held by the given texture.
+uint8 GetTextureMemory(ID3D11Resource *pTexture)
+{
+	uint4 width = 1, height = 1, depth = 1;
+	uint4 mipLevels = 1, elementCount = 1;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+	switch (GetType(pTexture))
+	{
+	case TextureType::Texture1D:
+		{
+			D3D11_TEXTURE1D_DESC desc;
+			static_cast<ID3D11Texture1D*>(pTexture)->GetDesc(&desc);
+			width = desc.Width;
+			mipLevels = desc.MipLevels;
+			elementCount = desc.ArraySize;
+			format = desc.Format;
+		}
+		break;
+	case TextureType::Texture2D:
+		{
+			D3D11_TEXTURE2D_DESC desc;
+			static_cast<ID3D11Texture2D*>(pTexture)->GetDesc(&desc);
+			width = desc.Width;
+			height = desc.Height;
+			mipLevels = desc.MipLevels;
+			elementCount = desc.ArraySize * desc.SampleDesc.Count;
+			format = desc.Format;
+		}
+		break;
+	case TextureType::Texture3D:
+		{
+			D3D11_TEXTURE3D_DESC desc;
+			static_cast<ID3D11Texture3D*>(pTexture)->GetDesc(&desc);
+			width = desc.Width;
+			height = desc.Height;
+			depth = desc.Depth;
+			mipLevels = desc.MipLevels;
+			format = desc.Format;
+		}
+		break;
+	default:
+		return 0;
+	}
+
+	uint8 size = 0;
+
+	for (uint4 mipLevel = 0; mipLevel < mipLevels; ++mipLevel)
+	{
+		// NOTE: Takes care of block-compressed formats
+		size_t rowPitch, slicePitch;
+		DirectX::ComputePitch(format, max(width >> mipLevel, 1U), max(height >> mipLevel, 1U), rowPitch, slicePitch);
+		size += static_cast<uint8>(slicePitch) * max(depth >> mipLevel, 1U);
+	}
+
+	return size * elementCount;
+}
+
 // Gets the type of the given texture.
 TextureType::T GetType(ID3D11Resource *pTexture)
 {
@@ -16,6 +16,8 @@
 #include <beCore/beResourceManagerImpl.hpp>
 #include <beCore/beResourceIndex.h>
 #include <beCore/beFileWatch.h>
+#include <beCore/beAsyncLoader.h>
+#include <beCore/beResourceBudget.h>
 
 #include <lean/io/filesystem.h>
 
@@ -27,6 +29,12 @@ namespace beGraphics
 namespace DX11
 {
 
+/// Gets the memory held by the given texture.
+LEAN_INLINE beCore::ResourceMemory GetResidentMemory(const Texture *texture)
+{
+	return beCore::ResourceMemory( GetTextureMemory(texture->GetResource()), sizeof(Texture) );
+}
+
 /// Texture cache implementation
 struct TextureCache::M : public beCore::FileObserver
 {
@@ -42,27 +50,42 @@ struct TextureCache::M : public beCore::FileObserver
 		lean::resource_ptr<TextureView> pTextureView;
 
 		bool bSRGB;
+		bool bPlaceholder;
+		bool bLoading;
+
+		beCore::ResourceMemory memory;
+		uint8 lastUse;
 
 		/// Constructor.
-		Info(Texture *texture, bool bSRGB)
+		Info(Texture *texture, bool bSRGB, bool bPlaceholder = false)
 			: texture(texture),
-			bSRGB(bSRGB) { }
+			bSRGB(bSRGB),
+			bPlaceholder(bPlaceholder),
+			bLoading(false),
+			memory(GetResidentMemory(texture)),
+			lastUse(0) { }
 	};
 
 	typedef beCore::ResourceIndex<API::Resource, Info> resources_t;
 	resources_t resourceIndex;
+	beCore::ResourceBudget budget;
 
 	beCore::FileWatch fileWatch;
 	typedef lean::simple_queue< std::deque< std::pair< lean::resource_ptr<Texture>, lean::resource_ptr<Texture> > > > replace_queue_t;
 	replace_queue_t replaceQueue;
 	lean::resource_ptr<beCore::ComponentMonitor> pComponentMonitor;
 
+	// ORDER: Destruct loader FIRST, waits for textures still being loaded
+	beCore::AsyncLoader loader;
+
 	/// Constructor.
 	M(TextureCache *cache, api::Device *device, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
 		: cache(cache),
 		device(device),
 		resolver(resolver),
-		provider(contentProvider)
+		provider(contentProvider),
+		// NOTE: Only reload textures whose contents have actually changed
+		fileWatch(beCore::FileRevisionMode::ContentHash)
 	{
 		LEAN_ASSERT(device != nullptr);
 	}
@@ -104,6 +127,14 @@ LEAN_INLINE void SetResource(TextureCache::M &m, Iterator it, beg::Texture *reso
 	M::Info &info = *it;
 	info.texture = ToImpl(resource);
 
+	beCore::ResourceMemory memory = GetResidentMemory(info.texture);
+	m.budget.Replace(info.memory, memory);
+	info.memory = memory;
+
+	// NOTE: Pending loads obsolete once the placeholder has been replaced
+	info.bPlaceholder = false;
+	info.bLoading = false;
+
 	// IMPORTANT: Keep texture view in sync
 	if (info.pTextureView)
 	{
@@ -112,6 +143,12 @@ LEAN_INLINE void SetResource(TextureCache::M &m, Iterator it, beg::Texture *reso
 			lean::resource_ptr<TextureView> newView = new_resource TextureView(info.texture->GetResource(), nullptr, m.device);
 			newView->SetCache(m.cache);
 			info.pTextureView->SetSuccessor(newView);
+
+			// Notify dependents still holding the old view
+			if (m.pComponentMonitor)
+				m.pComponentMonitor->Replacement.AddChanged( beg::TextureView::GetComponentType(),
+					static_cast<const beg::TextureView*>(info.pTextureView.get()) );
+
 			info.pTextureView = newView;
 		}
 		else
@@ -119,6 +156,42 @@ LEAN_INLINE void SetResource(TextureCache::M &m, Iterator it, beg::Texture *reso
 	}
 }
 
+/// Accounts for the given newly inserted resource.
+template <class Iterator>
+LEAN_INLINE void ResourceInserted(TextureCache::M &m, Iterator it)
+{
+	m.budget.Add(it->memory);
+	it->lastUse = m.budget.Tick();
+}
+
+/// Checks if the given texture is referenced by anyone but the cache.
+template <class Iterator>
+LEAN_INLINE bool IsResourceUsed(const TextureCache::M&, Iterator it)
+{
+	const TextureCache::M::Info &info = *it;
+
+	// NOTE: Never evict placeholders still loading, pending loads would be lost
+	return (info.bPlaceholder && info.bLoading)
+		|| info.texture->ref_count() > 1
+		|| (info.pTextureView && info.pTextureView->ref_count() > 1);
+}
+
+/// Releases the given evicted texture.
+template <class Iterator>
+LEAN_INLINE void ResourceEvicted(TextureCache::M &m, Iterator it)
+{
+	utf8_ntr file = m.resourceIndex.GetFile(it);
+
+	if (!file.empty())
+	{
+		m.fileWatch.RemoveObserver(file, &m);
+		LEAN_LOG("Texture \"" << file.c_str() << "\" evicted");
+	}
+
+	it->texture = nullptr;
+	it->pTextureView = nullptr;
+}
+
 /// Gets the resource key for the given resource.
 LEAN_INLINE API::Resource* GetResourceKey(const TextureCache::M&, const beg::Texture *pResource)
 {
@@ -127,10 +200,9 @@ LEAN_INLINE API::Resource* GetResourceKey(const TextureCache::M&, const beg::Tex
 
 /// Default resource change monitoring implementation. Replace using ADL.
 template <class Iterator>
-LEAN_INLINE void ResourceChanged(TextureCache::M &m, Iterator it)
+LEAN_INLINE void ResourceChanged(TextureCache::M &m, Iterator it, const beg::Texture *oldResource)
 {
-	if (m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(beg::TextureView::GetComponentType());
+	// NOTE: Replaced texture views reported in SetResource(), textures without views have no dependents
 }
 
 /// Default resource management change monitoring implementation. Replace using ADL.
@@ -148,6 +220,113 @@ lean::com_ptr<ID3D11Resource, true> LoadTexture(TextureCache::M &m, const lean::
 	return DX11::LoadTexture(m.device, content->Bytes(), static_cast<uint4>(content->Size()), nullptr, bSRGB);
 }
 
+// Creates a placeholder texture to be used until the actual texture has been loaded.
+lean::resource_ptr<Texture, true> CreatePlaceholderTexture(TextureCache::M &m, bool bSRGB)
+{
+	static const uint4 GreyTexel = 0xff808080;
+
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = 1;
+	desc.Height = 1;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = (bSRGB) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA data;
+	data.pSysMem = &GreyTexel;
+	data.SysMemPitch = sizeof(GreyTexel);
+	data.SysMemSlicePitch = sizeof(GreyTexel);
+
+	// NOTE: Textures are indexed by resource, every placeholder needs a resource of its own
+	return CreateTexture( DX11::CreateTexture(desc, &data, m.device).get() );
+}
+
+/// Loads a texture on a worker thread.
+class TextureLoadRequest : public beCore::AsyncLoadRequest
+{
+private:
+	TextureCache::M &m;
+	lean::resource_ptr<Texture> m_placeholder;
+	utf8_string m_file;
+	bool m_bSRGB;
+
+	lean::resource_ptr<Texture> m_texture;
+
+protected:
+	/// Loads the texture.
+	void Load()
+	{
+		m_texture = CreateTexture( LoadTexture(m, m_file, m_bSRGB).get() );
+		LEAN_LOG("Texture \"" << m_file << "\" loaded successfully");
+	}
+
+	/// Checks if the placeholder is referenced by anyone but the cache & this request.
+	bool IsUsed() const
+	{
+		TextureCache::M::resources_t::const_iterator it = m.resourceIndex.Find(m_placeholder->GetResource());
+
+		return it != m.resourceIndex.End() && (
+				m_placeholder->ref_count() > 2 ||
+				(it->pTextureView && it->pTextureView->ref_count() > 1)
+			);
+	}
+
+	/// Replaces the placeholder.
+	void Publish()
+	{
+		TextureCache::M::resources_t::iterator it = m.resourceIndex.Find(m_placeholder->GetResource());
+
+		// NOTE: Placeholder might have been replaced in the meantime, e.g. on file change
+		if (it != m.resourceIndex.End())
+			m.cache->Replace(m_placeholder, m_texture);
+	}
+
+	/// Allows for the placeholder to be requested again & evicted once no longer in use.
+	void Drop()
+	{
+		TextureCache::M::resources_t::iterator it = m.resourceIndex.Find(m_placeholder->GetResource());
+
+		if (it != m.resourceIndex.End())
+			it->bLoading = false;
+	}
+
+public:
+	/// Constructor.
+	TextureLoadRequest(TextureCache::M &m, Texture *pPlaceholder, const utf8_ntri &file, bool bSRGB)
+		: m(m),
+		m_placeholder(pPlaceholder),
+		m_file(file.to<utf8_string>()),
+		m_bSRGB(bSRGB) { }
+};
+
+// Adds the given texture to the given cache.
+TextureCache::M::resources_t::file_iterator AddTexture(TextureCache::M &m, Texture *pTexture, const utf8_ntri &unresolvedFile,
+	const utf8_string &path, bool bSRGB, bool bPlaceholder)
+{
+	// Insert texture into cache
+	TextureCache::M::resources_t::iterator rit = m.resourceIndex.Insert(
+			pTexture->GetResource(),
+			m.resourceIndex.GetUniqueName(lean::get_stem<utf8_string>(unresolvedFile)),
+			TextureCache::M::Info(pTexture, bSRGB, bPlaceholder)
+		);
+	pTexture->SetCache(m.cache);
+	TextureCache::M::resources_t::file_iterator it = m.resourceIndex.SetFile(rit, path);
+
+	m.budget.Add(rit->memory);
+	rit->lastUse = m.budget.Miss();
+	
+	// Watch texture changes
+	m.fileWatch.AddObserver(path, &m);
+
+	return it;
+}
+
 // Gets a texture from the given file.
 beGraphics::Texture* TextureCache::GetByFile(const lean::utf8_ntri &unresolvedFile, bool bSRGB)
 {
@@ -166,17 +345,53 @@ beGraphics::Texture* TextureCache::GetByFile(const lean::utf8_ntri &unresolvedFi
 		lean::resource_ptr<Texture> pTexture = CreateTexture( LoadTexture(m, path, bSRGB).get() );
 		LEAN_LOG("Texture \"" << unresolvedFile.c_str() << "\" created successfully");
 
-		// Insert texture into cache
-		M::resources_t::iterator rit = m.resourceIndex.Insert(
-				pTexture->GetResource(),
-				m.resourceIndex.GetUniqueName(lean::get_stem<utf8_string>(unresolvedFile)),
-				M::Info(pTexture, bSRGB)
-			);
-		pTexture->SetCache(this);
-		it = m.resourceIndex.SetFile(rit, path);
-		
-		// Watch texture changes
-		m.fileWatch.AddObserver(path, &m);
+		it = AddTexture(m, pTexture, unresolvedFile, path, bSRGB, false);
+	}
+	else
+	{
+		it->lastUse = m.budget.Hit();
+
+		if (it->bPlaceholder)
+		{
+			// Don't wait for asynchronous load, pending request obsolete after replacement
+			LEAN_LOG("Attempting to load pending texture \"" << path << "\"");
+			lean::resource_ptr<Texture> pTexture = CreateTexture( LoadTexture(m, path, it->bSRGB).get() );
+			LEAN_LOG("Texture \"" << unresolvedFile.c_str() << "\" created successfully");
+
+			Replace(it->texture, pTexture);
+		}
+	}
+
+	return it->texture;
+}
+
+// Gets a texture from the given file, returning a placeholder texture right away.
+beGraphics::Texture* TextureCache::GetByFileAsync(const lean::utf8_ntri &unresolvedFile, bool bSRGB, beCore::TaskPriority::T priority)
+{
+	LEAN_PIMPL();
+
+	// Nothing to load asynchronously on
+	if (!m.loader.GetThreadPool())
+		return GetByFile(unresolvedFile, bSRGB);
+
+	// Get absolute path
+	beCore::Exchange::utf8_string excPath = m.resolver->Resolve(unresolvedFile, true);
+	utf8_string path(excPath.begin(), excPath.end());
+
+	// Try to find cached resource
+	M::resources_t::file_iterator it = m.resourceIndex.FindByFile(path);
+
+	if (it == m.resourceIndex.EndByFile())
+		it = AddTexture(m, CreatePlaceholderTexture(m, bSRGB), unresolvedFile, path, bSRGB, true);
+	else
+		it->lastUse = m.budget.Hit();
+
+	// NOTE: Requests might have been dropped or failed before
+	if (it->bPlaceholder && !it->bLoading)
+	{
+		LEAN_LOG("Scheduling texture \"" << path << "\" for loading");
+		m.loader.Load( new TextureLoadRequest(m, it->texture, path, it->bSRGB), priority );
+		it->bLoading = true;
 	}
 
 	return it->texture;
@@ -256,17 +471,30 @@ void TextureCache::Commit()
 {
 	LEAN_PIMPL();
 
-	bool bHasChanges = !m.replaceQueue.empty();
+	// Publish asynchronously loaded textures
+	m.loader.Commit();
 
+	// NOTE: Dependents notified on replacement
 	while (!m.replaceQueue.empty())
 	{
 		M::replace_queue_t::value_type replacePair = m.replaceQueue.pop_front();
 		Replace(replacePair.first, replacePair.second);
 	}
 
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(TextureView::GetComponentType());
+	// Evict textures no longer in use while over budget
+	beCore::EvictResources(m);
+}
+
+// Sets the memory budget.
+void TextureCache::SetMemoryBudget(const beCore::ResourceMemory &budget)
+{
+	m->budget.SetBudget(budget);
+}
+
+// Gets memory & usage statistics.
+beCore::ResourceCacheStats TextureCache::GetCacheStats() const
+{
+	return m->budget.GetStats();
 }
 
 // Method called whenever an observed texture has changed.
@@ -286,6 +514,24 @@ void TextureCache::M::FileChanged(const lean::utf8_ntri &file, lean::uint8 revis
 	}
 }
 
+// Sets the thread pool used for asynchronous loading.
+void TextureCache::SetLoadThreadPool(beCore::ThreadPool *pPool)
+{
+	m->loader.SetThreadPool(pPool);
+}
+
+// Gets the thread pool used for asynchronous loading.
+beCore::ThreadPool* TextureCache::GetLoadThreadPool() const
+{
+	return m->loader.GetThreadPool();
+}
+
+// Gets the number of asynchronous loads not yet published.
+uint4 TextureCache::GetPendingLoadCount() const
+{
+	return m->loader.GetPendingCount();
+}
+
 /// Gets the path resolver.
 const beCore::PathResolver& TextureCache::GetPathResolver() const
 {
@@ -176,7 +176,7 @@ void LoadTextures(TextureProvider &textures, const rapidxml::xml_node<lean::utf8
 					{
 						bool bSRGB = textures.IsColorTexture(textureID) || bIsColor;
 						TextureView *texture = (!file.empty())
-							? cache.GetViewByFile(file, bSRGB)
+							? cache.GetViewByFileAsync(file, bSRGB)
 							: cache.GetView(cache.GetByName(name, true));
 						textures.SetTexture(textureID, texture);
 
@@ -245,7 +245,7 @@ void AddTextures(MaterialConfig &config, const rapidxml::xml_node<lean::utf8_t>
 			TextureView *texture;
 
 			if (!file.empty())
-				texture = cache.GetViewByFile(file, bIsColor);
+				texture = cache.GetViewByFileAsync(file, bIsColor);
 			else if (!name.empty())
 				texture = cache.GetView(cache.GetByName(name, true));
 			else
@@ -7,7 +7,7 @@
 #include <beCore/beFileSystem.h>
 
 #include <beCore/beFileSystemPathResolver.h>
-#include <beCore/beFileContentProvider.h>
+#include <beCore/bePackContentProvider.h>
 
 namespace bePhysics
 {
@@ -18,13 +18,13 @@ namespace
 /// Creates a material cache.
 lean::resource_ptr<MaterialCache, true> CreateMaterialCache(Device *device, const utf8_ntri &materialLocation)
 {
-	return bePhysics::CreateMaterialCache( device, beCore::FileSystemPathResolver(materialLocation), beCore::FileContentProvider() );
+	return bePhysics::CreateMaterialCache( device, beCore::FileSystemPathResolver(materialLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash) );
 }
 
 /// Creates a mesh cache.
 lean::resource_ptr<ShapeCache, true> CreateShapeCache(Device *device, const utf8_ntri &shapeLocation)
 {
-	return bePhysics::CreateShapeCache( device, beCore::FileSystemPathResolver(shapeLocation), beCore::FileContentProvider() );
+	return bePhysics::CreateShapeCache( device, beCore::FileSystemPathResolver(shapeLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash) );
 }
 
 } // namespace
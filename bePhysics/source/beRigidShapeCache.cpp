@@ -15,6 +15,8 @@
 #include <lean/logging/errors.h>
 #include <lean/logging/log.h>
 
+#include <algorithm>
+
 namespace bePhysics
 {
 
@@ -66,15 +68,25 @@ void RigidShapeCache::Commit()
 		!m.pComponentMonitor->Replacement.HasChanged(AssembledShape::GetComponentType()))
 		return;
 
-	bool bMeshHasChanges = false;
-	bool bDataHasChanges = false;
+	const beCore::ComponentMonitorChannel &replacement = m.pComponentMonitor->Replacement;
+
+	// Only check sources & materials replaced, if known
+	bool bAllSourcesTracked = replacement.AllChangesTracked(AssembledShape::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedSources = replacement.GetChanged(AssembledShape::GetComponentType());
+	bool bAllMaterialsTracked = replacement.AllChangesTracked(Material::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedMaterials = replacement.GetChanged(Material::GetComponentType());
 
+	// NOTE: Replaced shapes reported on replacement, changed shapes reported one by one
 	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
 	{
 		RigidShape *shape = it->resource;
 
 		const AssembledShape *oldSource = shape->GetSource();
-		const AssembledShape *newSource = bec::GetSuccessor(shape->GetSource());
+		const AssembledShape *newSource = oldSource;
+
+		// NOTE: Changed components sorted by address
+		if (!bAllSourcesTracked || std::binary_search(changedSources.Begin, changedSources.End, static_cast<const void*>(oldSource)))
+			newSource = bec::GetSuccessor(oldSource);
 
 		if (newSource != oldSource)
 		{
@@ -84,12 +96,16 @@ void RigidShapeCache::Commit()
 
 			Replace(shape, newShape);
 			shape = newShape;
-			bMeshHasChanges = true;
 		}
 
 		RigidShape::SubsetRange subsets = shape->GetSubsets();
+		bool bDataHasChanges = false;
+
 		for (uint4 i = 0, count = Size4(subsets); i < count; ++i)
 		{
+			if (bAllMaterialsTracked && !std::binary_search(changedMaterials.Begin, changedMaterials.End, static_cast<const void*>(subsets[i].Material.get())))
+				continue;
+
 			Material *material = bec::GetSuccessor(subsets[i].Material.get());
 			if (material != subsets[i].Material)
 			{
@@ -97,13 +113,11 @@ void RigidShapeCache::Commit()
 				bDataHasChanges = true;
 			}
 		}
-	}
 
-	// Notify dependents
-	if (bMeshHasChanges)
-		m.pComponentMonitor->Replacement.AddChanged(RigidShape::GetComponentType());
-	if (bDataHasChanges)
-		m.pComponentMonitor->Data.AddChanged(RigidShape::GetComponentType());
+		// Notify dependents
+		if (bDataHasChanges)
+			m.pComponentMonitor->Data.AddChanged(RigidShape::GetComponentType(), shape);
+	}
 }
 
 // Sets a default material.
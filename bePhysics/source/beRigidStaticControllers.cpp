@@ -23,6 +23,8 @@
 #include <lean/containers/simple_vector.h>
 #include <lean/memory/chunk_pool.h>
 
+#include <algorithm>
+
 namespace bePhysics
 {
 
@@ -121,21 +123,60 @@ lean::scoped_ptr<RigidStaticControllers, lean::critical_ref> CreateRigidStaticCo
 namespace
 {
 
+/// Re-applies changed shapes to the actors using them, actors keep copies of shapes & materials.
+void UpdateChangedShapes(RigidStaticControllers::M &m, const beCore::ComponentMonitorChannel &channel)
+{
+	LEAN_FREE_PIMPL(RigidStaticControllers);
+	const beCore::ComponentType *type = RigidShape::GetComponentType();
+
+	if (!channel.HasChanged(type))
+		return;
+
+	// Only visit controllers using the shapes changed, if known
+	bool bAllTracked = channel.AllChangesTracked(type);
+	beCore::ComponentMonitorChannel::Components changed = channel.GetChanged(type);
+
+	uint4 controllerCount = (uint4) m.controllers.size();
+
+	for (uint4 internalIdx = 0; internalIdx < controllerCount; ++internalIdx)
+	{
+		M::Record &record = m.controllers(M::record)[internalIdx];
+
+		// NOTE: Changed shapes sorted by address
+		if (record.Shape && (!bAllTracked ||
+			std::binary_search(changed.Begin, changed.End, static_cast<const void*>( static_cast<RigidShape*>(record.Shape.get()) ))))
+		{
+			PX3::SetShape(**record.Actor, *record.Shape, nullptr);
+			m.controllers(M::state)[internalIdx].Config.LastScaling = 1.0f;
+		}
+	}
+}
+
 void CommitExternalChanges(RigidStaticControllers::M &m, beCore::ComponentMonitor &monitor)
 {
 	LEAN_FREE_PIMPL(RigidStaticControllers);
 
-	// TODO: WHAT?
-	bool bHasChanges = monitor.Structure.HasChanged(RigidShape::GetComponentType()) ||
-		monitor.Data.HasChanged(RigidShape::GetComponentType());
+	UpdateChangedShapes(m, monitor.Structure);
+	UpdateChangedShapes(m, monitor.Data);
 
-	if (monitor.Replacement.HasChanged(RigidShape::GetComponentType()))
+	const beCore::ComponentMonitorChannel &replacement = monitor.Replacement;
+
+	if (replacement.HasChanged(RigidShape::GetComponentType()))
 	{
+		// Only check shapes replaced, if known
+		bool bAllTracked = replacement.AllChangesTracked(RigidShape::GetComponentType());
+		beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(RigidShape::GetComponentType());
+
 		uint4 controllerCount = (uint4) m.controllers.size();
 
 		for (uint4 internalIdx = 0; internalIdx < controllerCount; ++internalIdx)
 		{
 			RigidShape *oldShape = m.controllers(M::record)[internalIdx].Shape;
+
+			// NOTE: Changed shapes sorted by address
+			if (bAllTracked && !std::binary_search(changed.Begin, changed.End, static_cast<const void*>(oldShape)))
+				continue;
+
 			RigidShape *shape = bec::GetSuccessor(oldShape);
 
 			if (shape != oldShape)
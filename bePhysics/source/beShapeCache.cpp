@@ -57,7 +57,9 @@ struct ShapeCache::M : public beCore::FileObserver
 		: cache(cache),
 		device(device),
 		resolver(resolver),
-		provider(contentProvider)
+		provider(contentProvider),
+		// NOTE: Only reload shapes whose contents have actually changed
+		fileWatch(beCore::FileRevisionMode::ContentHash)
 	{
 		LEAN_ASSERT(device != nullptr);
 
@@ -136,17 +138,12 @@ void ShapeCache::Commit()
 {
 	LEAN_PIMPL();
 	
-	bool bHasChanges = !m.replaceQueue.empty();
-
+	// NOTE: Dependents notified on replacement
 	while (!m.replaceQueue.empty())
 	{
 		M::replace_queue_t::value_type replacePair = m.replaceQueue.pop_front();
 		Replace(replacePair.first, replacePair.second);
 	}
-
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(AssembledShape::GetComponentType());
 }
 
 // Method called whenever an observed mesh has changed.
@@ -65,6 +65,12 @@ public:
 	BE_SCENE_API const beGraphics::Any::ColorTextureTarget* GetColorTarget(const utf8_ntri &name) const;
 	/// Gets the depth-stencil target identified by the given name nullptr if none available.
 	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetDepthStencilTarget(const utf8_ntri &name) const;
+	/// Gets the target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::Any::TextureTarget* GetAnyTarget(beCore::Atom name) const;
+	/// Gets the color target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::Any::ColorTextureTarget* GetColorTarget(beCore::Atom name) const;
+	/// Gets the depth-stencil target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetDepthStencilTarget(beCore::Atom name) const;
 
 	/// Updates the color target identified by the given name.
 	BE_SCENE_API void SetColorTarget(const utf8_ntri &name,
@@ -74,6 +80,14 @@ public:
 	BE_SCENE_API void SetDepthStencilTarget(const utf8_ntri &name,
 		const beGraphics::Any::DepthStencilTextureTarget *pTarget, uint4 flags, uint4 outputIndex,
 		lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget = nullptr);
+	/// Updates the color target identified by the given name atom.
+	BE_SCENE_API void SetColorTarget(beCore::Atom name,
+		const beGraphics::Any::ColorTextureTarget *pTarget, uint4 flags, uint4 outputIndex,
+		lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget = nullptr);
+	/// Updates the color target identified by the given name atom.
+	BE_SCENE_API void SetDepthStencilTarget(beCore::Atom name,
+		const beGraphics::Any::DepthStencilTextureTarget *pTarget, uint4 flags, uint4 outputIndex,
+		lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget = nullptr);
 	
 
 	/// Gets a new color target matching the given description and stores it under the given name.
@@ -84,6 +98,14 @@ public:
 	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetNewDepthStencilTarget(const utf8_ntri &name,
 		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex,
 		lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget = nullptr);
+	/// Gets a new color target matching the given description and stores it under the given name atom.
+	BE_SCENE_API const beGraphics::Any::ColorTextureTarget* GetNewColorTarget(beCore::Atom name,
+		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex,
+		lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget = nullptr);
+	/// Gets a new depth-stencil target matching the given description and stores it under the given name atom.
+	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetNewDepthStencilTarget(beCore::Atom name,
+		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex,
+		lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget = nullptr);
 
 	/// Gets the color target identified by the given name or adds one according to the given description.
 	BE_SCENE_API const beGraphics::Any::ColorTextureTarget* GetColorTarget(const utf8_ntri &name,
@@ -91,6 +113,12 @@ public:
 	/// Gets the depth-stencil target identified by the given name or adds one according to the given description.
 	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetDepthStencilTarget(const utf8_ntri &name,
 		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew = nullptr);
+	/// Gets the color target identified by the given name atom or adds one according to the given description.
+	BE_SCENE_API const beGraphics::Any::ColorTextureTarget* GetColorTarget(beCore::Atom name,
+		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew = nullptr);
+	/// Gets the depth-stencil target identified by the given name atom or adds one according to the given description.
+	BE_SCENE_API const beGraphics::Any::DepthStencilTextureTarget* GetDepthStencilTarget(beCore::Atom name,
+		const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew = nullptr);
 
 	/// Resets all pipe contents.
 	BE_SCENE_API void Reset(const beGraphics::Any::TextureTargetDesc &desc);
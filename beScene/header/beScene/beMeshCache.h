@@ -15,6 +15,7 @@
 #include <beCore/bePathResolver.h>
 #include <beCore/beContentProvider.h>
 #include <beCore/beComponentMonitor.h>
+#include <beCore/beThreadPool.h>
 #include <lean/pimpl/pimpl_ptr.h>
 
 namespace beScene
@@ -44,15 +45,30 @@ public:
 
 	/// Gets a mesh from the given file.
 	BE_SCENE_API AssembledMesh* GetByFile(const lean::utf8_ntri &file);
+	/// Gets a mesh from the given file, returning an empty placeholder mesh right away & loading the actual mesh on the
+	/// load thread pool. The placeholder is replaced on commit, requests no longer in use by then are dropped.
+	BE_SCENE_API AssembledMesh* GetByFileAsync(const lean::utf8_ntri &file, beCore::TaskPriority::T priority = beCore::TaskPriority::Background);
 
 	/// Commits / reacts to changes.
 	BE_SCENE_API void Commit();
 
+	/// Sets the memory budget.
+	BE_SCENE_API void SetMemoryBudget(const beCore::ResourceMemory &budget) LEAN_OVERRIDE;
+	/// Gets memory & usage statistics.
+	BE_SCENE_API beCore::ResourceCacheStats GetCacheStats() const LEAN_OVERRIDE;
+
 	/// Sets the component monitor.
 	BE_SCENE_API void SetComponentMonitor(beCore::ComponentMonitor *componentMonitor);
 	/// Gets the component monitor.
 	BE_SCENE_API beCore::ComponentMonitor* GetComponentMonitor() const;
 
+	/// Sets the thread pool used for asynchronous loading, nullptr to load synchronously.
+	BE_SCENE_API void SetLoadThreadPool(beCore::ThreadPool *pPool);
+	/// Gets the thread pool used for asynchronous loading.
+	BE_SCENE_API beCore::ThreadPool* GetLoadThreadPool() const;
+	/// Gets the number of asynchronous loads not yet published.
+	BE_SCENE_API uint4 GetPendingLoadCount() const;
+
 	/// Gets the path resolver.
 	BE_SCENE_API const beCore::PathResolver& GetPathResolver() const;
 };
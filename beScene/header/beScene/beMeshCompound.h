@@ -72,9 +72,9 @@ public:
 	typedef beCore::Range<const LOD*> LODRange;
 
 	/// Gets all meshes.
-	LEAN_INLINE MeshRange GetMeshes() const { return beCore::MakeRangeN(&m_meshes[0].get(), m_meshes.size()); }
+	LEAN_INLINE MeshRange GetMeshes() const { return beCore::MakeRangeN(!m_meshes.empty() ? &m_meshes[0].get() : nullptr, m_meshes.size()); }
 	/// Gets all materials.
-	LEAN_INLINE MaterialRange GetMaterials() const { return beCore::MakeRangeN(&m_materials[0].get(), m_materials.size()); }
+	LEAN_INLINE MaterialRange GetMaterials() const { return beCore::MakeRangeN(!m_materials.empty() ? &m_materials[0].get() : nullptr, m_materials.size()); }
 	/// Gets all levels of detail.
 	LEAN_INLINE LODRange GetLODs() const { return beCore::MakeRangeN(m_lods.data(), m_lods.size()); }
 
@@ -8,6 +8,7 @@
 
 #include "beScene.h"
 #include <beCore/beShared.h>
+#include <beCore/beAtoms.h>
 #include <beGraphics/beTextureTargetPool.h>
 #include <beGraphics/beTexture.h>
 #include <beGraphics/beDevice.h>
@@ -58,6 +59,12 @@ public:
 	BE_SCENE_API const beGraphics::ColorTextureTarget* GetColorTarget(const utf8_ntri &name) const;
 	/// Gets the depth-stencil target identified by the given name nullptr if none available.
 	BE_SCENE_API const beGraphics::DepthStencilTextureTarget* GetDepthStencilTarget(const utf8_ntri &name) const;
+	/// Gets the target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::TextureTarget* GetAnyTarget(beCore::Atom name) const;
+	/// Gets the color target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::ColorTextureTarget* GetColorTarget(beCore::Atom name) const;
+	/// Gets the depth-stencil target identified by the given name atom or nullptr if none available.
+	BE_SCENE_API const beGraphics::DepthStencilTextureTarget* GetDepthStencilTarget(beCore::Atom name) const;
 
 	/// Updates the color target identified by the given name.
 	BE_SCENE_API void SetColorTarget(const utf8_ntri &name,
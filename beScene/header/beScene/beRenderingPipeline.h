@@ -8,6 +8,7 @@
 
 #include "beScene.h"
 #include <beCore/beShared.h>
+#include <beCore/beAtoms.h>
 #include <lean/pimpl/pimpl_ptr.h>
 #include "beRenderingLimits.h"
 #include "bePipelinePerspective.h"
@@ -113,6 +114,10 @@ public:
 	BE_SCENE_API uint2 GetStageID(const utf8_ntri &stageName) const;
 	/// Gets the ID of the render queue identified by the given name.
 	BE_SCENE_API uint2 GetQueueID(const utf8_ntri &queueName) const;
+	/// Gets the ID of the pipeline stage identified by the given name.
+	BE_SCENE_API uint2 GetStageID(beCore::Atom stageName) const;
+	/// Gets the ID of the render queue identified by the given name.
+	BE_SCENE_API uint2 GetQueueID(beCore::Atom queueName) const;
 
 	/// Gets the number of pipeline stages.
 	BE_SCENE_API uint2 GetStageCount() const;
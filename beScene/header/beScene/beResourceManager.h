@@ -50,12 +50,18 @@ public:
 
 	/// Commits / reacts to changes.
 	BE_SCENE_API void Commit();
+
+	/// Splits the given memory budget between the texture, mesh, material & material configuration caches.
+	BE_SCENE_API void SetMemoryBudget(const beCore::ResourceMemory &budget);
+	/// Gets memory & usage statistics summed over all caches that keep track of memory.
+	BE_SCENE_API beCore::ResourceCacheStats GetCacheStats() const;
 };
 
-/// Creates a resource manager from the given device.
+/// Creates a resource manager from the given device. Textures & meshes requested asynchronously are loaded on the given pool,
+/// if any, compressed meshes & cached effects are also decompressed on this pool.
 BE_SCENE_API lean::resource_ptr<ResourceManager, true> CreateResourceManager(beGraphics::Device *device,
 	const utf8_ntri &effectCacheDir, const utf8_ntri &effectDir, const utf8_ntri &textureDir, const utf8_ntri &materialDir, const utf8_ntri &meshDir,
-	beCore::ComponentMonitor *pMonitor = nullptr);
+	beCore::ComponentMonitor *pMonitor = nullptr, beCore::ThreadPool *pLoadPool = nullptr);
 /// Creates a resource manager from the given caches.
 BE_SCENE_API lean::resource_ptr<ResourceManager, true> CreateResourceManager(
 	beGraphics::EffectCache *effectCache, beGraphics::TextureCache *textureCache,
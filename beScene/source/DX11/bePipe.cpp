@@ -4,6 +4,7 @@
 
 #include "beSceneInternal/stdafx.h"
 #include "beScene/DX11/bePipe.h"
+#include <beCore/beAtoms.h>
 
 #include <lean/functional/algorithm.h>
 
@@ -18,12 +19,12 @@ namespace DX11
 /// Target.
 struct Target
 {
-	utf8_string name;
+	bec::Atom name;
 	uint4 flags;
 	PipeOutputMask used;
 
-	Target(const utf8_ntri &name, uint4 flags = 0, PipeOutputMask used = 0)
-		: name(name.to<utf8_string>()),
+	Target(bec::Atom name, uint4 flags = 0, PipeOutputMask used = 0)
+		: name(name),
 		flags(flags),
 		used(used) { }
 };
@@ -32,7 +33,7 @@ struct Pipe::ColorTarget : public Target
 {
 	lean::com_ptr<const beGraphics::Any::ColorTextureTarget> pTarget;
 
-	ColorTarget(const utf8_ntri &name, uint4 flags = 0,
+	ColorTarget(bec::Atom name, uint4 flags = 0,
 		const beGraphics::Any::ColorTextureTarget *pTarget = nullptr)
 			: Target(name, flags),
 			pTarget(pTarget) { }
@@ -42,7 +43,7 @@ struct Pipe::DepthStencilTarget : public Target
 {
 	lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> pTarget;
 
-	DepthStencilTarget(const utf8_ntri &name, uint4 flags = 0,
+	DepthStencilTarget(bec::Atom name, uint4 flags = 0,
 		const beGraphics::Any::DepthStencilTextureTarget *pTarget = nullptr)
 			: Target(name, flags),
 			pTarget(pTarget) { }
@@ -51,17 +52,17 @@ struct Pipe::DepthStencilTarget : public Target
 namespace
 {
 
-/// Sorts texture targets by their names.
+/// Sorts texture targets by their name atoms.
 struct TargetNameCompare
 {
 	LEAN_INLINE bool operator ()(const Target &left, const Target &right) { return left.name < right.name; }
-	LEAN_INLINE bool operator ()(const Target &left, const utf8_ntri &right) { return left.name < right; }
-	LEAN_INLINE bool operator ()(const utf8_ntri &left, const Target &right) { return left < right.name; }
+	LEAN_INLINE bool operator ()(const Target &left, bec::Atom right) { return left.name < right; }
+	LEAN_INLINE bool operator ()(bec::Atom left, const Target &right) { return left < right.name; }
 };
 
 /// Gets the target identified by the given name.
 template <class TargetVector>
-inline typename TargetVector::iterator GetTarget(TargetVector &targets, const utf8_ntri &name)
+inline typename TargetVector::iterator GetTarget(TargetVector &targets, bec::Atom name)
 {
 	typename TargetVector::iterator it = std::lower_bound(targets.begin(), targets.end(), name, TargetNameCompare());
 	return (it != targets.end() && it->name == name)
@@ -70,7 +71,7 @@ inline typename TargetVector::iterator GetTarget(TargetVector &targets, const ut
 }
 /// Gets the target identified by the given name.
 template <class TargetVector>
-inline typename TargetVector::const_iterator GetTarget(const TargetVector &targets, const utf8_ntri &name)
+inline typename TargetVector::const_iterator GetTarget(const TargetVector &targets, bec::Atom name)
 {
 	typename TargetVector::const_iterator it = std::lower_bound(targets.begin(), targets.end(), name, TargetNameCompare());
 	return (it != targets.end() && it->name == name)
@@ -80,7 +81,7 @@ inline typename TargetVector::const_iterator GetTarget(const TargetVector &targe
 
 /// Adds a new target to the given color target vector.
 template <class Target, class TargetVector>
-inline typename TargetVector::iterator AddTarget(TargetVector &targets, const utf8_ntri &name)
+inline typename TargetVector::iterator AddTarget(TargetVector &targets, bec::Atom name)
 {
 	targets.push_back( Target(name) );
 	return lean::insert_last(targets.begin(), --targets.end(), TargetNameCompare());
@@ -88,7 +89,7 @@ inline typename TargetVector::iterator AddTarget(TargetVector &targets, const ut
 
 /// Gets the target identified by the given name or adds a new target if none available.
 template <class Target, class TargetVector>
-inline typename TargetVector::iterator GetOrAddTarget(TargetVector &targets, const utf8_ntri &name)
+inline typename TargetVector::iterator GetOrAddTarget(TargetVector &targets, bec::Atom name)
 {
 	typename TargetVector::iterator itTarget = GetTarget(targets, name);
 	return (itTarget != targets.end())
@@ -172,7 +173,7 @@ lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget, true> Pipe::NewD
 }
 
 // Gets the target identified by the given name or nullptr if none available.
-const beGraphics::Any::TextureTarget* Pipe::GetAnyTarget(const utf8_ntri &name) const
+const beGraphics::Any::TextureTarget* Pipe::GetAnyTarget(bec::Atom name) const
 {
 	const beGraphics::TextureTarget* pTarget = GetColorTarget(name);
 	return (pTarget)
@@ -181,7 +182,7 @@ const beGraphics::Any::TextureTarget* Pipe::GetAnyTarget(const utf8_ntri &name)
 }
 
 // Gets the color target identified by the given name or nullptr if none available.
-const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri &name) const
+const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(bec::Atom name) const
 {
 	color_target_vector::const_iterator itTarget = GetTarget(m_colorTargets, name);
 	return (itTarget != m_colorTargets.end())
@@ -190,7 +191,7 @@ const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri
 }
 
 // Gets the depth-stencil target identified by the given name nullptr if none available.
-const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(const utf8_ntri &name) const
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(bec::Atom name) const
 {
 	depth_stencil_target_vector::const_iterator itTarget = GetTarget(m_depthStencilTargets, name);
 	return (itTarget != m_depthStencilTargets.end())
@@ -199,7 +200,7 @@ const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(co
 }
 
 // Updates the color target identified by the given name.
-void Pipe::SetColorTarget(const utf8_ntri &name, const beGraphics::Any::ColorTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
+void Pipe::SetColorTarget(bec::Atom name, const beGraphics::Any::ColorTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
 	lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget)
 {
 	ColorTarget &target = *GetOrAddTarget<ColorTarget>(m_colorTargets, name);
@@ -219,7 +220,7 @@ void Pipe::SetColorTarget(const utf8_ntri &name, const beGraphics::Any::ColorTex
 }
 
 // Updates the color target identified by the given name.
-void Pipe::SetDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::DepthStencilTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
+void Pipe::SetDepthStencilTarget(bec::Atom name, const beGraphics::Any::DepthStencilTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
 	lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget)
 {
 	DepthStencilTarget &target = *GetOrAddTarget<DepthStencilTarget>(m_depthStencilTargets, name);
@@ -239,7 +240,7 @@ void Pipe::SetDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::D
 }
 
 // Gets a new color target matching the given description and stores it under the given name.
-const beGraphics::Any::ColorTextureTarget* Pipe::GetNewColorTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
+const beGraphics::Any::ColorTextureTarget* Pipe::GetNewColorTarget(bec::Atom name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
 	lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget)
 {
 	ColorTarget &target = *GetOrAddTarget<ColorTarget>(m_colorTargets, name);
@@ -263,7 +264,7 @@ const beGraphics::Any::ColorTextureTarget* Pipe::GetNewColorTarget(const utf8_nt
 }
 
 // Gets a new depth-stencil target matching the given description and stores it under the given name.
-const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetNewDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetNewDepthStencilTarget(bec::Atom name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
 	lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget)
 {
 	DepthStencilTarget &target = *GetOrAddTarget<DepthStencilTarget>(m_depthStencilTargets, name);
@@ -287,7 +288,7 @@ const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetNewDepthStencilTarget
 }
 
 // Gets the color target identified by the given name or adds one according to the given description.
-const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
+const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(bec::Atom name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
 {
 	ColorTarget &target = *GetOrAddTarget<ColorTarget>(m_colorTargets, name);
 
@@ -308,7 +309,7 @@ const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri
 }
 
 // Gets the depth-stencil target identified by the given name or adds one according to the given description.
-const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(bec::Atom name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
 {
 	DepthStencilTarget &target = *GetOrAddTarget<DepthStencilTarget>(m_depthStencilTargets, name);
 
@@ -328,6 +329,67 @@ const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(co
 	return target.pTarget;
 }
 
+// Gets the target identified by the given name or nullptr if none available.
+const beGraphics::Any::TextureTarget* Pipe::GetAnyTarget(const utf8_ntri &name) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetAnyTarget( bec::FindAtom(name) );
+}
+
+// Gets the color target identified by the given name or nullptr if none available.
+const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri &name) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetColorTarget( bec::FindAtom(name) );
+}
+
+// Gets the depth-stencil target identified by the given name nullptr if none available.
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(const utf8_ntri &name) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetDepthStencilTarget( bec::FindAtom(name) );
+}
+
+// Updates the color target identified by the given name.
+void Pipe::SetColorTarget(const utf8_ntri &name, const beGraphics::Any::ColorTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
+	lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget)
+{
+	SetColorTarget( bec::InternAtom(name), pTarget, flags, outputIndex, pOldTarget );
+}
+
+// Updates the color target identified by the given name.
+void Pipe::SetDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::DepthStencilTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
+	lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget)
+{
+	SetDepthStencilTarget( bec::InternAtom(name), pTarget, flags, outputIndex, pOldTarget );
+}
+
+// Gets a new color target matching the given description and stores it under the given name.
+const beGraphics::Any::ColorTextureTarget* Pipe::GetNewColorTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
+	lean::com_ptr<const beGraphics::Any::ColorTextureTarget> *pOldTarget)
+{
+	return GetNewColorTarget( bec::InternAtom(name), desc, flags, outputIndex, pOldTarget );
+}
+
+// Gets a new depth-stencil target matching the given description and stores it under the given name.
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetNewDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, 
+	lean::com_ptr<const beGraphics::Any::DepthStencilTextureTarget> *pOldTarget)
+{
+	return GetNewDepthStencilTarget( bec::InternAtom(name), desc, flags, outputIndex, pOldTarget );
+}
+
+// Gets the color target identified by the given name or adds one according to the given description.
+const beGraphics::Any::ColorTextureTarget* Pipe::GetColorTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
+{
+	return GetColorTarget( bec::InternAtom(name), desc, flags, outputIndex, pIsNew );
+}
+
+// Gets the depth-stencil target identified by the given name or adds one according to the given description.
+const beGraphics::Any::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(const utf8_ntri &name, const beGraphics::Any::TextureTargetDesc &desc, uint4 flags, uint4 outputIndex, bool *pIsNew)
+{
+	return GetDepthStencilTarget( bec::InternAtom(name), desc, flags, outputIndex, pIsNew );
+}
+
 // Resets all pipe contents.
 void Pipe::Reset(const beGraphics::Any::TextureTargetDesc &desc)
 {
@@ -394,7 +456,9 @@ void Pipe::KeepResults(bool bKeep)
 // (Re)sets the final target.
 void Pipe::SetFinalTarget(const beGraphics::Any::Texture *pFinalTarget)
 {
-	SetColorTarget("FinalTarget", nullptr, PipeTargetFlags::Flash, 0);
+	const bec::Atom finalTargetName = bec::InternAtom( bec::HashLiteral("FinalTarget") );
+
+	SetColorTarget(finalTargetName, nullptr, PipeTargetFlags::Flash, 0);
 
 	if (pFinalTarget)
 	{
@@ -421,7 +485,7 @@ void Pipe::SetFinalTarget(const beGraphics::Any::Texture *pFinalTarget)
 			pTextureView,
 			pTargetView) );
 
-		SetColorTarget("FinalTarget",
+		SetColorTarget(finalTargetName,
 			m_pFinalTarget.get(),
 			PipeTargetFlags::Flash | PipeTargetFlags::Immutable | PipeTargetFlags::Persistent, 0);
 		SetDesc(desc);
@@ -433,7 +497,8 @@ void Pipe::SetFinalTarget(const beGraphics::Any::Texture *pFinalTarget)
 // Gets the target identified by the given name or nullptr if none available.
 const beGraphics::Any::TextureTarget* Pipe::GetFinalTarget() const
 {
-	return GetAnyTarget("FinalTarget");
+	// NOTE: Literal hashed at compile time
+	return GetAnyTarget( bec::FindAtom(bec::HashLiteral("FinalTarget")) );
 }
 
 // (Re)sets the description.
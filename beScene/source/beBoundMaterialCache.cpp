@@ -72,6 +72,42 @@ void GenericBoundMaterialCache::Commit()
 	if (!m.pComponentMonitor || !m.pComponentMonitor->Replacement.HasChanged(beg::Material::GetComponentType()))
 		return;
 
+	beCore::ComponentMonitorChannel &replacement = m.pComponentMonitor->Replacement;
+
+	// Only visit the materials replaced, if known
+	if (replacement.AllChangesTracked(beg::Material::GetComponentType()))
+	{
+		beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(beg::Material::GetComponentType());
+
+		for (const void *const *itChanged = changed.Begin; itChanged < changed.End; ++itChanged)
+		{
+			// NOTE: Changed materials only used as keys, bound materials keep cached materials alive
+			M::materials_t::iterator it = m.materials.find( static_cast<beg::Material*>(const_cast<void*>(*itChanged)) );
+
+			if (it == m.materials.end())
+				continue;
+
+			beg::Material *newMaterial = bec::GetSuccessor(it->first);
+
+			if (newMaterial != it->first)
+			{
+				lean::resource_ptr<GenericBoundMaterial> boundMaterial = it->second;
+
+				// Release old binding, unlikely to be needed again
+				// ORDER: Erase FIRST, insertion of the new binding may invalidate iterators
+				m.materials.erase(it);
+
+				// Replace old bound material by new one
+				boundMaterial->SetSuccessor( GetMaterial(newMaterial) );
+
+				// Notify dependents
+				replacement.AddChanged(this->GetComponentType(), boundMaterial.get());
+			}
+		}
+
+		return;
+	}
+
 	bool bHasChanges = false;
 
 	for (M::materials_t::iterator it = m.materials.end(); it-- != m.materials.begin(); )
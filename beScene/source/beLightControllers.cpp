@@ -275,13 +275,25 @@ void CommitExternalChanges(typename LightControllers::M &m, beCore::ComponentMon
 	LEAN_FREE_PIMPL(typename LightControllers);
 	typename M::Data &data = *m.data;
 
-	if (monitor.Replacement.HasChanged(LightMaterial::GetComponentType()))
+	const beCore::ComponentMonitorChannel &replacement = monitor.Replacement;
+	const beCore::ComponentType *materialType = LightMaterial::GetComponentType();
+
+	if (replacement.HasChanged(materialType))
 	{
+		// Only check materials replaced, if known
+		bool bAllTracked = replacement.AllChangesTracked(materialType);
+		beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(materialType);
+
 		uint4 controllerCount = (uint4) data.controllers.size();
 
 		for (uint4 internalIdx = 0; internalIdx < controllerCount; ++internalIdx)
 		{
 			typename M::Record &record = data.controllers[internalIdx];
+
+			// NOTE: Changed materials sorted by address
+			if (bAllTracked && !std::binary_search(changed.Begin, changed.End, static_cast<const void*>(record.Material.get())))
+				continue;
+
 			LightMaterial *newMaterial = record.Material;
 			
 			while (LightMaterial *successor = newMaterial->GetSuccessor())
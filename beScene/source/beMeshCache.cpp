@@ -8,10 +8,13 @@
 #include "beScene/beMeshSerialization.h"
 
 #include <beGraphics/beDevice.h>
+#include <beGraphics/Any/beFormat.h>
 
 #include <beCore/beResourceIndex.h>
 #include <beCore/beResourceManagerImpl.hpp>
 #include <beCore/beFileWatch.h>
+#include <beCore/beAsyncLoader.h>
+#include <beCore/beResourceBudget.h>
 
 #include <lean/smart/cloneable_obj.h>
 #include <lean/smart/com_ptr.h>
@@ -26,6 +29,24 @@
 namespace beScene
 {
 
+/// Gets the memory held by the given mesh.
+beCore::ResourceMemory GetResidentMemory(const AssembledMesh *mesh)
+{
+	beCore::ResourceMemory memory(0, sizeof(AssembledMesh));
+
+	for (AssembledMesh::MeshRange meshes = mesh->GetMeshes(); meshes; ++meshes)
+	{
+		const DX11::Mesh &meshDX11 = ToImpl(*meshes[0]);
+
+		memory.GPUBytes += static_cast<uint8>(meshDX11.GetVertexSize()) * meshDX11.GetVertexCount()
+			+ static_cast<uint8>(beGraphics::Any::SizeofFormat(meshDX11.GetIndexFormat())) * meshDX11.GetIndexCount();
+		memory.CPUBytes += sizeof(DX11::Mesh)
+			+ meshDX11.GetVertexElementDescCount() * sizeof(D3D11_INPUT_ELEMENT_DESC);
+	}
+
+	return memory;
+}
+
 /// Mesh cache implementation
 struct MeshCache::M : public beCore::FileObserver
 {
@@ -38,25 +59,40 @@ struct MeshCache::M : public beCore::FileObserver
 	struct Info
 	{
 		lean::resource_ptr<AssembledMesh> resource;
-
-		Info(AssembledMesh *resource)
-			: resource(resource) { }
+		bool bPlaceholder;
+		bool bLoading;
+
+		beCore::ResourceMemory memory;
+		uint8 lastUse;
+
+		Info(AssembledMesh *resource, bool bPlaceholder = false)
+			: resource(resource),
+			bPlaceholder(bPlaceholder),
+			bLoading(false),
+			memory(GetResidentMemory(resource)),
+			lastUse(0) { }
 	};
 
 	typedef bec::ResourceIndex<besc::AssembledMesh, Info> resources_t;
 	resources_t resourceIndex;
+	beCore::ResourceBudget budget;
 
 	beCore::FileWatch fileWatch;
 	typedef lean::simple_queue< std::deque< std::pair< lean::resource_ptr<AssembledMesh>, lean::resource_ptr<AssembledMesh> > > > replace_queue_t;
 	replace_queue_t replaceQueue;
 	lean::resource_ptr<beCore::ComponentMonitor> pComponentMonitor;
 
+	// ORDER: Destruct loader FIRST, waits for meshes still being loaded
+	beCore::AsyncLoader loader;
+
 	/// Constructor.
 	M(MeshCache *cache, beGraphics::Device *device, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
 		: resolver(resolver),
 		provider(contentProvider),
 		cache(cache),
-		device(device)
+		device(device),
+		// NOTE: Only reload meshes whose contents have actually changed
+		fileWatch(beCore::FileRevisionMode::ContentHash)
 	{
 		LEAN_ASSERT(device != nullptr);
 	}
@@ -72,6 +108,135 @@ lean::resource_ptr<AssembledMesh, true> LoadMesh(MeshCache::M &m, const lean::ut
 	return LoadMeshes( content->Bytes(), content->Size(), *m.device );
 }
 
+/// Loads a mesh on a worker thread.
+class MeshLoadRequest : public beCore::AsyncLoadRequest
+{
+private:
+	MeshCache::M &m;
+	lean::resource_ptr<AssembledMesh> m_placeholder;
+	utf8_string m_file;
+
+	lean::resource_ptr<AssembledMesh> m_mesh;
+
+protected:
+	/// Loads the mesh.
+	void Load()
+	{
+		m_mesh = LoadMesh(m, m_file);
+		LEAN_LOG("Mesh \"" << m_file << "\" loaded successfully");
+	}
+
+	/// Checks if the placeholder is referenced by anyone but the cache & this request.
+	bool IsUsed() const
+	{
+		return m.resourceIndex.Find(m_placeholder) != m.resourceIndex.End()
+			&& m_placeholder->ref_count() > 2;
+	}
+
+	/// Replaces the placeholder.
+	void Publish()
+	{
+		// NOTE: Placeholder might have been replaced in the meantime, e.g. on file change
+		if (m.resourceIndex.Find(m_placeholder) != m.resourceIndex.End())
+			m.cache->Replace(m_placeholder, m_mesh);
+	}
+
+	/// Allows for the placeholder to be requested again & evicted once no longer in use.
+	void Drop()
+	{
+		MeshCache::M::resources_t::iterator it = m.resourceIndex.Find(m_placeholder);
+
+		if (it != m.resourceIndex.End())
+			it->bLoading = false;
+	}
+
+public:
+	/// Constructor.
+	MeshLoadRequest(MeshCache::M &m, AssembledMesh *pPlaceholder, const utf8_ntri &file)
+		: m(m),
+		m_placeholder(pPlaceholder),
+		m_file(file.to<utf8_string>()) { }
+};
+
+// Adds the given mesh to the given cache.
+MeshCache::M::resources_t::file_iterator AddMesh(MeshCache::M &m, AssembledMesh *mesh, const utf8_ntri &unresolvedFile,
+	const utf8_string &path, bool bPlaceholder)
+{
+	// Insert mesh into cache
+	MeshCache::M::resources_t::iterator rit = m.resourceIndex.Insert(
+			mesh,
+			m.resourceIndex.GetUniqueName( lean::get_stem<utf8_string>(unresolvedFile) ),
+			MeshCache::M::Info(mesh, bPlaceholder)
+		);
+	mesh->SetCache(m.cache);
+	MeshCache::M::resources_t::file_iterator it = m.resourceIndex.SetFile(rit, path);
+
+	m.budget.Add(rit->memory);
+	rit->lastUse = m.budget.Miss();
+
+	// Watch mesh changes
+	m.fileWatch.AddObserver(path, &m);
+
+	return it;
+}
+
+/// Sets the resource for the given resource index iterator.
+template <class Iterator>
+LEAN_INLINE void SetResource(MeshCache::M &m, Iterator it, AssembledMesh *resource)
+{
+	MeshCache::M::Info &info = *it;
+	info.resource = resource;
+
+	beCore::ResourceMemory memory = GetResidentMemory(resource);
+	m.budget.Replace(info.memory, memory);
+	info.memory = memory;
+
+	// NOTE: Pending loads obsolete once the placeholder has been replaced
+	info.bPlaceholder = false;
+	info.bLoading = false;
+}
+
+/// Accounts for the given newly inserted resource.
+template <class Iterator>
+LEAN_INLINE void ResourceInserted(MeshCache::M &m, Iterator it)
+{
+	m.budget.Add(it->memory);
+	it->lastUse = m.budget.Tick();
+}
+
+/// Checks if the given mesh or any of its subsets is referenced by anyone but the cache.
+template <class Iterator>
+LEAN_INLINE bool IsResourceUsed(const MeshCache::M&, Iterator it)
+{
+	const MeshCache::M::Info &info = *it;
+
+	// NOTE: Never evict placeholders still loading, pending loads would be lost
+	if ((info.bPlaceholder && info.bLoading) || info.resource->ref_count() > 1)
+		return true;
+
+	// NOTE: Subsets only keep a weak pointer to their compound
+	for (AssembledMesh::MeshRange meshes = info.resource->GetMeshes(); meshes; ++meshes)
+		if (meshes[0]->ref_count() > 1)
+			return true;
+
+	return false;
+}
+
+/// Releases the given evicted mesh.
+template <class Iterator>
+LEAN_INLINE void ResourceEvicted(MeshCache::M &m, Iterator it)
+{
+	utf8_ntr file = m.resourceIndex.GetFile(it);
+
+	if (!file.empty())
+	{
+		m.fileWatch.RemoveObserver(file, &m);
+		LEAN_LOG("Mesh \"" << file.c_str() << "\" evicted");
+	}
+
+	it->resource = nullptr;
+}
+
 // Constructor.
 MeshCache::MeshCache(beGraphics::Device *device, const beCore::PathResolver &resolver, const beCore::ContentProvider &contentProvider)
 	: m( new M(this, device, resolver, contentProvider) )
@@ -111,17 +276,56 @@ beScene::AssembledMesh* MeshCache::GetByFile(const lean::utf8_ntri &unresolvedFi
 		lean::resource_ptr<AssembledMesh> mesh = LoadMesh(m, path);
 		LEAN_LOG("Mesh \"" << unresolvedFile.c_str() << "\" created successfully");
 
-		// Insert mesh into cache
-		M::resources_t::iterator rit = m.resourceIndex.Insert(
-				mesh,
-				m.resourceIndex.GetUniqueName( lean::get_stem<utf8_string>(unresolvedFile) ),
-				M::Info(mesh)
-			);
-		mesh->SetCache(this);
-		it = m.resourceIndex.SetFile(rit, path);
-
-		// Watch mesh changes
-		m.fileWatch.AddObserver(path, &m);
+		it = AddMesh(m, mesh, unresolvedFile, path, false);
+	}
+	else
+	{
+		it->lastUse = m.budget.Hit();
+
+		if (it->bPlaceholder)
+		{
+			// Don't wait for asynchronous load, pending request obsolete after replacement
+			LEAN_LOG("Attempting to load pending mesh \"" << path << "\"");
+			lean::resource_ptr<AssembledMesh> mesh = LoadMesh(m, path);
+			LEAN_LOG("Mesh \"" << unresolvedFile.c_str() << "\" created successfully");
+
+			Replace(it->resource, mesh);
+		}
+	}
+
+	return it->resource;
+}
+
+// Gets a mesh from the given file, returning an empty placeholder mesh right away.
+beScene::AssembledMesh* MeshCache::GetByFileAsync(const lean::utf8_ntri &unresolvedFile, beCore::TaskPriority::T priority)
+{
+	LEAN_PIMPL();
+
+	// Nothing to load asynchronously on
+	if (!m.loader.GetThreadPool())
+		return GetByFile(unresolvedFile);
+
+	// Get absolute path
+	beCore::Exchange::utf8_string excPath = m.resolver->Resolve(unresolvedFile, true);
+	utf8_string path(excPath.begin(), excPath.end());
+
+	// Try to find cached mesh
+	M::resources_t::file_iterator it = m.resourceIndex.FindByFile(path);
+
+	if (it == m.resourceIndex.EndByFile())
+	{
+		lean::resource_ptr<AssembledMesh> placeholder = new_resource AssembledMesh();
+		it = AddMesh(m, placeholder, unresolvedFile, path, true);
+	}
+	else
+		it->lastUse = m.budget.Hit();
+
+	// NOTE: Requests might have been dropped or failed before
+	if (it->bPlaceholder && !it->bLoading)
+	{
+		LEAN_LOG("Scheduling mesh \"" << path << "\" for loading");
+		m.loader.Load( new MeshLoadRequest(m, it->resource, path), priority );
+		it->bLoading = true;
 	}
 
 	return it->resource;
@@ -154,17 +358,30 @@ void MeshCache::Commit()
 {
 	LEAN_PIMPL();
 
-	bool bHasChanges = !m.replaceQueue.empty();
+	// Publish asynchronously loaded meshes
+	m.loader.Commit();
 
+	// NOTE: Dependents notified on replacement
 	while (!m.replaceQueue.empty())
 	{
 		M::replace_queue_t::value_type replacePair = m.replaceQueue.pop_front();
 		Replace(replacePair.first, replacePair.second);
 	}
 
-	// Notify dependents
-	if (bHasChanges && m.pComponentMonitor)
-		m.pComponentMonitor->Replacement.AddChanged(AssembledMesh::GetComponentType());
+	// Evict meshes no longer in use while over budget
+	beCore::EvictResources(m);
+}
+
+// Sets the memory budget.
+void MeshCache::SetMemoryBudget(const beCore::ResourceMemory &budget)
+{
+	m->budget.SetBudget(budget);
+}
+
+// Gets memory & usage statistics.
+beCore::ResourceCacheStats MeshCache::GetCacheStats() const
+{
+	return m->budget.GetStats();
 }
 
 // Method called whenever an observed mesh has changed.
@@ -186,6 +403,24 @@ void MeshCache::M::FileChanged(const lean::utf8_ntri &file, lean::uint8 revision
 	}
 }
 
+// Sets the thread pool used for asynchronous loading.
+void MeshCache::SetLoadThreadPool(beCore::ThreadPool *pPool)
+{
+	m->loader.SetThreadPool(pPool);
+}
+
+// Gets the thread pool used for asynchronous loading.
+beCore::ThreadPool* MeshCache::GetLoadThreadPool() const
+{
+	return m->loader.GetThreadPool();
+}
+
+// Gets the number of asynchronous loads not yet published.
+uint4 MeshCache::GetPendingLoadCount() const
+{
+	return m->loader.GetPendingCount();
+}
+
 /// Gets the path resolver.
 const beCore::PathResolver& MeshCache::GetPathResolver() const
 {
@@ -192,21 +192,56 @@ lean::scoped_ptr<MeshControllers, lean::critical_ref> CreateMeshControllers(beCo
 namespace
 {
 
+/// Checks if any meshes in use by attached controllers have been changed.
+bool UsedMeshesChanged(const MeshControllers::M::Data &data, const beCore::ComponentMonitorChannel &channel)
+{
+	const beCore::ComponentType *type = RenderableMesh::GetComponentType();
+
+	if (!channel.HasChanged(type))
+		return false;
+	// Check all meshes, if unknown
+	else if (!channel.AllChangesTracked(type))
+		return true;
+
+	beCore::ComponentMonitorChannel::Components changed = channel.GetChanged(type);
+
+	// NOTE: Unique meshes sorted by address
+	for (const void *const *itChanged = changed.Begin; itChanged < changed.End; ++itChanged)
+		if (std::binary_search(data.uniqueMeshes.begin(), data.uniqueMeshes.end(), static_cast<RenderableMesh*>(const_cast<void*>(*itChanged))))
+			return true;
+
+	return false;
+}
+
 void CommitExternalChanges(MeshControllers::M &m, beCore::ComponentMonitor &monitor)
 {
 	LEAN_FREE_PIMPL(MeshControllers);
 	M::Data &data = *m.data;
 
-	bool bHasChanges = monitor.Structure.HasChanged(RenderableMesh::GetComponentType()) ||
-		monitor.Data.HasChanged(RenderableMesh::GetComponentType());
+	// NOTE: Unique meshes outdated while rebuild pending, detached controllers rebuilt on attachment
+	bool bHasChanges = data.structureRevision == m.controllerRevision && (
+			UsedMeshesChanged(data, monitor.Structure) ||
+			UsedMeshesChanged(data, monitor.Data)
+		);
+
+	const beCore::ComponentMonitorChannel &replacement = monitor.Replacement;
 
-	if (monitor.Replacement.HasChanged(RenderableMesh::GetComponentType()))
+	if (replacement.HasChanged(RenderableMesh::GetComponentType()))
 	{
+		// Only check meshes replaced, if known
+		bool bAllTracked = replacement.AllChangesTracked(RenderableMesh::GetComponentType());
+		beCore::ComponentMonitorChannel::Components changed = replacement.GetChanged(RenderableMesh::GetComponentType());
+
 		uint4 controllerCount = (uint4) data.controllers.size();
 
 		for (uint4 internalIdx = 0; internalIdx < controllerCount; ++internalIdx)
 		{
 			RenderableMesh *oldMesh = data.controllers(M::record)[internalIdx].Mesh;
+
+			// NOTE: Changed meshes sorted by address
+			if (bAllTracked && !std::binary_search(changed.Begin, changed.End, static_cast<const void*>(oldMesh)))
+				continue;
+
 			RenderableMesh *mesh = bec::GetSuccessor(oldMesh);
 
 			if (mesh != oldMesh)
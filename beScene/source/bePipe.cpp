@@ -38,6 +38,24 @@ const beGraphics::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(const u
 	return ToImpl(this)->GetDepthStencilTarget( name );
 }
 
+// Gets the target identified by the given name atom or nullptr if none available.
+const beGraphics::TextureTarget* Pipe::GetAnyTarget(beCore::Atom name) const
+{
+	return ToImpl(this)->GetAnyTarget( name );
+}
+
+// Gets the color target identified by the given name atom or nullptr if none available.
+const beGraphics::ColorTextureTarget* Pipe::GetColorTarget(beCore::Atom name) const
+{
+	return ToImpl(this)->GetColorTarget( name );
+}
+
+// Gets the depth-stencil target identified by the given name atom or nullptr if none available.
+const beGraphics::DepthStencilTextureTarget* Pipe::GetDepthStencilTarget(beCore::Atom name) const
+{
+	return ToImpl(this)->GetDepthStencilTarget( name );
+}
+
 // Updates the color target identified by the given name.
 void Pipe::SetColorTarget(const utf8_ntri &name, const beGraphics::ColorTextureTarget *pTarget, uint4 flags, uint4 outputIndex, 
 	lean::com_ptr<const beGraphics::ColorTextureTarget> *pOldTarget)
@@ -94,6 +94,7 @@ struct PipeEffectBinder::Target
 	ID3DX11EffectScalarVariable *pTextureMultisampling;
 
 	utf8_string name;
+	bec::Atom nameAtom;
 	TargetType::T type;
 	bool bPerObject;
 	bool bOutput;
@@ -261,6 +262,8 @@ PipeEffectBinder::target_vector GetTargets(ID3DX11Effect *pEffect)
 			LEAN_THROW_ERROR_CTX("GetTargets()", "Target missing name semantic.");
 
 		target.name = variableDesc.Semantic;
+		// NOTE: Resolve once, targets are looked up by atom on every pass
+		target.nameAtom = bec::InternAtom(target.name);
 
 		target.pTextureResolution = MaybeGetVectorVariable( pEffect, (target.name + "Resolution").c_str() );
 		target.pTextureScaling = MaybeGetVectorVariable( pEffect, (target.name + "Scaling").c_str() );
@@ -623,14 +626,26 @@ LEAN_INLINE utf8_ntr GenerateLocalName(utf8_t *buffer, size_t bufferLen, const u
 		numEnd + lean::strmcpy( numEnd, name.data(), bufferLen - (numEnd - buffer) ) );
 }
 
-/// Gets the target name.
-template <size_t BufferLen>
-inline utf8_ntr GetTargetName(const PipeEffectBinder::Target &target, utf8_t (&nameBuffer)[BufferLen], const void *pObject)
+/// Gets the target name atom, InvalidAtom if the object-specific name has never been interned.
+inline bec::Atom FindTargetName(const PipeEffectBinder::Target &target, const void *pObject)
 {
-	// Build object-specific name, if requested
-	return (target.bPerObject)
-		? GenerateLocalName(nameBuffer, lean::arraylen(nameBuffer), target.name, pObject)
-		: utf8_ntr(target.name);
+	if (!target.bPerObject)
+		return target.nameAtom;
+
+	// Object-specific names cannot be resolved in advance
+	utf8_t nameBuffer[256];
+	return bec::FindAtom( GenerateLocalName(nameBuffer, lean::arraylen(nameBuffer), target.name, pObject) );
+}
+
+/// Gets the target name atom, interning the object-specific name if requested.
+inline bec::Atom InternTargetName(const PipeEffectBinder::Target &target, const void *pObject)
+{
+	if (!target.bPerObject)
+		return target.nameAtom;
+
+	// Object-specific names cannot be resolved in advance
+	utf8_t nameBuffer[256];
+	return bec::InternAtom( GenerateLocalName(nameBuffer, lean::arraylen(nameBuffer), target.name, pObject) );
 }
 
 /// Sets the sample count, if requested.
@@ -696,8 +711,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 	DX11::Pipe *pPipe, uint4 outputIndex, const void *pObject,
 	ID3D11DeviceContext *pContext)
 {
-	utf8_t nameBuffer[256];
-	utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
+	const bec::Atom targetName = FindTargetName(target, pObject);
 
 	const beGraphics::TextureTarget *pTextureTarget = pPipe->GetColorTarget(targetName);
 	bool bColorTarget = (pTextureTarget != nullptr);
@@ -707,8 +721,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 		pTextureTarget = pPipe->GetDepthStencilTarget(targetName);
 
 	const PipeEffectBinder::Target *pSourceTarget = &target;
-	utf8_t sourceNameBuffer[256];
-	utf8_ntr sourceTargetName = targetName;
+	bec::Atom sourceTargetName = targetName;
 
 	uint4 sourceLoopCounter = 0;
 
@@ -718,7 +731,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 			++sourceLoopCounter < targetCount)
 	{
 		pSourceTarget = &targets[pSourceTarget->sourceTargetID];
-		sourceTargetName = GetTargetName(*pSourceTarget, sourceNameBuffer, pObject);
+		sourceTargetName = FindTargetName(*pSourceTarget, pObject);
 
 		pTextureTarget = pPipe->GetColorTarget(sourceTargetName);
 		bColorTarget = (pTextureTarget != nullptr);
@@ -730,7 +743,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 
 	// Always log essential errors
 	if (sourceLoopCounter == targetCount)
-		LEAN_LOG_ERROR_CTX("Non-terminating texture target source cycle detected!", targetName.c_str());
+		LEAN_LOG_ERROR_CTX("Non-terminating texture target source cycle detected!", target.name.c_str());
 
 	if (pTextureTarget)
 	{
@@ -748,11 +761,14 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 
 			const beGraphics::TextureTarget *pResolvedTextureTarget;
 
+			// NOTE: Target may have been found via its source, original name not necessarily interned yet
+			const bec::Atom resolvedTargetName = InternTargetName(target, pObject);
+
 			// Replace original multisampled target by new non-multisampled resolvation target texture
 			if (bColorTarget)
-				pResolvedTextureTarget = pPipe->GetNewColorTarget(targetName, resolvedDesc, targetFlags | PipeTargetFlags::Keep, outputIndex);
+				pResolvedTextureTarget = pPipe->GetNewColorTarget(resolvedTargetName, resolvedDesc, targetFlags | PipeTargetFlags::Keep, outputIndex);
 			else
-				pResolvedTextureTarget = pPipe->GetNewDepthStencilTarget(targetName, resolvedDesc, targetFlags | PipeTargetFlags::Keep, outputIndex);
+				pResolvedTextureTarget = pPipe->GetNewDepthStencilTarget(resolvedTargetName, resolvedDesc, targetFlags | PipeTargetFlags::Keep, outputIndex);
 
 			// Resolve original multisampled target to new non-multisampled target texture
 			if (pResolvedTextureTarget->GetTexture())
@@ -762,7 +778,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 			}
 			// Always log essential errors
 			else
-				LEAN_LOG_ERROR_CTX("Multisampled target cannot be resolved!", sourceTargetName.c_str());
+				LEAN_LOG_ERROR_CTX("Multisampled target cannot be resolved!", bec::GetAtomString(sourceTargetName).c_str());
 		}
 
 		// Re-generate mip levels before rendering
@@ -773,7 +789,7 @@ LEAN_INLINE void SetTargetTexture(const PipeEffectBinder::Target &target, const
 
 		// Always log essential errors
 		if (!pTextureTarget->GetTexture())
-			LEAN_LOG_ERROR_CTX("Target cannot be bound as texture!", sourceTargetName.c_str());
+			LEAN_LOG_ERROR_CTX("Target cannot be bound as texture!", bec::GetAtomString(sourceTargetName).c_str());
 		
 		MaybeSetResolution(target.pTextureResolution, pTextureTarget->GetDesc());
 		MaybeSetScaling(target.pTextureScaling, pTextureTarget->GetDesc(), pPipe->GetDesc());
@@ -829,10 +845,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 				const ColorDestination &dest = pass.color[i];
 
 				const PipeEffectBinder::Target &target = targets[dest.targetID];
-				utf8_t nameBuffer[256];
-				utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
-
-				pMainTarget = pPipe->GetColorTarget(targetName);
+				pMainTarget = pPipe->GetColorTarget( FindTargetName(target, pObject) );
 			}
 
 			if (!pMainTarget && bHasDepthStencilTarget)
@@ -840,10 +853,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 				const DepthStencilDestination &dest = pass.depthStencil;
 				
 				const PipeEffectBinder::Target &target = targets[dest.targetID];
-				utf8_t nameBuffer[256];
-				utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
-
-				pMainTarget = pPipe->GetDepthStencilTarget(targetName);
+				pMainTarget = pPipe->GetDepthStencilTarget( FindTargetName(target, pObject) );
 			}
 
 			// Use pipe description, if no reference target available.
@@ -900,8 +910,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 			const ColorDestination &dest = pass.color[i];
 
 			const PipeEffectBinder::Target &target = targets[dest.targetID];
-			utf8_t nameBuffer[256];
-			utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
+			const bec::Atom targetName = InternTargetName(target, pObject);
 
 			beGraphics::Any::TextureTargetDesc targetDesc = mainDesc;
 
@@ -934,7 +943,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 			}
 			// Always log essential errors
 			else
-				LEAN_LOG_ERROR_CTX("Color target cannot be rendered to!", targetName.c_str());
+				LEAN_LOG_ERROR_CTX("Color target cannot be rendered to!", bec::GetAtomString(targetName).c_str());
 		}
 
 		ID3D11DepthStencilView *pDepthStencilTarget = nullptr;
@@ -944,8 +953,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 			const DepthStencilDestination &dest = pass.depthStencil;
 			
 			const PipeEffectBinder::Target &target = targets[dest.targetID];
-			utf8_t nameBuffer[256];
-			utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
+			const bec::Atom targetName = InternTargetName(target, pObject);
 
 			beGraphics::Any::TextureTargetDesc targetDesc = mainDesc;
 
@@ -981,7 +989,7 @@ LEAN_INLINE bool SetTargets(const PipeEffectBinder::Pass &pass, const PipeEffect
 			}
 			// Always log essential errors
 			else
-				LEAN_LOG_ERROR_CTX("Depth-stencil target cannot be rendered to!", targetName.c_str());
+				LEAN_LOG_ERROR_CTX("Depth-stencil target cannot be rendered to!", bec::GetAtomString(targetName).c_str());
 		}
 		// DON'T DO THIS:
 		// -> Allows for un-buffered rendering
@@ -1049,11 +1057,14 @@ bool PipeEffectBinder::Apply(uint4 &nextPassID, DX11::Pipe *pPipe, uint4 outputI
 			// Dispose temporary targets as soon as possible
 			if (target.disposePassID <= passID)
 			{
-				utf8_t nameBuffer[256];
-				utf8_ntr targetName = GetTargetName(target, nameBuffer, pObject);
+				const bec::Atom targetName = FindTargetName(target, pObject);
 
-				pPipe->SetColorTarget(targetName, nullptr, outputIndex, 0);
-				pPipe->SetDepthStencilTarget(targetName, nullptr, outputIndex, 0);
+				// Names never interned have never been set
+				if (targetName != bec::InvalidAtom)
+				{
+					pPipe->SetColorTarget(targetName, nullptr, outputIndex, 0);
+					pPipe->SetDepthStencilTarget(targetName, nullptr, outputIndex, 0);
+				}
 			}
 		}
 	}
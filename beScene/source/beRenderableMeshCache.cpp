@@ -17,6 +17,8 @@
 #include <lean/logging/errors.h>
 #include <lean/logging/log.h>
 
+#include <algorithm>
+
 namespace beScene
 {
 
@@ -69,14 +71,22 @@ void RenderableMeshCache::Commit()
 		!m.pComponentMonitor->Replacement.HasChanged(AssembledMesh::GetComponentType()))
 		return;
 
-	bool bMeshHasChanges = false;
-	bool bDataHasChanges = false;
+	const beCore::ComponentMonitorChannel &replacement = m.pComponentMonitor->Replacement;
+
+	// Only check sources & materials replaced, if known
+	bool bAllSourcesTracked = replacement.AllChangesTracked(AssembledMesh::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedSources = replacement.GetChanged(AssembledMesh::GetComponentType());
+	bool bAllMaterialsTracked = replacement.AllChangesTracked(RenderableMaterial::GetComponentType());
+	beCore::ComponentMonitorChannel::Components changedMaterials = replacement.GetChanged(RenderableMaterial::GetComponentType());
 
+	// NOTE: Replaced meshes reported on replacement, changed meshes reported one by one
 	for (M::resources_t::iterator it = m.resourceIndex.Begin(), itEnd = m.resourceIndex.End(); it != itEnd; ++it)
 	{
 		RenderableMesh *mesh = it->resource;
+		const AssembledMesh *oldSource = mesh->GetSource();
 
-		if (const AssembledMesh *oldSource = mesh->GetSource())
+		// NOTE: Changed components sorted by address
+		if (oldSource && (!bAllSourcesTracked || std::binary_search(changedSources.Begin, changedSources.End, static_cast<const void*>(oldSource))))
 		{
 			const AssembledMesh *newSource = bec::GetSuccessor(oldSource);
 
@@ -87,14 +97,18 @@ void RenderableMeshCache::Commit()
 				TransferMaterials(*mesh, *newMesh);
 				Replace(mesh, newMesh);
 				mesh = newMesh;
-				bMeshHasChanges = true;
 			}
 
 		}
 
 		RenderableMesh::MaterialRange materials = mesh->GetMaterials();
+		bool bDataHasChanges = false;
+
 		for (uint4 i = 0, count = Size4(materials); i < count; ++i)
 		{
+			if (bAllMaterialsTracked && !std::binary_search(changedMaterials.Begin, changedMaterials.End, static_cast<const void*>(materials[i])))
+				continue;
+
 			RenderableMaterial *material = bec::GetSuccessor(materials[i]);
 			if (material != materials[i])
 			{
@@ -102,13 +116,11 @@ void RenderableMeshCache::Commit()
 				bDataHasChanges = true;
 			}
 		}
-	}
 
-	// Notify dependents
-	if (bMeshHasChanges)
-		m.pComponentMonitor->Replacement.AddChanged(RenderableMesh::GetComponentType());
-	if (bDataHasChanges)
-		m.pComponentMonitor->Data.AddChanged(RenderableMesh::GetComponentType());
+		// Notify dependents
+		if (bDataHasChanges)
+			m.pComponentMonitor->Data.AddChanged(RenderableMesh::GetComponentType(), mesh);
+	}
 }
 
 // Sets the component monitor.
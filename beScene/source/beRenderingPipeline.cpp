@@ -18,13 +18,13 @@ public:
 	/// Pipeline stage.
 	struct Stage
 	{
-		utf8_string name;		///< Name.
+		bec::Atom name;			///< Name.
 		PipelineStageDesc desc;	///< Description.
 
 		/// Constructor.
-		Stage(const utf8_ntri &name,
+		Stage(bec::Atom name,
 			const PipelineStageDesc &desc)
-				: name( name.to<utf8_string>() ),
+				: name( name ),
 				desc( desc ) { }
 	};
 	typedef std::vector<Stage> stage_vector;
@@ -39,13 +39,13 @@ public:
 	/// Render queue.
 	struct Queue
 	{
-		utf8_string name;		///< Name.
+		bec::Atom name;			///< Name.
 		RenderQueueDesc desc;	///< Description.
 
 		/// Constructor.
-		Queue(const utf8_ntri &name,
+		Queue(bec::Atom name,
 			const RenderQueueDesc &desc)
-				: name( name.to<utf8_string>() ),
+				: name( name ),
 				desc( desc ) { }
 	};
 	typedef std::vector<Queue> queue_vector;
@@ -251,13 +251,13 @@ void RenderingPipeline::ReleaseIntermediate(PipelinePerspective &perspective, co
 namespace
 {
 
-/// Sorts structed elements by their names.
+/// Finds structed elements by their names.
 template <class Type>
 struct NameAttributeCompare
 {
-	utf8_ntr name;
+	bec::Atom name;
 
-	NameAttributeCompare(const utf8_ntr &name)
+	NameAttributeCompare(bec::Atom name)
 		: name(name) { }
 
 	LEAN_INLINE bool operator ()(const Type &elem) { return (elem.name == name); }
@@ -280,18 +280,20 @@ struct IDByLayerCompare
 // Adds a pipeline stage according to the given description.
 uint2 RenderingPipeline::AddStage(const utf8_ntri &stageName, const PipelineStageDesc &desc)	
 {
+	const bec::Atom stageAtom = bec::InternAtom(stageName);
+
 	Impl::stage_vector &stages = m_impl->stages;
 	Impl::stage_vector::iterator it = std::find_if(
 		stages.begin(), stages.end(),
-		NameAttributeCompare<Impl::Stage>(make_ntr(stageName)) );
+		NameAttributeCompare<Impl::Stage>(stageAtom) );
 
 	// Enforce unique names
 	if (it == stages.end())
 	{
 		if (it == stages.end())
-			it = stages.insert(stages.end(), Impl::Stage(stageName, desc));
+			it = stages.insert(stages.end(), Impl::Stage(stageAtom, desc));
 		else
-			*it = Impl::Stage(stageName, desc);
+			*it = Impl::Stage(stageAtom, desc);
 
 		// Insert stage into ordered rendering sequence
 		uint2 stageID = static_cast<uint2>(it - stages.begin());
@@ -319,18 +321,20 @@ uint2 RenderingPipeline::AddStage(const utf8_ntri &stageName, const PipelineStag
 // Adds a render queue according to the given description.
 uint2 RenderingPipeline::AddQueue(const utf8_ntri &queueName, const RenderQueueDesc &desc)
 {
+	const bec::Atom queueAtom = bec::InternAtom(queueName);
+
 	Impl::queue_vector &queues = m_impl->queues;
 	Impl::queue_vector::iterator it = std::find_if(
 		queues.begin(), queues.end(), 
-		NameAttributeCompare<Impl::Queue>(make_ntr(queueName)) );
+		NameAttributeCompare<Impl::Queue>(queueAtom) );
 
 	// Enforce unique names
 	if (it == queues.end())
 	{
 		if (it == queues.end())
-			it = queues.insert(queues.end(), Impl::Queue(queueName, desc));
+			it = queues.insert(queues.end(), Impl::Queue(queueAtom, desc));
 		else
-			*it = Impl::Queue(queueName, desc);
+			*it = Impl::Queue(queueAtom, desc);
 
 		// Insert queue into ordered rendering sequence
 		uint2 queueID = static_cast<uint2>(it - queues.begin());
@@ -370,24 +374,38 @@ void RenderingPipeline::SetQueueSetup(uint2 queueID, const QueueSetup *pSetup)
 
 // Gets the ID of the pipeline stage identified by the given name.
 uint2 RenderingPipeline::GetStageID(const utf8_ntri &stageName) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetStageID( bec::FindAtom(stageName) );
+}
+
+// Gets the ID of the render queue identified by the given name.
+uint2 RenderingPipeline::GetQueueID(const utf8_ntri &queueName) const
+{
+	// NOTE: Strings never interned cannot have been added
+	return GetQueueID( bec::FindAtom(queueName) );
+}
+
+// Gets the ID of the pipeline stage identified by the given name.
+uint2 RenderingPipeline::GetStageID(bec::Atom stageName) const
 {
 	Impl::stage_vector::const_iterator it = std::find_if(
 		m_impl->stages.begin(), m_impl->stages.end(),
-		NameAttributeCompare<Impl::Stage>(make_ntr(stageName)) );
+		NameAttributeCompare<Impl::Stage>(stageName) );
 
-	return (it != m_impl->stages.end())
+	return (it != m_impl->stages.end() && stageName != bec::InvalidAtom)
 		? static_cast<uint2>(it - m_impl->stages.begin())
 		: InvalidPipelineStage;
 }
 
 // Gets the ID of the render queue identified by the given name.
-uint2 RenderingPipeline::GetQueueID(const utf8_ntri &queueName) const
+uint2 RenderingPipeline::GetQueueID(bec::Atom queueName) const
 {
 	Impl::queue_vector::const_iterator it = std::find_if(
 		m_impl->queues.begin(), m_impl->queues.end(), 
-		NameAttributeCompare<Impl::Queue>(make_ntr(queueName)) );
+		NameAttributeCompare<Impl::Queue>(queueName) );
 
-	return (it != m_impl->queues.end())
+	return (it != m_impl->queues.end() && queueName != bec::InvalidAtom)
 		? static_cast<uint2>(it - m_impl->queues.begin())
 		: InvalidRenderQueue;
 }
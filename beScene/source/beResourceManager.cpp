@@ -7,7 +7,8 @@
 #include <beCore/beFileSystem.h>
 
 #include <beCore/beFileSystemPathResolver.h>
-#include <beCore/beFileContentProvider.h>
+#include <beCore/bePackContentProvider.h>
+#include <beCore/beCompressedContentProvider.h>
 
 namespace beScene
 {
@@ -15,13 +16,16 @@ namespace beScene
 namespace
 {
 
+// NOTE: All resources may be served from mounted content packs (see berc pack & beCore::MountContentPack()),
+// loose files override packed files in builds defining BE_CORE_LOOSE_CONTENT_OVERRIDES
+
 /// Creates an effect cache.
 lean::resource_ptr<beGraphics::EffectCache, true> CreateEffectCache(beGraphics::Device *pDevice,
-	const utf8_ntri &effectCacheLocation, const utf8_ntri &effectLocation, beGraphics::TextureCache *pTextureCache)
+	const utf8_ntri &effectCacheLocation, const utf8_ntri &effectLocation, beGraphics::TextureCache *pTextureCache, beCore::ThreadPool *pPool)
 {
 	return beGraphics::CreateEffectCache(*pDevice, pTextureCache,
 		beCore::FileSystem::Get().GetPrimaryPath(effectCacheLocation, true),
-		beCore::FileSystemPathResolver(effectLocation), beCore::FileContentProvider() );
+		beCore::FileSystemPathResolver(effectLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash), pPool );
 }
 
 /// Creates a texture cache.
@@ -29,14 +33,14 @@ lean::resource_ptr<beGraphics::TextureCache, true> CreateTextureCache(beGraphics
 	const utf8_ntri &textureLocation)
 {
 	return beGraphics::CreateTextureCache(*pDevice,
-		beCore::FileSystemPathResolver(textureLocation), beCore::FileContentProvider() );
+		beCore::FileSystemPathResolver(textureLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash) );
 }
 
 /// Creates a material cache.
 lean::resource_ptr<beGraphics::MaterialConfigCache, true> CreateMaterialConfigCache(beGraphics::TextureCache *pTextureCache, const utf8_ntri &materialLocation)
 {
 	return beg::CreateMaterialConfigCache(pTextureCache,
-		beCore::FileSystemPathResolver(materialLocation), beCore::FileContentProvider() );
+		beCore::FileSystemPathResolver(materialLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash) );
 }
 
 /// Creates a material cache.
@@ -44,15 +48,65 @@ lean::resource_ptr<beGraphics::MaterialCache, true> CreateMaterialCache(beGraphi
 	const utf8_ntri &materialLocation)
 {
 	return beg::CreateMaterialCache(pEffectCache, pConfigCache,
-		beCore::FileSystemPathResolver(materialLocation), beCore::FileContentProvider() );
+		beCore::FileSystemPathResolver(materialLocation), beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash) );
 }
 
 /// Creates a mesh cache.
 lean::resource_ptr<MeshCache, true> CreateMeshCache(beGraphics::Device *device,
-	const utf8_ntri &meshLocation)
+	const utf8_ntri &meshLocation, beCore::ThreadPool *pPool)
 {
+	// NOTE: Meshes may be block-compressed (see berc mesh /Z), packed meshes are decompressed just the same
 	return beScene::CreateMeshCache(device,
-		beCore::FileSystemPathResolver(meshLocation), beCore::FileContentProvider() );
+		beCore::FileSystemPathResolver(meshLocation), beCore::CompressedContentProvider(beCore::PackContentProvider(true, beCore::FileRevisionMode::ContentHash), pPool) );
+}
+
+/// Shares of the overall memory budget, in percent.
+struct CacheBudgetShares
+{
+	enum T
+	{
+		Texture = 60,
+		Mesh = 30,
+		MaterialConfig = 5,
+		Material = 5
+	};
+};
+
+/// Gets the given share of the given budget.
+uint8 GetBudgetShare(uint8 budget, uint4 percent)
+{
+	return (budget != beCore::ResourceMemory::Unlimited)
+		? budget / 100 * percent
+		: budget;
+}
+
+/// Gets the given share of the given budget.
+beCore::ResourceMemory GetBudgetShare(const beCore::ResourceMemory &budget, uint4 percent)
+{
+	return beCore::ResourceMemory(
+			GetBudgetShare(budget.GPUBytes, percent),
+			GetBudgetShare(budget.CPUBytes, percent)
+		);
+}
+
+/// Adds the given budget to the given total, unlimited if either is unlimited.
+void AddBudget(uint8 &total, uint8 budget)
+{
+	total = (total != beCore::ResourceMemory::Unlimited && budget != beCore::ResourceMemory::Unlimited)
+		? total + budget
+		: beCore::ResourceMemory::Unlimited;
+}
+
+/// Adds the given cache statistics to the given total.
+void AddCacheStats(beCore::ResourceCacheStats &total, const beCore::ResourceCacheStats &stats)
+{
+	AddBudget(total.Budget.GPUBytes, stats.Budget.GPUBytes);
+	AddBudget(total.Budget.CPUBytes, stats.Budget.CPUBytes);
+	total.Resident += stats.Resident;
+	total.ResidentCount += stats.ResidentCount;
+	total.Hits += stats.Hits;
+	total.Misses += stats.Misses;
+	total.Evictions += stats.Evictions;
 }
 
 } // namespace
@@ -98,10 +152,38 @@ void ResourceManager::Commit()
 	MeshCache->Commit();
 }
 
+// Splits the given memory budget between the texture, mesh, material & material configuration caches.
+void ResourceManager::SetMemoryBudget(const beCore::ResourceMemory &budget)
+{
+	TextureCache->SetMemoryBudget( GetBudgetShare(budget, CacheBudgetShares::Texture) );
+	MeshCache->SetMemoryBudget( GetBudgetShare(budget, CacheBudgetShares::Mesh) );
+	MaterialConfigCache->SetMemoryBudget( GetBudgetShare(budget, CacheBudgetShares::MaterialConfig) );
+	MaterialCache->SetMemoryBudget( GetBudgetShare(budget, CacheBudgetShares::Material) );
+}
+
+// Gets memory & usage statistics summed over all caches that keep track of memory.
+beCore::ResourceCacheStats ResourceManager::GetCacheStats() const
+{
+	beCore::ResourceCacheStats stats;
+	stats.Budget = beCore::ResourceMemory();
+
+	const beCore::ResourceCacheStats cacheStats[] = {
+			TextureCache->GetCacheStats(),
+			MeshCache->GetCacheStats(),
+			MaterialConfigCache->GetCacheStats(),
+			MaterialCache->GetCacheStats()
+		};
+
+	for (size_t i = 0; i < lean::arraylen(cacheStats); ++i)
+		AddCacheStats(stats, cacheStats[i]);
+
+	return stats;
+}
+
 // Creates a resource manager from the given device.
 lean::resource_ptr<ResourceManager, true> CreateResourceManager(beGraphics::Device *device,
 	const utf8_ntri &effectCacheDir, const utf8_ntri &effectDir, const utf8_ntri &textureDir, const utf8_ntri &materialDir, const utf8_ntri &meshDir,
-	beCore::ComponentMonitor *pMonitor)
+	beCore::ComponentMonitor *pMonitor, beCore::ThreadPool *pLoadPool)
 {
 	LEAN_ASSERT(device != nullptr);
 
@@ -110,10 +192,10 @@ lean::resource_ptr<ResourceManager, true> CreateResourceManager(beGraphics::Devi
 		monitor = new_resource bec::ComponentMonitor();
 
 	lean::resource_ptr<beGraphics::TextureCache> textureCache = CreateTextureCache(device, textureDir);
-	lean::resource_ptr<beGraphics::EffectCache> effectCache = CreateEffectCache(device, effectCacheDir, effectDir, textureCache);
+	lean::resource_ptr<beGraphics::EffectCache> effectCache = CreateEffectCache(device, effectCacheDir, effectDir, textureCache, pLoadPool);
 	lean::resource_ptr<beGraphics::MaterialConfigCache> materialConfigCache = CreateMaterialConfigCache(textureCache, materialDir);
 	lean::resource_ptr<beGraphics::MaterialCache> materialCache = CreateMaterialCache(effectCache, materialConfigCache, materialDir);
-	lean::resource_ptr<MeshCache> meshCache = CreateMeshCache(device, meshDir);
+	lean::resource_ptr<MeshCache> meshCache = CreateMeshCache(device, meshDir, pLoadPool);
 	
 	effectCache->SetComponentMonitor(monitor);
 	textureCache->SetComponentMonitor(monitor);
@@ -121,6 +203,9 @@ lean::resource_ptr<ResourceManager, true> CreateResourceManager(beGraphics::Devi
 	materialCache->SetComponentMonitor(monitor);
 	meshCache->SetComponentMonitor(monitor);
 
+	textureCache->SetLoadThreadPool(pLoadPool);
+	meshCache->SetLoadThreadPool(pLoadPool);
+
 	return CreateResourceManager(effectCache, textureCache, materialConfigCache, materialCache, meshCache, monitor);
 }
 
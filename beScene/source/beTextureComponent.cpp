@@ -99,7 +99,7 @@ class TextureReflector : public beCore::ComponentReflector
 		SceneParameters sceneParameters = GetSceneParameters(parameters);
 
 		return bec::any_resource_t<beGraphics::TextureView>::t(
-				sceneParameters.ResourceManager->TextureCache()->GetViewByFile(file) // TODO: Where to get parameters from? --> create?
+				sceneParameters.ResourceManager->TextureCache()->GetViewByFileAsync(file) // TODO: Where to get parameters from? --> create?
 			);
 	}
 